@@ -158,6 +158,7 @@ add_definitions(
   -DCERES_NO_CXSPARSE
   -DCERES_NO_LAPACK
   -DCERES_HAVE_RWLOCK
+  -DCERES_USE_EIGEN_SPARSE
 )
 
 if(WITH_OPENMP)
@@ -349,6 +349,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Sample lights and emissive objects using a tree built over their bounds, "
+        "favoring lights that are near and facing the shading point",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use adaptive sampling",
@@ -625,6 +631,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         description="Use Embree as ray accelerator",
         default=False,
     )
+    debug_use_bvh_instancing: BoolProperty(
+        name="Use Instanced BVH",
+        description="Build a separate BVH for every mesh and a top level BVH over objects: "
+        "faster builds and object updates for scenes with much instancing, slightly slower render",
+        default=False,
+    )
     debug_use_spatial_splits: BoolProperty(
         name="Use Spatial Splits",
         description="Use BVH spatial splits: longer builder time, faster render",
@@ -648,6 +660,27 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default='HILBERT_SPIRAL',
         options=set(),  # Not animatable!
     )
+    use_tile_subdivision: BoolProperty(
+        name="Subdivide Tiles",
+        description="Split the last tiles into smaller ones, so that all threads keep rendering "
+        "until the end of the render (not used with denoising or save buffers)",
+        default=False,
+    )
+    profiling_report_path: StringProperty(
+        name="Profiling Report",
+        description="Directory to write a JSON report with render time per kernel event, shader "
+        "and object to, for every rendered frame and view layer (CPU only, disabled when empty)",
+        subtype='DIR_PATH',
+        default="",
+    )
+    geometry_memory_budget: IntProperty(
+        name="Geometry Memory",
+        description="Amount of geometry and acceleration structure data to keep in memory in "
+        "megabytes, the rest is read from a scratch file on disk when needed, allowing scenes "
+        "larger than the available memory to render at reduced speed (CPU only, 0 to disable)",
+        min=0,
+        default=0,
+    )
     use_progressive_refine: BoolProperty(
         name="Progressive Refine",
         description="Instead of rendering each tile until it is finished, "
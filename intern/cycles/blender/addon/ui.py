@@ -264,9 +264,11 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
         col.prop(cscene, "min_light_bounces")
         col.prop(cscene, "min_transparent_bounces")
         col.prop(cscene, "light_sampling_threshold", text="Light Threshold")
+        col.prop(cscene, "use_light_tree")
 
         if cscene.progressive != 'PATH' and use_branched_path(context):
             col = layout.column(align=True)
+            col.active = not cscene.use_light_tree
             col.prop(cscene, "sample_all_lights_direct")
             col.prop(cscene, "sample_all_lights_indirect")
 
@@ -652,6 +654,10 @@ class CYCLES_RENDER_PT_performance_tiles(CyclesButtonsPanel, Panel):
         sub.active = not rd.use_save_buffers
         sub.prop(cscene, "use_progressive_refine")
 
+        sub = col.column()
+        sub.active = not rd.use_save_buffers and not cscene.use_progressive_refine
+        sub.prop(cscene, "use_tile_subdivision")
+
 
 class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Panel):
     bl_label = "Acceleration Structure"
@@ -673,6 +679,7 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
             row = col.row()
             row.active = use_cpu(context)
             row.prop(cscene, "use_bvh_embree")
+        col.prop(cscene, "debug_use_bvh_instancing")
         col.prop(cscene, "debug_use_spatial_splits")
         sub = col.column()
         sub.active = not cscene.use_bvh_embree or not _cycles.with_embree
@@ -693,12 +700,18 @@ class CYCLES_RENDER_PT_performance_final_render(CyclesButtonsPanel, Panel):
 
         scene = context.scene
         rd = scene.render
+        cscene = scene.cycles
 
         col = layout.column()
 
         col.prop(rd, "use_save_buffers")
         col.prop(rd, "use_persistent_data", text="Persistent Images")
 
+        col.prop(cscene, "geometry_memory_budget")
+
+        col.separator()
+        col.prop(cscene, "profiling_report_path")
+
 
 class CYCLES_RENDER_PT_performance_viewport(CyclesButtonsPanel, Panel):
     bl_label = "Viewport"
@@ -1966,6 +1979,12 @@ class CYCLES_RENDER_PT_bake_output(CyclesButtonsPanel, Panel):
             layout.prop(cbk, "margin")
             layout.prop(cbk, "use_clear", text="Clear Image")
 
+            col = layout.column()
+            col.prop(cbk, "use_tiles")
+            sub = col.column()
+            sub.active = cbk.use_tiles
+            sub.prop(cbk, "tile_size")
+
 
 class CYCLES_RENDER_PT_debug(CyclesButtonsPanel, Panel):
     bl_label = "Debug"
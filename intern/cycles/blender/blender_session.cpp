@@ -38,6 +38,7 @@
 #include "util/util_hash.h"
 #include "util/util_logging.h"
 #include "util/util_murmurhash.h"
+#include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_time.h"
 
@@ -441,6 +442,34 @@ void BlenderSession::stamp_view_layer_metadata(Scene *scene, const string &view_
                             time_human_readable_from_seconds(render_time).c_str());
   b_rr.stamp_data_add_field((prefix + "synchronization_time").c_str(),
                             time_human_readable_from_seconds(total_time - render_time).c_str());
+
+  /* Point to the profiling reports, so scripts can find them from the render result.
+   * With multiple views, every view has its own report. */
+  foreach (const map<string, string>::value_type &view_report, profiling_report_filepaths) {
+    string field = prefix + "profiling_report";
+    if (!view_report.first.empty()) {
+      field += "." + view_report.first;
+    }
+    b_rr.stamp_data_add_field(field.c_str(), view_report.second.c_str());
+  }
+}
+
+string BlenderSession::write_profiling_report(RenderStats &stats, const string &report_dir)
+{
+  string filename = string_printf("%04d_%s", b_scene.frame_current(), b_rlay_name.c_str());
+  if (!b_rview_name.empty()) {
+    filename += "_" + b_rview_name;
+  }
+  string filepath = path_join(report_dir, filename + ".json");
+
+  string report = stats.json_report();
+  if (!path_write_text(filepath, report)) {
+    fprintf(stderr, "Cycles: failed to write profiling report to %s\n", filepath.c_str());
+    return "";
+  }
+
+  VLOG(1) << "Profiling report written to " << filepath;
+  return filepath;
 }
 
 void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
@@ -503,6 +532,17 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
   scene->film->tag_update(scene);
   scene->integrator->tag_update(scene);
 
+  /* Directory to write per view profiling reports to, empty when disabled. */
+  PointerRNA cscene = RNA_pointer_get(&b_scene.ptr, "cycles");
+  string profiling_report_dir;
+  if (!b_engine.is_preview() && background) {
+    profiling_report_dir = get_string(cscene, "profiling_report_path");
+    if (!profiling_report_dir.empty()) {
+      profiling_report_dir = blender_absolute_path(b_data, b_scene, profiling_report_dir);
+    }
+  }
+  profiling_report_filepaths.clear();
+
   BL::RenderResult::views_iterator b_view_iter;
 
   int num_views = 0;
@@ -563,10 +603,19 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     session->start();
     session->wait();
 
-    if (!b_engine.is_preview() && background && print_render_stats) {
+    if (!b_engine.is_preview() && background &&
+        (print_render_stats || !profiling_report_dir.empty())) {
       RenderStats stats;
       session->collect_statistics(&stats);
-      printf("Render statistics:\n%s\n", stats.full_report().c_str());
+      if (print_render_stats) {
+        printf("Render statistics:\n%s\n", stats.full_report().c_str());
+      }
+      if (!profiling_report_dir.empty()) {
+        string filepath = write_profiling_report(stats, profiling_report_dir);
+        if (!filepath.empty()) {
+          profiling_report_filepaths[b_rview_name] = filepath;
+        }
+      }
     }
 
     if (session->progress.get_cancel())
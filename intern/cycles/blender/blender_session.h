@@ -22,6 +22,7 @@
 #include "render/session.h"
 #include "render/bake.h"
 
+#include "util/util_map.h"
 #include "util/util_vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -30,6 +31,7 @@ class ImageMetaData;
 class Scene;
 class Session;
 class RenderBuffers;
+class RenderStats;
 class RenderTile;
 
 class BlenderSession {
@@ -121,6 +123,9 @@ class BlenderSession {
 
   void *python_thread_state;
 
+  /* Files the profiling reports were written to, by view name. */
+  map<string, string> profiling_report_filepaths;
+
   /* Global state which is common for all render sessions created from Blender.
    * Usually denotes command line arguments.
    */
@@ -148,6 +153,10 @@ class BlenderSession {
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
+  /* Write render statistics of the current view as JSON into the profiling
+   * report directory configured in the scene, returns the file path. */
+  string write_profiling_report(RenderStats &stats, const string &report_dir);
+
   void do_write_update_render_result(BL::RenderLayer &b_rlay,
                                      RenderTile &rtile,
                                      bool do_update_only);
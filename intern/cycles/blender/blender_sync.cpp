@@ -296,6 +296,13 @@ void BlenderSync::sync_integrator()
   integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
   integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
 
+  /* Light tree is built along with the light distribution. */
+  const bool use_light_tree = get_boolean(cscene, "use_light_tree");
+  if (integrator->use_light_tree != use_light_tree) {
+    scene->light_manager->tag_update(scene);
+  }
+  integrator->use_light_tree = use_light_tree;
+
   if (RNA_boolean_get(&cscene, "use_adaptive_sampling")) {
     integrator->sampling_pattern = SAMPLING_PATTERN_PMJ;
     integrator->adaptive_min_samples = get_int(cscene, "adaptive_min_samples");
@@ -725,6 +732,7 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
   else
     params.bvh_type = SceneParams::BVH_DYNAMIC;
 
+  params.use_bvh_instancing = RNA_boolean_get(&cscene, "debug_use_bvh_instancing");
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
@@ -748,6 +756,15 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  /* Out of core geometry is only meant for final renders of huge scenes. */
+  if (background) {
+    params.geometry_memory_budget = (size_t)RNA_int_get(&cscene, "geometry_memory_budget") *
+                                    1024 * 1024;
+  }
+  else {
+    params.geometry_memory_budget = 0;
+  }
+
   /* TODO(sergey): Once OSL supports per-microarchitecture optimization get
    * rid of this.
    */
@@ -905,10 +922,15 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
   }
 
   params.use_profiling = params.device.has_profiling && !b_engine.is_preview() && background &&
-                         BlenderSession::print_render_stats;
+                         (BlenderSession::print_render_stats ||
+                          !get_string(cscene, "profiling_report_path").empty());
 
   params.adaptive_sampling = RNA_boolean_get(&cscene, "use_adaptive_sampling");
 
+  /* Tiles written to save buffers must match the render parts exactly. */
+  params.use_tile_subdivision = background && !b_r.use_save_buffers() &&
+                                RNA_boolean_get(&cscene, "use_tile_subdivision");
+
   return params;
 }
 
@@ -17,6 +17,8 @@
 #include "device/device.h"
 #include "device/device_memory.h"
 
+#include "util/util_mapped_memory.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Device Memory */
@@ -37,7 +39,9 @@ device_memory::device_memory(Device *device, const char *name, MemoryType type)
       device_pointer(0),
       host_pointer(0),
       shared_pointer(0),
-      shared_counter(0)
+      shared_counter(0),
+      out_of_core(false),
+      host_out_of_core(false)
 {
 }
 
@@ -49,10 +53,21 @@ device_memory::~device_memory()
 
 void *device_memory::host_alloc(size_t size)
 {
+  host_out_of_core = out_of_core;
+
   if (!size) {
     return 0;
   }
 
+  /* Only the CPU device renders directly from host memory, other devices
+   * would copy the data to the device anyway. */
+  if (out_of_core && device->info.type == DEVICE_CPU) {
+    void *ptr = util_mapped_memory_alloc(size);
+    if (ptr) {
+      return ptr;
+    }
+  }
+
   void *ptr = util_aligned_malloc(size, MIN_ALIGNMENT_CPU_DATA_TYPES);
 
   if (ptr) {
@@ -68,6 +83,11 @@ void *device_memory::host_alloc(size_t size)
 void device_memory::host_free()
 {
   if (host_pointer) {
+    if (util_mapped_memory_free(host_pointer)) {
+      host_pointer = 0;
+      return;
+    }
+
     util_guarded_mem_free(memory_size());
     util_aligned_free((void *)host_pointer);
     host_pointer = 0;
@@ -219,6 +219,12 @@ class device_memory {
   /* reference counter for shared_pointer */
   int shared_counter;
 
+  /* Allocate host memory from a scratch file instead of RAM, so that it can be
+   * paged out when running low on memory. Only affects the CPU device. */
+  bool out_of_core;
+  /* Value of out_of_core the host memory was allocated with. */
+  bool host_out_of_core;
+
   virtual ~device_memory();
 
   void swap_device(Device *new_device, size_t new_device_size, device_ptr new_device_ptr);
@@ -335,7 +341,7 @@ template<typename T> class device_vector : public device_memory {
   {
     size_t new_size = size(width, height, depth);
 
-    if (new_size != data_size) {
+    if (new_size != data_size || out_of_core != host_out_of_core) {
       device_free();
       host_free();
       host_pointer = host_alloc(sizeof(T) * new_size);
@@ -356,7 +362,7 @@ template<typename T> class device_vector : public device_memory {
   {
     size_t new_size = size(width, height, depth);
 
-    if (new_size != data_size) {
+    if (new_size != data_size || out_of_core != host_out_of_core) {
       void *new_ptr = host_alloc(sizeof(T) * new_size);
 
       if (new_size && data_size) {
@@ -388,7 +394,18 @@ template<typename T> class device_vector : public device_memory {
     data_width = 0;
     data_height = 0;
     data_depth = 0;
-    host_pointer = from.steal_pointer();
+
+    if (out_of_core) {
+      /* Memory might be mapped from a file, so copy instead of taking over. */
+      host_pointer = host_alloc(sizeof(T) * data_size);
+      if (data_size) {
+        memcpy(host_pointer, from.data(), sizeof(T) * data_size);
+      }
+      from.clear();
+    }
+    else {
+      host_pointer = from.steal_pointer();
+    }
     assert(device_pointer == 0);
   }
 
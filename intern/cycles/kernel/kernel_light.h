@@ -33,6 +33,34 @@ typedef struct LightSample {
   LightType type; /* type of light */
 } LightSample;
 
+/* Light Selection
+ *
+ * Probability of selecting a light when sampling one at random from P. With
+ * the light tree this depends on P, otherwise lights are selected uniformly
+ * and triangles proportional to their area. */
+
+ccl_device_inline float light_select_lamp_pdf(KernelGlobals *kg, int lamp, float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    if (lamp < 0) {
+      return 0.0f;
+    }
+    return light_tree_pdf(kg, kernel_data.integrator.light_tree_lamp_offset + lamp, P);
+  }
+  return kernel_data.integrator.pdf_lights;
+}
+
+/* Returns the probability per unit area of the triangle. */
+ccl_device_inline float light_select_triangle_pdf(KernelGlobals *kg, int object, float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    /* Triangles within the object are selected proportional to their area. */
+    const float area = kernel_tex_fetch(__light_tree_emitters, object).area;
+    return (area > 0.0f) ? light_tree_pdf(kg, object, P) / area : 0.0f;
+  }
+  return kernel_data.integrator.pdf_triangles;
+}
+
 /* Area light sampling */
 
 /* Uses the following paper:
@@ -511,7 +539,8 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
        * If map sampling is possible, it would be used instead,
        * otherwise fallback sampling is used. */
       if (portal_sampling_pdf == 1.0f) {
-        return kernel_data.integrator.pdf_lights / M_4PI_F;
+        return light_select_lamp_pdf(kg, kernel_data.integrator.light_tree_background_lamp, P) /
+               M_4PI_F;
       }
       else {
         /* Force map sampling. */
@@ -523,14 +552,20 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
     /* Evaluate PDF of sampling this direction by map sampling. */
     map_pdf = background_map_pdf(kg, direction) * (1.0f - portal_sampling_pdf);
   }
-  return (portal_pdf + map_pdf) * kernel_data.integrator.pdf_lights;
+  return (portal_pdf + map_pdf) *
+         light_select_lamp_pdf(kg, kernel_data.integrator.light_tree_background_lamp, P);
 }
 #endif
 
 /* Regular Light */
 
-ccl_device_inline bool lamp_light_sample(
-    KernelGlobals *kg, int lamp, float randu, float randv, float3 P, LightSample *ls)
+ccl_device_inline bool lamp_light_sample(KernelGlobals *kg,
+                                         int lamp,
+                                         float randu,
+                                         float randv,
+                                         float3 P,
+                                         float select_pdf,
+                                         LightSample *ls)
 {
   const ccl_global KernelLight *klight = &kernel_tex_fetch(__lights, lamp);
   LightType type = (LightType)klight->type;
@@ -645,7 +680,7 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= select_pdf;
 
   return (ls->pdf > 0.0f);
 }
@@ -783,7 +818,7 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= light_select_lamp_pdf(kg, lamp, P);
 
   return true;
 }
@@ -822,12 +857,12 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
-                                                const float3 Ng,
+ccl_device_inline float triangle_light_pdf_area(const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float select_pdf)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
+  float pdf = select_pdf;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -852,10 +887,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+  const float select_pdf = light_select_triangle_pdf(kg, sd->object, Px);
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -883,12 +920,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       else {
         area = 0.5f * len(N);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * select_pdf;
       return pdf / solid_angle;
     }
   }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(sd->Ng, sd->I, t, select_pdf);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -912,7 +949,8 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
                                                   float randv,
                                                   float time,
                                                   LightSample *ls,
-                                                  const float3 P)
+                                                  const float3 P,
+                                                  float select_pdf)
 {
   /* A naive heuristic to decide between costly solid angle sampling
    * and simple area sampling, comparing the distance to the triangle plane
@@ -1036,7 +1074,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
         triangle_world_space_vertices(kg, object, prim, -1.0f, V);
         area = triangle_area(V[0], V[1], V[2]);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * select_pdf;
       ls->pdf = pdf / solid_angle;
     }
   }
@@ -1050,7 +1088,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
+    ls->pdf = triangle_light_pdf_area(ls->Ng, -ls->D, ls->t, select_pdf);
     if (has_motion && area != 0.0f) {
       /* scale the PDF.
        * area = the area the sample was taken from
@@ -1066,15 +1104,21 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
 
 /* Light Distribution */
 
-ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
+/* Sample an entry from a range of the light distribution, proportional to area. */
+ccl_device int light_distribution_sample_range(KernelGlobals *kg,
+                                               int offset,
+                                               int num,
+                                               float *randu)
 {
   /* This is basically std::upper_bound as used by pbrt, to find a point light or
    * triangle to emit from, proportional to area. a good improvement would be to
    * also sample proportional to power, though it's not so well defined with
    * arbitrary shaders. */
-  int first = 0;
-  int len = kernel_data.integrator.num_distribution + 1;
-  float r = *randu;
+  const float range_min = kernel_tex_fetch(__light_distribution, offset).totarea;
+  const float range_max = kernel_tex_fetch(__light_distribution, offset + num).totarea;
+  int first = offset;
+  int len = num + 1;
+  float r = range_min + *randu * (range_max - range_min);
 
   do {
     int half_len = len >> 1;
@@ -1091,7 +1135,7 @@ ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
 
   /* Clamping should not be needed but float rounding errors seem to
    * make this fail on rare occasions. */
-  int index = clamp(first - 1, 0, kernel_data.integrator.num_distribution - 1);
+  int index = clamp(first - 1, offset, offset + num - 1);
 
   /* Rescale to reuse random number. this helps the 2D samples within
    * each area light be stratified as well. */
@@ -1102,6 +1146,11 @@ ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
   return index;
 }
 
+ccl_device int light_distribution_sample(KernelGlobals *kg, float *randu)
+{
+  return light_distribution_sample_range(kg, 0, kernel_data.integrator.num_distribution, randu);
+}
+
 /* Generic Light */
 
 ccl_device_inline bool light_select_reached_max_bounces(KernelGlobals *kg, int index, int bounce)
@@ -1118,9 +1167,33 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
+  float lamp_pdf = kernel_data.integrator.pdf_lights;
+
   if (lamp < 0) {
     /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+    int index;
+    float triangle_pdf = kernel_data.integrator.pdf_triangles;
+
+    if (kernel_data.integrator.use_light_tree) {
+      /* Select an object or lamp from the tree, and a triangle of the object
+       * proportional to area. */
+      float tree_pdf;
+      int emitter = light_tree_sample(kg, P, &randu, &tree_pdf);
+      if (emitter < 0) {
+        return false;
+      }
+
+      const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(
+          __light_tree_emitters, emitter);
+      index = light_distribution_sample_range(
+          kg, kemitter->distribution_offset, kemitter->num_distribution, &randu);
+
+      lamp_pdf = tree_pdf;
+      triangle_pdf = (kemitter->area > 0.0f) ? tree_pdf / kemitter->area : 0.0f;
+    }
+    else {
+      index = light_distribution_sample(kg, &randu);
+    }
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
@@ -1131,7 +1204,7 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
       int object = kdistribution->mesh_light.object_id;
       int shader_flag = kdistribution->mesh_light.shader_flag;
 
-      triangle_light_sample(kg, prim, object, randu, randv, time, ls, P);
+      triangle_light_sample(kg, prim, object, randu, randv, time, ls, P, triangle_pdf);
       ls->shader |= shader_flag;
       return (ls->pdf > 0.0f);
     }
@@ -1143,7 +1216,7 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
     return false;
   }
 
-  return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+  return lamp_light_sample(kg, lamp, randu, randv, P, lamp_pdf, ls);
 }
 
 ccl_device_inline int light_select_num_samples(KernelGlobals *kg, int index)
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Emitters are selected by traversing a binary tree over their bounds, choosing
+ * each child proportional to an importance estimate of the light it could
+ * contribute to the shading point. This follows "Importance Sampling of Many
+ * Lights with Adaptive Tree Splitting" by Conty Estevez and Kulla, without the
+ * splitting and without taking the shading normal into account, so that the
+ * probability of a light can be evaluated the same way when it is hit by a
+ * BSDF sample for multiple importance sampling. */
+
+ccl_device float light_tree_node_importance(const ccl_global KernelLightTreeNode *knode, float3 P)
+{
+  /* Distant lights are selected proportional to their energy only. */
+  if (knode->type == LIGHT_TREE_NODE_DISTANT) {
+    return knode->energy;
+  }
+
+  const float3 bounds_min = make_float3(
+      knode->bounds_min[0], knode->bounds_min[1], knode->bounds_min[2]);
+  const float3 bounds_max = make_float3(
+      knode->bounds_max[0], knode->bounds_max[1], knode->bounds_max[2]);
+  const float3 centroid = 0.5f * (bounds_min + bounds_max);
+  const float radius_squared = 0.25f * len_squared(bounds_max - bounds_min);
+
+  float distance;
+  const float3 D = safe_normalize_len(P - centroid, &distance);
+  const float distance_squared = distance * distance;
+
+  /* Clamp the distance to the size of the node, to avoid very high importance
+   * for shading points close to or inside the node. */
+  const float falloff = knode->energy / max(distance_squared, max(radius_squared, 1e-8f));
+
+  /* Inside the bounds, or for emitters facing all directions, the orientation
+   * does not give a useful bound. */
+  if (distance_squared <= radius_squared || knode->theta_o >= M_PI_F) {
+    return falloff;
+  }
+
+  /* Bound the angle between the emitter normals and the direction towards
+   * the shading point, over the whole node. */
+  const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+  const float theta = safe_acosf(dot(axis, D));
+  const float theta_u = safe_asinf(sqrtf(radius_squared) / distance);
+  const float theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+
+  if (theta_prime > knode->theta_e) {
+    return 0.0f;
+  }
+
+  return falloff * max(cosf(theta_prime), 0.0f);
+}
+
+/* Probability of descending into the first child of an inner node, or a
+ * negative value if neither child can contribute light at P. */
+ccl_device float light_tree_first_child_probability(KernelGlobals *kg, int node, float3 P)
+{
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node);
+  const ccl_global KernelLightTreeNode *kfirst = &kernel_tex_fetch(__light_tree_nodes, node + 1);
+  const ccl_global KernelLightTreeNode *ksecond = &kernel_tex_fetch(__light_tree_nodes,
+                                                                   knode->child);
+
+  /* Importance of local and distant lights is not comparable, so the root
+   * splits between both with a fixed probability. */
+  if (kfirst->type != ksecond->type) {
+    const float distant_pdf = kernel_data.integrator.light_tree_distant_pdf;
+    return (kfirst->type == LIGHT_TREE_NODE_DISTANT) ? distant_pdf : 1.0f - distant_pdf;
+  }
+
+  const float first_importance = light_tree_node_importance(kfirst, P);
+  const float second_importance = light_tree_node_importance(ksecond, P);
+  const float total_importance = first_importance + second_importance;
+
+  if (!(total_importance > 0.0f)) {
+    return -1.0f;
+  }
+
+  return first_importance / total_importance;
+}
+
+/* Select an emitter by traversing the tree from the root, returns the emitter
+ * index or -1 if no light can be selected. The random number is rescaled at
+ * every level so it can be reused to sample a point on the emitter. */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float *randu, float *pdf)
+{
+  int node = 0;
+  float r = *randu;
+  *pdf = 1.0f;
+
+  while (true) {
+    const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node);
+    if (knode->child < 0) {
+      *randu = r;
+      return ~knode->child;
+    }
+
+    const float first_probability = light_tree_first_child_probability(kg, node, P);
+    if (first_probability < 0.0f) {
+      return -1;
+    }
+
+    if (r < first_probability) {
+      r = r / first_probability;
+      *pdf *= first_probability;
+      node = node + 1;
+    }
+    else {
+      r = (r - first_probability) / (1.0f - first_probability);
+      *pdf *= 1.0f - first_probability;
+      node = knode->child;
+    }
+
+    /* Guard against the random number leaving the unit interval due to float
+     * rounding, which would bias the selection in the next level. */
+    r = min(r, 1.0f - FLT_EPSILON);
+  }
+}
+
+/* Probability of selecting an emitter with light_tree_sample, by walking from
+ * its leaf up to the root. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, int emitter, float3 P)
+{
+  const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                       emitter);
+  int node = kemitter->node;
+  if (node < 0) {
+    return 0.0f;
+  }
+
+  float pdf = 1.0f;
+  int parent = kernel_tex_fetch(__light_tree_nodes, node).parent;
+
+  while (parent >= 0) {
+    const float first_probability = light_tree_first_child_probability(kg, parent, P);
+    if (first_probability < 0.0f) {
+      return 0.0f;
+    }
+
+    pdf *= (node == parent + 1) ? first_probability : 1.0f - first_probability;
+
+    node = parent;
+    parent = kernel_tex_fetch(__light_tree_nodes, node).parent;
+  }
+
+  return pdf;
+}
+
+CCL_NAMESPACE_END
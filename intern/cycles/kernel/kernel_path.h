@@ -30,6 +30,7 @@
 #include "kernel/kernel_write_passes.h"
 #include "kernel/kernel_accumulate.h"
 #include "kernel/kernel_shader.h"
+#include "kernel/kernel_light_tree.h"
 #include "kernel/kernel_light.h"
 #include "kernel/kernel_adaptive_sampling.h"
 #include "kernel/kernel_passes.h"
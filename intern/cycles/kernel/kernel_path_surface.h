@@ -34,6 +34,12 @@ ccl_device_noinline_cpu void kernel_branched_path_surface_connect_light(
   /* sample illumination from lights to find path contribution */
   BsdfEval L_light ccl_optional_struct_init;
 
+  /* The light tree selects a single light based on the shading point, it can
+   * not be combined with sampling every lamp separately. */
+  if (kernel_data.integrator.use_light_tree) {
+    sample_all_lights = false;
+  }
+
   int num_lights = 0;
   if (kernel_data.integrator.use_direct_light) {
     if (sample_all_lights) {
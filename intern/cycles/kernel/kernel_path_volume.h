@@ -141,6 +141,12 @@ ccl_device void kernel_branched_path_volume_connect_light(KernelGlobals *kg,
 #    ifdef __EMISSION__
   BsdfEval L_light ccl_optional_struct_init;
 
+  /* The light tree selects a single light based on the shading point, it can
+   * not be combined with sampling every lamp separately. */
+  if (kernel_data.integrator.use_light_tree) {
+    sample_all_lights = false;
+  }
+
   int num_lights = 1;
   if (sample_all_lights) {
     num_lights = kernel_data.integrator.num_all_lights;
@@ -614,6 +614,13 @@ typedef enum LightType {
   LIGHT_TRIANGLE
 } LightType;
 
+/* Light Tree Node Type */
+
+typedef enum LightTreeNodeType {
+  LIGHT_TREE_NODE_LOCAL,
+  LIGHT_TREE_NODE_DISTANT,
+} LightTreeNodeType;
+
 /* Camera Type */
 
 enum CameraType { CAMERA_PERSPECTIVE, CAMERA_ORTHOGRAPHIC, CAMERA_PANORAMA };
@@ -1298,6 +1305,12 @@ typedef struct KernelIntegrator {
   int pdf_background_res_y;
   float light_inv_rr_threshold;
 
+  /* light tree */
+  int use_light_tree;
+  int light_tree_lamp_offset;
+  int light_tree_background_lamp;
+  float light_tree_distant_pdf;
+
   /* light portals */
   float portal_pdf;
   int num_portals;
@@ -1531,6 +1544,34 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Light tree node. Inner nodes have their first child stored right after them
+ * and the index of the second child in child, leaves store ~emitter instead.
+ * Orientation is bounded by a cone around axis, with theta_o the spread of
+ * the emitter normals and theta_e the spread of emission around the normals. */
+typedef struct KernelLightTreeNode {
+  float bounds_min[3];
+  float energy;
+  float bounds_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  int child;
+  int parent;
+  int type;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+/* Object or lamp which the light tree selects, as a range of entries in the
+ * light distribution which is sampled proportional to area within the range. */
+typedef struct KernelLightTreeEmitter {
+  int distribution_offset;
+  int num_distribution;
+  int node;
+  float area;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -40,6 +40,7 @@
 
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
+#include "util/util_mapped_memory.h"
 #include "util/util_progress.h"
 
 CCL_NAMESPACE_BEGIN
@@ -265,6 +266,8 @@ GeometryManager::GeometryManager()
 {
   need_update = true;
   need_flags_update = true;
+  need_update_bvh = false;
+  resident_geometry_size = 0;
 }
 
 GeometryManager::~GeometryManager()
@@ -843,6 +846,38 @@ void GeometryManager::mesh_calc_offset(Scene *scene)
   }
 }
 
+void GeometryManager::assign_geometry_memory(Scene *scene,
+                                             device_memory &mem,
+                                             size_t num_elements)
+{
+  /* Arrays stay in memory as long as they fit in the budget, in the order they
+   * are allocated. The remaining ones are mapped from a scratch file, so huge
+   * scenes render slower rather than running out of memory. */
+  const size_t budget = scene->params.geometry_memory_budget;
+  const size_t size = num_elements * mem.data_elements * datatype_size(mem.data_type);
+
+  /* Allocating an array again replaces its previous size. */
+  release_geometry_memory(mem);
+
+  if (budget == 0 || resident_geometry_size + size <= budget) {
+    resident_geometry[&mem] = size;
+    resident_geometry_size += size;
+    mem.out_of_core = false;
+  }
+  else {
+    mem.out_of_core = true;
+  }
+}
+
+void GeometryManager::release_geometry_memory(device_memory &mem)
+{
+  map<device_memory *, size_t>::iterator it = resident_geometry.find(&mem);
+  if (it != resident_geometry.end()) {
+    resident_geometry_size -= it->second;
+    resident_geometry.erase(it);
+  }
+}
+
 void GeometryManager::device_update_mesh(
     Device *, DeviceScene *dscene, Scene *scene, bool for_displacement, Progress &progress)
 {
@@ -911,10 +946,15 @@ void GeometryManager::device_update_mesh(
     /* normals */
     progress.set_status("Updating Mesh", "Computing normals");
 
+    assign_geometry_memory(scene, dscene->tri_shader, tri_size);
     uint *tri_shader = dscene->tri_shader.alloc(tri_size);
+    assign_geometry_memory(scene, dscene->tri_vnormal, vert_size);
     float4 *vnormal = dscene->tri_vnormal.alloc(vert_size);
+    assign_geometry_memory(scene, dscene->tri_vindex, tri_size);
     uint4 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
+    assign_geometry_memory(scene, dscene->tri_patch, tri_size);
     uint *tri_patch = dscene->tri_patch.alloc(tri_size);
+    assign_geometry_memory(scene, dscene->tri_patch_uv, vert_size);
     float2 *tri_patch_uv = dscene->tri_patch_uv.alloc(vert_size);
 
     foreach (Geometry *geom, scene->geometry) {
@@ -946,7 +986,9 @@ void GeometryManager::device_update_mesh(
   if (curve_size != 0) {
     progress.set_status("Updating Mesh", "Copying Strands to device");
 
+    assign_geometry_memory(scene, dscene->curve_keys, curve_key_size);
     float4 *curve_keys = dscene->curve_keys.alloc(curve_key_size);
+    assign_geometry_memory(scene, dscene->curves, curve_size);
     float4 *curves = dscene->curves.alloc(curve_size);
 
     foreach (Geometry *geom, scene->geometry) {
@@ -968,6 +1010,7 @@ void GeometryManager::device_update_mesh(
   if (patch_size != 0) {
     progress.set_status("Updating Mesh", "Copying Patches to device");
 
+    assign_geometry_memory(scene, dscene->patches, patch_size);
     uint *patch_data = dscene->patches.alloc(patch_size);
 
     foreach (Geometry *geom, scene->geometry) {
@@ -992,6 +1035,7 @@ void GeometryManager::device_update_mesh(
   }
 
   if (for_displacement) {
+    assign_geometry_memory(scene, dscene->prim_tri_verts, tri_size * 3);
     float4 *prim_tri_verts = dscene->prim_tri_verts.alloc(tri_size * 3);
     foreach (Geometry *geom, scene->geometry) {
       if (geom->type == Geometry::MESH) {
@@ -1061,42 +1105,52 @@ void GeometryManager::device_update_bvh(Device *device,
   PackedBVH &pack = bvh->pack;
 
   if (pack.nodes.size()) {
+    assign_geometry_memory(scene, dscene->bvh_nodes, pack.nodes.size());
     dscene->bvh_nodes.steal_data(pack.nodes);
     dscene->bvh_nodes.copy_to_device();
   }
   if (pack.leaf_nodes.size()) {
+    assign_geometry_memory(scene, dscene->bvh_leaf_nodes, pack.leaf_nodes.size());
     dscene->bvh_leaf_nodes.steal_data(pack.leaf_nodes);
     dscene->bvh_leaf_nodes.copy_to_device();
   }
   if (pack.object_node.size()) {
+    assign_geometry_memory(scene, dscene->object_node, pack.object_node.size());
     dscene->object_node.steal_data(pack.object_node);
     dscene->object_node.copy_to_device();
   }
   if (pack.prim_tri_index.size()) {
+    assign_geometry_memory(scene, dscene->prim_tri_index, pack.prim_tri_index.size());
     dscene->prim_tri_index.steal_data(pack.prim_tri_index);
     dscene->prim_tri_index.copy_to_device();
   }
   if (pack.prim_tri_verts.size()) {
+    assign_geometry_memory(scene, dscene->prim_tri_verts, pack.prim_tri_verts.size());
     dscene->prim_tri_verts.steal_data(pack.prim_tri_verts);
     dscene->prim_tri_verts.copy_to_device();
   }
   if (pack.prim_type.size()) {
+    assign_geometry_memory(scene, dscene->prim_type, pack.prim_type.size());
     dscene->prim_type.steal_data(pack.prim_type);
     dscene->prim_type.copy_to_device();
   }
   if (pack.prim_visibility.size()) {
+    assign_geometry_memory(scene, dscene->prim_visibility, pack.prim_visibility.size());
     dscene->prim_visibility.steal_data(pack.prim_visibility);
     dscene->prim_visibility.copy_to_device();
   }
   if (pack.prim_index.size()) {
+    assign_geometry_memory(scene, dscene->prim_index, pack.prim_index.size());
     dscene->prim_index.steal_data(pack.prim_index);
     dscene->prim_index.copy_to_device();
   }
   if (pack.prim_object.size()) {
+    assign_geometry_memory(scene, dscene->prim_object, pack.prim_object.size());
     dscene->prim_object.steal_data(pack.prim_object);
     dscene->prim_object.copy_to_device();
   }
   if (pack.prim_time.size()) {
+    assign_geometry_memory(scene, dscene->prim_time, pack.prim_time.size());
     dscene->prim_time.steal_data(pack.prim_time);
     dscene->prim_time.copy_to_device();
   }
@@ -1110,6 +1164,47 @@ void GeometryManager::device_update_bvh(Device *device,
   delete bvh;
 }
 
+void GeometryManager::device_update_top_level_bvh(Device *device,
+                                                  DeviceScene *dscene,
+                                                  Scene *scene,
+                                                  Progress &progress)
+{
+  /* Geometry data and bottom level BVHs are still valid on the device, only
+   * re-pack the top level BVH over the new object transforms. */
+  VLOG(1) << "Rebuilding top level BVH only.";
+
+  device_free_bvh(dscene);
+
+  Scene::MotionType need_motion = scene->need_motion();
+  bool motion_blur = need_motion == Scene::MOTION_BLUR;
+
+  bool has_flattened_geometry = false;
+  foreach (Object *object, scene->objects) {
+    object->compute_bounds(motion_blur);
+    if (!object->geometry->is_instanced()) {
+      has_flattened_geometry = true;
+    }
+  }
+
+  if (progress.get_cancel())
+    return;
+
+  device_update_bvh(device, dscene, scene, progress);
+  if (progress.get_cancel())
+    return;
+
+  /* Primitives which are part of the top level BVH get re-ordered by the
+   * build, so the triangle to packed vertices mapping has to be updated. */
+  if (has_flattened_geometry) {
+    device_update_mesh(device, dscene, scene, false, progress);
+    if (progress.get_cancel())
+      return;
+  }
+
+  /* Object data was re-created by the object manager. */
+  scene->object_manager->device_update_mesh_offsets(device, dscene, scene);
+}
+
 void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Progress &progress)
 {
   if (!need_update && !need_flags_update) {
@@ -1224,8 +1319,14 @@ void GeometryManager::device_update(Device *device,
                                     Scene *scene,
                                     Progress &progress)
 {
-  if (!need_update)
+  if (!need_update) {
+    if (need_update_bvh) {
+      device_update_top_level_bvh(device, dscene, scene, progress);
+      if (!progress.get_cancel())
+        need_update_bvh = false;
+    }
     return;
+  }
 
   VLOG(1) << "Total " << scene->geometry.size() << " meshes.";
 
@@ -1389,6 +1490,8 @@ void GeometryManager::device_update(Device *device,
   if (progress.get_cancel())
     return;
 
+  /* BVH arrays are assigned memory before the mesh arrays, since traversal accesses them most.
+   * Arrays of the displacement pass are accounted for until they are allocated again. */
   device_update_bvh(device, dscene, scene, progress);
   if (progress.get_cancel())
     return;
@@ -1397,7 +1500,13 @@ void GeometryManager::device_update(Device *device,
   if (progress.get_cancel())
     return;
 
+  if (scene->params.geometry_memory_budget) {
+    VLOG(1) << "Geometry kept in memory: " << string_human_readable_size(resident_geometry_size)
+            << ", mapped out of core: " << string_human_readable_size(util_mapped_memory_size());
+  }
+
   need_update = false;
+  need_update_bvh = false;
 
   if (true_displacement_used) {
     /* Re-tag flags for update, so they're re-evaluated
@@ -1410,8 +1519,19 @@ void GeometryManager::device_update(Device *device,
   }
 }
 
-void GeometryManager::device_free(Device *device, DeviceScene *dscene)
+void GeometryManager::device_free_bvh(DeviceScene *dscene)
 {
+  release_geometry_memory(dscene->bvh_nodes);
+  release_geometry_memory(dscene->bvh_leaf_nodes);
+  release_geometry_memory(dscene->object_node);
+  release_geometry_memory(dscene->prim_tri_verts);
+  release_geometry_memory(dscene->prim_tri_index);
+  release_geometry_memory(dscene->prim_type);
+  release_geometry_memory(dscene->prim_visibility);
+  release_geometry_memory(dscene->prim_index);
+  release_geometry_memory(dscene->prim_object);
+  release_geometry_memory(dscene->prim_time);
+
   dscene->bvh_nodes.free();
   dscene->bvh_leaf_nodes.free();
   dscene->object_node.free();
@@ -1422,6 +1542,14 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene)
   dscene->prim_index.free();
   dscene->prim_object.free();
   dscene->prim_time.free();
+}
+
+void GeometryManager::device_free(Device *device, DeviceScene *dscene)
+{
+  device_free_bvh(dscene);
+  resident_geometry.clear();
+  resident_geometry_size = 0;
+
   dscene->tri_shader.free();
   dscene->tri_vnormal.free();
   dscene->tri_vindex.free();
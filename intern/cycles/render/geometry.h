@@ -24,6 +24,7 @@
 #include "render/attribute.h"
 
 #include "util/util_boundbox.h"
+#include "util/util_map.h"
 #include "util/util_transform.h"
 #include "util/util_set.h"
 #include "util/util_types.h"
@@ -34,6 +35,7 @@ CCL_NAMESPACE_BEGIN
 class BVH;
 class Device;
 class DeviceScene;
+class device_memory;
 class Mesh;
 class Progress;
 class RenderStats;
@@ -147,6 +149,15 @@ class GeometryManager {
   /* Update Flags */
   bool need_update;
   bool need_flags_update;
+  /* Only object transforms of instanced geometry changed, so only the top
+   * level BVH needs to be rebuilt. */
+  bool need_update_bvh;
+
+  /* Geometry arrays kept in memory and their size, used to map arrays out of
+   * core once the geometry memory budget is exceeded. Arrays stay accounted
+   * for until they are freed, also across top level BVH updates. */
+  map<device_memory *, size_t> resident_geometry;
+  size_t resident_geometry_size;
 
   /* Constructor/Destructor */
   GeometryManager();
@@ -195,6 +206,17 @@ class GeometryManager {
 
   void device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
 
+  void device_update_top_level_bvh(Device *device,
+                                   DeviceScene *dscene,
+                                   Scene *scene,
+                                   Progress &progress);
+
+  void device_free_bvh(DeviceScene *dscene);
+
+  /* Decide whether a geometry array is kept in memory or mapped out of core. */
+  void assign_geometry_memory(Scene *scene, device_memory &mem, size_t num_elements);
+  void release_geometry_memory(device_memory &mem);
+
   void device_update_displacement_images(Device *device, Scene *scene, Progress &progress);
 
   void device_update_volume_images(Device *device, Scene *scene, Progress &progress);
@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/light.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -257,6 +258,67 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Rough estimate of the power emitted per unit area by a shader, used to guide
+ * the light tree. Emission driven by textures or other nodes is assumed to be
+ * of unit strength. */
+static float light_tree_shader_emission(Shader *shader, map<Shader *, float> &shader_emission)
+{
+  map<Shader *, float>::iterator it = shader_emission.find(shader);
+  if (it != shader_emission.end()) {
+    return it->second;
+  }
+
+  float3 emission;
+  float estimate = 1.0f;
+  if (shader->is_constant_emission(&emission)) {
+    estimate = max(average(emission), 0.0f);
+  }
+
+  /* Mesh lights emit from both sides. */
+  estimate *= 2.0f;
+
+  shader_emission[shader] = estimate;
+  return estimate;
+}
+
+static LightTreePrimitive light_tree_lamp_primitive(Light *light, int emitter)
+{
+  LightTreePrimitive prim;
+  prim.emitter = emitter;
+  prim.energy = max(average(light->strength), 0.0f);
+
+  switch (light->type) {
+    case LIGHT_DISTANT:
+    case LIGHT_BACKGROUND:
+      /* Distant lights are selected uniformly among each other. */
+      prim.is_distant = true;
+      prim.energy = 1.0f;
+      break;
+    case LIGHT_POINT:
+    case LIGHT_SPOT: {
+      const float3 extent = make_float3(light->size, light->size, light->size);
+      prim.bounds = BoundBox(light->co - extent, light->co + extent);
+      if (light->type == LIGHT_SPOT) {
+        prim.cone = LightTreeCone(safe_normalize(light->dir), 0.0f, light->spot_angle * 0.5f);
+      }
+      break;
+    }
+    case LIGHT_AREA: {
+      const float3 axisu = light->axisu * (light->sizeu * light->size);
+      const float3 axisv = light->axisv * (light->sizev * light->size);
+      const float3 extent = 0.5f * (fabs(axisu) + fabs(axisv));
+      prim.bounds = BoundBox(light->co - extent, light->co + extent);
+      prim.cone = LightTreeCone(safe_normalize(light->dir), 0.0f, M_PI_2_F);
+      prim.energy *= M_PI_4_F;
+      break;
+    }
+    default:
+      break;
+  }
+
+  return prim;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -311,6 +373,25 @@ void LightManager::device_update_distribution(Device *,
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
 
+  /* Light tree emitters, one slot per object followed by one per enabled light,
+   * so the kernel can find the emitter of a light it hit directly. */
+  const bool use_light_tree = scene->integrator->use_light_tree && num_distribution > 0;
+  const size_t num_objects = scene->objects.size();
+  KernelLightTreeEmitter *emitters = NULL;
+  vector<LightTreePrimitive> tree_primitives;
+  map<Shader *, float> shader_emission;
+  int background_light_index = -1;
+
+  if (use_light_tree) {
+    emitters = dscene->light_tree_emitters.alloc(num_objects + num_lights);
+    for (size_t i = 0; i < num_objects + num_lights; i++) {
+      emitters[i].distribution_offset = 0;
+      emitters[i].num_distribution = 0;
+      emitters[i].node = -1;
+      emitters[i].area = 0.0f;
+    }
+  }
+
   /* triangles */
   size_t offset = 0;
   int j = 0;
@@ -347,6 +428,11 @@ void LightManager::device_update_distribution(Device *,
       use_light_visibility = true;
     }
 
+    const size_t object_offset = offset;
+    const float object_totarea = totarea;
+    BoundBox object_bounds = BoundBox::empty;
+    float object_energy = 0.0f;
+
     size_t mesh_num_triangles = mesh->num_triangles();
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->shader[i];
@@ -375,10 +461,30 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          object_bounds.grow(p1);
+          object_bounds.grow(p2);
+          object_bounds.grow(p3);
+          object_energy += area * light_tree_shader_emission(shader, shader_emission);
+        }
       }
     }
 
+    if (use_light_tree && offset > object_offset && object_bounds.valid()) {
+      emitters[j].distribution_offset = object_offset;
+      emitters[j].num_distribution = offset - object_offset;
+      emitters[j].area = totarea - object_totarea;
+
+      LightTreePrimitive prim;
+      prim.emitter = j;
+      prim.bounds = object_bounds;
+      prim.energy = object_energy;
+      tree_primitives.push_back(prim);
+    }
+
     j++;
   }
 
@@ -399,6 +505,17 @@ void LightManager::device_update_distribution(Device *,
     distribution[offset].lamp.size = light->size;
     totarea += lightarea;
 
+    if (use_light_tree) {
+      const int emitter = num_objects + light_index;
+      emitters[emitter].distribution_offset = offset;
+      emitters[emitter].num_distribution = 1;
+      tree_primitives.push_back(light_tree_lamp_primitive(light, emitter));
+
+      if (light->type == LIGHT_BACKGROUND) {
+        background_light_index = light_index;
+      }
+    }
+
     if (light->type == LIGHT_DISTANT) {
       use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
     }
@@ -475,6 +592,23 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    if (use_light_tree) {
+      device_update_light_tree(dscene, tree_primitives);
+
+      kintegrator->light_tree_lamp_offset = num_objects;
+      kintegrator->light_tree_background_lamp = background_light_index;
+    }
+    else {
+      dscene->light_tree_nodes.free();
+      dscene->light_tree_emitters.free();
+
+      kintegrator->use_light_tree = false;
+      kintegrator->light_tree_lamp_offset = 0;
+      kintegrator->light_tree_background_lamp = -1;
+      kintegrator->light_tree_distant_pdf = 0.0f;
+    }
+
     /* Portals */
     if (num_portals > 0) {
       kintegrator->portal_offset = light_index;
@@ -489,6 +623,8 @@ void LightManager::device_update_distribution(Device *,
   }
   else {
     dscene->light_distribution.free();
+    dscene->light_tree_nodes.free();
+    dscene->light_tree_emitters.free();
 
     kintegrator->num_distribution = 0;
     kintegrator->num_all_lights = 0;
@@ -498,11 +634,56 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->num_portals = 0;
     kintegrator->portal_offset = 0;
     kintegrator->portal_pdf = 0.0f;
+    kintegrator->use_light_tree = false;
+    kintegrator->light_tree_lamp_offset = 0;
+    kintegrator->light_tree_background_lamp = -1;
+    kintegrator->light_tree_distant_pdf = 0.0f;
 
     kfilm->pass_shadow_scale = 1.0f;
   }
 }
 
+void LightManager::device_update_light_tree(DeviceScene *dscene,
+                                            const vector<LightTreePrimitive> &primitives)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+
+  size_t num_distant = 0;
+  foreach (const LightTreePrimitive &prim, primitives) {
+    if (prim.is_distant) {
+      num_distant++;
+    }
+  }
+
+  /* Without any emitter that can be selected, fall back to the distribution. */
+  LightTree tree(primitives);
+  if (tree.num_nodes() == 0) {
+    dscene->light_tree_nodes.free();
+    dscene->light_tree_emitters.free();
+
+    kintegrator->use_light_tree = false;
+    kintegrator->light_tree_distant_pdf = 0.0f;
+    return;
+  }
+
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(tree.num_nodes());
+  tree.pack(knodes, dscene->light_tree_emitters.data());
+
+  /* Distant lights and the background share one branch of the root, chosen
+   * so that every distant light is as likely as all local lights together. */
+  const size_t num_local = primitives.size() - num_distant;
+  kintegrator->use_light_tree = true;
+  kintegrator->light_tree_distant_pdf = (num_local > 0 && num_distant > 0) ?
+                                            (float)num_distant / (float)(num_distant + 1) :
+                                            0.0f;
+
+  VLOG(1) << "Light tree built with " << tree.num_nodes() << " nodes for " << primitives.size()
+          << " emitters.";
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+}
+
 static void background_cdf(
     int start, int end, int res_x, int res_y, const vector<float3> *pixels, float2 *cond_cdf)
 {
@@ -934,6 +1115,8 @@ void LightManager::device_update(Device *device,
 void LightManager::device_free(Device *, DeviceScene *dscene)
 {
   dscene->light_distribution.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
   dscene->lights.free();
   dscene->light_background_marginal_cdf.free();
   dscene->light_background_conditional_cdf.free();
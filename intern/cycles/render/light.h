@@ -34,6 +34,7 @@ class Object;
 class Progress;
 class Scene;
 class Shader;
+struct LightTreePrimitive;
 
 class Light : public Node {
  public:
@@ -116,6 +117,7 @@ class LightManager {
                                   DeviceScene *dscene,
                                   Scene *scene,
                                   Progress &progress);
+  void device_update_light_tree(DeviceScene *dscene, const vector<LightTreePrimitive> &primitives);
   void device_update_background(Device *device,
                                 DeviceScene *dscene,
                                 Scene *scene,
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Smallest cone containing both cones, see "Importance Sampling of Many Lights
+ * with Adaptive Tree Splitting", Algorithm 1. */
+LightTreeCone LightTreeCone::merge(const LightTreeCone &cone_a, const LightTreeCone &cone_b)
+{
+  const LightTreeCone *a = &cone_a, *b = &cone_b;
+  if (b->theta_o > a->theta_o) {
+    swap(a, b);
+  }
+
+  const float theta_e = max(a->theta_e, b->theta_e);
+  const float theta_d = safe_acosf(dot(a->axis, b->axis));
+
+  if (min(theta_d + b->theta_o, M_PI_F) <= a->theta_o) {
+    return LightTreeCone(a->axis, a->theta_o, theta_e);
+  }
+
+  const float theta_o = 0.5f * (a->theta_o + theta_d + b->theta_o);
+  if (theta_o >= M_PI_F) {
+    return LightTreeCone(a->axis, M_PI_F, theta_e);
+  }
+
+  /* Rotate the axis of the wider cone towards the other one. For opposite
+   * axes there is no unique rotation, fall back to a cone facing everywhere. */
+  const float3 rotation_axis = cross(a->axis, b->axis);
+  if (len_squared(rotation_axis) < 1e-12f) {
+    return LightTreeCone(a->axis, M_PI_F, theta_e);
+  }
+
+  const float theta_r = theta_o - a->theta_o;
+  const float3 axis = rotate_around_axis(a->axis, normalize(rotation_axis), theta_r);
+  return LightTreeCone(normalize(axis), theta_o, theta_e);
+}
+
+LightTree::LightTree(const vector<LightTreePrimitive> &primitives_) : primitives(primitives_)
+{
+  if (primitives.empty()) {
+    return;
+  }
+
+  /* Importance of local and distant lights is not comparable, so they are
+   * built into separate sub-trees below the root. */
+  const vector<LightTreePrimitive>::iterator distant_begin = std::stable_partition(
+      primitives.begin(), primitives.end(), [](const LightTreePrimitive &prim) {
+        return !prim.is_distant;
+      });
+  const int num_local = distant_begin - primitives.begin();
+  const int num_primitives = primitives.size();
+
+  if (num_local == 0 || num_local == num_primitives) {
+    build_recursive(0, num_primitives, -1);
+    return;
+  }
+
+  nodes.push_back(Node());
+  build_recursive(0, num_local, 0);
+  const int distant_root = build_recursive(num_local, num_primitives, 0);
+
+  Node &root = nodes[0];
+  root.bounds = nodes[1].bounds;
+  root.cone = LightTreeCone();
+  root.energy = nodes[1].energy + nodes[distant_root].energy;
+  root.is_distant = false;
+  root.child = distant_root;
+  root.parent = -1;
+  root.primitive = -1;
+}
+
+int LightTree::build_recursive(int begin, int end, int parent)
+{
+  const int index = nodes.size();
+  nodes.push_back(Node());
+  nodes[index].parent = parent;
+
+  if (end - begin == 1) {
+    const LightTreePrimitive &prim = primitives[begin];
+    Node &node = nodes[index];
+    node.bounds = prim.bounds;
+    node.cone = prim.cone;
+    node.energy = prim.energy;
+    node.is_distant = prim.is_distant;
+    node.child = -1;
+    node.primitive = begin;
+    return index;
+  }
+
+  /* Median split along the largest axis of the primitive centroids. */
+  BoundBox centroid_bounds = BoundBox::empty;
+  for (int i = begin; i < end; i++) {
+    centroid_bounds.grow(primitives[i].bounds.center());
+  }
+
+  const float3 extent = centroid_bounds.size();
+  int axis = 0;
+  if (extent.y > extent.x) {
+    axis = 1;
+  }
+  if (extent.z > extent[axis]) {
+    axis = 2;
+  }
+
+  const int mid = (begin + end) / 2;
+  std::nth_element(primitives.begin() + begin,
+                   primitives.begin() + mid,
+                   primitives.begin() + end,
+                   [axis](const LightTreePrimitive &a, const LightTreePrimitive &b) {
+                     return a.bounds.center()[axis] < b.bounds.center()[axis];
+                   });
+
+  const int first = build_recursive(begin, mid, index);
+  const int second = build_recursive(mid, end, index);
+
+  /* Node array may have been reallocated by the children. */
+  Node &node = nodes[index];
+  node.bounds = nodes[first].bounds;
+  node.bounds.grow(nodes[second].bounds);
+  node.cone = LightTreeCone::merge(nodes[first].cone, nodes[second].cone);
+  node.energy = nodes[first].energy + nodes[second].energy;
+  node.is_distant = nodes[first].is_distant;
+  node.child = second;
+  node.primitive = -1;
+  return index;
+}
+
+void LightTree::pack(KernelLightTreeNode *knodes, KernelLightTreeEmitter *kemitters) const
+{
+  for (size_t i = 0; i < nodes.size(); i++) {
+    const Node &node = nodes[i];
+    KernelLightTreeNode &knode = knodes[i];
+
+    const BoundBox bounds = (node.bounds.valid()) ? node.bounds :
+                                                    BoundBox(make_float3(0.0f, 0.0f, 0.0f));
+    knode.bounds_min[0] = bounds.min.x;
+    knode.bounds_min[1] = bounds.min.y;
+    knode.bounds_min[2] = bounds.min.z;
+    knode.bounds_max[0] = bounds.max.x;
+    knode.bounds_max[1] = bounds.max.y;
+    knode.bounds_max[2] = bounds.max.z;
+    knode.energy = node.energy;
+
+    knode.axis[0] = node.cone.axis.x;
+    knode.axis[1] = node.cone.axis.y;
+    knode.axis[2] = node.cone.axis.z;
+    knode.theta_o = node.cone.theta_o;
+    knode.theta_e = node.cone.theta_e;
+
+    knode.parent = node.parent;
+    knode.type = (node.is_distant) ? LIGHT_TREE_NODE_DISTANT : LIGHT_TREE_NODE_LOCAL;
+    knode.pad = 0;
+
+    if (node.primitive != -1) {
+      const int emitter = primitives[node.primitive].emitter;
+      knode.child = ~emitter;
+      kemitters[emitter].node = i;
+    }
+    else {
+      knode.child = node.child;
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bound on the normals of the emitters in a node: all normals are within
+ * theta_o of the axis, and light is emitted within theta_e of a normal. */
+struct LightTreeCone {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  LightTreeCone() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(M_PI_F), theta_e(M_PI_2_F)
+  {
+  }
+
+  LightTreeCone(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  static LightTreeCone merge(const LightTreeCone &a, const LightTreeCone &b);
+};
+
+/* Emitter to be inserted in the light tree, an emissive object or a lamp. */
+struct LightTreePrimitive {
+  /* Index into the kernel emitter array. */
+  int emitter;
+  BoundBox bounds;
+  LightTreeCone cone;
+  float energy;
+  bool is_distant;
+
+  LightTreePrimitive() : emitter(-1), bounds(BoundBox::empty), energy(0.0f), is_distant(false)
+  {
+  }
+};
+
+class LightTree {
+ public:
+  explicit LightTree(const vector<LightTreePrimitive> &primitives);
+
+  size_t num_nodes() const
+  {
+    return nodes.size();
+  }
+
+  /* Write the nodes to the kernel array, and the leaf node of every primitive
+   * to the emitter array. */
+  void pack(KernelLightTreeNode *knodes, KernelLightTreeEmitter *kemitters) const;
+
+ protected:
+  struct Node {
+    BoundBox bounds;
+    LightTreeCone cone;
+    float energy;
+    bool is_distant;
+    /* Index of the second child for inner nodes, the first child directly
+     * follows its parent. */
+    int child;
+    int parent;
+    /* Index into primitives for leaf nodes, -1 for inner nodes. */
+    int primitive;
+  };
+
+  int build_recursive(int begin, int end, int parent);
+
+  vector<LightTreePrimitive> primitives;
+  vector<Node> nodes;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -205,9 +205,16 @@ void Object::apply_transform(bool apply_to_motion)
 
 void Object::tag_update(Scene *scene)
 {
+  /* When the transform is not baked into the geometry, only the top level BVH
+   * depends on the object, geometry arrays and bottom level BVH stay valid.
+   * OSL keeps per object attribute maps, those require a full update. */
+  bool need_full_geometry_update = true;
+
   if (geometry) {
     if (geometry->transform_applied)
       geometry->need_update = true;
+    else if (!scene->shader_manager->use_osl())
+      need_full_geometry_update = false;
 
     foreach (Shader *shader, geometry->used_shaders) {
       if (shader->use_mis && shader->has_surface_emission)
@@ -217,7 +224,10 @@ void Object::tag_update(Scene *scene)
 
   scene->camera->need_flags_update = true;
   scene->curve_system_manager->need_update = true;
-  scene->geometry_manager->need_update = true;
+  if (need_full_geometry_update)
+    scene->geometry_manager->need_update = true;
+  else
+    scene->geometry_manager->need_update_bvh = true;
   scene->object_manager->need_update = true;
 }
 
@@ -604,7 +614,7 @@ void ObjectManager::device_update(Device *device,
 
   /* prepare for static BVH building */
   /* todo: do before to support getting object level coords? */
-  if (scene->params.bvh_type == SceneParams::BVH_STATIC) {
+  if (scene->params.bvh_type == SceneParams::BVH_STATIC && !scene->params.use_bvh_instancing) {
     progress.set_status("Updating Objects", "Applying Static Transformations");
     apply_static_transforms(dscene, scene, progress);
   }
@@ -70,6 +70,8 @@ DeviceScene::DeviceScene(Device *device)
       attributes_float3(device, "__attributes_float3", MEM_TEXTURE),
       attributes_uchar4(device, "__attributes_uchar4", MEM_TEXTURE),
       light_distribution(device, "__light_distribution", MEM_TEXTURE),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_TEXTURE),
+      light_tree_emitters(device, "__light_tree_emitters", MEM_TEXTURE),
       lights(device, "__lights", MEM_TEXTURE),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_TEXTURE),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_TEXTURE),
@@ -356,10 +358,10 @@ bool Scene::need_update()
 bool Scene::need_data_update()
 {
   return (background->need_update || image_manager->need_update || object_manager->need_update ||
-          geometry_manager->need_update || light_manager->need_update ||
-          lookup_tables->need_update || integrator->need_update || shader_manager->need_update ||
-          particle_system_manager->need_update || curve_system_manager->need_update ||
-          bake_manager->need_update || film->need_update);
+          geometry_manager->need_update || geometry_manager->need_update_bvh ||
+          light_manager->need_update || lookup_tables->need_update || integrator->need_update ||
+          shader_manager->need_update || particle_system_manager->need_update ||
+          curve_system_manager->need_update || bake_manager->need_update || film->need_update);
 }
 
 bool Scene::need_reset()
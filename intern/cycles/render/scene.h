@@ -104,6 +104,8 @@ class DeviceScene {
 
   /* lights */
   device_vector<KernelLightDistribution> light_distribution;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
@@ -164,11 +166,20 @@ class SceneParams {
   BVHLayout bvh_layout;
 
   BVHType bvh_type;
+  /* Always build a separate bottom level BVH for every geometry, and only a
+   * top level BVH over object instances, even for static BVH. Object
+   * transforms are then never applied to geometry, so changing them only
+   * requires rebuilding the top level BVH.
+   */
+  bool use_bvh_instancing;
   bool use_bvh_spatial_split;
   bool use_bvh_unaligned_nodes;
   int num_bvh_time_steps;
   bool persistent_data;
   int texture_limit;
+  /* Geometry and BVH arrays beyond this many bytes are mapped from a scratch
+   * file rather than kept in memory, zero keeps everything in memory. */
+  size_t geometry_memory_budget;
 
   bool background;
 
@@ -177,22 +188,25 @@ class SceneParams {
     shadingsystem = SHADINGSYSTEM_SVM;
     bvh_layout = BVH_LAYOUT_BVH2;
     bvh_type = BVH_DYNAMIC;
+    use_bvh_instancing = false;
     use_bvh_spatial_split = false;
     use_bvh_unaligned_nodes = true;
     num_bvh_time_steps = 0;
     persistent_data = false;
     texture_limit = 0;
+    geometry_memory_budget = 0;
     background = true;
   }
 
   bool modified(const SceneParams &params)
   {
     return !(shadingsystem == params.shadingsystem && bvh_layout == params.bvh_layout &&
-             bvh_type == params.bvh_type &&
+             bvh_type == params.bvh_type && use_bvh_instancing == params.use_bvh_instancing &&
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             geometry_memory_budget == params.geometry_memory_budget);
   }
 };
 
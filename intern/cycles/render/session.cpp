@@ -39,6 +39,21 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Number of workers acquiring tiles concurrently: every CPU thread and every
+ * other device renders its own tile. */
+static int session_num_tile_workers(const DeviceInfo &info)
+{
+  if (!info.multi_devices.empty()) {
+    int num_workers = 0;
+    foreach (const DeviceInfo &sub_info, info.multi_devices) {
+      num_workers += session_num_tile_workers(sub_info);
+    }
+    return num_workers;
+  }
+
+  return (info.type == DEVICE_CPU) ? TaskScheduler::num_threads() : 1;
+}
+
 /* Note about  preserve_tile_device option for tile manager:
  * progressive refine and viewport rendering does requires tiles to
  * always be allocated for the same device
@@ -61,6 +76,9 @@ Session::Session(const SessionParams &params_)
 
   TaskScheduler::init(params.threads);
 
+  tile_manager.use_tile_subdivision = params.use_tile_subdivision;
+  tile_manager.num_tile_workers = session_num_tile_workers(params.device);
+
   device = Device::create(params.device, stats, profiler, params.background);
 
   if (params.background && !params.write_render_cb) {
@@ -78,6 +96,9 @@ Session::Session(const SessionParams &params_)
   reset_time = 0.0;
   last_update_time = 0.0;
 
+  tile_render_start_time = 0.0;
+  tile_render_end_time = 0.0;
+
   delayed_reset.do_reset = false;
   delayed_reset.samples = 0;
 
@@ -304,6 +325,7 @@ void Session::run_gpu()
       render(need_denoise);
 
       device->task_wait();
+      update_tile_stats();
 
       if (!device->error_message().empty())
         progress.set_cancel(device->error_message());
@@ -400,6 +422,9 @@ bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_typ
       denoising_cond.wait(tile_lock);
       continue;
     }
+    if (tile_types & RenderTile::PATH_TRACE) {
+      tile_worker_done_times.push_back(time_dt());
+    }
     return false;
   }
 
@@ -483,6 +508,10 @@ void Session::release_tile(RenderTile &rtile)
 
   progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
 
+  if (rtile.task == RenderTile::PATH_TRACE) {
+    tile_render_end_time = time_dt();
+  }
+
   bool delete_tile;
 
   if (tile_manager.finish_tile(rtile.tile_index, delete_tile)) {
@@ -507,6 +536,41 @@ void Session::release_tile(RenderTile &rtile)
   denoising_cond.notify_all();
 }
 
+void Session::update_tile_stats()
+{
+  thread_scoped_lock tile_lock(tile_mutex);
+
+  if (tile_render_start_time == 0.0) {
+    return;
+  }
+
+  const int num_workers = tile_worker_done_times.size();
+  if (num_workers > 0 && tile_render_end_time > tile_render_start_time) {
+    double idle_time = 0.0;
+    foreach (double done_time, tile_worker_done_times) {
+      idle_time += max(tile_render_end_time - done_time, 0.0);
+    }
+
+    const double render_time = tile_render_end_time - tile_render_start_time;
+    tile_stats.render_time += render_time;
+    tile_stats.worker_time += render_time * num_workers;
+    tile_stats.idle_time += idle_time;
+    tile_stats.num_workers = max(tile_stats.num_workers, num_workers);
+  }
+
+  tile_stats.num_tiles = tile_manager.state.num_tiles;
+  tile_stats.num_subdivided_tiles = tile_manager.state.num_subdivided_tiles;
+
+  if (params.background) {
+    VLOG(2) << "Tile workers idle " << tile_stats.idle_fraction() * 100.0 << "% of render time, "
+            << tile_stats.num_subdivided_tiles << " tiles subdivided.";
+  }
+
+  tile_render_start_time = 0.0;
+  tile_render_end_time = 0.0;
+  tile_worker_done_times.clear();
+}
+
 void Session::map_neighbor_tiles(RenderTile *tiles, Device *tile_device)
 {
   thread_scoped_lock tile_lock(tile_mutex);
@@ -708,6 +772,7 @@ void Session::run_cpu()
     }
 
     device->task_wait();
+    update_tile_stats();
 
     {
       thread_scoped_lock reset_lock(delayed_reset.mutex);
@@ -876,6 +941,8 @@ void Session::reset_(BufferParams &buffer_params, int samples)
   tile_manager.reset(buffer_params, samples);
   progress.reset_sample();
 
+  tile_stats = TileStats();
+
   bool show_progress = params.background || tile_manager.get_num_effective_samples() != INT_MAX;
   progress.set_total_pixel_samples(show_progress ? tile_manager.state.total_pixel_samples : 0);
 
@@ -1090,6 +1157,10 @@ void Session::render(bool with_denoising)
     return; /* Avoid empty launches. */
   }
 
+  tile_render_start_time = time_dt();
+  tile_render_end_time = 0.0;
+  tile_worker_done_times.clear();
+
   /* Add path trace task. */
   DeviceTask task(DeviceTask::RENDER);
 
@@ -1256,6 +1327,10 @@ void Session::device_free()
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  {
+    thread_scoped_lock tile_lock(tile_mutex);
+    render_stats->tiles = tile_stats;
+  }
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene, profiler);
   }
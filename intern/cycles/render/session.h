@@ -57,6 +57,7 @@ class SessionParams {
   int pixel_size;
   int threads;
   bool adaptive_sampling;
+  bool use_tile_subdivision;
 
   bool use_profiling;
 
@@ -91,6 +92,7 @@ class SessionParams {
     pixel_size = 1;
     threads = 0;
     adaptive_sampling = false;
+    use_tile_subdivision = false;
 
     use_profiling = false;
 
@@ -120,6 +122,7 @@ class SessionParams {
              tile_size == params.tile_size && start_resolution == params.start_resolution &&
              pixel_size == params.pixel_size && threads == params.threads &&
              adaptive_sampling == params.adaptive_sampling &&
+             use_tile_subdivision == params.use_tile_subdivision &&
              use_profiling == params.use_profiling &&
              display_buffer_linear == params.display_buffer_linear &&
              cancel_timeout == params.cancel_timeout && reset_timeout == params.reset_timeout &&
@@ -206,6 +209,9 @@ class Session {
   void map_neighbor_tiles(RenderTile *tiles, Device *tile_device);
   void unmap_neighbor_tiles(RenderTile *tiles, Device *tile_device);
 
+  /* Accumulate tile statistics of the render task which just finished. */
+  void update_tile_stats();
+
   bool device_use_gl;
 
   thread *session_thread;
@@ -231,6 +237,13 @@ class Session {
   double last_update_time;
   double last_display_time;
 
+  /* Tile scheduling statistics, protected by the tile mutex. To measure idle
+   * workers, the time at which every worker ran out of tiles is recorded. */
+  TileStats tile_stats;
+  double tile_render_start_time;
+  double tile_render_end_time;
+  vector<double> tile_worker_done_times;
+
   /* progressive refine */
   bool update_progressive_refine(bool cancel);
 
@@ -45,6 +45,37 @@ bool namedSampleCountPairComparator(const NamedSampleCountPair &a, const NamedSa
   return a.samples > b.samples;
 }
 
+/* Quote and escape a string for use in a JSON document. */
+string json_string(const string &str)
+{
+  string result = "\"";
+  foreach (char c, str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", (int)c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
 }  // namespace
 
 NamedSizeEntry::NamedSizeEntry() : name(""), size(0)
@@ -87,6 +118,19 @@ string NamedSizeStats::full_report(int indent_level)
   return result;
 }
 
+string NamedSizeStats::json_report()
+{
+  sort(entries.begin(), entries.end(), namedSizeEntryComparator);
+  string result = string_printf("{\"total_size\": %zu, \"entries\": [", total_size);
+  for (size_t i = 0; i < entries.size(); i++) {
+    result += string_printf("%s{\"name\": %s, \"size\": %zu}",
+                            (i == 0) ? "" : ", ",
+                            json_string(entries[i].name).c_str(),
+                            entries[i].size);
+  }
+  return result + "]}";
+}
+
 /* Named time sample statistics. */
 
 NamedNestedSampleStats::NamedNestedSampleStats() : name(""), self_samples(0), sum_samples(0)
@@ -142,6 +186,25 @@ string NamedNestedSampleStats::full_report(int indent_level, uint64_t total_samp
   return result;
 }
 
+string NamedNestedSampleStats::json_report()
+{
+  update_sum();
+
+  string result = string_printf("{\"name\": %s, \"seconds\": %.3f, \"self_seconds\": %.3f",
+                                json_string(name).c_str(),
+                                sum_samples * 0.001,
+                                self_samples * 0.001);
+  if (!entries.empty()) {
+    sort(entries.begin(), entries.end(), namedTimeSampleEntryComparator);
+    result += ", \"entries\": [";
+    for (size_t i = 0; i < entries.size(); i++) {
+      result += ((i == 0) ? "" : ", ") + entries[i].json_report();
+    }
+    result += "]";
+  }
+  return result + "}";
+}
+
 /* Named sample count pairs. */
 
 NamedSampleCountPair::NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits)
@@ -196,6 +259,43 @@ string NamedSampleCountStats::full_report(int indent_level)
   return result;
 }
 
+string NamedSampleCountStats::json_report()
+{
+  vector<NamedSampleCountPair> sorted_entries;
+  sorted_entries.reserve(entries.size());
+
+  uint64_t total_hits = 0, total_samples = 0;
+  foreach (entry_map::const_reference entry, entries) {
+    const NamedSampleCountPair &pair = entry.second;
+
+    total_hits += pair.hits;
+    total_samples += pair.samples;
+
+    sorted_entries.push_back(pair);
+  }
+  const double avg_samples_per_hit = (total_hits) ? ((double)total_samples) / total_hits : 0.0;
+
+  sort(sorted_entries.begin(), sorted_entries.end(), namedSampleCountPairComparator);
+
+  string result = "[";
+  for (size_t i = 0; i < sorted_entries.size(); i++) {
+    const NamedSampleCountPair &entry = sorted_entries[i];
+    /* Avoid writing NaN or infinity, neither of which is valid JSON. */
+    const double relative = (entry.hits && avg_samples_per_hit > 0.0) ?
+                                ((double)entry.samples) / (entry.hits * avg_samples_per_hit) :
+                                0.0;
+
+    result += string_printf(
+        "%s{\"name\": %s, \"seconds\": %.3f, \"hits\": %llu, \"relative_cost\": %.4f}",
+        (i == 0) ? "" : ", ",
+        json_string(entry.name.string()).c_str(),
+        entry.samples * 0.001,
+        (unsigned long long)entry.hits,
+        relative);
+  }
+  return result + "]";
+}
+
 /* Mesh statistics. */
 
 MeshStats::MeshStats()
@@ -224,6 +324,50 @@ string ImageStats::full_report(int indent_level)
   return result;
 }
 
+/* Tile statistics. */
+
+TileStats::TileStats()
+    : num_tiles(0),
+      num_subdivided_tiles(0),
+      num_workers(0),
+      render_time(0.0),
+      worker_time(0.0),
+      idle_time(0.0)
+{
+}
+
+double TileStats::idle_fraction() const
+{
+  return (worker_time > 0.0) ? idle_time / worker_time : 0.0;
+}
+
+string TileStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result = "";
+  result += string_printf("%sTiles: %d (%d subdivided)\n",
+                          indent.c_str(),
+                          num_tiles,
+                          num_subdivided_tiles);
+  result += string_printf("%sWorkers: %d\n", indent.c_str(), num_workers);
+  result += string_printf("%sRender time: %.2fs\n", indent.c_str(), render_time);
+  result += string_printf("%sIdle workers: %.2f%%\n", indent.c_str(), idle_fraction() * 100.0);
+  return result;
+}
+
+string TileStats::json_report()
+{
+  return string_printf(
+      "{\"num_tiles\": %d, \"num_subdivided_tiles\": %d, \"num_workers\": %d, "
+      "\"render_time\": %.3f, \"worker_time\": %.3f, \"idle_time\": %.3f}",
+      num_tiles,
+      num_subdivided_tiles,
+      num_workers,
+      render_time,
+      worker_time,
+      idle_time);
+}
+
 /* Overall statistics. */
 
 RenderStats::RenderStats()
@@ -306,6 +450,7 @@ string RenderStats::full_report()
   string result = "";
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
+  result += "Tile statistics:\n" + tiles.full_report(1);
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
@@ -317,4 +462,20 @@ string RenderStats::full_report()
   return result;
 }
 
+string RenderStats::json_report()
+{
+  string result = "{\n";
+  result += "  \"geometry\": " + mesh.geometry.json_report() + ",\n";
+  result += "  \"textures\": " + image.textures.json_report() + ",\n";
+  result += "  \"tiles\": " + tiles.json_report() + ",\n";
+  result += string_printf("  \"has_profiling\": %s", has_profiling ? "true" : "false");
+  if (has_profiling) {
+    result += ",\n";
+    result += "  \"kernel\": " + kernel.json_report() + ",\n";
+    result += "  \"shaders\": " + shaders.json_report() + ",\n";
+    result += "  \"objects\": " + objects.json_report();
+  }
+  return result + "\n}\n";
+}
+
 CCL_NAMESPACE_END
@@ -55,6 +55,9 @@ class NamedSizeStats {
   /* Generate full human-readable report. */
   string full_report(int indent_level = 0);
 
+  /* Generate machine-readable report as a JSON object. */
+  string json_report();
+
   /* Total size of all entries. */
   size_t total_size;
 
@@ -75,6 +78,7 @@ class NamedNestedSampleStats {
   void update_sum();
 
   string full_report(int indent_level = 0, uint64_t total_samples = 0);
+  string json_report();
 
   string name;
 
@@ -103,6 +107,7 @@ class NamedSampleCountStats {
   NamedSampleCountStats();
 
   string full_report(int indent_level = 0);
+  string json_report();
   void add(const ustring &name, uint64_t samples, uint64_t hits);
 
   typedef unordered_map<ustring, NamedSampleCountPair, ustringHash> entry_map;
@@ -135,6 +140,32 @@ class ImageStats {
   NamedSizeStats textures;
 };
 
+/* Statistics about how render tiles were distributed over the workers. */
+class TileStats {
+ public:
+  TileStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  /* Generate machine-readable report as a JSON object. */
+  string json_report();
+
+  /* Fraction of the available worker time which was spent idle, waiting for
+   * other workers to finish the last tiles. */
+  double idle_fraction() const;
+
+  int num_tiles;
+  int num_subdivided_tiles;
+  int num_workers;
+
+  /* Wall time spent rendering tiles, and the part of the accumulated worker
+   * time in which workers had no tile left to render. */
+  double render_time;
+  double worker_time;
+  double idle_time;
+};
+
 /* Render process statistics. */
 class RenderStats {
  public:
@@ -143,6 +174,10 @@ class RenderStats {
   /* Return full report as string. */
   string full_report();
 
+  /* Return the same information as a JSON document, meant to be consumed by
+   * scripts which track render performance over time. Times are in seconds. */
+  string json_report();
+
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
@@ -150,6 +185,7 @@ class RenderStats {
 
   MeshStats mesh;
   ImageStats image;
+  TileStats tiles;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
@@ -77,6 +77,11 @@ inline int2 hilbert_index_to_pos(int n, int d)
   return xy;
 }
 
+/* Tiles are not split into sub-tiles smaller than this size in pixels. */
+const int TILE_SUBDIVISION_MIN_SIZE = 16;
+/* Number of subdivisions reserved for every worker. */
+const int TILE_SUBDIVISION_MAX_PER_WORKER = 4;
+
 enum SpiralDirection {
   DIRECTION_UP,
   DIRECTION_LEFT,
@@ -107,6 +112,8 @@ TileManager::TileManager(bool progressive_,
   preserve_tile_device = preserve_tile_device_;
   background = background_;
   schedule_denoising = false;
+  use_tile_subdivision = false;
+  num_tile_workers = 1;
 
   range_start_sample = 0;
   range_num_samples = -1;
@@ -154,6 +161,7 @@ void TileManager::reset(BufferParams &params_, int num_samples_)
   state.buffer = BufferParams();
   state.sample = range_start_sample - 1;
   state.num_tiles = 0;
+  state.num_subdivided_tiles = 0;
   state.num_samples = 0;
   state.resolution_divider = get_divider(params.width, params.height, start_resolution);
   state.render_tiles.clear();
@@ -381,6 +389,14 @@ void TileManager::set_tiles()
   int image_h = max(1, params.height / resolution);
 
   state.num_tiles = gen_tiles(!background);
+  state.num_subdivided_tiles = 0;
+
+  if (use_tile_subdivision) {
+    /* Tiles are referenced by pointer while being rendered, so make sure subdivision never
+     * reallocates the array. */
+    state.tiles.reserve(state.tiles.size() +
+                        3 * TILE_SUBDIVISION_MAX_PER_WORKER * max(num_tile_workers, 1));
+  }
 
   state.buffer.width = image_w;
   state.buffer.height = image_h;
@@ -495,6 +511,51 @@ bool TileManager::finish_tile(int index, bool &delete_tile)
   }
 }
 
+bool TileManager::subdivide_tile(list<int> &tile_list, list<int>::iterator it)
+{
+  const int index = *it;
+  const Tile tile = state.tiles[index];
+
+  const int num_x = (tile.w >= 2 * TILE_SUBDIVISION_MIN_SIZE) ? 2 : 1;
+  const int num_y = (tile.h >= 2 * TILE_SUBDIVISION_MIN_SIZE) ? 2 : 1;
+  const int num_sub_tiles = num_x * num_y;
+
+  if (num_sub_tiles == 1 || state.tiles.size() + num_sub_tiles - 1 > state.tiles.capacity()) {
+    return false;
+  }
+
+  const int sub_w = tile.w / num_x;
+  const int sub_h = tile.h / num_y;
+
+  /* The original tile index is reused for the first sub-tile, the others follow it in the
+   * list. */
+  list<int>::iterator next = it;
+  next++;
+
+  for (int i = 0; i < num_sub_tiles; i++) {
+    const int sub_x = i % num_x;
+    const int sub_y = i / num_x;
+    const int x = tile.x + sub_x * sub_w;
+    const int y = tile.y + sub_y * sub_h;
+    const int w = (sub_x == num_x - 1) ? tile.w - sub_x * sub_w : sub_w;
+    const int h = (sub_y == num_y - 1) ? tile.h - sub_y * sub_h : sub_h;
+
+    if (i == 0) {
+      state.tiles[index] = Tile(index, x, y, w, h, tile.device, Tile::RENDER);
+    }
+    else {
+      const int sub_index = state.tiles.size();
+      state.tiles.push_back(Tile(sub_index, x, y, w, h, tile.device, Tile::RENDER));
+      tile_list.insert(next, sub_index);
+    }
+  }
+
+  state.num_tiles += num_sub_tiles - 1;
+  state.num_subdivided_tiles++;
+
+  return true;
+}
+
 bool TileManager::next_tile(Tile *&tile, int device, uint tile_types)
 {
   /* Preserve device if requested, unless this is a separate denoising device that just wants to
@@ -542,8 +603,27 @@ bool TileManager::next_tile(Tile *&tile, int device, uint tile_types)
         }
       }
 
-      tile_index = state.render_tiles[logical_device].front();
-      state.render_tiles[logical_device].pop_front();
+      list<int> &tile_list = state.render_tiles[logical_device];
+
+      /* Near the end of the render, split the largest remaining tile so workers which would
+       * otherwise run out of work get a part of it. Only one tile is split per acquired tile,
+       * further ones are split as the next workers ask for work. Denoising and progressive
+       * rendering rely on the regular tile grid. */
+      if (use_tile_subdivision && !preserve_device && !progressive && !schedule_denoising &&
+          tile_list.size() < (size_t)num_tile_workers) {
+        list<int>::iterator largest = tile_list.begin();
+        for (list<int>::iterator it = tile_list.begin(); it != tile_list.end(); it++) {
+          const Tile &it_tile = state.tiles[*it];
+          const Tile &largest_tile = state.tiles[*largest];
+          if (it_tile.w * it_tile.h > largest_tile.w * largest_tile.h) {
+            largest = it;
+          }
+        }
+        subdivide_tile(tile_list, largest);
+      }
+
+      tile_index = tile_list.front();
+      tile_list.pop_front();
       break;
     }
 
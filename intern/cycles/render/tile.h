@@ -86,6 +86,9 @@ class TileManager {
      * Each list in each vector is for one logical device. */
     vector<list<int>> render_tiles;
     vector<list<int>> denoising_tiles;
+
+    /* Number of tiles which were split into smaller ones near the end of the render. */
+    int num_subdivided_tiles;
   } state;
 
   int num_samples;
@@ -133,9 +136,23 @@ class TileManager {
   /* Schedule tiles for denoising after they've been rendered. */
   bool schedule_denoising;
 
+  /* ** Tile subdivision. ** */
+
+  /* Split remaining tiles into smaller ones when there are fewer tiles left than workers
+   * rendering them, so that the last tiles do not leave most workers idle. Only used when
+   * tiles are shared between all devices and are not scheduled for denoising. */
+  bool use_tile_subdivision;
+
+  /* Number of workers (CPU threads and GPU devices) acquiring tiles concurrently. */
+  int num_tile_workers;
+
  protected:
   void set_tiles();
 
+  /* Split the tile at the list position into up to four smaller tiles, which take its place in
+   * the list. */
+  bool subdivide_tile(list<int> &tile_list, list<int>::iterator it);
+
   bool progressive;
   int2 tile_size;
   TileOrder tile_order;
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/util_mapped_memory.h"
+#include "util/util_logging.h"
+#include "util/util_map.h"
+#include "util/util_path.h"
+#include "util/util_string.h"
+#include "util/util_thread.h"
+
+#ifdef _WIN32
+#  include "util/util_windows.h"
+#else
+#  include <fcntl.h>
+#  include <stdlib.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+CCL_NAMESPACE_BEGIN
+
+static thread_mutex mapped_memory_mutex;
+static map<void *, size_t> mapped_memory_blocks;
+static size_t mapped_memory_total_size = 0;
+
+#ifndef _WIN32
+
+void *util_mapped_memory_alloc(size_t size)
+{
+  if (size == 0) {
+    return NULL;
+  }
+
+  /* Each allocation gets its own file, which is unlinked right away so it is
+   * removed by the operating system once unmapped, even after a crash. */
+  string filepath = path_cache_get(path_join("geometry", "mapped_XXXXXX"));
+  path_create_directories(filepath);
+
+  vector<char> filename(filepath.begin(), filepath.end());
+  filename.push_back('\0');
+
+  int fd = mkstemp(filename.data());
+  if (fd == -1) {
+    VLOG(1) << "Failed to create scratch file " << filepath << ", using regular memory.";
+    return NULL;
+  }
+  unlink(filename.data());
+
+  void *ptr = NULL;
+  if (ftruncate(fd, size) == 0) {
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+
+  if (ptr == NULL || ptr == MAP_FAILED) {
+    VLOG(1) << "Failed to map " << string_human_readable_size(size)
+            << " of scratch memory, using regular memory.";
+    return NULL;
+  }
+
+  /* Ray traversal accesses the data in no particular order, so read ahead
+   * would mostly load pages which are not needed. */
+  madvise(ptr, size, MADV_RANDOM);
+
+  thread_scoped_lock lock(mapped_memory_mutex);
+  mapped_memory_blocks[ptr] = size;
+  mapped_memory_total_size += size;
+
+  return ptr;
+}
+
+bool util_mapped_memory_free(void *ptr)
+{
+  thread_scoped_lock lock(mapped_memory_mutex);
+
+  map<void *, size_t>::iterator it = mapped_memory_blocks.find(ptr);
+  if (it == mapped_memory_blocks.end()) {
+    return false;
+  }
+
+  munmap(ptr, it->second);
+  mapped_memory_total_size -= it->second;
+  mapped_memory_blocks.erase(it);
+
+  return true;
+}
+
+#else
+
+void *util_mapped_memory_alloc(size_t size)
+{
+  if (size == 0) {
+    return NULL;
+  }
+
+  /* Each allocation gets its own file, which is deleted by the operating
+   * system once the last handle and view are closed, even after a crash. */
+  static int mapped_memory_counter = 0;
+  int counter;
+  {
+    thread_scoped_lock lock(mapped_memory_mutex);
+    counter = mapped_memory_counter++;
+  }
+
+  string filepath = path_cache_get(path_join(
+      "geometry", string_printf("mapped_%lu_%d", GetCurrentProcessId(), counter)));
+  path_create_directories(filepath);
+
+  HANDLE file = CreateFileW(string_to_wstring(filepath).c_str(),
+                            GENERIC_READ | GENERIC_WRITE,
+                            0,
+                            NULL,
+                            CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE |
+                                FILE_FLAG_RANDOM_ACCESS,
+                            NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    VLOG(1) << "Failed to create scratch file " << filepath << ", using regular memory.";
+    return NULL;
+  }
+
+  /* The mapping grows the file to the requested size. */
+  HANDLE mapping = CreateFileMappingW(
+      file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+
+  void *ptr = NULL;
+  if (mapping != NULL) {
+    ptr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    /* The view keeps the mapping and the file alive until it is unmapped. */
+    CloseHandle(mapping);
+  }
+  CloseHandle(file);
+
+  if (ptr == NULL) {
+    VLOG(1) << "Failed to map " << string_human_readable_size(size)
+            << " of scratch memory, using regular memory.";
+    return NULL;
+  }
+
+  thread_scoped_lock lock(mapped_memory_mutex);
+  mapped_memory_blocks[ptr] = size;
+  mapped_memory_total_size += size;
+
+  return ptr;
+}
+
+bool util_mapped_memory_free(void *ptr)
+{
+  thread_scoped_lock lock(mapped_memory_mutex);
+
+  map<void *, size_t>::iterator it = mapped_memory_blocks.find(ptr);
+  if (it == mapped_memory_blocks.end()) {
+    return false;
+  }
+
+  UnmapViewOfFile(ptr);
+  mapped_memory_total_size -= it->second;
+  mapped_memory_blocks.erase(it);
+
+  return true;
+}
+
+#endif
+
+size_t util_mapped_memory_size()
+{
+  thread_scoped_lock lock(mapped_memory_mutex);
+  return mapped_memory_total_size;
+}
+
+CCL_NAMESPACE_END
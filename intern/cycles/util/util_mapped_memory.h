@@ -0,0 +1,42 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UTIL_MAPPED_MEMORY_H__
+#define __UTIL_MAPPED_MEMORY_H__
+
+#include "util/util_types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Memory backed by a scratch file in the cache directory rather than by RAM
+ * or swap. Pages are read from the file when accessed and are dropped again by
+ * the operating system under memory pressure, least recently used first. This
+ * is meant for large read-mostly data which might not fit in memory otherwise.
+ *
+ * Returns NULL when mapping is not supported on this platform or failed, in
+ * which case the caller is expected to fall back to a regular allocation. */
+void *util_mapped_memory_alloc(size_t size);
+
+/* Free memory allocated by util_mapped_memory_alloc. Returns false if the
+ * pointer was not allocated by it, so it can be used to check ownership. */
+bool util_mapped_memory_free(void *ptr);
+
+/* Total size of all currently mapped allocations. */
+size_t util_mapped_memory_size();
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_MAPPED_MEMORY_H__ */
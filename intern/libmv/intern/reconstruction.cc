@@ -38,9 +38,12 @@ using libmv::EuclideanReconstruction;
 using libmv::EuclideanScaleToUnity;
 using libmv::Marker;
 using libmv::ProgressUpdateCallback;
+using libmv::SolverStatistics;
+using libmv::SolverWallTime;
 
 using libmv::PolynomialCameraIntrinsics;
 using libmv::Tracks;
+using libmv::BundleOptions;
 using libmv::EuclideanBundle;
 using libmv::EuclideanCompleteReconstruction;
 using libmv::EuclideanReconstructTwoFrames;
@@ -55,6 +58,12 @@ struct libmv_Reconstruction {
 
   double error;
   bool is_valid;
+
+  /* Time spent in the stages of the solver. */
+  SolverStatistics statistics;
+  double keyframe_selection_time;
+  double initialization_time;
+  double total_time;
 };
 
 namespace {
@@ -84,6 +93,7 @@ void libmv_solveRefineIntrinsics(
     const int bundle_constraints,
     reconstruct_progress_update_cb progress_update_callback,
     void* callback_customdata,
+    const BundleOptions &bundle_options,
     EuclideanReconstruction* reconstruction,
     CameraIntrinsics* intrinsics) {
   /* only a few combinations are supported but trust the caller/ */
@@ -108,7 +118,9 @@ void libmv_solveRefineIntrinsics(
                                   bundle_intrinsics,
                                   bundle_constraints,
                                   reconstruction,
-                                  intrinsics);
+                                  intrinsics,
+                                  NULL,
+                                  bundle_options);
 }
 
 void finishReconstruction(
@@ -227,6 +239,17 @@ void libmv_getNormalizedTracks(const Tracks &tracks,
   }
 }
 
+void libmv_bundleOptionsFromReconstructionOptions(
+    const libmv_ReconstructionOptions* libmv_reconstruction_options,
+    libmv_Reconstruction* libmv_reconstruction,
+    BundleOptions* bundle_options) {
+  bundle_options->num_threads = libmv_reconstruction_options->num_threads;
+  bundle_options->statistics = &libmv_reconstruction->statistics;
+  libmv_reconstruction->keyframe_selection_time = 0.0;
+  libmv_reconstruction->initialization_time = 0.0;
+  libmv_reconstruction->total_time = 0.0;
+}
+
 }  // namespace
 
 libmv_Reconstruction *libmv_solveReconstruction(
@@ -235,6 +258,7 @@ libmv_Reconstruction *libmv_solveReconstruction(
     libmv_ReconstructionOptions* libmv_reconstruction_options,
     reconstruct_progress_update_cb progress_update_callback,
     void* callback_customdata) {
+  const double start_time = SolverWallTime();
   libmv_Reconstruction *libmv_reconstruction =
     LIBMV_OBJECT_NEW(libmv_Reconstruction);
 
@@ -251,6 +275,11 @@ libmv_Reconstruction *libmv_solveReconstruction(
   camera_intrinsics = libmv_reconstruction->intrinsics =
     libmv_cameraIntrinsicsCreateFromOptions(libmv_camera_intrinsics_options);
 
+  BundleOptions bundle_options;
+  libmv_bundleOptionsFromReconstructionOptions(libmv_reconstruction_options,
+                                               libmv_reconstruction,
+                                               &bundle_options);
+
   /* Invert the camera intrinsics/ */
   Tracks normalized_tracks;
   libmv_getNormalizedTracks(tracks, *camera_intrinsics, &normalized_tracks);
@@ -264,6 +293,7 @@ libmv_Reconstruction *libmv_solveReconstruction(
 
     update_callback.invoke(0, "Selecting keyframes");
 
+    const double keyframe_start_time = SolverWallTime();
     if (selectTwoKeyframesBasedOnGRICAndVariance(tracks,
                                              normalized_tracks,
                                              *camera_intrinsics,
@@ -273,6 +303,8 @@ libmv_Reconstruction *libmv_solveReconstruction(
       libmv_reconstruction_options->keyframe1 = keyframe1;
       libmv_reconstruction_options->keyframe2 = keyframe2;
     }
+    libmv_reconstruction->keyframe_selection_time =
+      SolverWallTime() - keyframe_start_time;
   }
 
   /* Actual reconstruction. */
@@ -291,16 +323,20 @@ libmv_Reconstruction *libmv_solveReconstruction(
 
   update_callback.invoke(0, "Initial reconstruction");
 
+  const double initialization_start_time = SolverWallTime();
   if (!EuclideanReconstructTwoFrames(keyframe_markers, &reconstruction)) {
     LG << "Failed to initialize reconstruction";
     libmv_reconstruction->is_valid = false;
     return libmv_reconstruction;
   }
+  libmv_reconstruction->initialization_time =
+    SolverWallTime() - initialization_start_time;
 
-  EuclideanBundle(normalized_tracks, &reconstruction);
+  EuclideanBundle(normalized_tracks, &reconstruction, bundle_options);
   EuclideanCompleteReconstruction(normalized_tracks,
                                   &reconstruction,
-                                  &update_callback);
+                                  &update_callback,
+                                  bundle_options);
 
   /* Refinement. */
   if (libmv_reconstruction_options->refine_intrinsics) {
@@ -310,6 +346,7 @@ libmv_Reconstruction *libmv_solveReconstruction(
                                 libmv::BUNDLE_NO_CONSTRAINTS,
                                 progress_update_callback,
                                 callback_customdata,
+                                bundle_options,
                                 &reconstruction,
                                 camera_intrinsics);
   }
@@ -324,6 +361,7 @@ libmv_Reconstruction *libmv_solveReconstruction(
                        progress_update_callback,
                        callback_customdata);
 
+  libmv_reconstruction->total_time = SolverWallTime() - start_time;
   libmv_reconstruction->is_valid = true;
   return (libmv_Reconstruction *) libmv_reconstruction;
 }
@@ -334,6 +372,7 @@ libmv_Reconstruction *libmv_solveModal(
     const libmv_ReconstructionOptions *libmv_reconstruction_options,
     reconstruct_progress_update_cb progress_update_callback,
     void *callback_customdata) {
+  const double start_time = SolverWallTime();
   libmv_Reconstruction *libmv_reconstruction =
     LIBMV_OBJECT_NEW(libmv_Reconstruction);
 
@@ -351,6 +390,11 @@ libmv_Reconstruction *libmv_solveModal(
     libmv_cameraIntrinsicsCreateFromOptions(
                                             libmv_camera_intrinsics_options);
 
+  BundleOptions bundle_options;
+  libmv_bundleOptionsFromReconstructionOptions(libmv_reconstruction_options,
+                                               libmv_reconstruction,
+                                               &bundle_options);
+
   /* Invert the camera intrinsics. */
   Tracks normalized_tracks;
   libmv_getNormalizedTracks(tracks, *camera_intrinsics, &normalized_tracks);
@@ -363,7 +407,9 @@ libmv_Reconstruction *libmv_solveModal(
                                   libmv::BUNDLE_NO_INTRINSICS,
                                   libmv::BUNDLE_NO_TRANSLATION,
                                   &reconstruction,
-                                  &empty_intrinsics);
+                                  &empty_intrinsics,
+                                  NULL,
+                                  bundle_options);
 
   /* Refinement. */
   if (libmv_reconstruction_options->refine_intrinsics) {
@@ -372,6 +418,7 @@ libmv_Reconstruction *libmv_solveModal(
                                 libmv_reconstruction_options->refine_intrinsics,
                                 libmv::BUNDLE_NO_TRANSLATION,
                                 progress_update_callback, callback_customdata,
+                                bundle_options,
                                 &reconstruction,
                                 camera_intrinsics);
   }
@@ -383,6 +430,7 @@ libmv_Reconstruction *libmv_solveModal(
                        progress_update_callback,
                        callback_customdata);
 
+  libmv_reconstruction->total_time = SolverWallTime() - start_time;
   libmv_reconstruction->is_valid = true;
   return (libmv_Reconstruction *) libmv_reconstruction;
 }
@@ -391,6 +439,23 @@ int libmv_reconstructionIsValid(libmv_Reconstruction *libmv_reconstruction) {
   return libmv_reconstruction->is_valid;
 }
 
+void libmv_reconstructionStatistics(
+    const libmv_Reconstruction* libmv_reconstruction,
+    libmv_ReconstructionStatistics* statistics) {
+  const SolverStatistics &solver_statistics = libmv_reconstruction->statistics;
+  statistics->keyframe_selection_time =
+    libmv_reconstruction->keyframe_selection_time;
+  statistics->initialization_time = libmv_reconstruction->initialization_time;
+  statistics->num_intersects = solver_statistics.num_intersects;
+  statistics->intersect_time = solver_statistics.intersect_time;
+  statistics->num_resects = solver_statistics.num_resects;
+  statistics->resect_time = solver_statistics.resect_time;
+  statistics->num_bundles = solver_statistics.num_bundles;
+  statistics->num_bundle_iterations = solver_statistics.num_bundle_iterations;
+  statistics->bundle_time = solver_statistics.bundle_time;
+  statistics->total_time = libmv_reconstruction->total_time;
+}
+
 void libmv_reconstructionDestroy(libmv_Reconstruction *libmv_reconstruction) {
   LIBMV_OBJECT_DELETE(libmv_reconstruction->intrinsics, CameraIntrinsics);
   LIBMV_OBJECT_DELETE(libmv_reconstruction, libmv_Reconstruction);
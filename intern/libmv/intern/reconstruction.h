@@ -41,8 +41,24 @@ typedef struct libmv_ReconstructionOptions {
   int select_keyframes;
   int keyframe1, keyframe2;
   int refine_intrinsics;
+  /* Threads used by the bundle adjustment, all available threads when zero. */
+  int num_threads;
 } libmv_ReconstructionOptions;
 
+/* Time spent in the stages of the solver in seconds, and the work they did. */
+typedef struct libmv_ReconstructionStatistics {
+  double keyframe_selection_time;
+  double initialization_time;
+  int num_intersects;
+  double intersect_time;
+  int num_resects;
+  double resect_time;
+  int num_bundles;
+  int num_bundle_iterations;
+  double bundle_time;
+  double total_time;
+} libmv_ReconstructionStatistics;
+
 typedef void (*reconstruct_progress_update_cb) (void* customdata,
                                                 double progress,
                                                 const char* message);
@@ -63,6 +79,10 @@ libmv_Reconstruction* libmv_solveModal(
 
 int libmv_reconstructionIsValid(libmv_Reconstruction *libmv_reconstruction);
 
+void libmv_reconstructionStatistics(
+    const libmv_Reconstruction* libmv_reconstruction,
+    libmv_ReconstructionStatistics* statistics);
+
 void libmv_reconstructionDestroy(libmv_Reconstruction* libmv_reconstruction);
 
 int libmv_reprojectionPointForTrack(
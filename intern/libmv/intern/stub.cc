@@ -135,6 +135,12 @@ int libmv_reconstructionIsValid(libmv_Reconstruction * /*libmv_reconstruction*/)
   return 0;
 }
 
+void libmv_reconstructionStatistics(
+    const libmv_Reconstruction * /*libmv_reconstruction*/,
+    libmv_ReconstructionStatistics *statistics) {
+  memset(statistics, 0, sizeof(*statistics));
+}
+
 int libmv_reprojectionPointForTrack(
     const libmv_Reconstruction * /*libmv_reconstruction*/,
     int /*track*/,
@@ -20,6 +20,8 @@
 
 #include "libmv/simple_pipeline/bundle.h"
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 
 #include "ceres/ceres.h"
@@ -366,6 +368,52 @@ void EuclideanBundlerPerformEvaluation(const Tracks &tracks,
     }
 }
 
+// Problems with fewer cameras are solved with iterative Schur, the reduced
+// camera system of larger shots is factorized by the sparse Schur solver.
+const int kSparseSchurMinCameras = 100;
+
+void ConfigureSolverOptions(const BundleOptions &bundle_options,
+                            const int num_cameras,
+                            ceres::Solver::Options *options) {
+  options->use_nonmonotonic_steps = true;
+  options->preconditioner_type = ceres::SCHUR_JACOBI;
+  if (num_cameras >= kSparseSchurMinCameras &&
+      ceres::IsSparseLinearAlgebraLibraryTypeAvailable(ceres::EIGEN_SPARSE)) {
+    options->linear_solver_type = ceres::SPARSE_SCHUR;
+    options->sparse_linear_algebra_library_type = ceres::EIGEN_SPARSE;
+  } else {
+    options->linear_solver_type = ceres::ITERATIVE_SCHUR;
+    options->use_explicit_schur_complement = true;
+  }
+  options->use_inner_iterations = true;
+  options->max_num_iterations = 100;
+
+  int num_threads = bundle_options.num_threads;
+#ifdef _OPENMP
+  if (num_threads == 0) {
+    num_threads = omp_get_max_threads();
+  }
+#endif
+  options->num_threads = std::max(num_threads, 1);
+  options->num_linear_solver_threads = options->num_threads;
+}
+
+void SolveWithStatistics(const BundleOptions &bundle_options,
+                         const ceres::Solver::Options &options,
+                         ceres::Problem *problem,
+                         ceres::Solver::Summary *summary) {
+  const double start_time = SolverWallTime();
+  ceres::Solve(options, problem, summary);
+
+  SolverStatistics *statistics = bundle_options.statistics;
+  if (statistics) {
+    statistics->num_bundles++;
+    statistics->num_bundle_iterations += summary->num_successful_steps +
+                                         summary->num_unsuccessful_steps;
+    statistics->bundle_time += SolverWallTime() - start_time;
+  }
+}
+
 // This is an utility function to only bundle 3D position of
 // given markers list.
 //
@@ -379,7 +427,8 @@ void EuclideanBundlePointsOnly(const DistortionModelType distortion_model,
                                const vector<Marker> &markers,
                                vector<Vec6> &all_cameras_R_t,
                                double ceres_intrinsics[OFFSET_MAX],
-                               EuclideanReconstruction *reconstruction) {
+                               EuclideanReconstruction *reconstruction,
+                               const BundleOptions &bundle_options) {
   ceres::Problem::Options problem_options;
   ceres::Problem problem(problem_options);
   int num_residuals = 0;
@@ -421,21 +470,11 @@ void EuclideanBundlePointsOnly(const DistortionModelType distortion_model,
 
   // Configure the solver.
   ceres::Solver::Options options;
-  options.use_nonmonotonic_steps = true;
-  options.preconditioner_type = ceres::SCHUR_JACOBI;
-  options.linear_solver_type = ceres::ITERATIVE_SCHUR;
-  options.use_explicit_schur_complement = true;
-  options.use_inner_iterations = true;
-  options.max_num_iterations = 100;
-
-#ifdef _OPENMP
-  options.num_threads = omp_get_max_threads();
-  options.num_linear_solver_threads = omp_get_max_threads();
-#endif
+  ConfigureSolverOptions(bundle_options, 0, &options);
 
   // Solve!
   ceres::Solver::Summary summary;
-  ceres::Solve(options, &problem, &summary);
+  SolveWithStatistics(bundle_options, options, &problem, &summary);
 
   LG << "Final report:\n" << summary.FullReport();
 
@@ -443,15 +482,22 @@ void EuclideanBundlePointsOnly(const DistortionModelType distortion_model,
 
 }  // namespace
 
+double SolverWallTime() {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 void EuclideanBundle(const Tracks &tracks,
-                     EuclideanReconstruction *reconstruction) {
+                     EuclideanReconstruction *reconstruction,
+                     const BundleOptions &options) {
   PolynomialCameraIntrinsics empty_intrinsics;
   EuclideanBundleCommonIntrinsics(tracks,
                                   BUNDLE_NO_INTRINSICS,
                                   BUNDLE_NO_CONSTRAINTS,
                                   reconstruction,
                                   &empty_intrinsics,
-                                  NULL);
+                                  NULL,
+                                  options);
 }
 
 void EuclideanBundleCommonIntrinsics(
@@ -460,7 +506,8 @@ void EuclideanBundleCommonIntrinsics(
     const int bundle_constraints,
     EuclideanReconstruction *reconstruction,
     CameraIntrinsics *intrinsics,
-    BundleEvaluation *evaluation) {
+    BundleEvaluation *evaluation,
+    const BundleOptions &bundle_options) {
   LG << "Original intrinsics: " << *intrinsics;
   vector<Marker> markers = tracks.AllMarkers();
 
@@ -591,21 +638,11 @@ void EuclideanBundleCommonIntrinsics(
 
   // Configure the solver.
   ceres::Solver::Options options;
-  options.use_nonmonotonic_steps = true;
-  options.preconditioner_type = ceres::SCHUR_JACOBI;
-  options.linear_solver_type = ceres::ITERATIVE_SCHUR;
-  options.use_explicit_schur_complement = true;
-  options.use_inner_iterations = true;
-  options.max_num_iterations = 100;
-
-#ifdef _OPENMP
-  options.num_threads = omp_get_max_threads();
-  options.num_linear_solver_threads = omp_get_max_threads();
-#endif
+  ConfigureSolverOptions(bundle_options, all_cameras_R_t.size(), &options);
 
   // Solve!
   ceres::Solver::Summary summary;
-  ceres::Solve(options, &problem, &summary);
+  SolveWithStatistics(bundle_options, options, &problem, &summary);
 
   LG << "Final report:\n" << summary.FullReport();
 
@@ -645,7 +682,8 @@ void EuclideanBundleCommonIntrinsics(
                               zero_weight_markers,
                               all_cameras_R_t,
                               ceres_intrinsics,
-                              reconstruction);
+                              reconstruction,
+                              bundle_options);
   }
 }
 
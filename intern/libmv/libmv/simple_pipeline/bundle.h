@@ -55,6 +55,49 @@ struct BundleEvaluation {
   Mat jacobian;
 };
 
+// Time spent in the stages of a reconstruction, in seconds, and the work done
+// by them. Accumulated over all the bundle adjustments, intersections and
+// resections of the reconstruction.
+struct SolverStatistics {
+  SolverStatistics() :
+    num_bundles(0),
+    num_bundle_iterations(0),
+    bundle_time(0.0),
+    num_intersects(0),
+    intersect_time(0.0),
+    num_resects(0),
+    resect_time(0.0) {
+  }
+
+  int num_bundles;
+  int num_bundle_iterations;
+  double bundle_time;
+
+  int num_intersects;
+  double intersect_time;
+
+  int num_resects;
+  double resect_time;
+};
+
+struct BundleOptions {
+  BundleOptions() :
+    num_threads(0),
+    statistics(NULL) {
+  }
+
+  // Number of threads used by Ceres to evaluate the problem and to solve the
+  // linear systems, all OpenMP threads when zero.
+  int num_threads;
+
+  // When not null, the time and iterations of the bundle adjustments are
+  // added to it.
+  SolverStatistics *statistics;
+};
+
+// Wall clock time in seconds, for the statistics of the solver.
+double SolverWallTime();
+
 /*!
     Refine camera poses and 3D coordinates using bundle adjustment.
 
@@ -73,7 +116,8 @@ struct BundleEvaluation {
     \sa EuclideanResect, EuclideanIntersect, EuclideanReconstructTwoFrames
 */
 void EuclideanBundle(const Tracks &tracks,
-                     EuclideanReconstruction *reconstruction);
+                     EuclideanReconstruction *reconstruction,
+                     const BundleOptions &options = BundleOptions());
 
 /*!
     Refine camera poses and 3D coordinates using bundle adjustment.
@@ -120,7 +164,8 @@ void EuclideanBundleCommonIntrinsics(
     const int bundle_constraints,
     EuclideanReconstruction *reconstruction,
     CameraIntrinsics *intrinsics,
-    BundleEvaluation *evaluation = NULL);
+    BundleEvaluation *evaluation = NULL,
+    const BundleOptions &options = BundleOptions());
 
 /*!
     Refine camera poses and 3D coordinates using bundle adjustment.
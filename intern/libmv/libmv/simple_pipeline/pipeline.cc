@@ -47,8 +47,9 @@ struct EuclideanPipelineRoutines {
   typedef EuclideanPoint Point;
 
   static void Bundle(const Tracks &tracks,
-                     EuclideanReconstruction *reconstruction) {
-    EuclideanBundle(tracks, reconstruction);
+                     EuclideanReconstruction *reconstruction,
+                     const BundleOptions &bundle_options) {
+    EuclideanBundle(tracks, reconstruction, bundle_options);
   }
 
   static bool Resect(const vector<Marker> &markers,
@@ -85,7 +86,8 @@ struct ProjectivePipelineRoutines {
   typedef ProjectivePoint Point;
 
   static void Bundle(const Tracks &tracks,
-                     ProjectiveReconstruction *reconstruction) {
+                     ProjectiveReconstruction *reconstruction,
+                     const BundleOptions & /*bundle_options*/) {
     ProjectiveBundle(tracks, reconstruction);
   }
 
@@ -143,7 +145,9 @@ template<typename PipelineRoutines>
 void InternalCompleteReconstruction(
     const Tracks &tracks,
     typename PipelineRoutines::Reconstruction *reconstruction,
-    ProgressUpdateCallback *update_callback = NULL) {
+    ProgressUpdateCallback *update_callback = NULL,
+    const BundleOptions &bundle_options = BundleOptions()) {
+  SolverStatistics *statistics = bundle_options.statistics;
   int max_track = tracks.MaxTrack();
   int max_image = tracks.MaxImage();
   int num_resects = -1;
@@ -155,6 +159,7 @@ void InternalCompleteReconstruction(
   while (num_resects != 0 || num_intersects != 0) {
     // Do all possible intersections.
     num_intersects = 0;
+    double start_time = SolverWallTime();
     for (int track = 0; track <= max_track; ++track) {
       if (reconstruction->PointForTrack(track)) {
         LG << "Skipping point: " << track;
@@ -183,17 +188,22 @@ void InternalCompleteReconstruction(
         }
       }
     }
+    if (statistics) {
+      statistics->num_intersects += num_intersects;
+      statistics->intersect_time += SolverWallTime() - start_time;
+    }
     if (num_intersects) {
       CompleteReconstructionLogProgress(update_callback,
                                         (double)tot_resects/(max_image),
                                         "Bundling...");
-      PipelineRoutines::Bundle(tracks, reconstruction);
+      PipelineRoutines::Bundle(tracks, reconstruction, bundle_options);
       LG << "Ran Bundle() after intersections.";
     }
     LG << "Did " << num_intersects << " intersects.";
 
     // Do all possible resections.
     num_resects = 0;
+    start_time = SolverWallTime();
     for (int image = 0; image <= max_image; ++image) {
       if (reconstruction->CameraForImage(image)) {
         LG << "Skipping frame: " << image;
@@ -223,17 +233,22 @@ void InternalCompleteReconstruction(
         }
       }
     }
+    if (statistics) {
+      statistics->num_resects += num_resects;
+      statistics->resect_time += SolverWallTime() - start_time;
+    }
     if (num_resects) {
       CompleteReconstructionLogProgress(update_callback,
                                         (double)tot_resects/(max_image),
                                         "Bundling...");
-      PipelineRoutines::Bundle(tracks, reconstruction);
+      PipelineRoutines::Bundle(tracks, reconstruction, bundle_options);
     }
     LG << "Did " << num_resects << " resects.";
   }
 
   // One last pass...
   num_resects = 0;
+  const double start_time = SolverWallTime();
   for (int image = 0; image <= max_image; ++image) {
     if (reconstruction->CameraForImage(image)) {
       LG << "Skipping frame: " << image;
@@ -259,11 +274,15 @@ void InternalCompleteReconstruction(
       }
     }
   }
+  if (statistics) {
+    statistics->num_resects += num_resects;
+    statistics->resect_time += SolverWallTime() - start_time;
+  }
   if (num_resects) {
     CompleteReconstructionLogProgress(update_callback,
                                       (double)tot_resects/(max_image),
                                       "Bundling...");
-    PipelineRoutines::Bundle(tracks, reconstruction);
+    PipelineRoutines::Bundle(tracks, reconstruction, bundle_options);
   }
 }
 
@@ -340,10 +359,12 @@ double ProjectiveReprojectionError(
 
 void EuclideanCompleteReconstruction(const Tracks &tracks,
                                      EuclideanReconstruction *reconstruction,
-                                     ProgressUpdateCallback *update_callback) {
+                                     ProgressUpdateCallback *update_callback,
+                                     const BundleOptions &bundle_options) {
   InternalCompleteReconstruction<EuclideanPipelineRoutines>(tracks,
                                                             reconstruction,
-                                                            update_callback);
+                                                            update_callback,
+                                                            bundle_options);
 }
 
 void ProjectiveCompleteReconstruction(const Tracks &tracks,
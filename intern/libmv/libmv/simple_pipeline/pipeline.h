@@ -21,6 +21,7 @@
 #ifndef LIBMV_SIMPLE_PIPELINE_PIPELINE_H_
 #define LIBMV_SIMPLE_PIPELINE_PIPELINE_H_
 
+#include "libmv/simple_pipeline/bundle.h"
 #include "libmv/simple_pipeline/callbacks.h"
 #include "libmv/simple_pipeline/tracks.h"
 #include "libmv/simple_pipeline/reconstruction.h"
@@ -44,12 +45,16 @@ namespace libmv {
     cameras. The minimum number of cameras is two (with no 3D points) and the
     minimum number of 3D points (with no estimated cameras) is 5.
 
+    The bundle adjustments use \a bundle_options, the time spent in the
+    intersections and resections is added to its statistics.
+
     \sa EuclideanResect, EuclideanIntersect, EuclideanBundle
 */
 void EuclideanCompleteReconstruction(
         const Tracks &tracks,
         EuclideanReconstruction *reconstruction,
-        ProgressUpdateCallback *update_callback = NULL);
+        ProgressUpdateCallback *update_callback = NULL,
+        const BundleOptions &bundle_options = BundleOptions());
 
 /*!
     Estimate camera matrices and homogeneous 3D coordinates for all frames and
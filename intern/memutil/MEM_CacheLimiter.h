@@ -142,7 +142,8 @@ template<class T> class MEM_CacheLimiter {
   typedef int (*MEM_CacheLimiter_ItemPriority_Func)(void *item, int default_priority);
   typedef bool (*MEM_CacheLimiter_ItemDestroyable_Func)(void *item);
 
-  MEM_CacheLimiter(MEM_CacheLimiter_DataSize_Func data_size_func) : data_size_func(data_size_func)
+  MEM_CacheLimiter(MEM_CacheLimiter_DataSize_Func data_size_func)
+      : data_size_func(data_size_func), max_memory(0)
   {
   }
 
@@ -185,9 +186,15 @@ template<class T> class MEM_CacheLimiter {
     return size;
   }
 
+  /* Limit of this cache only, zero uses the global maximum. */
+  void set_maximum(size_t m)
+  {
+    max_memory = m;
+  }
+
   void enforce_limits()
   {
-    size_t max = MEM_CacheLimiter_get_maximum();
+    size_t max = max_memory ? max_memory : MEM_CacheLimiter_get_maximum();
     bool is_disabled = MEM_CacheLimiter_is_disabled();
     size_t mem_in_use, cur_size;
 
@@ -319,6 +326,7 @@ template<class T> class MEM_CacheLimiter {
   MEM_CacheLimiter_DataSize_Func data_size_func;
   MEM_CacheLimiter_ItemPriority_Func item_priority_func;
   MEM_CacheLimiter_ItemDestroyable_Func item_destroyable_func;
+  size_t max_memory;
 };
 
 #endif  // __MEM_CACHELIMITER_H__
@@ -147,6 +147,12 @@ void MEM_CacheLimiter_ItemDestroyable_Func_set(
 
 size_t MEM_CacheLimiter_get_memory_in_use(MEM_CacheLimiterC *This);
 
+/**
+ * Limit memory of a single cache, instead of the global maximum shared by all of them.
+ * A zero maximum goes back to the global one.
+ */
+void MEM_CacheLimiter_set_cache_maximum(MEM_CacheLimiterC *This, size_t m);
+
 #ifdef __cplusplus
 }
 #endif
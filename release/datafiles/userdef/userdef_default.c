@@ -129,8 +129,9 @@ const UserDef U_default = {
     /** Clamped by half the systems memory. */
     .memcachelimit = 4096,
 
-    .prefetchframes = 0,
     .pad_rot_angle = 15,
+    .sequencer_disk_cache_size_limit = 10,
+    .image_cache_limit = 4096,
     .rvisize = 25,
     .rvibright = 8,
     .recent_files = 10,
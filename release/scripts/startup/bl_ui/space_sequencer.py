@@ -203,6 +203,8 @@ class SEQUENCER_MT_view_cache(Menu):
         col.prop(ed, "show_cache_raw")
         col.prop(ed, "show_cache_preprocessed")
         col.prop(ed, "show_cache_composite")
+        col.separator()
+        col.prop(ed, "show_cache_render_time")
 
 
 class SEQUENCER_MT_range(Menu):
@@ -1808,6 +1810,8 @@ class SEQUENCER_PT_cache_settings(SequencerButtonsPanel, Panel):
         col.prop(ed, "use_cache_composite")
         col.prop(ed, "use_cache_final")
         col.separator()
+        col.prop(ed, "use_cache_compression")
+        col.prop(ed, "use_cache_disk")
         col.prop(ed, "recycle_max_cost")
 
 
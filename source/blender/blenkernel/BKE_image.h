@@ -332,6 +332,10 @@ int BKE_image_get_tile_from_pos(struct Image *ima,
                                 float ofs[2]);
 
 void BKE_image_get_size(struct Image *image, struct ImageUser *iuser, int *width, int *height);
+bool BKE_image_get_tile_size(struct Image *ima,
+                             struct ImageTile *tile,
+                             int *r_width,
+                             int *r_height);
 void BKE_image_get_size_fl(struct Image *image, struct ImageUser *iuser, float size[2]);
 void BKE_image_get_aspect(struct Image *image, float *aspx, float *aspy);
 
@@ -299,6 +299,9 @@ void BKE_sequencer_proxy_rebuild(struct SeqIndexBuildContext *context,
                                  short *do_update,
                                  float *num_frames_prefetched);
 void BKE_sequencer_proxy_rebuild_finish(struct SeqIndexBuildContext *context, bool stop);
+bool BKE_sequencer_proxy_rebuild_supports_threads(struct SeqIndexBuildContext *context);
+void BKE_sequencer_proxy_rebuild_set_num_threads(struct SeqIndexBuildContext *context,
+                                                 int num_threads);
 
 void BKE_sequencer_proxy_set(struct Sequence *seq, bool value);
 /* **********************************************************************
@@ -340,6 +343,7 @@ void BKE_sequencer_cache_iterate(
     bool callback(void *userdata, struct Sequence *seq, int cfra, int cache_type, float cost));
 size_t BKE_sequencer_cache_get_num_items(struct Scene *scene);
 bool BKE_sequencer_cache_is_full(struct Scene *scene);
+void BKE_sequencer_cache_disk_exit(void);
 
 /* **********************************************************************
  * seqprefetch.c
@@ -359,6 +359,10 @@ bool BKE_tracking_reconstruction_finish(struct MovieReconstructContext *context,
 void BKE_tracking_reconstruction_report_error_message(struct MovieReconstructContext *context,
                                                       const char *error_message);
 
+void BKE_tracking_reconstruction_statistics_report(const struct MovieReconstructContext *context,
+                                                   char *message,
+                                                   int message_size);
+
 const char *BKE_tracking_reconstruction_error_message_get(
     const struct MovieReconstructContext *context);
 
@@ -604,6 +604,8 @@ UserDef *BKE_blendfile_userdef_from_defaults(void)
 
   userdef->memcachelimit = min_ii(BLI_system_memory_max_in_megabytes_int() / 2,
                                   userdef->memcachelimit);
+  userdef->image_cache_limit = min_ii(BLI_system_memory_max_in_megabytes_int() / 2,
+                                      userdef->image_cache_limit);
 
   /* Init weight paint range. */
   BKE_colorband_init(&userdef->coba_weight, true);
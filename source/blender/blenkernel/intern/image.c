@@ -159,6 +159,11 @@ static void imagecache_put(Image *image, int index, ImBuf *ibuf)
     image->cache = IMB_moviecache_create(
         "Image Datablock Cache", sizeof(ImageCacheKey), imagecache_hashhash, imagecache_hashcmp);
     IMB_moviecache_set_getdata_callback(image->cache, imagecache_keydata);
+
+    /* UDIM tiles are loaded on first access and freed again when over the image budget. */
+    if (image->source == IMA_SRC_TILED) {
+      IMB_moviecache_use_image_budget(image->cache);
+    }
   }
 
   key.index = index;
@@ -3617,6 +3622,8 @@ bool BKE_image_fill_tile(struct Image *ima,
       width, height, ima->name, planes, is_float, gen_type, color, &ima->colorspace_settings);
 
   if (tile_ibuf != NULL) {
+    /* Generated tiles can't be loaded again, keep them out of the image budget. */
+    tile_ibuf->userflags |= IB_PERSISTENT;
     image_assign_ibuf(ima, tile_ibuf, 0, tile->tile_number);
     BKE_image_release_ibuf(ima, tile_ibuf, NULL);
     tile->ok = 1;
@@ -4899,8 +4906,8 @@ static ImBuf *image_acquire_ibuf(Image *ima, ImageUser *iuser, void **r_lock)
       }
     }
 
-    /* We only want movies and sequences to be memory limited. */
-    if (ibuf != NULL && !ELEM(ima->source, IMA_SRC_MOVIE, IMA_SRC_SEQUENCE)) {
+    /* We only want movies, sequences and UDIM tiles to be memory limited. */
+    if (ibuf != NULL && !ELEM(ima->source, IMA_SRC_MOVIE, IMA_SRC_SEQUENCE, IMA_SRC_TILED)) {
       ibuf->userflags |= IB_PERSISTENT;
     }
   }
@@ -5313,6 +5320,41 @@ bool BKE_image_has_alpha(struct Image *image)
   }
 }
 
+/* Size of a UDIM tile, read from the header of its file when the tile isn't loaded already so
+ * the tile doesn't have to be decoded. */
+bool BKE_image_get_tile_size(Image *ima, ImageTile *tile, int *r_width, int *r_height)
+{
+  ImageUser iuser = {NULL};
+  iuser.tile = tile->tile_number;
+  iuser.ok = true;
+
+  BLI_mutex_lock(image_mutex);
+  ImBuf *ibuf = image_get_cached_ibuf(ima, &iuser, NULL, NULL);
+  BLI_mutex_unlock(image_mutex);
+
+  if (ibuf == NULL && ima->type == IMA_TYPE_IMAGE && !BKE_image_has_packedfile(ima)) {
+    char filepath[FILE_MAX];
+    BKE_image_user_file_path(&iuser, ima, filepath);
+    ibuf = IMB_testiffname(filepath, IB_rect);
+  }
+
+  if (ibuf == NULL) {
+    void *lock;
+    ibuf = BKE_image_acquire_ibuf(ima, &iuser, &lock);
+    if (ibuf != NULL) {
+      *r_width = ibuf->x;
+      *r_height = ibuf->y;
+    }
+    BKE_image_release_ibuf(ima, ibuf, lock);
+    return ibuf != NULL;
+  }
+
+  *r_width = ibuf->x;
+  *r_height = ibuf->y;
+  IMB_freeImBuf(ibuf);
+  return true;
+}
+
 void BKE_image_get_size(Image *image, ImageUser *iuser, int *width, int *height)
 {
   ImBuf *ibuf = NULL;
@@ -21,13 +21,19 @@
  */
 
 #include <stddef.h>
+#include <stdio.h>
 #include <memory.h>
+#include <time.h>
 
 #include "MEM_guardedalloc.h"
 
+#include "DNA_color_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
+#include "DNA_vfont_types.h"
 
+#include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
@@ -35,11 +41,24 @@
 #include "BLI_threads.h"
 #include "BLI_listbase.h"
 #include "BLI_ghash.h"
+#include "BLI_task.h"
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
 
 #include "BKE_sequencer.h"
 #include "BKE_scene.h"
 #include "BKE_main.h"
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#endif
+
 /**
  * Sequencer Cache Design Notes
  * ============================
@@ -63,8 +82,33 @@
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * Compression:
+ * With #SEQ_CACHE_COMPRESS the pixels of cold images, of frames other than the current frame
+ * of the scene, are compressed losslessly by a background task. The bytes of every pixel are
+ * split into planes first, LZO compresses those much better than interleaved floats. Images
+ * are compressed in blocks, which are decompressed in parallel when the image is taken from the
+ * cache again.
+ *
+ * Disk cache:
+ * With #SEQ_CACHE_DISK_CACHE_ENABLE and a disk cache directory set in the preferences, final
+ * and preprocessed images are written to files in the background as well, so they can be read
+ * back instead of rendered after reopening the file. See the disk cache section for how files
+ * are named and limited in size.
  */
 
+typedef struct SeqCacheCompressedBlock {
+  unsigned char *data;
+  /** Size of the compressed data, the same as raw_size when it is stored uncompressed. */
+  size_t size;
+  size_t raw_size;
+} SeqCacheCompressedBlock;
+
+typedef struct SeqCacheCompressedBuffer {
+  SeqCacheCompressedBlock *blocks;
+  int num_blocks;
+} SeqCacheCompressedBuffer;
+
 typedef struct SeqCache {
   struct GHash *hash;
   ThreadMutex iterator_mutex;
@@ -72,11 +116,23 @@ typedef struct SeqCache {
   struct BLI_mempool *items_pool;
   struct SeqCacheKey *last_key;
   size_t memory_used;
+  /** Compresses cold images in the background. */
+  TaskPool *compress_pool;
+  bool compress_scheduled;
+  /** Frame which is kept uncompressed. */
+  int compress_hot_frame;
 } SeqCache;
 
 typedef struct SeqCacheItem {
   struct SeqCache *cache_owner;
   struct ImBuf *ibuf;
+  /** Pixels of ibuf while it is compressed, ibuf has no buffers then. */
+  SeqCacheCompressedBuffer compressed_rect;
+  SeqCacheCompressedBuffer compressed_rect_float;
+  bool is_compressed;
+  bool is_incompressible;
+  /** Size of the item counted in memory_used. */
+  size_t memory_size;
 } SeqCacheItem;
 
 typedef struct SeqCacheKey {
@@ -178,15 +234,1047 @@ static void seq_cache_keyfree(void *val)
   BLI_mempool_free(key->cache_owner->keys_pool, key);
 }
 
+/* ************************** Compression ************************** */
+
+/* Size of the blocks images are compressed in. */
+#define SEQ_CACHE_COMPRESS_BLOCK_SIZE (1024 * 1024)
+
+static void seq_cache_compressed_buffer_free(SeqCacheCompressedBuffer *buffer)
+{
+  for (int i = 0; i < buffer->num_blocks; i++) {
+    MEM_SAFE_FREE(buffer->blocks[i].data);
+  }
+  MEM_SAFE_FREE(buffer->blocks);
+  buffer->num_blocks = 0;
+}
+
+static size_t seq_cache_compressed_buffer_size(const SeqCacheCompressedBuffer *buffer)
+{
+  size_t size = 0;
+  for (int i = 0; i < buffer->num_blocks; i++) {
+    size += buffer->blocks[i].size;
+  }
+  return size;
+}
+
+/* Split the bytes of 4 byte pixels (byte RGBA or float channels) into planes. */
+static void seq_cache_shuffle(unsigned char *dst, const unsigned char *src, size_t size)
+{
+  const size_t num = size / 4;
+  for (size_t i = 0; i < num; i++) {
+    dst[i] = src[i * 4];
+    dst[num + i] = src[i * 4 + 1];
+    dst[num * 2 + i] = src[i * 4 + 2];
+    dst[num * 3 + i] = src[i * 4 + 3];
+  }
+}
+
+static void seq_cache_unshuffle(unsigned char *dst, const unsigned char *src, size_t size)
+{
+  const size_t num = size / 4;
+  for (size_t i = 0; i < num; i++) {
+    dst[i * 4] = src[i];
+    dst[i * 4 + 1] = src[num + i];
+    dst[i * 4 + 2] = src[num * 2 + i];
+    dst[i * 4 + 3] = src[num * 3 + i];
+  }
+}
+
+#define SEQ_CACHE_LZO_OUT_LEN(size) ((size) + (size) / 16 + 64 + 3)
+
+/* Returns the compressed size, blocks are stored uncompressed without LZO. */
+static size_t seq_cache_compress_buffer(SeqCacheCompressedBuffer *buffer,
+                                        const void *data,
+                                        size_t size)
+{
+  const unsigned char *bytes = data;
+  unsigned char *shuffled = MEM_mallocN(SEQ_CACHE_COMPRESS_BLOCK_SIZE, __func__);
+#ifdef WITH_LZO
+  unsigned char *out = MEM_mallocN(SEQ_CACHE_LZO_OUT_LEN(SEQ_CACHE_COMPRESS_BLOCK_SIZE), __func__);
+  void *wrkmem = MEM_mallocN(LZO1X_1_MEM_COMPRESS, __func__);
+#endif
+  size_t total_size = 0;
+
+  buffer->num_blocks = (int)((size + SEQ_CACHE_COMPRESS_BLOCK_SIZE - 1) /
+                             SEQ_CACHE_COMPRESS_BLOCK_SIZE);
+  buffer->blocks = MEM_callocN(sizeof(SeqCacheCompressedBlock) * buffer->num_blocks, __func__);
+
+  for (int i = 0; i < buffer->num_blocks; i++) {
+    SeqCacheCompressedBlock *block = &buffer->blocks[i];
+    const size_t offset = (size_t)i * SEQ_CACHE_COMPRESS_BLOCK_SIZE;
+    block->raw_size = MIN2(SEQ_CACHE_COMPRESS_BLOCK_SIZE, size - offset);
+
+    seq_cache_shuffle(shuffled, bytes + offset, block->raw_size);
+
+#ifdef WITH_LZO
+    lzo_uint out_len = SEQ_CACHE_LZO_OUT_LEN(block->raw_size);
+    const int r = lzo1x_1_compress(shuffled, (lzo_uint)block->raw_size, out, &out_len, wrkmem);
+
+    if (r == LZO_E_OK && out_len < block->raw_size) {
+      block->size = out_len;
+      block->data = MEM_mallocN(out_len, __func__);
+      memcpy(block->data, out, out_len);
+      total_size += block->size;
+      continue;
+    }
+#endif
+    block->size = block->raw_size;
+    block->data = MEM_mallocN(block->raw_size, __func__);
+    memcpy(block->data, shuffled, block->raw_size);
+    total_size += block->size;
+  }
+
+  MEM_freeN(shuffled);
+#ifdef WITH_LZO
+  MEM_freeN(out);
+  MEM_freeN(wrkmem);
+#endif
+
+  return total_size;
+}
+
+typedef struct SeqCacheDecompressData {
+  const SeqCacheCompressedBuffer *buffer;
+  unsigned char *data;
+  /** Set when a block failed to decompress. */
+  bool failed;
+} SeqCacheDecompressData;
+
+static void seq_cache_decompress_block(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SeqCacheDecompressData *decompress_data = userdata;
+  const SeqCacheCompressedBlock *block = &decompress_data->buffer->blocks[i];
+  unsigned char *dst = decompress_data->data + (size_t)i * SEQ_CACHE_COMPRESS_BLOCK_SIZE;
+
+  if (block->size == block->raw_size) {
+    seq_cache_unshuffle(dst, block->data, block->raw_size);
+    return;
+  }
+
+#ifdef WITH_LZO
+  unsigned char *shuffled = MEM_mallocN(block->raw_size, __func__);
+  lzo_uint out_len = block->raw_size;
+  const int r = lzo1x_decompress_safe(
+      block->data, (lzo_uint)block->size, shuffled, &out_len, NULL);
+  if (r == LZO_E_OK && out_len == block->raw_size) {
+    seq_cache_unshuffle(dst, shuffled, block->raw_size);
+  }
+  else {
+    decompress_data->failed = true;
+  }
+  MEM_freeN(shuffled);
+#else
+  BLI_assert(!"Compressed sequencer cache block without LZO support");
+  decompress_data->failed = true;
+#endif
+}
+
+/* Returns false when the data is corrupt, the contents of data are undefined then. */
+static bool seq_cache_decompress_buffer(const SeqCacheCompressedBuffer *buffer, void *data)
+{
+  SeqCacheDecompressData decompress_data = {buffer, data, false};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(
+      0, buffer->num_blocks, &decompress_data, seq_cache_decompress_block, &settings);
+
+  return !decompress_data.failed;
+}
+
+/* Returns false when the image could not be restored, it is freed and the item left without
+ * image then, to be removed by recycling. */
+static bool seq_cache_item_decompress(SeqCacheItem *item)
+{
+  SeqCache *cache = item->cache_owner;
+  ImBuf *ibuf = item->ibuf;
+  bool ok = true;
+
+  if (item->compressed_rect.num_blocks) {
+    imb_addrectImBuf(ibuf);
+    ok &= seq_cache_decompress_buffer(&item->compressed_rect, ibuf->rect);
+    seq_cache_compressed_buffer_free(&item->compressed_rect);
+  }
+  if (item->compressed_rect_float.num_blocks) {
+    imb_addrectfloatImBuf(ibuf);
+    ok &= seq_cache_decompress_buffer(&item->compressed_rect_float, ibuf->rect_float);
+    seq_cache_compressed_buffer_free(&item->compressed_rect_float);
+  }
+  item->is_compressed = false;
+
+  cache->memory_used -= item->memory_size;
+  if (!ok) {
+    IMB_freeImBuf(ibuf);
+    item->ibuf = NULL;
+    item->memory_size = 0;
+    return false;
+  }
+  item->memory_size = IMB_get_size_in_memory(ibuf);
+  cache->memory_used += item->memory_size;
+  return true;
+}
+
+#ifdef WITH_LZO
+static bool seq_cache_item_is_cold(const SeqCache *cache, const SeqCacheKey *key)
+{
+  const SeqCacheItem *item = BLI_ghash_lookup(cache->hash, key);
+  const ImBuf *ibuf = item->ibuf;
+
+  /* Images used outside of the cache are being displayed or rendered with. */
+  return !key->is_temp_cache && !item->is_compressed && !item->is_incompressible && ibuf &&
+         ibuf->refcounter == 0 && (ibuf->rect || ibuf->rect_float) && ibuf->planes <= 32 &&
+         (ibuf->rect == NULL || ibuf->mall & IB_rect) &&
+         (ibuf->rect_float == NULL || (ibuf->mall & IB_rectfloat && ibuf->channels == 4)) &&
+         (int)(key->seq->start + key->nfra) != cache->compress_hot_frame;
+}
+
+/* Compress the image of the item at key, unless it was removed or got used meanwhile. */
+static void seq_cache_compress_item(SeqCache *cache, SeqCacheKey *key)
+{
+  BLI_mutex_lock(&cache->iterator_mutex);
+  SeqCacheItem *item = BLI_ghash_lookup(cache->hash, key);
+  ImBuf *ibuf = NULL;
+  if (item && seq_cache_item_is_cold(cache, key)) {
+    ibuf = item->ibuf;
+    IMB_refImBuf(ibuf);
+  }
+  BLI_mutex_unlock(&cache->iterator_mutex);
+
+  if (ibuf == NULL) {
+    return;
+  }
+
+  /* The cache is not locked while compressing, the item may be removed meanwhile. */
+  SeqCacheCompressedBuffer compressed_rect = {NULL}, compressed_rect_float = {NULL};
+  size_t size = 0, compressed_size = 0;
+  if (ibuf->rect) {
+    size += sizeof(unsigned int) * ibuf->x * ibuf->y;
+    compressed_size += seq_cache_compress_buffer(
+        &compressed_rect, ibuf->rect, sizeof(unsigned int) * ibuf->x * ibuf->y);
+  }
+  if (ibuf->rect_float) {
+    size += sizeof(float) * 4 * ibuf->x * ibuf->y;
+    compressed_size += seq_cache_compress_buffer(
+        &compressed_rect_float, ibuf->rect_float, sizeof(float) * 4 * ibuf->x * ibuf->y);
+  }
+  /* Not worth the time it takes to decompress. */
+  const bool ok = compressed_size <= size / 4 * 3;
+
+  BLI_mutex_lock(&cache->iterator_mutex);
+  item = BLI_ghash_lookup(cache->hash, key);
+  if (item && item->ibuf == ibuf && !ok) {
+    item->is_incompressible = true;
+  }
+  /* Only the cache and this task use the image. */
+  else if (item && item->ibuf == ibuf && ibuf->refcounter == 1 && !item->is_compressed) {
+    if (ibuf->rect) {
+      imb_freerectImBuf(ibuf);
+      item->compressed_rect = compressed_rect;
+      compressed_rect.num_blocks = 0;
+      compressed_rect.blocks = NULL;
+    }
+    if (ibuf->rect_float) {
+      imb_freerectfloatImBuf(ibuf);
+      item->compressed_rect_float = compressed_rect_float;
+      compressed_rect_float.num_blocks = 0;
+      compressed_rect_float.blocks = NULL;
+    }
+    item->is_compressed = true;
+
+    cache->memory_used -= item->memory_size;
+    item->memory_size = IMB_get_size_in_memory(ibuf) +
+                        seq_cache_compressed_buffer_size(&item->compressed_rect) +
+                        seq_cache_compressed_buffer_size(&item->compressed_rect_float);
+    cache->memory_used += item->memory_size;
+  }
+  BLI_mutex_unlock(&cache->iterator_mutex);
+
+  seq_cache_compressed_buffer_free(&compressed_rect);
+  seq_cache_compressed_buffer_free(&compressed_rect_float);
+  IMB_freeImBuf(ibuf);
+}
+
+static void seq_cache_compress_task(TaskPool *__restrict pool,
+                                    void *UNUSED(taskdata),
+                                    int UNUSED(threadid))
+{
+  SeqCache *cache = BLI_task_pool_userdata(pool);
+
+  while (!BLI_task_pool_canceled(pool)) {
+    /* Collect the keys of cold items once, images which went cold while compressing them are
+     * picked up by the next pass. */
+    BLI_mutex_lock(&cache->iterator_mutex);
+    SeqCacheKey *keys = NULL;
+    int num_keys = 0;
+    GHashIterator gh_iter;
+    GHASH_ITER (gh_iter, cache->hash) {
+      SeqCacheKey *cold_key = BLI_ghashIterator_getKey(&gh_iter);
+      if (seq_cache_item_is_cold(cache, cold_key)) {
+        if (keys == NULL) {
+          keys = MEM_mallocN(sizeof(SeqCacheKey) * BLI_ghash_len(cache->hash), __func__);
+        }
+        keys[num_keys++] = *cold_key;
+      }
+    }
+    if (num_keys == 0) {
+      cache->compress_scheduled = false;
+      BLI_mutex_unlock(&cache->iterator_mutex);
+      break;
+    }
+    BLI_mutex_unlock(&cache->iterator_mutex);
+
+    for (int i = 0; i < num_keys && !BLI_task_pool_canceled(pool); i++) {
+      seq_cache_compress_item(cache, &keys[i]);
+    }
+    MEM_freeN(keys);
+  }
+}
+#endif
+
+/* Start compressing cold images, the cache has to be locked. */
+static void seq_cache_compress_schedule(Scene *scene, SeqCache *cache)
+{
+#ifdef WITH_LZO
+  /* The frame being displayed, prefetching renders the frames after it. */
+  cache->compress_hot_frame = scene->r.cfra;
+
+  if ((scene->ed->cache_flag & SEQ_CACHE_COMPRESS) == 0 || cache->compress_scheduled) {
+    return;
+  }
+
+  cache->compress_scheduled = true;
+  BLI_task_pool_push(
+      cache->compress_pool, seq_cache_compress_task, NULL, false, TASK_PRIORITY_LOW);
+#else
+  UNUSED_VARS(scene, cache);
+#endif
+}
+
+/* ************************** Disk cache ************************** */
+
+/* Final and preprocessed images are also written to files, which are kept between sessions.
+ * Files are named after a hash of everything the image is rendered from, so changed strips never
+ * find stale images and no invalidation is needed, unused files are deleted when the directory
+ * exceeds its size limit, the least recently used first. Strips rendered from other data-blocks
+ * (scenes, clips and masks) are not stored on disk, their contents change without the strip
+ * changing. */
+
+#define SEQ_DISK_CACHE_VERSION 1
+#define SEQ_DISK_CACHE_EXT ".seqcache"
+/* Writes waiting for a thread, images rendered meanwhile are not written. */
+#define SEQ_DISK_CACHE_MAX_WRITES 8
+
+typedef struct SeqDiskCacheHeader {
+  char magic[4];
+  int version;
+  int x, y;
+  int planes, channels;
+  int num_rect_blocks;
+  int num_rect_float_blocks;
+  char rect_colorspace[64];
+  char float_colorspace[64];
+} SeqDiskCacheHeader;
+
+typedef struct SeqDiskCacheFile {
+  struct SeqDiskCacheFile *next, *prev;
+  char filepath[FILE_MAX];
+  size_t size;
+  int64_t mtime;
+} SeqDiskCacheFile;
+
+typedef struct SeqDiskCacheWrite {
+  struct SeqDiskCacheWrite *next, *prev;
+  char filepath[FILE_MAX];
+  ImBuf *ibuf;
+  size_t size;
+} SeqDiskCacheWrite;
+
+static ThreadMutex disk_cache_lock = BLI_MUTEX_INITIALIZER;
+
+static struct {
+  /** Directory the files were listed from. */
+  char dirpath[FILE_MAX];
+  /** Files of the directory, least recently used first. */
+  ListBase files;
+  GHash *files_hash;
+  size_t size;
+
+  TaskPool *write_pool;
+  ListBase writes;
+  int num_writes;
+} seq_disk_cache = {{0}};
+
+/* 64 bit FNV-1a. */
+static uint64_t seq_disk_cache_hash(uint64_t hash, const void *data, size_t size)
+{
+  const unsigned char *bytes = data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+#define SEQ_DISK_CACHE_HASH(hash, value) seq_disk_cache_hash(hash, &(value), sizeof(value))
+
+static uint64_t seq_disk_cache_hash_string(uint64_t hash, const char *str)
+{
+  return seq_disk_cache_hash(hash, str, strlen(str) + 1);
+}
+
+static uint64_t seq_disk_cache_hash_curve_mapping(uint64_t hash, const CurveMapping *cumap)
+{
+  hash = SEQ_DISK_CACHE_HASH(hash, cumap->flag);
+  hash = SEQ_DISK_CACHE_HASH(hash, cumap->clipr);
+  hash = SEQ_DISK_CACHE_HASH(hash, cumap->black);
+  hash = SEQ_DISK_CACHE_HASH(hash, cumap->white);
+  hash = SEQ_DISK_CACHE_HASH(hash, cumap->tone);
+  for (int i = 0; i < CM_TOT; i++) {
+    const CurveMap *cuma = &cumap->cm[i];
+    hash = SEQ_DISK_CACHE_HASH(hash, cuma->totpoint);
+    for (int a = 0; a < cuma->totpoint; a++) {
+      hash = SEQ_DISK_CACHE_HASH(hash, cuma->curve[a].x);
+      hash = SEQ_DISK_CACHE_HASH(hash, cuma->curve[a].y);
+      hash = SEQ_DISK_CACHE_HASH(hash, cuma->curve[a].flag);
+    }
+  }
+  return hash;
+}
+
+static bool seq_disk_cache_hash_strip(uint64_t *hash,
+                                      const char *relbase,
+                                      Sequence *seq,
+                                      float cfra);
+
+static bool seq_disk_cache_hash_modifiers(uint64_t *hash,
+                                          const char *relbase,
+                                          Sequence *seq,
+                                          float cfra)
+{
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_id) {
+      return false;
+    }
+    if (smd->mask_sequence &&
+        !seq_disk_cache_hash_strip(hash, relbase, smd->mask_sequence, cfra)) {
+      return false;
+    }
+
+    const int flag = smd->flag & SEQUENCE_MODIFIER_MUTE;
+    *hash = SEQ_DISK_CACHE_HASH(*hash, smd->type);
+    *hash = SEQ_DISK_CACHE_HASH(*hash, flag);
+    *hash = SEQ_DISK_CACHE_HASH(*hash, smd->mask_input_type);
+    *hash = SEQ_DISK_CACHE_HASH(*hash, smd->mask_time);
+
+    switch (smd->type) {
+      case seqModifierType_Curves:
+        *hash = seq_disk_cache_hash_curve_mapping(*hash,
+                                                  &((CurvesModifierData *)smd)->curve_mapping);
+        break;
+      case seqModifierType_HueCorrect:
+        *hash = seq_disk_cache_hash_curve_mapping(
+            *hash, &((HueCorrectModifierData *)smd)->curve_mapping);
+        break;
+      default:
+        /* Settings of other modifiers follow the common data, they have no pointers. */
+        *hash = seq_disk_cache_hash(*hash,
+                                    smd + 1,
+                                    MEM_allocN_len(smd) - sizeof(SequenceModifierData));
+        break;
+    }
+  }
+  return true;
+}
+
+static void seq_disk_cache_hash_effect(uint64_t *hash, Sequence *seq)
+{
+  if (seq->effectdata == NULL) {
+    return;
+  }
+
+  if (seq->type == SEQ_TYPE_TEXT) {
+    TextVars *data = seq->effectdata;
+    *hash = seq_disk_cache_hash_string(*hash, data->text);
+    if (data->text_font) {
+      *hash = seq_disk_cache_hash_string(*hash, data->text_font->name);
+    }
+    *hash = seq_disk_cache_hash(*hash,
+                                &data->text_size,
+                                sizeof(TextVars) - offsetof(TextVars, text_size));
+  }
+  else {
+    *hash = seq_disk_cache_hash(*hash, seq->effectdata, MEM_allocN_len(seq->effectdata));
+  }
+}
+
+/* Files are replaced by rendering them again under the same name. */
+static void seq_disk_cache_hash_file_stat(uint64_t *hash,
+                                          const char *relbase,
+                                          const char *dir,
+                                          const char *name)
+{
+  char filepath[FILE_MAX];
+  BLI_stat_t st;
+  BLI_join_dirfile(filepath, sizeof(filepath), dir, name);
+  BLI_path_abs(filepath, relbase);
+  if (BLI_stat(filepath, &st) == 0) {
+    const int64_t mtime = st.st_mtime, size = st.st_size;
+    *hash = SEQ_DISK_CACHE_HASH(*hash, mtime);
+    *hash = SEQ_DISK_CACHE_HASH(*hash, size);
+  }
+}
+
+static bool seq_disk_cache_hash_strip(uint64_t *hash,
+                                      const char *relbase,
+                                      Sequence *seq,
+                                      float cfra)
+{
+  /* Speed effects depend on the speed of all frames before. */
+  if (ELEM(seq->type, SEQ_TYPE_SCENE, SEQ_TYPE_MOVIECLIP, SEQ_TYPE_MASK, SEQ_TYPE_SPEED)) {
+    return false;
+  }
+
+  const int flag = seq->flag & ~(SELECT | SEQ_LEFTSEL | SEQ_RIGHTSEL | SEQ_OVERLAP | SEQ_LOCK);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->type);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, flag);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->len);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->start);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->startofs);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->endofs);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->startstill);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->endstill);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->machine);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->sat);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->mul);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->streamindex);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->multicam_source);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->effect_fader);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->speed_fader);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->strobe);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->anim_startofs);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->anim_endofs);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->blend_mode);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->blend_opacity);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->alpha_mode);
+  *hash = SEQ_DISK_CACHE_HASH(*hash, seq->views_format);
+
+  Strip *strip = seq->strip;
+  if (strip) {
+    *hash = seq_disk_cache_hash_string(*hash, strip->dir);
+    *hash = seq_disk_cache_hash_string(*hash, strip->colorspace_settings.name);
+    if (strip->stripdata) {
+      const int num_elems = MEM_allocN_len(strip->stripdata) / sizeof(StripElem);
+      for (int i = 0; i < num_elems; i++) {
+        *hash = seq_disk_cache_hash_string(*hash, strip->stripdata[i].name);
+      }
+    }
+    if (strip->crop) {
+      *hash = seq_disk_cache_hash(*hash, strip->crop, sizeof(StripCrop));
+    }
+    if (strip->transform) {
+      *hash = seq_disk_cache_hash(*hash, strip->transform, sizeof(StripTransform));
+    }
+    if (strip->proxy) {
+      *hash = SEQ_DISK_CACHE_HASH(*hash, strip->proxy->tc);
+    }
+
+    if (seq->type == SEQ_TYPE_MOVIE && strip->stripdata) {
+      seq_disk_cache_hash_file_stat(hash, relbase, strip->dir, strip->stripdata->name);
+    }
+    else if (seq->type == SEQ_TYPE_IMAGE) {
+      /* Only the image shown at the frame. */
+      StripElem *s_elem = BKE_sequencer_give_stripelem(seq, (int)cfra);
+      if (s_elem) {
+        seq_disk_cache_hash_file_stat(hash, relbase, strip->dir, s_elem->name);
+      }
+    }
+  }
+
+  seq_disk_cache_hash_effect(hash, seq);
+
+  Sequence *inputs[3] = {seq->seq1, seq->seq2, seq->seq3};
+  for (int i = 0; i < ARRAY_SIZE(inputs); i++) {
+    if (inputs[i] && !seq_disk_cache_hash_strip(hash, relbase, inputs[i], cfra)) {
+      return false;
+    }
+  }
+
+  LISTBASE_FOREACH (Sequence *, seq_meta, &seq->seqbase) {
+    if (!ELEM(seq_meta->type, SEQ_TYPE_SOUND_RAM, SEQ_TYPE_SOUND_HD) &&
+        !seq_disk_cache_hash_strip(hash, relbase, seq_meta, cfra)) {
+      return false;
+    }
+  }
+
+  return seq_disk_cache_hash_modifiers(hash, relbase, seq, cfra);
+}
+
+/* Strips shown at the frame, up to the channel of the strip in the final image key. */
+static bool seq_disk_cache_hash_stack(
+    uint64_t *hash, const char *relbase, ListBase *seqbase, float cfra, int machine)
+{
+  LISTBASE_FOREACH (Sequence *, seq, seqbase) {
+    if (seq->machine > machine || cfra < seq->startdisp || cfra >= seq->enddisp ||
+        ELEM(seq->type, SEQ_TYPE_SOUND_RAM, SEQ_TYPE_SOUND_HD)) {
+      continue;
+    }
+    if (!seq_disk_cache_hash_strip(hash, relbase, seq, cfra)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static ListBase *seq_disk_cache_find_seqbase(Editing *ed, Sequence *seq)
+{
+  if (BLI_findindex(ed->seqbasep, seq) != -1) {
+    return ed->seqbasep;
+  }
+  LISTBASE_FOREACH (MetaStack *, ms, &ed->metastack) {
+    if (BLI_findindex(ms->oldbasep, seq) != -1) {
+      return ms->oldbasep;
+    }
+  }
+  return NULL;
+}
+
+/* The context has to be the one the image is rendered with, prefetching renders with a copy of
+ * the scene which is evaluated at the frame. */
+static bool seq_disk_cache_key(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, uint64_t *r_key)
+{
+  Scene *scene = context->scene;
+  Editing *ed = scene->ed;
+
+  if (!ELEM(type, SEQ_CACHE_STORE_FINAL_OUT, SEQ_CACHE_STORE_PREPROCESSED) || seq == NULL ||
+      ed == NULL || (ed->cache_flag & SEQ_CACHE_DISK_CACHE_ENABLE) == 0 ||
+      context->skip_cache || context->is_proxy_render) {
+    return false;
+  }
+  /* Only used once a directory is chosen in the preferences. */
+  if (U.sequencer_disk_cache_dir[0] == '\0') {
+    return false;
+  }
+
+  /* Main database of prefetching has no file path. */
+  const char *relbase = BKE_main_blendfile_path_from_global();
+  const int version = SEQ_DISK_CACHE_VERSION;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = SEQ_DISK_CACHE_HASH(hash, version);
+  hash = SEQ_DISK_CACHE_HASH(hash, type);
+  hash = SEQ_DISK_CACHE_HASH(hash, cfra);
+  hash = SEQ_DISK_CACHE_HASH(hash, context->rectx);
+  hash = SEQ_DISK_CACHE_HASH(hash, context->recty);
+  hash = SEQ_DISK_CACHE_HASH(hash, context->preview_render_size);
+  hash = SEQ_DISK_CACHE_HASH(hash, context->view_id);
+  hash = SEQ_DISK_CACHE_HASH(hash, scene->r.views_format);
+  hash = SEQ_DISK_CACHE_HASH(hash, scene->r.seq_flag);
+  hash = SEQ_DISK_CACHE_HASH(hash, scene->r.frs_sec);
+  hash = SEQ_DISK_CACHE_HASH(hash, scene->r.frs_sec_base);
+  hash = seq_disk_cache_hash_string(hash, scene->sequencer_colorspace_settings.name);
+
+  bool ok;
+  if (type == SEQ_CACHE_STORE_PREPROCESSED) {
+    /* Both are rendered from the strips below. */
+    ok = !ELEM(seq->type, SEQ_TYPE_MULTICAM, SEQ_TYPE_ADJUSTMENT) &&
+         seq_disk_cache_hash_strip(&hash, relbase, seq, cfra);
+  }
+  else {
+    ListBase *seqbase = seq_disk_cache_find_seqbase(ed, seq);
+    ok = seqbase && seq_disk_cache_hash_stack(&hash, relbase, seqbase, cfra, seq->machine);
+  }
+
+  *r_key = hash;
+  return ok;
+}
+
+static void seq_disk_cache_get_dirpath(char dirpath[FILE_MAX])
+{
+  BLI_strncpy(dirpath, U.sequencer_disk_cache_dir, FILE_MAX);
+}
+
+static void seq_disk_cache_get_filepath(uint64_t key, char filepath[FILE_MAX])
+{
+  char dirpath[FILE_MAX], filename[FILE_MAXFILE];
+  seq_disk_cache_get_dirpath(dirpath);
+  BLI_snprintf(
+      filename, sizeof(filename), "%016llx" SEQ_DISK_CACHE_EXT, (unsigned long long)key);
+  BLI_join_dirfile(filepath, FILE_MAX, dirpath, filename);
+}
+
+static size_t seq_disk_cache_get_size_limit(void)
+{
+  return ((size_t)U.sequencer_disk_cache_size_limit) * 1024 * 1024 * 1024;
+}
+
+static int seq_disk_cache_file_cmp_mtime(const void *a_, const void *b_)
+{
+  const SeqDiskCacheFile *a = a_, *b = b_;
+  return (a->mtime > b->mtime) - (a->mtime < b->mtime);
+}
+
+static void seq_disk_cache_files_free(void)
+{
+  if (seq_disk_cache.files_hash) {
+    BLI_ghash_free(seq_disk_cache.files_hash, NULL, NULL);
+    seq_disk_cache.files_hash = NULL;
+  }
+  BLI_freelistN(&seq_disk_cache.files);
+  seq_disk_cache.size = 0;
+  seq_disk_cache.dirpath[0] = '\0';
+}
+
+static void seq_disk_cache_file_remove(SeqDiskCacheFile *file)
+{
+  BLI_ghash_remove(seq_disk_cache.files_hash, file->filepath, NULL, NULL);
+  BLI_remlink(&seq_disk_cache.files, file);
+  seq_disk_cache.size -= file->size;
+  MEM_freeN(file);
+}
+
+static void seq_disk_cache_file_add(const char *filepath, size_t size, int64_t mtime)
+{
+  SeqDiskCacheFile *file = BLI_ghash_lookup(seq_disk_cache.files_hash, filepath);
+  if (file) {
+    seq_disk_cache_file_remove(file);
+  }
+
+  file = MEM_callocN(sizeof(SeqDiskCacheFile), __func__);
+  BLI_strncpy(file->filepath, filepath, sizeof(file->filepath));
+  file->size = size;
+  file->mtime = mtime;
+  BLI_addtail(&seq_disk_cache.files, file);
+  BLI_ghash_insert(seq_disk_cache.files_hash, file->filepath, file);
+  seq_disk_cache.size += size;
+}
+
+/* List the files of the cache directory, when it is used for the first time or changed. The disk
+ * cache has to be locked. */
+static void seq_disk_cache_files_ensure(void)
+{
+  char dirpath[FILE_MAX];
+  seq_disk_cache_get_dirpath(dirpath);
+
+  if (seq_disk_cache.files_hash && STREQ(dirpath, seq_disk_cache.dirpath)) {
+    return;
+  }
+
+  seq_disk_cache_files_free();
+  BLI_strncpy(seq_disk_cache.dirpath, dirpath, sizeof(seq_disk_cache.dirpath));
+  seq_disk_cache.files_hash = BLI_ghash_str_new(__func__);
+
+  if (!BLI_is_dir(dirpath)) {
+    return;
+  }
+
+  struct direntry *filelist;
+  const unsigned int num_files = BLI_filelist_dir_contents(dirpath, &filelist);
+  for (unsigned int i = 0; i < num_files; i++) {
+    if (BLI_path_extension_check(filelist[i].relname, SEQ_DISK_CACHE_EXT)) {
+      seq_disk_cache_file_add(filelist[i].path, filelist[i].s.st_size, filelist[i].s.st_mtime);
+    }
+  }
+  BLI_filelist_free(filelist, num_files);
+
+  BLI_listbase_sort(&seq_disk_cache.files, seq_disk_cache_file_cmp_mtime);
+}
+
+/* Delete least recently used files, the disk cache has to be locked. */
+static void seq_disk_cache_enforce_limit(void)
+{
+  const size_t size_limit = seq_disk_cache_get_size_limit();
+  while (seq_disk_cache.size > size_limit && seq_disk_cache.files.first) {
+    SeqDiskCacheFile *file = seq_disk_cache.files.first;
+    BLI_delete(file->filepath, false, false);
+    seq_disk_cache_file_remove(file);
+  }
+}
+
+static bool seq_disk_cache_write_buffer(FILE *file, const SeqCacheCompressedBuffer *buffer)
+{
+  for (int i = 0; i < buffer->num_blocks; i++) {
+    const SeqCacheCompressedBlock *block = &buffer->blocks[i];
+    const uint64_t sizes[2] = {block->size, block->raw_size};
+    if (fwrite(sizes, sizeof(sizes), 1, file) != 1 ||
+        fwrite(block->data, block->size, 1, file) != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Returns the size of the file, zero when it could not be written. */
+static size_t seq_disk_cache_write_file(const char *filepath, ImBuf *ibuf)
+{
+  char dirpath[FILE_MAX], filepath_temp[FILE_MAX];
+  BLI_split_dir_part(filepath, dirpath, sizeof(dirpath));
+  if (!BLI_dir_create_recursive(dirpath)) {
+    return 0;
+  }
+
+  SeqCacheCompressedBuffer rect = {NULL}, rect_float = {NULL};
+  size_t size = sizeof(SeqDiskCacheHeader);
+  if (ibuf->rect) {
+    size += seq_cache_compress_buffer(&rect, ibuf->rect, sizeof(unsigned int) * ibuf->x * ibuf->y);
+  }
+  if (ibuf->rect_float) {
+    size += seq_cache_compress_buffer(
+        &rect_float, ibuf->rect_float, sizeof(float) * 4 * ibuf->x * ibuf->y);
+  }
+  size += sizeof(uint64_t) * 2 * (rect.num_blocks + rect_float.num_blocks);
+
+  SeqDiskCacheHeader header = {{0}};
+  memcpy(header.magic, "BSEQ", sizeof(header.magic));
+  header.version = SEQ_DISK_CACHE_VERSION;
+  header.x = ibuf->x;
+  header.y = ibuf->y;
+  header.planes = ibuf->planes;
+  header.channels = ibuf->channels;
+  header.num_rect_blocks = rect.num_blocks;
+  header.num_rect_float_blocks = rect_float.num_blocks;
+  BLI_strncpy(header.rect_colorspace,
+              IMB_colormanagement_get_rect_colorspace(ibuf),
+              sizeof(header.rect_colorspace));
+  BLI_strncpy(header.float_colorspace,
+              IMB_colormanagement_get_float_colorspace(ibuf),
+              sizeof(header.float_colorspace));
+
+  /* Readers never see files which are partially written. */
+  BLI_snprintf(filepath_temp, sizeof(filepath_temp), "%s.tmp", filepath);
+  FILE *file = BLI_fopen(filepath_temp, "wb");
+  bool ok = false;
+  if (file) {
+    ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+         seq_disk_cache_write_buffer(file, &rect) &&
+         seq_disk_cache_write_buffer(file, &rect_float);
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && BLI_rename(filepath_temp, filepath) == 0;
+    if (!ok) {
+      BLI_delete(filepath_temp, false, false);
+    }
+  }
+
+  seq_cache_compressed_buffer_free(&rect);
+  seq_cache_compressed_buffer_free(&rect_float);
+
+  return ok ? size : 0;
+}
+
+static bool seq_disk_cache_read_buffer(FILE *file,
+                                       SeqCacheCompressedBuffer *buffer,
+                                       int num_blocks,
+                                       size_t size)
+{
+  if (num_blocks != (size + SEQ_CACHE_COMPRESS_BLOCK_SIZE - 1) / SEQ_CACHE_COMPRESS_BLOCK_SIZE) {
+    return false;
+  }
+
+  buffer->num_blocks = num_blocks;
+  buffer->blocks = MEM_callocN(sizeof(SeqCacheCompressedBlock) * num_blocks, __func__);
+
+  for (int i = 0; i < num_blocks; i++) {
+    SeqCacheCompressedBlock *block = &buffer->blocks[i];
+    const size_t offset = (size_t)i * SEQ_CACHE_COMPRESS_BLOCK_SIZE;
+    uint64_t sizes[2];
+    if (fread(sizes, sizeof(sizes), 1, file) != 1) {
+      return false;
+    }
+
+    block->size = sizes[0];
+    block->raw_size = sizes[1];
+    if (block->raw_size != MIN2(SEQ_CACHE_COMPRESS_BLOCK_SIZE, size - offset) ||
+        block->size > block->raw_size) {
+      return false;
+    }
+#ifndef WITH_LZO
+    if (block->size != block->raw_size) {
+      return false;
+    }
+#endif
+
+    block->data = MEM_mallocN(block->size, __func__);
+    if (fread(block->data, block->size, 1, file) != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static ImBuf *seq_disk_cache_read_file(const char *filepath)
+{
+  FILE *file = BLI_fopen(filepath, "rb");
+  if (file == NULL) {
+    return NULL;
+  }
+
+  SeqDiskCacheHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, "BSEQ", 4) != 0 ||
+      header.version != SEQ_DISK_CACHE_VERSION || header.x <= 0 || header.y <= 0) {
+    fclose(file);
+    return NULL;
+  }
+  header.rect_colorspace[sizeof(header.rect_colorspace) - 1] = '\0';
+  header.float_colorspace[sizeof(header.float_colorspace) - 1] = '\0';
+
+  SeqCacheCompressedBuffer rect = {NULL}, rect_float = {NULL};
+  const size_t num_pixels = (size_t)header.x * header.y;
+  bool ok = true;
+  if (header.num_rect_blocks) {
+    ok = seq_disk_cache_read_buffer(
+        file, &rect, header.num_rect_blocks, sizeof(unsigned int) * num_pixels);
+  }
+  if (ok && header.num_rect_float_blocks) {
+    ok = seq_disk_cache_read_buffer(
+        file, &rect_float, header.num_rect_float_blocks, sizeof(float) * 4 * num_pixels);
+  }
+  fclose(file);
+
+  ImBuf *ibuf = NULL;
+  if (ok && (rect.num_blocks || rect_float.num_blocks)) {
+    ibuf = IMB_allocImBuf(header.x, header.y, header.planes, 0);
+    if (rect.num_blocks) {
+      imb_addrectImBuf(ibuf);
+      ok = seq_cache_decompress_buffer(&rect, ibuf->rect);
+      IMB_colormanagement_assign_rect_colorspace(ibuf, header.rect_colorspace);
+    }
+    if (ok && rect_float.num_blocks) {
+      imb_addrectfloatImBuf(ibuf);
+      ok = seq_cache_decompress_buffer(&rect_float, ibuf->rect_float);
+      IMB_colormanagement_assign_float_colorspace(ibuf, header.float_colorspace);
+    }
+    if (!ok) {
+      /* Corrupt file, render the image again. */
+      IMB_freeImBuf(ibuf);
+      ibuf = NULL;
+    }
+  }
+
+  seq_cache_compressed_buffer_free(&rect);
+  seq_cache_compressed_buffer_free(&rect_float);
+
+  return ibuf;
+}
+
+static ImBuf *seq_disk_cache_read(uint64_t key)
+{
+  char filepath[FILE_MAX];
+  seq_disk_cache_get_filepath(key, filepath);
+
+  BLI_mutex_lock(&disk_cache_lock);
+  seq_disk_cache_files_ensure();
+  SeqDiskCacheFile *file = BLI_ghash_lookup(seq_disk_cache.files_hash, filepath);
+  if (file) {
+    BLI_remlink(&seq_disk_cache.files, file);
+    BLI_addtail(&seq_disk_cache.files, file);
+  }
+  BLI_mutex_unlock(&disk_cache_lock);
+
+  if (file == NULL) {
+    return NULL;
+  }
+
+  ImBuf *ibuf = seq_disk_cache_read_file(filepath);
+
+  /* The file may have been deleted to enforce the limit while it was read, touching it would
+   * create an empty file then. */
+  BLI_mutex_lock(&disk_cache_lock);
+  file = BLI_ghash_lookup(seq_disk_cache.files_hash, filepath);
+  if (file) {
+    if (ibuf) {
+      /* Keeps the order of use for the next session. */
+      BLI_file_touch(filepath);
+    }
+    else {
+      BLI_delete(filepath, false, false);
+      seq_disk_cache_file_remove(file);
+    }
+  }
+  BLI_mutex_unlock(&disk_cache_lock);
+
+  return ibuf;
+}
+
+static void seq_disk_cache_write_task(TaskPool *__restrict UNUSED(pool),
+                                      void *taskdata,
+                                      int UNUSED(threadid))
+{
+  SeqDiskCacheWrite *write = taskdata;
+  write->size = seq_disk_cache_write_file(write->filepath, write->ibuf);
+}
+
+/* Also called for writes which were canceled before they got to run. */
+static void seq_disk_cache_write_free(TaskPool *__restrict UNUSED(pool),
+                                      void *taskdata,
+                                      int UNUSED(threadid))
+{
+  SeqDiskCacheWrite *write = taskdata;
+
+  BLI_mutex_lock(&disk_cache_lock);
+  BLI_remlink(&seq_disk_cache.writes, write);
+  seq_disk_cache.num_writes--;
+  if (write->size && seq_disk_cache.files_hash) {
+    seq_disk_cache_file_add(write->filepath, write->size, (int64_t)time(NULL));
+    seq_disk_cache_enforce_limit();
+  }
+  BLI_mutex_unlock(&disk_cache_lock);
+
+  IMB_freeImBuf(write->ibuf);
+  MEM_freeN(write);
+}
+
+static void seq_disk_cache_write_async(uint64_t key, ImBuf *ibuf)
+{
+  if (ibuf->rect_float && ibuf->channels != 4) {
+    return;
+  }
+
+  char filepath[FILE_MAX];
+  seq_disk_cache_get_filepath(key, filepath);
+
+  BLI_mutex_lock(&disk_cache_lock);
+  seq_disk_cache_files_ensure();
+
+  bool is_written = seq_disk_cache.write_pool == NULL ||
+                    BLI_ghash_haskey(seq_disk_cache.files_hash, filepath) ||
+                    seq_disk_cache.num_writes >= SEQ_DISK_CACHE_MAX_WRITES;
+  LISTBASE_FOREACH (SeqDiskCacheWrite *, write, &seq_disk_cache.writes) {
+    is_written |= STREQ(write->filepath, filepath);
+  }
+
+  if (!is_written) {
+    SeqDiskCacheWrite *write = MEM_callocN(sizeof(SeqDiskCacheWrite), __func__);
+    BLI_strncpy(write->filepath, filepath, sizeof(write->filepath));
+    write->ibuf = ibuf;
+    IMB_refImBuf(ibuf);
+    BLI_addtail(&seq_disk_cache.writes, write);
+    seq_disk_cache.num_writes++;
+
+    BLI_task_pool_push_ex(seq_disk_cache.write_pool,
+                          seq_disk_cache_write_task,
+                          write,
+                          true,
+                          seq_disk_cache_write_free,
+                          TASK_PRIORITY_LOW);
+  }
+
+  BLI_mutex_unlock(&disk_cache_lock);
+}
+
+/* ************************** Cache items ************************** */
+
 static void seq_cache_valfree(void *val)
 {
   SeqCacheItem *item = (SeqCacheItem *)val;
   SeqCache *cache = item->cache_owner;
 
   if (item->ibuf) {
-    cache->memory_used -= IMB_get_size_in_memory(item->ibuf);
+    cache->memory_used -= item->memory_size;
     IMB_freeImBuf(item->ibuf);
   }
+  seq_cache_compressed_buffer_free(&item->compressed_rect);
+  seq_cache_compressed_buffer_free(&item->compressed_rect_float);
 
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
@@ -194,14 +1282,15 @@ static void seq_cache_valfree(void *val)
 static void seq_cache_put(SeqCache *cache, SeqCacheKey *key, ImBuf *ibuf)
 {
   SeqCacheItem *item;
-  item = BLI_mempool_alloc(cache->items_pool);
+  item = BLI_mempool_calloc(cache->items_pool);
   item->cache_owner = cache;
   item->ibuf = ibuf;
 
   if (BLI_ghash_reinsert(cache->hash, key, item, seq_cache_keyfree, seq_cache_valfree)) {
     IMB_refImBuf(ibuf);
     cache->last_key = key;
-    cache->memory_used += IMB_get_size_in_memory(ibuf);
+    item->memory_size = IMB_get_size_in_memory(ibuf);
+    cache->memory_used += item->memory_size;
   }
 }
 
@@ -210,6 +1299,9 @@ static ImBuf *seq_cache_get(SeqCache *cache, void *key)
   SeqCacheItem *item = BLI_ghash_lookup(cache->hash, key);
 
   if (item && item->ibuf) {
+    if (item->is_compressed && !seq_cache_item_decompress(item)) {
+      return NULL;
+    }
     IMB_refImBuf(item->ibuf);
 
     return item->ibuf;
@@ -442,9 +1534,20 @@ static void BKE_sequencer_cache_create(Scene *scene)
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
     cache->last_key = NULL;
     BLI_mutex_init(&cache->iterator_mutex);
+    /* Background pools can not be created from tasks rendering strips, which put images into
+     * the cache. Rendering a frame always looks it up in the cache first. */
+#ifdef WITH_LZO
+    cache->compress_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), cache);
+#endif
     scene->ed->cache = cache;
   }
   BLI_mutex_unlock(&cache_create_lock);
+
+  BLI_mutex_lock(&disk_cache_lock);
+  if (seq_disk_cache.write_pool == NULL) {
+    seq_disk_cache.write_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), NULL);
+  }
+  BLI_mutex_unlock(&disk_cache_lock);
 }
 
 /* ***************************** API ****************************** */
@@ -478,6 +1581,11 @@ void BKE_sequencer_cache_destruct(Scene *scene)
     return;
   }
 
+  if (cache->compress_pool) {
+    BLI_task_pool_cancel(cache->compress_pool);
+    BLI_task_pool_free(cache->compress_pool);
+  }
+
   BLI_ghash_free(cache->hash, seq_cache_keyfree, seq_cache_valfree);
   BLI_mempool_destroy(cache->keys_pool);
   BLI_mempool_destroy(cache->items_pool);
@@ -495,6 +1603,8 @@ void BKE_sequencer_cache_cleanup_all(Main *bmain)
 void BKE_sequencer_cache_cleanup(Scene *scene)
 {
   BKE_sequencer_prefetch_stop(scene);
+  /* Images loaded ahead may be outdated as well. */
+  IMB_load_async_cancel_all();
 
   SeqCache *cache = seq_cache_get_from_scene(scene);
   if (!cache) {
@@ -572,11 +1682,19 @@ void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
   seq_cache_unlock(scene);
 }
 
-struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
-                                      Sequence *seq,
-                                      float cfra,
-                                      int type)
+static void seq_cache_put_ex(const SeqRenderData *context,
+                             Sequence *seq,
+                             float cfra,
+                             int type,
+                             ImBuf *i,
+                             float cost,
+                             bool use_disk_cache);
+
+static ImBuf *seq_cache_get_ex(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, bool use_disk_cache)
 {
+  const SeqRenderData *render_context = context;
+  Sequence *render_seq = seq;
   Scene *scene = context->scene;
 
   if (context->is_prefetch_render) {
@@ -587,7 +1705,6 @@ struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
 
   if (!scene->ed->cache) {
     BKE_sequencer_cache_create(scene);
-    return NULL;
   }
 
   seq_cache_lock(scene);
@@ -603,12 +1720,34 @@ struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
     key.type = type;
 
     ibuf = seq_cache_get(cache, &key);
+
+    if (ibuf && type == SEQ_CACHE_STORE_FINAL_OUT) {
+      /* Images of other frames went cold. */
+      seq_cache_compress_schedule(scene, cache);
+    }
   }
   seq_cache_unlock(scene);
 
+  uint64_t disk_key;
+  if (ibuf == NULL && use_disk_cache &&
+      seq_disk_cache_key(render_context, render_seq, cfra, type, &disk_key)) {
+    ibuf = seq_disk_cache_read(disk_key);
+    if (ibuf) {
+      seq_cache_put_ex(render_context, render_seq, cfra, type, ibuf, 0.0f, false);
+    }
+  }
+
   return ibuf;
 }
 
+struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context,
+                                      Sequence *seq,
+                                      float cfra,
+                                      int type)
+{
+  return seq_cache_get_ex(context, seq, cfra, type, true);
+}
+
 bool BKE_sequencer_cache_put_if_possible(
     const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *ibuf, float cost)
 {
@@ -631,9 +1770,16 @@ bool BKE_sequencer_cache_put_if_possible(
   }
 }
 
-void BKE_sequencer_cache_put(
-    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *i, float cost)
+static void seq_cache_put_ex(const SeqRenderData *context,
+                             Sequence *seq,
+                             float cfra,
+                             int type,
+                             ImBuf *i,
+                             float cost,
+                             bool use_disk_cache)
 {
+  const SeqRenderData *render_context = context;
+  Sequence *render_seq = seq;
   Scene *scene = context->scene;
 
   if (context->is_prefetch_render) {
@@ -647,7 +1793,7 @@ void BKE_sequencer_cache_put(
   }
 
   /* Prevent reinserting, it breaks cache key linking */
-  ImBuf *test = BKE_sequencer_cache_get(context, seq, cfra, type);
+  ImBuf *test = seq_cache_get_ex(context, seq, cfra, type, false);
   if (test) {
     IMB_freeImBuf(test);
     return;
@@ -712,9 +1858,40 @@ void BKE_sequencer_cache_put(
   /* Reset linking */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
     cache->last_key = NULL;
+    seq_cache_compress_schedule(scene, cache);
   }
 
   seq_cache_unlock(scene);
+
+  uint64_t disk_key;
+  if (use_disk_cache && (flag & type) &&
+      seq_disk_cache_key(render_context, render_seq, cfra, type, &disk_key)) {
+    seq_disk_cache_write_async(disk_key, i);
+  }
+}
+
+void BKE_sequencer_cache_put(
+    const SeqRenderData *context, Sequence *seq, float cfra, int type, ImBuf *i, float cost)
+{
+  seq_cache_put_ex(context, seq, cfra, type, i, cost, true);
+}
+
+void BKE_sequencer_cache_disk_exit(void)
+{
+  BLI_mutex_lock(&disk_cache_lock);
+  TaskPool *pool = seq_disk_cache.write_pool;
+  seq_disk_cache.write_pool = NULL;
+  BLI_mutex_unlock(&disk_cache_lock);
+
+  if (pool) {
+    /* Waits for the running writes, the others are dropped. */
+    BLI_task_pool_cancel(pool);
+    BLI_task_pool_free(pool);
+  }
+
+  BLI_mutex_lock(&disk_cache_lock);
+  seq_disk_cache_files_free();
+  BLI_mutex_unlock(&disk_cache_lock);
 }
 
 size_t BKE_sequencer_cache_get_num_items(struct Scene *scene)
@@ -42,11 +42,13 @@
 
 #include "BLI_math.h"
 #include "BLI_fileops.h"
+#include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_linklist.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -78,6 +80,8 @@
 
 #include "RE_pipeline.h"
 
+#include "PIL_time.h"
+
 #include <pthread.h>
 
 #include "IMB_imbuf.h"
@@ -2254,6 +2258,21 @@ void BKE_sequencer_proxy_rebuild_finish(SeqIndexBuildContext *context, bool stop
   MEM_freeN(context);
 }
 
+/* Movies are built from their own decoder, other strips are rendered by the sequencer and are
+ * built one at a time. */
+bool BKE_sequencer_proxy_rebuild_supports_threads(SeqIndexBuildContext *context)
+{
+  return context->seq->type == SEQ_TYPE_MOVIE;
+}
+
+/* Threads decoding the movie of the strip, lowered when several movies are built at once. */
+void BKE_sequencer_proxy_rebuild_set_num_threads(SeqIndexBuildContext *context, int num_threads)
+{
+  if (context->index_context) {
+    IMB_anim_index_rebuild_set_num_threads(context->index_context, num_threads);
+  }
+}
+
 void BKE_sequencer_proxy_set(struct Sequence *seq, bool value)
 {
   if (value) {
@@ -3001,6 +3020,32 @@ static ImBuf *seq_render_effect_strip_impl(const SeqRenderData *context,
   return out;
 }
 
+/* Number of frames of image strips decoded in the background ahead of the rendered frame. */
+#define SEQ_IMAGE_LOAD_AHEAD 4
+
+static void seq_image_strip_load_ahead(Sequence *seq, StripElem *s_elem, float cfra, int flag)
+{
+  for (int i = 1; i <= SEQ_IMAGE_LOAD_AHEAD; i++) {
+    const int frame = (int)cfra + i;
+    if (frame >= seq->enddisp) {
+      break;
+    }
+
+    StripElem *s_elem_next = BKE_sequencer_give_stripelem(seq, frame);
+    if (s_elem_next == NULL || s_elem_next == s_elem) {
+      /* Still frames. */
+      continue;
+    }
+
+    char name[FILE_MAX];
+    BLI_join_dirfile(name, sizeof(name), seq->strip->dir, s_elem_next->name);
+    BLI_path_abs(name, BKE_main_blendfile_path_from_global());
+    if (!IMB_load_async_request(name, flag, seq->strip->colorspace_settings.name)) {
+      break;
+    }
+  }
+}
+
 static ImBuf *seq_render_image_strip(const SeqRenderData *context,
                                      Sequence *seq,
                                      float UNUSED(nr),
@@ -3103,7 +3148,12 @@ static ImBuf *seq_render_image_strip(const SeqRenderData *context,
   }
   else {
   monoview_image:
-    if ((ibuf = IMB_loadiffname(name, flag, seq->strip->colorspace_settings.name))) {
+    ibuf = IMB_load_async_acquire(name, flag, seq->strip->colorspace_settings.name);
+    /* Decode the next frames while this one is processed, playback of sequences of large
+     * images is bound by decoding them. */
+    seq_image_strip_load_ahead(seq, s_elem, cfra, flag);
+
+    if (ibuf) {
       /* we don't need both (speed reasons)! */
       if (ibuf->rect_float && ibuf->rect) {
         imb_freerectImBuf(ibuf);
@@ -3776,17 +3826,17 @@ static ImBuf *do_render_strip_uncached(const SeqRenderData *context,
   return ibuf;
 }
 
-/* Estimate time spent by the program rendering the strip */
-static clock_t seq_estimate_render_cost_begin(void)
+/* Estimate time spent by the program rendering the strip. Wall clock time, processor time adds
+ * up the time of strips rendered at the same time. */
+static double seq_estimate_render_cost_begin(void)
 {
-  return clock();
+  return PIL_check_seconds_timer();
 }
 
-static float seq_estimate_render_cost_end(Scene *scene, clock_t begin)
+static float seq_estimate_render_cost_end(Scene *scene, double begin)
 {
-  clock_t end = clock();
-  float time_spent = (float)(end - begin);
-  float time_max = (1.0f / scene->r.frs_sec) * CLOCKS_PER_SEC;
+  float time_spent = (float)(PIL_check_seconds_timer() - begin);
+  float time_max = 1.0f / scene->r.frs_sec;
 
   if (time_max != 0) {
     return time_spent / time_max;
@@ -3810,7 +3860,7 @@ static ImBuf *seq_render_strip(const SeqRenderData *context,
   bool is_preprocessed = !ELEM(
       type, SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE, SEQ_TYPE_SCENE, SEQ_TYPE_MOVIECLIP);
 
-  clock_t begin = seq_estimate_render_cost_begin();
+  double begin = seq_estimate_render_cost_begin();
 
   ibuf = BKE_sequencer_cache_get(context, seq, cfra, SEQ_CACHE_STORE_PREPROCESSED);
 
@@ -3931,6 +3981,126 @@ static ImBuf *seq_render_strip_stack_apply_effect(
   return out;
 }
 
+/* Strips rendered on their own before being blended, with the time it took in the cost of
+ * their composite image. */
+typedef struct SeqRenderStripTask {
+  const SeqRenderData *context;
+  SeqRenderState state;
+  Sequence *seq;
+  float cfra;
+  ImBuf *ibuf;
+  float cost;
+} SeqRenderStripTask;
+
+static void seq_render_strip_task_run(SeqRenderStripTask *task)
+{
+  double begin = seq_estimate_render_cost_begin();
+  task->ibuf = seq_render_strip(task->context, &task->state, task->seq, task->cfra);
+  task->cost = seq_estimate_render_cost_end(task->context->scene, begin);
+}
+
+static void seq_render_strip_task(TaskPool *__restrict UNUSED(pool),
+                                  void *taskdata,
+                                  int UNUSED(threadid))
+{
+  seq_render_strip_task_run((SeqRenderStripTask *)taskdata);
+}
+
+/* Strips can be rendered at the same time as other strips when they don't share inputs and only
+ * use code which is safe to run from multiple threads. Scene strips render with their own
+ * depsgraph, text strips use the font cache and movie clips and masks are evaluated on access. */
+static bool seq_render_strip_is_thread_safe(Sequence *seq, GSet *used_seqs)
+{
+  if (seq == NULL) {
+    return true;
+  }
+  if (!BLI_gset_add(used_seqs, seq)) {
+    return false;
+  }
+  if (ELEM(seq->type,
+           SEQ_TYPE_SCENE,
+           SEQ_TYPE_MOVIECLIP,
+           SEQ_TYPE_MASK,
+           SEQ_TYPE_TEXT,
+           SEQ_TYPE_MULTICAM,
+           SEQ_TYPE_ADJUSTMENT)) {
+    return false;
+  }
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_sequence || smd->mask_id) {
+      return false;
+    }
+  }
+  if (!seq_render_strip_is_thread_safe(seq->seq1, used_seqs) ||
+      !seq_render_strip_is_thread_safe(seq->seq2, used_seqs) ||
+      !seq_render_strip_is_thread_safe(seq->seq3, used_seqs)) {
+    return false;
+  }
+  LISTBASE_FOREACH (Sequence *, seq_meta, &seq->seqbase) {
+    if (!seq_render_strip_is_thread_safe(seq_meta, used_seqs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void seq_render_strips(const SeqRenderData *context,
+                              SeqRenderState *state,
+                              Sequence **seq_arr,
+                              const bool *do_render,
+                              int count,
+                              float cfra,
+                              ImBuf **r_ibufs,
+                              float *r_costs)
+{
+  SeqRenderStripTask tasks[MAXSEQ + 1];
+  int num_tasks = 0;
+  bool use_threads = true;
+  GSet *used_seqs = BLI_gset_ptr_new(__func__);
+
+  for (int i = 0; i < count; i++) {
+    if (do_render[i]) {
+      SeqRenderStripTask *task = &tasks[num_tasks++];
+      task->context = context;
+      task->state = *state;
+      task->seq = seq_arr[i];
+      task->cfra = cfra;
+      task->ibuf = NULL;
+      task->cost = 0.0f;
+      use_threads = use_threads && seq_render_strip_is_thread_safe(seq_arr[i], used_seqs);
+    }
+  }
+  BLI_gset_free(used_seqs, NULL);
+
+  if (use_threads && num_tasks > 1) {
+    /* Image strips may request frames from here, background threads can't be started from the
+     * task threads. */
+    IMB_load_async_ensure_threads();
+
+    TaskPool *pool = BLI_task_pool_create(BLI_task_scheduler_get(), NULL);
+    for (int i = 0; i < num_tasks; i++) {
+      BLI_task_pool_push(pool, seq_render_strip_task, &tasks[i], false, TASK_PRIORITY_HIGH);
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+  else {
+    for (int i = 0; i < num_tasks; i++) {
+      seq_render_strip_task_run(&tasks[i]);
+    }
+  }
+
+  for (int i = 0, task_index = 0; i < count; i++) {
+    r_ibufs[i] = NULL;
+    r_costs[i] = 0.0f;
+    if (do_render[i]) {
+      r_ibufs[i] = tasks[task_index].ibuf;
+      r_costs[i] = tasks[task_index].cost;
+      task_index++;
+    }
+  }
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *seqbasep,
@@ -3938,10 +4108,13 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      int chanshown)
 {
   Sequence *seq_arr[MAXSEQ + 1];
+  ImBuf *ibufs[MAXSEQ + 1];
+  float costs[MAXSEQ + 1];
+  bool do_render[MAXSEQ + 1] = {false};
   int count;
   int i;
   ImBuf *out = NULL;
-  clock_t begin;
+  double begin;
 
   count = get_shown_sequences(seqbasep, cfra, chanshown, (Sequence **)&seq_arr);
 
@@ -3949,8 +4122,10 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return NULL;
   }
 
+  /* Find the strips which have to be rendered first, so they can be rendered at the same time
+   * and only blending is left to do from the bottom up. */
+  bool do_effect_on_blank = false;
   for (i = count - 1; i >= 0; i--) {
-    int early_out;
     Sequence *seq = seq_arr[i];
 
     out = BKE_sequencer_cache_get(context, seq, cfra, SEQ_CACHE_STORE_COMPOSITE);
@@ -3959,52 +4134,60 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       break;
     }
     if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-      out = seq_render_strip(context, state, seq, cfra);
+      do_render[i] = true;
       break;
     }
 
-    early_out = seq_get_early_out_for_blend_mode(seq);
+    int early_out = seq_get_early_out_for_blend_mode(seq);
 
-    switch (early_out) {
-      case EARLY_NO_INPUT:
-      case EARLY_USE_INPUT_2:
-        out = seq_render_strip(context, state, seq, cfra);
-        break;
-      case EARLY_USE_INPUT_1:
-        if (i == 0) {
-          out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-        }
-        break;
-      case EARLY_DO_EFFECT:
-        if (i == 0) {
-          begin = seq_estimate_render_cost_begin();
+    if (ELEM(early_out, EARLY_NO_INPUT, EARLY_USE_INPUT_2)) {
+      do_render[i] = true;
+      break;
+    }
+    if (i == 0) {
+      if (early_out == EARLY_USE_INPUT_1) {
+        out = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
+      }
+      else if (early_out == EARLY_DO_EFFECT) {
+        do_render[i] = true;
+        do_effect_on_blank = true;
+      }
+      break;
+    }
+  }
+
+  const int bottom = max_ii(i, 0);
+  for (int k = bottom + 1; k < count; k++) {
+    do_render[k] = seq_get_early_out_for_blend_mode(seq_arr[k]) == EARLY_DO_EFFECT;
+  }
 
-          ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, cfra);
+  seq_render_strips(context, state, seq_arr, do_render, count, cfra, ibufs, costs);
 
-          out = seq_render_strip_stack_apply_effect(context, seq, cfra, ibuf1, ibuf2);
+  if (do_effect_on_blank) {
+    begin = seq_estimate_render_cost_begin();
 
-          float cost = seq_estimate_render_cost_end(context->scene, begin);
-          BKE_sequencer_cache_put(context, seq_arr[i], cfra, SEQ_CACHE_STORE_COMPOSITE, out, cost);
+    ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
+    ImBuf *ibuf2 = ibufs[0];
 
-          IMB_freeImBuf(ibuf1);
-          IMB_freeImBuf(ibuf2);
-        }
-        break;
-    }
-    if (out) {
-      break;
-    }
+    out = seq_render_strip_stack_apply_effect(context, seq_arr[0], cfra, ibuf1, ibuf2);
+
+    float cost = seq_estimate_render_cost_end(context->scene, begin) + costs[0];
+    BKE_sequencer_cache_put(context, seq_arr[0], cfra, SEQ_CACHE_STORE_COMPOSITE, out, cost);
+
+    IMB_freeImBuf(ibuf1);
+    IMB_freeImBuf(ibuf2);
+  }
+  else if (out == NULL) {
+    out = ibufs[bottom];
   }
 
-  i++;
-  for (; i < count; i++) {
+  for (i = bottom + 1; i < count; i++) {
     begin = seq_estimate_render_cost_begin();
     Sequence *seq = seq_arr[i];
 
-    if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
+    if (do_render[i]) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, cfra);
+      ImBuf *ibuf2 = ibufs[i];
 
       out = seq_render_strip_stack_apply_effect(context, seq, cfra, ibuf1, ibuf2);
 
@@ -4012,7 +4195,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       IMB_freeImBuf(ibuf2);
     }
 
-    float cost = seq_estimate_render_cost_end(context->scene, begin);
+    float cost = seq_estimate_render_cost_end(context->scene, begin) + costs[i];
     BKE_sequencer_cache_put(context, seq_arr[i], cfra, SEQ_CACHE_STORE_COMPOSITE, out, cost);
   }
 
@@ -4057,7 +4240,7 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
 
   BKE_sequencer_cache_free_temp_cache(context->scene, context->task_id, cfra);
 
-  clock_t begin = seq_estimate_render_cost_begin();
+  double begin = seq_estimate_render_cost_begin();
   float cost = 0;
 
   if (count && !out) {
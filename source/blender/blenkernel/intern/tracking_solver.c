@@ -34,6 +34,7 @@
 #include "BLI_math.h"
 #include "BLI_listbase.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 
 #include "BLT_translation.h"
 
@@ -62,6 +63,9 @@ typedef struct MovieReconstructContext {
 
   float reprojection_error;
 
+  /* Time spent in the stages of the solver, filled in once solving is done. */
+  libmv_ReconstructionStatistics statistics;
+
   TracksMap *tracks_map;
 
   int sfra, efra;
@@ -484,6 +488,8 @@ static void reconstructionOptionsFromContext(libmv_ReconstructionOptions *recons
   reconstruction_options->keyframe2 = context->keyframe2;
 
   reconstruction_options->refine_intrinsics = context->refine_flags;
+
+  reconstruction_options->num_threads = BLI_system_thread_count();
 }
 
 /* Solve camera/object motion and reconstruct 3D markers position
@@ -540,6 +546,45 @@ void BKE_tracking_reconstruction_solve(MovieReconstructContext *context,
   error = libmv_reprojectionError(context->reconstruction);
 
   context->reprojection_error = error;
+
+  libmv_reconstructionStatistics(context->reconstruction, &context->statistics);
+}
+
+/* Summary of where the solver spent its time, for reporting after a successful solve. */
+void BKE_tracking_reconstruction_statistics_report(const MovieReconstructContext *context,
+                                                   char *message,
+                                                   int message_size)
+{
+  const libmv_ReconstructionStatistics *statistics = &context->statistics;
+
+  /* The tripod solver finds rotations only, there are no keyframes and no points to
+   * intersect or cameras to resect. */
+  if (context->motion_flag & TRACKING_MOTION_MODAL) {
+    BLI_snprintf(message,
+                 message_size,
+                 "Solved in %.2fs (%d bundle adjustments with %d iterations %.2fs)",
+                 statistics->total_time,
+                 statistics->num_bundles,
+                 statistics->num_bundle_iterations,
+                 statistics->bundle_time);
+    return;
+  }
+
+  BLI_snprintf(message,
+               message_size,
+               "Solved in %.2fs (keyframes %.2fs, initialization %.2fs, "
+               "%d intersections %.2fs, %d resections %.2fs, "
+               "%d bundle adjustments with %d iterations %.2fs)",
+               statistics->total_time,
+               statistics->keyframe_selection_time,
+               statistics->initialization_time,
+               statistics->num_intersects,
+               statistics->intersect_time,
+               statistics->num_resects,
+               statistics->resect_time,
+               statistics->num_bundles,
+               statistics->num_bundle_iterations,
+               statistics->bundle_time);
 }
 
 /* Finish reconstruction process by copying reconstructed data
@@ -36,6 +36,7 @@
 #include "BLI_ghash.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
 
 #include "BLT_translation.h"
 
@@ -561,6 +562,25 @@ MovieTrackingMarker *tracking_get_keyframed_marker(MovieTrackingTrack *track,
 
 /*********************** Frame accessr *************************/
 
+/* Frames followed for the tracks, the tracked frame and the reference frames. */
+#define ACCESSOR_MAX_FRAMES 4
+/* Regions requested from a frame before it is converted once for all tracks, fewer regions are
+ * cheaper to convert on their own. */
+#define ACCESSOR_SHARE_MIN_REQUESTS 4
+
+typedef struct AccessFrame {
+  struct AccessFrame *next, *prev;
+  int clip_index;
+  int frame;
+  libmv_InputMode input_mode;
+  int num_requests;
+  /* Converted by the thread doing the request which shares the frame, other threads wait for
+   * it. */
+  ImBuf *ibuf;
+  bool is_building, is_ready;
+  int num_waiting;
+} AccessFrame;
+
 typedef struct AccessCacheKey {
   int clip_index;
   int frame;
@@ -574,8 +594,13 @@ typedef struct AccessCacheKey {
 static unsigned int accesscache_hashhash(const void *key_v)
 {
   const AccessCacheKey *key = (const AccessCacheKey *)key_v;
-  /* TODP(sergey): Need better hashing here for faster frame access. */
-  return key->clip_index << 16 | key->frame;
+  unsigned int hash = key->clip_index << 16 | key->frame;
+  /* Regions of all tracks are cached for the same frames. */
+  if (key->has_region) {
+    hash = BLI_ghashutil_combine_hash(hash, (unsigned int)key->region_min[0]);
+    hash = BLI_ghashutil_combine_hash(hash, (unsigned int)key->region_min[1]);
+  }
+  return hash;
 }
 
 static bool accesscache_hashcmp(const void *a_v, const void *b_v)
@@ -664,31 +689,75 @@ static ImBuf *accessor_get_preprocessed_ibuf(TrackingImageAccessor *accessor,
   return ibuf;
 }
 
-static ImBuf *make_grayscale_ibuf_copy(ImBuf *ibuf)
+static ImBuf *float_ibuf_alloc(int width, int height, int channels)
 {
-  ImBuf *grayscale = IMB_allocImBuf(ibuf->x, ibuf->y, 32, 0);
-
-  BLI_assert(ibuf->channels == 3 || ibuf->channels == 4);
-
   /* TODO(sergey): Bummer, currently IMB API only allows to create 4 channels
    * float buffer, so we do it manually here.
    *
    * Will generalize it later.
    */
-  const size_t size = (size_t)grayscale->x * (size_t)grayscale->y * sizeof(float);
-  grayscale->channels = 1;
-  if ((grayscale->rect_float = MEM_mapallocN(size, "tracking grayscale image")) != NULL) {
-    grayscale->mall |= IB_rectfloat;
-    grayscale->flags |= IB_rectfloat;
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, 0);
+  const size_t size = (size_t)width * (size_t)height * channels * sizeof(float);
+  ibuf->channels = channels;
+  if ((ibuf->rect_float = MEM_mapallocN(size, "tracking float image")) != NULL) {
+    ibuf->mall |= IB_rectfloat;
+    ibuf->flags |= IB_rectfloat;
+  }
+  return ibuf;
+}
+
+typedef struct ConvertIbufData {
+  const ImBuf *src;
+  ImBuf *dst;
+} ConvertIbufData;
 
-    for (int i = 0; i < grayscale->x * grayscale->y; i++) {
-      const float *pixel = ibuf->rect_float + ibuf->channels * i;
+/* Convert a row of a byte or float buffer to a float buffer of 1 or 4 channels. Byte buffers
+ * are not color managed, the tracker works on the display values of those. */
+static void convert_ibuf_row_cb(void *__restrict userdata,
+                                const int y,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ConvertIbufData *data = userdata;
+  const ImBuf *src = data->src;
+  ImBuf *dst = data->dst;
+  float *dst_pixel = dst->rect_float + (size_t)dst->channels * dst->x * y;
+
+  for (int x = 0; x < src->x; x++, dst_pixel += dst->channels) {
+    const size_t index = (size_t)src->x * y + x;
+    float rgba[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    if (src->rect_float != NULL) {
+      memcpy(rgba, src->rect_float + src->channels * index, sizeof(float) * src->channels);
+    }
+    else {
+      rgba_uchar_to_float(rgba, (unsigned char *)(src->rect + index));
+    }
 
-      grayscale->rect_float[i] = 0.2126f * pixel[0] + 0.7152f * pixel[1] + 0.0722f * pixel[2];
+    if (dst->channels == 1) {
+      dst_pixel[0] = 0.2126f * rgba[0] + 0.7152f * rgba[1] + 0.0722f * rgba[2];
+    }
+    else {
+      copy_v4_v4(dst_pixel, rgba);
     }
   }
+}
 
-  return grayscale;
+static ImBuf *convert_ibuf_copy(const ImBuf *ibuf, int channels)
+{
+  ImBuf *result = float_ibuf_alloc(ibuf->x, ibuf->y, channels);
+  if (result->rect_float != NULL) {
+    ConvertIbufData data = {ibuf, result};
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 32;
+    BLI_task_parallel_range(0, ibuf->y, &data, convert_ibuf_row_cb, &settings);
+  }
+  return result;
+}
+
+static ImBuf *make_grayscale_ibuf_copy(ImBuf *ibuf)
+{
+  BLI_assert(ibuf->channels == 3 || ibuf->channels == 4);
+  return convert_ibuf_copy(ibuf, 1);
 }
 
 static void ibuf_to_float_image(const ImBuf *ibuf, libmv_FloatImage *float_image)
@@ -714,6 +783,104 @@ static ImBuf *float_image_to_ibuf(libmv_FloatImage *float_image)
   return ibuf;
 }
 
+/* Frame of the clip as float, or as grayscale. */
+static ImBuf *accessor_frame_build(TrackingImageAccessor *accessor,
+                                   int clip_index,
+                                   int frame,
+                                   libmv_InputMode input_mode)
+{
+  ImBuf *orig_ibuf = accessor_get_preprocessed_ibuf(accessor, clip_index, frame);
+  if (orig_ibuf == NULL) {
+    return NULL;
+  }
+
+  if (input_mode == LIBMV_IMAGE_MODE_RGBA && orig_ibuf->rect_float != NULL) {
+    return orig_ibuf;
+  }
+
+  ImBuf *ibuf = convert_ibuf_copy(orig_ibuf, input_mode == LIBMV_IMAGE_MODE_MONO ? 1 : 4);
+  IMB_freeImBuf(orig_ibuf);
+  return ibuf;
+}
+
+static void accessor_frames_trim(TrackingImageAccessor *accessor)
+{
+  AccessFrame *access_frame = accessor->frames.last;
+  while (access_frame != NULL && accessor->num_frames > ACCESSOR_MAX_FRAMES) {
+    AccessFrame *prev = access_frame->prev;
+    if ((access_frame->is_ready || !access_frame->is_building) &&
+        access_frame->num_waiting == 0) {
+      BLI_remlink(&accessor->frames, access_frame);
+      accessor->num_frames--;
+      if (access_frame->ibuf != NULL) {
+        IMB_freeImBuf(access_frame->ibuf);
+      }
+      MEM_freeN(access_frame);
+    }
+    access_frame = prev;
+  }
+}
+
+/* Get a frame shared by all tracks, the result is to be freed with IMB_freeImBuf(). Returns NULL
+ * while too few regions were requested from the frame, the region is then converted on its
+ * own. */
+static ImBuf *accessor_frame_acquire(TrackingImageAccessor *accessor,
+                                     int clip_index,
+                                     int frame,
+                                     libmv_InputMode input_mode)
+{
+  BLI_mutex_lock(&accessor->frames_lock);
+
+  AccessFrame *access_frame;
+  for (access_frame = accessor->frames.first; access_frame; access_frame = access_frame->next) {
+    if (access_frame->clip_index == clip_index && access_frame->frame == frame &&
+        access_frame->input_mode == input_mode) {
+      break;
+    }
+  }
+
+  if (access_frame == NULL) {
+    access_frame = MEM_callocN(sizeof(AccessFrame), "tracking access frame");
+    access_frame->clip_index = clip_index;
+    access_frame->frame = frame;
+    access_frame->input_mode = input_mode;
+    accessor->num_frames++;
+  }
+  else {
+    BLI_remlink(&accessor->frames, access_frame);
+  }
+  BLI_addhead(&accessor->frames, access_frame);
+  access_frame->num_requests++;
+
+  if (access_frame->is_building) {
+    access_frame->num_waiting++;
+    while (!access_frame->is_ready) {
+      BLI_condition_wait(&accessor->frames_cond, &accessor->frames_lock);
+    }
+    access_frame->num_waiting--;
+  }
+  else if (access_frame->num_requests >= ACCESSOR_SHARE_MIN_REQUESTS) {
+    access_frame->is_building = true;
+    BLI_mutex_unlock(&accessor->frames_lock);
+
+    ImBuf *ibuf = accessor_frame_build(accessor, clip_index, frame, input_mode);
+
+    BLI_mutex_lock(&accessor->frames_lock);
+    access_frame->ibuf = ibuf;
+    access_frame->is_ready = true;
+    BLI_condition_notify_all(&accessor->frames_cond);
+  }
+
+  ImBuf *ibuf = access_frame->ibuf;
+  if (ibuf != NULL) {
+    IMB_refImBuf(ibuf);
+  }
+  accessor_frames_trim(accessor);
+
+  BLI_mutex_unlock(&accessor->frames_lock);
+  return ibuf;
+}
+
 static ImBuf *accessor_get_ibuf(TrackingImageAccessor *accessor,
                                 int clip_index,
                                 int frame,
@@ -744,8 +911,20 @@ static ImBuf *accessor_get_ibuf(TrackingImageAccessor *accessor,
     return ibuf;
   }
   CACHE_PRINTF("Calculate new buffer for frame %d\n", frame);
-  /* And now we do postprocessing of the original frame. */
-  orig_ibuf = accessor_get_preprocessed_ibuf(accessor, clip_index, frame);
+  /* And now we do postprocessing of the original frame. Regions of frames requested by several
+   * tracks are cut from a frame converted once for all of them, in grayscale when nothing else
+   * is to be done with the region. */
+  orig_ibuf = NULL;
+  if (region != NULL) {
+    const bool use_grayscale = (input_mode == LIBMV_IMAGE_MODE_MONO && downscale == 0 &&
+                                transform == NULL);
+    const libmv_InputMode frame_mode = use_grayscale ? LIBMV_IMAGE_MODE_MONO :
+                                                       LIBMV_IMAGE_MODE_RGBA;
+    orig_ibuf = accessor_frame_acquire(accessor, clip_index, frame, frame_mode);
+  }
+  if (orig_ibuf == NULL) {
+    orig_ibuf = accessor_get_preprocessed_ibuf(accessor, clip_index, frame);
+  }
   if (orig_ibuf == NULL) {
     return NULL;
   }
@@ -765,9 +944,20 @@ static ImBuf *accessor_get_ibuf(TrackingImageAccessor *accessor,
     clamped_width = min_ii(clamped_width, orig_ibuf->x - clamped_origin_x);
     clamped_height = min_ii(clamped_height, orig_ibuf->y - clamped_origin_y);
 
-    final_ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
-
-    if (orig_ibuf->rect_float != NULL) {
+    if (orig_ibuf->channels == 1) {
+      final_ibuf = float_ibuf_alloc(width, height, 1);
+      if (final_ibuf->rect_float != NULL) {
+        memset(final_ibuf->rect_float, 0, sizeof(float) * width * height);
+        for (int y = 0; y < clamped_height; y++) {
+          memcpy(final_ibuf->rect_float + (size_t)(y + dst_offset_y) * width + dst_offset_x,
+                 orig_ibuf->rect_float +
+                     (size_t)(y + clamped_origin_y) * orig_ibuf->x + clamped_origin_x,
+                 sizeof(float) * clamped_width);
+        }
+      }
+    }
+    else if (orig_ibuf->rect_float != NULL) {
+      final_ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
       IMB_rectcpy(final_ibuf,
                   orig_ibuf,
                   dst_offset_x,
@@ -778,6 +968,7 @@ static ImBuf *accessor_get_ibuf(TrackingImageAccessor *accessor,
                   clamped_height);
     }
     else {
+      final_ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
       /* TODO(sergey): We don't do any color space or alpha conversion
        * here. Probably Libmv is better to work in the linear space,
        * but keep sRGB space here for compatibility for now.
@@ -979,6 +1170,8 @@ TrackingImageAccessor *tracking_image_accessor_new(MovieClip *clips[MAX_ACCESSOR
                                                     accessor_release_mask_callback);
 
   BLI_spin_init(&accessor->cache_lock);
+  BLI_mutex_init(&accessor->frames_lock);
+  BLI_condition_init(&accessor->frames_cond);
 
   return accessor;
 }
@@ -988,5 +1181,15 @@ void tracking_image_accessor_destroy(TrackingImageAccessor *accessor)
   IMB_moviecache_free(accessor->cache);
   libmv_FrameAccessorDestroy(accessor->libmv_accessor);
   BLI_spin_end(&accessor->cache_lock);
+
+  LISTBASE_FOREACH_MUTABLE (AccessFrame *, access_frame, &accessor->frames) {
+    if (access_frame->ibuf != NULL) {
+      IMB_freeImBuf(access_frame->ibuf);
+    }
+    MEM_freeN(access_frame);
+  }
+  BLI_mutex_end(&accessor->frames_lock);
+  BLI_condition_end(&accessor->frames_cond);
+
   MEM_freeN(accessor);
 }
@@ -37,6 +37,8 @@
 #  endif
 
 #  include "BLI_math_base.h"
+#  include "BLI_task.h"
+#  include "BLI_threads.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_global.h"
@@ -55,6 +57,7 @@
 #  include <libavformat/avformat.h>
 #  include <libavcodec/avcodec.h>
 #  include <libavutil/imgutils.h>
+#  include <libavutil/pixdesc.h>
 #  include <libavutil/rational.h>
 #  include <libavutil/samplefmt.h>
 #  include <libswscale/swscale.h>
@@ -63,6 +66,30 @@
 
 struct StampData;
 
+/* Rows converted above and below the rows of a slice, so its chroma is filtered from the same
+ * rows as when converting the whole frame at once. A multiple of the chroma subsampling. */
+#  define FFMPEG_CONVERT_SLICE_MARGIN 16
+#  define FFMPEG_CONVERT_SLICE_MIN_HEIGHT 128
+
+/* Rendered frames waiting to be encoded, 4K frames take 33MB each. */
+#  define FFMPEG_ENCODE_MAX_QUEUED_FRAMES 4
+
+typedef struct FFMpegConvertSlice {
+  struct SwsContext *sws_ctx;
+  /* Rows of the slice and its margins in the output pixel format. */
+  AVFrame *frame;
+  /* Rows of the slice in the output frame, and of the slice and its margins in the source. */
+  int start, end;
+  int src_start, src_end;
+} FFMpegConvertSlice;
+
+typedef struct FFMpegEncodeFrame {
+  /* Copy of the rendered pixels. */
+  uint8_t *pixels;
+  int cfra;
+  double audio_pts;
+} FFMpegEncodeFrame;
+
 typedef struct FFMpegContext {
   int ffmpeg_type;
   int ffmpeg_codec;
@@ -86,6 +113,20 @@ typedef struct FFMpegContext {
   /* Image frame in Blender's own pixel format, may need conversion to the output pixel format. */
   AVFrame *img_convert_frame;
   struct SwsContext *img_convert_ctx;
+  /* Bands of rows converted by separate threads, instead of by img_convert_ctx. */
+  FFMpegConvertSlice *convert_slices;
+  int num_convert_slices;
+
+  /* Frames are converted and encoded by a thread while the next frame renders, the thread
+   * writes the audio as well so only it accesses the output file. */
+  ListBase encode_thread;
+  ThreadQueue *encode_queue;
+  ThreadMutex encode_mutex;
+  ThreadCondition encode_cond;
+  int encode_num_pending;
+  bool encode_error;
+  /* Reports of the render, for errors of the frames still queued when the movie ends. */
+  ReportList *reports;
 
   uint8_t *audio_input_buffer;
   uint8_t *audio_deinterleave_buffer;
@@ -337,8 +378,7 @@ static const char **get_file_extensions(int format)
 }
 
 /* Write a frame to the output file */
-static int write_video_frame(
-    FFMpegContext *context, RenderData *rd, int cfra, AVFrame *frame, ReportList *reports)
+static int write_video_frame(FFMpegContext *context, int cfra, AVFrame *frame)
 {
   int got_output;
   int ret, success = 1;
@@ -375,17 +415,48 @@ static int write_video_frame(
     success = 0;
   }
 
-  if (!success) {
-    BKE_report(reports, RPT_ERROR, "Error writing frame");
-  }
-
   return success;
 }
 
+static void convert_video_frame_slice(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  FFMpegContext *context = userdata;
+  FFMpegConvertSlice *slice = &context->convert_slices[i];
+  AVFrame *src = context->img_convert_frame;
+  AVFrame *dst = context->current_frame;
+
+  const uint8_t *src_data[4] = {
+      src->data[0] + (size_t)src->linesize[0] * slice->src_start, NULL, NULL, NULL};
+  sws_scale(slice->sws_ctx,
+            (const uint8_t *const *)src_data,
+            src->linesize,
+            0,
+            slice->src_end - slice->src_start,
+            slice->frame->data,
+            slice->frame->linesize);
+
+  /* Copy the rows of the slice without its margins. */
+  const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(dst->format);
+  const int num_planes = av_pix_fmt_count_planes(dst->format);
+  for (int plane = 0; plane < num_planes; plane++) {
+    const int shift = ELEM(plane, 1, 2) ? desc->log2_chroma_h : 0;
+    const int start = slice->start >> shift;
+    const int end = -((-slice->end) >> shift);
+    const int offset = (slice->start - slice->src_start) >> shift;
+
+    av_image_copy_plane(dst->data[plane] + (size_t)dst->linesize[plane] * start,
+                        dst->linesize[plane],
+                        slice->frame->data[plane] + (size_t)slice->frame->linesize[plane] * offset,
+                        slice->frame->linesize[plane],
+                        av_image_get_linesize(dst->format, dst->width, plane),
+                        end - start);
+  }
+}
+
 /* read and encode a frame of audio from the buffer */
-static AVFrame *generate_video_frame(FFMpegContext *context,
-                                     const uint8_t *pixels,
-                                     ReportList *reports)
+static AVFrame *generate_video_frame(FFMpegContext *context, const uint8_t *pixels)
 {
   AVCodecContext *c = context->video_stream->codec;
   int height = c->height;
@@ -427,7 +498,14 @@ static AVFrame *generate_video_frame(FFMpegContext *context,
   }
 
   /* Convert to the output pixel format, if it's different that Blender's internal one. */
-  if (context->img_convert_frame != NULL) {
+  if (context->num_convert_slices) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(
+        0, context->num_convert_slices, context, convert_video_frame_slice, &settings);
+  }
+  else if (context->img_convert_frame != NULL) {
     BLI_assert(context->img_convert_ctx != NULL);
     sws_scale(context->img_convert_ctx,
               (const uint8_t *const *)rgb_frame->data,
@@ -538,6 +616,68 @@ static void set_ffmpeg_properties(RenderData *rd,
 
 /* prepare a video stream for the output file */
 
+static void free_convert_slices(FFMpegContext *context)
+{
+  for (int i = 0; i < context->num_convert_slices; i++) {
+    FFMpegConvertSlice *slice = &context->convert_slices[i];
+    if (slice->sws_ctx) {
+      sws_freeContext(slice->sws_ctx);
+    }
+    delete_picture(slice->frame);
+  }
+  MEM_SAFE_FREE(context->convert_slices);
+  context->num_convert_slices = 0;
+}
+
+/* Split the conversion to the output pixel format into bands of rows for the threads, each with
+ * its own scaling context. */
+static void alloc_convert_slices(FFMpegContext *context, AVCodecContext *c)
+{
+  const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(c->pix_fmt);
+  const int num_threads = BLI_system_thread_count();
+
+  if (desc == NULL || (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM)) ||
+      desc->log2_chroma_h > 2 || num_threads < 2 ||
+      c->height < 2 * FFMPEG_CONVERT_SLICE_MIN_HEIGHT) {
+    return;
+  }
+
+  int slice_height = max_ii(c->height / num_threads, FFMPEG_CONVERT_SLICE_MIN_HEIGHT);
+  slice_height = (slice_height + FFMPEG_CONVERT_SLICE_MARGIN - 1) /
+                 FFMPEG_CONVERT_SLICE_MARGIN * FFMPEG_CONVERT_SLICE_MARGIN;
+  const int num_slices = (c->height + slice_height - 1) / slice_height;
+
+  context->convert_slices = MEM_callocN(sizeof(FFMpegConvertSlice) * num_slices, __func__);
+  context->num_convert_slices = num_slices;
+
+  for (int i = 0; i < num_slices; i++) {
+    FFMpegConvertSlice *slice = &context->convert_slices[i];
+    slice->start = i * slice_height;
+    slice->end = min_ii(slice->start + slice_height, c->height);
+    slice->src_start = max_ii(slice->start - FFMPEG_CONVERT_SLICE_MARGIN, 0);
+    slice->src_end = min_ii(slice->end + FFMPEG_CONVERT_SLICE_MARGIN, c->height);
+
+    const int height = slice->src_end - slice->src_start;
+    slice->frame = alloc_picture(c->pix_fmt, c->width, height);
+    slice->sws_ctx = sws_getContext(c->width,
+                                    height,
+                                    AV_PIX_FMT_RGBA,
+                                    c->width,
+                                    height,
+                                    c->pix_fmt,
+                                    SWS_BICUBIC,
+                                    NULL,
+                                    NULL,
+                                    NULL);
+
+    if (slice->frame == NULL || slice->sws_ctx == NULL) {
+      /* Convert the whole frame at once. */
+      free_convert_slices(context);
+      return;
+    }
+  }
+}
+
 static AVStream *alloc_video_stream(FFMpegContext *context,
                                     RenderData *rd,
                                     int codec_id,
@@ -564,7 +704,7 @@ static AVStream *alloc_video_stream(FFMpegContext *context,
 
   c = st->codec;
   c->thread_count = 0;
-  c->thread_type = FF_THREAD_FRAME;
+  c->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
 
   c->codec_id = codec_id;
   c->codec_type = AVMEDIA_TYPE_VIDEO;
@@ -746,6 +886,7 @@ static AVStream *alloc_video_stream(FFMpegContext *context,
                                               NULL,
                                               NULL,
                                               NULL);
+    alloc_convert_slices(context, c);
   }
 
   return st;
@@ -1287,6 +1428,100 @@ void BKE_ffmpeg_filepath_get(char *string, RenderData *rd, bool preview, const c
   ffmpeg_filepath_get(NULL, string, rd, preview, suffix);
 }
 
+#  ifdef WITH_AUDASPACE
+static void write_audio_frames(FFMpegContext *context, double to_pts)
+{
+  int finished = 0;
+
+  while (context->audio_stream && !finished) {
+    if ((context->audio_time >= to_pts) || (write_audio_frame(context))) {
+      finished = 1;
+    }
+  }
+}
+#  endif
+
+static bool encode_frame(FFMpegContext *context, FFMpegEncodeFrame *frame)
+{
+  bool success = true;
+
+  if (context->video_stream) {
+    AVFrame *avframe = generate_video_frame(context, frame->pixels);
+    success = (avframe && write_video_frame(context, frame->cfra, avframe));
+  }
+
+#  ifdef WITH_AUDASPACE
+  write_audio_frames(context, frame->audio_pts);
+#  endif
+  return success;
+}
+
+static void *encode_thread(void *context_v)
+{
+  FFMpegContext *context = context_v;
+  FFMpegEncodeFrame *frame;
+
+  while ((frame = BLI_thread_queue_pop(context->encode_queue))) {
+    /* Frames after an error are dropped, the render stops at the next frame. */
+    const bool success = !context->encode_error && encode_frame(context, frame);
+
+    MEM_freeN(frame->pixels);
+    MEM_freeN(frame);
+
+    BLI_mutex_lock(&context->encode_mutex);
+    context->encode_error |= !success;
+    context->encode_num_pending--;
+    BLI_condition_notify_all(&context->encode_cond);
+    BLI_mutex_unlock(&context->encode_mutex);
+  }
+
+  return NULL;
+}
+
+static void encode_thread_begin(FFMpegContext *context)
+{
+  context->encode_queue = BLI_thread_queue_init();
+  BLI_mutex_init(&context->encode_mutex);
+  BLI_condition_init(&context->encode_cond);
+  context->encode_num_pending = 0;
+  context->encode_error = false;
+
+  BLI_threadpool_init(&context->encode_thread, encode_thread, 1);
+  BLI_threadpool_insert(&context->encode_thread, context);
+}
+
+/* Wait until no more than max_pending frames are waiting or being encoded, returns false when
+ * encoding a frame failed. */
+static bool encode_thread_wait(FFMpegContext *context, int max_pending)
+{
+  BLI_mutex_lock(&context->encode_mutex);
+  while (context->encode_num_pending > max_pending) {
+    BLI_condition_wait(&context->encode_cond, &context->encode_mutex);
+  }
+  const bool success = !context->encode_error;
+  BLI_mutex_unlock(&context->encode_mutex);
+  return success;
+}
+
+/* Encode the frames still queued and stop the thread, returns false when encoding a frame
+ * failed. */
+static bool encode_thread_end(FFMpegContext *context)
+{
+  if (context->encode_queue == NULL) {
+    return true;
+  }
+
+  BLI_thread_queue_nowait(context->encode_queue);
+  BLI_threadpool_end(&context->encode_thread);
+  BLI_thread_queue_free(context->encode_queue);
+  context->encode_queue = NULL;
+
+  BLI_condition_end(&context->encode_cond);
+  BLI_mutex_end(&context->encode_mutex);
+
+  return !context->encode_error;
+}
+
 int BKE_ffmpeg_start(void *context_v,
                      struct Scene *scene,
                      RenderData *rd,
@@ -1302,6 +1537,7 @@ int BKE_ffmpeg_start(void *context_v,
   context->ffmpeg_autosplit_count = 0;
   context->ffmpeg_preview = preview;
   context->stamp_data = BKE_stamp_info_from_scene_static(scene);
+  context->reports = reports;
 
   success = start_ffmpeg_impl(context, rd, rectx, recty, suffix, reports);
 #  ifdef WITH_AUDASPACE
@@ -1339,24 +1575,15 @@ int BKE_ffmpeg_start(void *context_v,
 #    endif
   }
 #  endif
+
+  if (success && context->video_stream) {
+    encode_thread_begin(context);
+  }
   return success;
 }
 
 static void end_ffmpeg_impl(FFMpegContext *context, int is_autosplit);
 
-#  ifdef WITH_AUDASPACE
-static void write_audio_frames(FFMpegContext *context, double to_pts)
-{
-  int finished = 0;
-
-  while (context->audio_stream && !finished) {
-    if ((context->audio_time >= to_pts) || (write_audio_frame(context))) {
-      finished = 1;
-    }
-  }
-}
-#  endif
-
 int BKE_ffmpeg_append(void *context_v,
                       RenderData *rd,
                       int start_frame,
@@ -1368,7 +1595,6 @@ int BKE_ffmpeg_append(void *context_v,
                       ReportList *reports)
 {
   FFMpegContext *context = context_v;
-  AVFrame *avframe;
   int success = 1;
 
   PRINT("Writing frame %i, render width=%d, render height=%d\n", frame, rectx, recty);
@@ -1376,23 +1602,48 @@ int BKE_ffmpeg_append(void *context_v,
   /* why is this done before writing the video frame and again at end_ffmpeg? */
   //  write_audio_frames(frame / (((double)rd->frs_sec) / rd->frs_sec_base));
 
+  FFMpegEncodeFrame *encode_frame_data = MEM_mallocN(sizeof(FFMpegEncodeFrame), __func__);
+  encode_frame_data->pixels = NULL;
+  encode_frame_data->cfra = frame - start_frame;
+  encode_frame_data->audio_pts = (frame - start_frame) /
+                                 (((double)rd->frs_sec) / (double)rd->frs_sec_base);
+
   if (context->video_stream) {
-    avframe = generate_video_frame(context, (unsigned char *)pixels, reports);
-    success = (avframe && write_video_frame(context, rd, frame - start_frame, avframe, reports));
-
-    if (context->ffmpeg_autosplit) {
-      if (avio_tell(context->outfile->pb) > FFMPEG_AUTOSPLIT_SIZE) {
-        end_ffmpeg_impl(context, true);
-        context->ffmpeg_autosplit_count++;
-        success &= start_ffmpeg_impl(context, rd, rectx, recty, suffix, reports);
-      }
+    const size_t size = (size_t)rectx * recty * 4;
+    encode_frame_data->pixels = MEM_mallocN(size, "FFmpeg encode pixels");
+    memcpy(encode_frame_data->pixels, pixels, size);
+  }
+
+  if (context->encode_queue) {
+    success = encode_thread_wait(context, FFMPEG_ENCODE_MAX_QUEUED_FRAMES - 1);
+
+    BLI_mutex_lock(&context->encode_mutex);
+    context->encode_num_pending++;
+    BLI_mutex_unlock(&context->encode_mutex);
+    BLI_thread_queue_push(context->encode_queue, encode_frame_data);
+  }
+  else {
+    success = encode_frame(context, encode_frame_data);
+    MEM_SAFE_FREE(encode_frame_data->pixels);
+    MEM_freeN(encode_frame_data);
+  }
+
+  if (context->video_stream && context->ffmpeg_autosplit) {
+    /* The size of the file is known once the thread wrote all frames. */
+    if (context->encode_queue) {
+      success &= encode_thread_wait(context, 0);
+    }
+    if (avio_tell(context->outfile->pb) > FFMPEG_AUTOSPLIT_SIZE) {
+      end_ffmpeg_impl(context, true);
+      context->ffmpeg_autosplit_count++;
+      success &= start_ffmpeg_impl(context, rd, rectx, recty, suffix, reports);
     }
   }
 
-#  ifdef WITH_AUDASPACE
-  write_audio_frames(context,
-                     (frame - start_frame) / (((double)rd->frs_sec) / (double)rd->frs_sec_base));
-#  endif
+  if (!success) {
+    BKE_report(reports, RPT_ERROR, "Error writing frame");
+  }
+
   return success;
 }
 
@@ -1470,11 +1721,15 @@ static void end_ffmpeg_impl(FFMpegContext *context, int is_autosplit)
     sws_freeContext(context->img_convert_ctx);
     context->img_convert_ctx = NULL;
   }
+  free_convert_slices(context);
 }
 
 void BKE_ffmpeg_end(void *context_v)
 {
   FFMpegContext *context = context_v;
+  if (!encode_thread_end(context) && context->reports) {
+    BKE_report(context->reports, RPT_ERROR, "Error writing frame");
+  }
   end_ffmpeg_impl(context, false);
 }
 
@@ -1886,6 +2141,7 @@ void BKE_ffmpeg_context_free(void *context_v)
   if (context == NULL) {
     return;
   }
+  encode_thread_end(context);
   if (context->stamp_data) {
     MEM_freeN(context->stamp_data);
   }
@@ -140,6 +140,12 @@ typedef struct TrackingImageAccessor {
   int start_frame;
   struct libmv_FrameAccessor *libmv_accessor;
   SpinLock cache_lock;
+  /* Frames requested by the tracks, converted once when several of them share a frame. Most
+   * recently used first. */
+  ListBase frames;
+  int num_frames;
+  ThreadMutex frames_lock;
+  ThreadCondition frames_cond;
 } TrackingImageAccessor;
 
 TrackingImageAccessor *tracking_image_accessor_new(MovieClip *clips[MAX_ACCESSOR_CLIP],
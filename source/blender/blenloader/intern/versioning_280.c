@@ -4527,5 +4527,19 @@ void blo_do_versions_280(FileData *fd, Library *UNUSED(lib), Main *bmain)
         }
       }
     }
+
+    if (!DNA_struct_elem_find(fd->filesdna, "bNodeTree", "int", "cache_size")) {
+      LISTBASE_FOREACH (Scene *, scene, &bmain->scenes) {
+        if (scene->nodetree) {
+          scene->nodetree->cache_size = 512;
+        }
+      }
+    }
+
+    if (!DNA_struct_elem_find(fd->filesdna, "BakeData", "short", "tile_size")) {
+      LISTBASE_FOREACH (Scene *, scene, &bmain->scenes) {
+        scene->r.bake.tile_size = 1024;
+      }
+    }
   }
 }
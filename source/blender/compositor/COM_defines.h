@@ -46,6 +46,18 @@ typedef enum CompositorQuality {
   COM_QUALITY_LOW = 2,
 } CompositorQuality;
 
+/**
+ * \brief Possible execution models
+ * \see CompositorContext.getExecutionModel
+ * \ingroup Execution
+ */
+typedef enum CompositorExecutionModel {
+  /** \brief Evaluate per pixel, in chunks scheduled on the WorkScheduler */
+  COM_EXECUTION_MODEL_TILED = 0,
+  /** \brief Evaluate operations one after another over whole buffers */
+  COM_EXECUTION_MODEL_FULL_FRAME = 1,
+} CompositorExecutionModel;
+
 /**
  * \brief Possible priority settings
  * \ingroup Execution
@@ -63,6 +75,8 @@ typedef enum CompositorPriority {
 
 // chunk size determination
 #define COM_PREVIEW_SIZE 140.0f
+/* number of pixels calculated at once by the full frame execution model */
+#define COM_FULL_FRAME_BAND_PIXELS (256 * 256)
 #define COM_OPENCL_ENABLED
 //#define COM_DEBUG
 
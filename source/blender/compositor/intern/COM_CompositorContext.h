@@ -268,6 +268,26 @@ class CompositorContext {
   {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
+
+  /**
+   * \brief memory limit in bytes of the results kept between executions, 0 when disabled
+   * \note results are not kept when rendering, every frame differs
+   */
+  size_t getResultCacheLimit() const
+  {
+    if (this->m_rendering) {
+      return 0;
+    }
+    return (size_t)this->getbNodeTree()->cache_size * 1024 * 1024;
+  }
+
+  /**
+   * \brief get the execution model of the node tree
+   */
+  CompositorExecutionModel getExecutionModel() const
+  {
+    return (CompositorExecutionModel)this->getbNodeTree()->execution_mode;
+  }
 };
 
 #endif
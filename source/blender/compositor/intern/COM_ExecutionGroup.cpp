@@ -24,6 +24,7 @@
 #include "atomic_ops.h"
 
 #include "COM_ExecutionGroup.h"
+#include "COM_CPUDevice.h"
 #include "COM_defines.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_ReadBufferOperation.h"
@@ -57,6 +58,7 @@ ExecutionGroup::ExecutionGroup()
   this->m_openCL = false;
   this->m_singleThreaded = false;
   this->m_chunksFinished = 0;
+  this->m_fullFrameBandHeight = 0;
   BLI_rcti_init(&this->m_viewerBorder, 0, 0, 0, 0);
   this->m_executionStartTime = 0;
 }
@@ -371,6 +373,75 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
   MEM_freeN(chunkOrder);
 }
 
+void ExecutionGroup::executeFullFrame(ExecutionSystem *graph)
+{
+  const CompositorContext &context = graph->getContext();
+  const bNodeTree *bTree = context.getbNodeTree();
+  if (this->m_width == 0 || this->m_height == 0) {
+    return;
+  }  /// \note Break out... no pixels to calculate.
+  if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+    return;
+  }
+
+  const int border_width = BLI_rcti_size_x(&this->m_viewerBorder);
+  const int border_height = BLI_rcti_size_y(&this->m_viewerBorder);
+  if (border_width <= 0 || border_height <= 0) {
+    return;
+  }
+
+  this->m_executionStartTime = PIL_check_seconds_timer();
+  this->m_bTree = bTree;
+
+  /* bands hold about as many pixels as a chunk of the tiled execution model */
+  int band_height = border_height;
+  if (!this->m_singleThreaded) {
+    band_height = max_ii(1, (COM_FULL_FRAME_BAND_PIXELS + border_width - 1) / border_width);
+  }
+  this->m_fullFrameBandHeight = band_height;
+  const int num_bands = (border_height + band_height - 1) / band_height;
+
+  DebugInfo::execution_group_started(this);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = !this->m_singleThreaded && num_bands > 1;
+  BLI_task_parallel_range(0, num_bands, this, executeFullFrameBand, &settings);
+
+  DebugInfo::execution_group_finished(this);
+
+  this->m_bTree = NULL;
+}
+
+void ExecutionGroup::executeFullFrameBand(void *__restrict userdata,
+                                          const int band,
+                                          const TaskParallelTLS *__restrict tls)
+{
+  ExecutionGroup *group = (ExecutionGroup *)userdata;
+  const bNodeTree *bTree = group->m_bTree;
+  if (bTree->test_break && bTree->test_break(bTree->tbh)) {
+    return;
+  }
+
+  const rcti &border = group->m_viewerBorder;
+  const int ymin = border.ymin + band * group->m_fullFrameBandHeight;
+  const int ymax = min_ii(ymin + group->m_fullFrameBandHeight, border.ymax);
+  rcti rect;
+  BLI_rcti_init(&rect,
+                border.xmin,
+                min_ii(border.xmax, (int)group->m_width),
+                ymin,
+                min_ii(ymax, (int)group->m_height));
+
+  /* operations using the thread id expect to run on a CPUDevice */
+  CPUDevice device(tls->thread_id);
+  CPUDevice *previous_device = WorkScheduler::set_thread_device(&device);
+
+  group->getOutputOperation()->executeRegion(&rect, band);
+
+  WorkScheduler::set_thread_device(previous_device);
+}
+
 MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
 {
   rcti rect;
@@ -403,6 +474,23 @@ MemoryBuffer *ExecutionGroup::constructConsolidatedMemoryBuffer(MemoryProxy *mem
   return result;
 }
 
+void ExecutionGroup::setChunksExecuted()
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+  }
+}
+
+bool ExecutionGroup::areChunksExecuted() const
+{
+  for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+    if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers)
 {
   if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED) {
@@ -23,6 +23,7 @@
 #include "COM_NodeOperation.h"
 #include <vector>
 #include "BLI_rect.h"
+#include "BLI_task.h"
 #include "COM_MemoryProxy.h"
 #include "COM_Device.h"
 #include "COM_CompositorContext.h"
@@ -147,6 +148,11 @@ class ExecutionGroup {
    */
   unsigned int m_chunksFinished;
 
+  /**
+   * \brief height of the bands the area is split in by executeFullFrame
+   */
+  int m_fullFrameBandHeight;
+
   /**
    * \brief the chunkExecutionStates holds per chunk the execution state. this state can be
    *   - COM_ES_NOT_SCHEDULED: not scheduled
@@ -372,6 +378,16 @@ class ExecutionGroup {
    */
   void finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers);
 
+  /**
+   * \brief mark all chunks as executed, when the result is read from the ResultCache
+   */
+  void setChunksExecuted();
+
+  /**
+   * \brief have all chunks been executed
+   */
+  bool areChunksExecuted() const;
+
   /**
    * \brief deinitExecution is called just after execution the whole graph.
    * \note It will release all needed resources
@@ -396,6 +412,25 @@ class ExecutionGroup {
    */
   void execute(ExecutionSystem *system);
 
+  /**
+   * \brief calculate the whole area of this ExecutionGroup at once
+   * \note used by the full frame execution model, all ExecutionGroups this group reads from
+   * must have been executed and all operations of the group must be initialized.
+   *
+   * The area is split in horizontal bands that are calculated in parallel by the task
+   * scheduler, instead of chunks scheduled on the WorkScheduler.
+   * \param system:
+   */
+  void executeFullFrame(ExecutionSystem *system);
+
+  /**
+   * \brief get the operations of this ExecutionGroup, the output operation is the first
+   */
+  const Operations &getOperations() const
+  {
+    return this->m_operations;
+  }
+
   /**
    * \brief this method determines the MemoryProxy's where this execution group depends on.
    * \note After this method determineDependingAreaOfInterest can be called to determine
@@ -436,6 +471,15 @@ class ExecutionGroup {
 
   void setRenderBorder(float xmin, float xmax, float ymin, float ymax);
 
+ private:
+  /**
+   * \brief calculate one band of executeFullFrame, called from the task scheduler
+   */
+  static void executeFullFrameBand(void *__restrict userdata,
+                                   const int band,
+                                   const TaskParallelTLS *__restrict tls);
+
+ public:
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -19,6 +19,7 @@
 #include "COM_ExecutionSystem.h"
 
 #include "PIL_time.h"
+#include "BLI_string.h"
 #include "BLI_utildefines.h"
 extern "C" {
 #include "BKE_node.h"
@@ -32,8 +33,13 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_ResultCache.h"
+#include "COM_WriteBufferOperation.h"
 #include "COM_Debug.h"
 
+#include <map>
+#include <set>
+
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
 #endif
@@ -128,6 +134,17 @@ void ExecutionSystem::set_operations(const Operations &operations, const Groups
   m_groups = groups;
 }
 
+/* Operation writing the result of a group, when it is kept in the ResultCache. */
+static WriteBufferOperation *result_cache_operation(ExecutionGroup *group)
+{
+  NodeOperation *operation = group->getOutputOperation();
+  if (operation->isWriteBufferOperation() &&
+      ((WriteBufferOperation *)operation)->useResultCache()) {
+    return (WriteBufferOperation *)operation;
+  }
+  return NULL;
+}
+
 void ExecutionSystem::execute()
 {
   const bNodeTree *editingtree = this->m_context.getbNodeTree();
@@ -135,6 +152,17 @@ void ExecutionSystem::execute()
 
   DebugInfo::execute_started(this);
 
+  const size_t cache_limit = this->m_context.getResultCacheLimit();
+  if (cache_limit == 0 && !this->m_context.isRendering()) {
+    /* the cache was disabled, don't hold on to its memory */
+    ResultCache::clear();
+  }
+
+  if (this->m_context.getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME) {
+    executeFullFrame();
+    return;
+  }
+
   unsigned int order = 0;
   for (vector<NodeOperation *>::iterator iter = this->m_operations.begin();
        iter != this->m_operations.end();
@@ -177,6 +205,17 @@ void ExecutionSystem::execute()
     executionGroup->setChunksize(this->m_context.getChunksize());
     executionGroup->initExecution();
   }
+  /* results found in the cache don't need to be calculated, nor the groups they depend on */
+  if (cache_limit != 0) {
+    for (index = 0; index < this->m_groups.size(); index++) {
+      ExecutionGroup *executionGroup = this->m_groups[index];
+      WriteBufferOperation *writeOperation = result_cache_operation(executionGroup);
+      if (writeOperation && ResultCache::read(writeOperation->getResultCacheKey(),
+                                              writeOperation->getMemoryProxy()->getBuffer())) {
+        executionGroup->setChunksExecuted();
+      }
+    }
+  }
 
   WorkScheduler::start(this->m_context);
 
@@ -189,6 +228,19 @@ void ExecutionSystem::execute()
   WorkScheduler::finish();
   WorkScheduler::stop();
 
+  /* keep complete results, not the ones interrupted by a break */
+  if (cache_limit != 0 && !(editingtree->test_break && editingtree->test_break(editingtree->tbh))) {
+    for (index = 0; index < this->m_groups.size(); index++) {
+      ExecutionGroup *executionGroup = this->m_groups[index];
+      WriteBufferOperation *writeOperation = result_cache_operation(executionGroup);
+      if (writeOperation && executionGroup->areChunksExecuted()) {
+        ResultCache::write(writeOperation->getResultCacheKey(),
+                           writeOperation->getMemoryProxy()->getBuffer(),
+                           cache_limit);
+      }
+    }
+  }
+
   editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
@@ -200,6 +252,140 @@ void ExecutionSystem::execute()
   }
 }
 
+typedef struct FullFrameExecution {
+  ExecutionSystem *system;
+  const bNodeTree *tree;
+  std::set<ExecutionGroup *> executed_groups;
+  std::set<NodeOperation *> initialized_operations;
+  /** Number of read buffer operations still to be executed per memory proxy. */
+  std::map<MemoryProxy *, int> remaining_reads;
+  int num_groups;
+  size_t cache_limit;
+} FullFrameExecution;
+
+static void full_frame_init_operation(FullFrameExecution &execution, NodeOperation *operation)
+{
+  if (!execution.initialized_operations.insert(operation).second) {
+    return;
+  }
+  operation->initExecution();
+  if (operation->isReadBufferOperation()) {
+    ((ReadBufferOperation *)operation)->updateMemoryBuffer();
+  }
+}
+
+static void full_frame_execute_group(FullFrameExecution &execution, ExecutionGroup *group)
+{
+  if (!execution.executed_groups.insert(group).second) {
+    return;
+  }
+
+  /* a result found in the cache doesn't need the buffers it was calculated from */
+  WriteBufferOperation *cachedOperation = NULL;
+  if (execution.cache_limit != 0) {
+    cachedOperation = result_cache_operation(group);
+  }
+  if (cachedOperation) {
+    full_frame_init_operation(execution, cachedOperation);
+    if (ResultCache::read(cachedOperation->getResultCacheKey(),
+                          cachedOperation->getMemoryProxy()->getBuffer())) {
+      return;
+    }
+  }
+
+  const ExecutionGroup::Operations &operations = group->getOperations();
+
+  /* calculate the buffers read by this group first */
+  for (unsigned int index = 0; index < operations.size(); index++) {
+    NodeOperation *operation = operations[index];
+    if (operation->isReadBufferOperation()) {
+      MemoryProxy *memoryProxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+      full_frame_execute_group(execution, memoryProxy->getExecutor());
+    }
+  }
+
+  const bNodeTree *tree = execution.tree;
+  if (tree->test_break && tree->test_break(tree->tbh)) {
+    return;
+  }
+
+  /* the output operation comes first, so a write buffer is allocated before it is read */
+  for (unsigned int index = 0; index < operations.size(); index++) {
+    full_frame_init_operation(execution, operations[index]);
+  }
+
+  group->executeFullFrame(execution.system);
+
+  if (cachedOperation && !(tree->test_break && tree->test_break(tree->tbh))) {
+    ResultCache::write(cachedOperation->getResultCacheKey(),
+                       cachedOperation->getMemoryProxy()->getBuffer(),
+                       execution.cache_limit);
+  }
+
+  /* free buffers once all their readers have been calculated */
+  for (unsigned int index = 0; index < operations.size(); index++) {
+    NodeOperation *operation = operations[index];
+    if (operation->isReadBufferOperation()) {
+      MemoryProxy *memoryProxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+      if (--execution.remaining_reads[memoryProxy] == 0) {
+        WriteBufferOperation *writeOperation = memoryProxy->getWriteBufferOperation();
+        writeOperation->deinitExecution();
+        execution.initialized_operations.erase(writeOperation);
+      }
+    }
+  }
+
+  const int num_executed = execution.executed_groups.size();
+  tree->progress(tree->prh, (float)num_executed / (float)execution.num_groups);
+
+  char buf[128];
+  BLI_snprintf(buf,
+               sizeof(buf),
+               TIP_("Compositing | Operation %d-%d"),
+               num_executed,
+               execution.num_groups);
+  tree->stats_draw(tree->sdh, buf);
+}
+
+void ExecutionSystem::executeFullFrame()
+{
+  const bNodeTree *editingtree = this->m_context.getbNodeTree();
+
+  FullFrameExecution execution;
+  execution.system = this;
+  execution.tree = editingtree;
+  execution.num_groups = this->m_groups.size();
+  execution.cache_limit = this->m_context.getResultCacheLimit();
+
+  unsigned int index;
+  for (index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    operation->setbNodeTree(editingtree);
+    if (operation->isReadBufferOperation()) {
+      ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
+      execution.remaining_reads[readOperation->getMemoryProxy()]++;
+    }
+  }
+
+  CompositorPriority priorities[3] = {COM_PRIORITY_HIGH, COM_PRIORITY_MEDIUM, COM_PRIORITY_LOW};
+  const int num_priorities = this->getContext().isFastCalculation() ? 1 : 3;
+  for (int priority = 0; priority < num_priorities; priority++) {
+    vector<ExecutionGroup *> executionGroups;
+    this->findOutputExecutionGroup(&executionGroups, priorities[priority]);
+    for (index = 0; index < executionGroups.size(); index++) {
+      full_frame_execute_group(execution, executionGroups[index]);
+    }
+  }
+
+  editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
+  for (index = 0; index < this->m_operations.size(); index++) {
+    NodeOperation *operation = this->m_operations[index];
+    if (execution.initialized_operations.count(operation)) {
+      operation->deinitExecution();
+    }
+  }
+}
+
 void ExecutionSystem::executeGroups(CompositorPriority priority)
 {
   unsigned int index;
@@ -189,6 +189,14 @@ class ExecutionSystem {
  private:
   void executeGroups(CompositorPriority priority);
 
+  /**
+   * \brief execute the system with the full frame execution model
+   * ExecutionGroups are calculated one after another over their whole area, in order of their
+   * dependencies. Buffers are allocated right before they are written and freed as soon as all
+   * ExecutionGroups reading them have been calculated.
+   */
+  void executeFullFrame();
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -20,6 +20,10 @@
 
 #include "MEM_guardedalloc.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 using std::max;
 using std::min;
 
@@ -229,3 +233,93 @@ void MemoryBuffer::readEWA(float *result, const float uv[2], const float derivat
                  this,
                  result);
 }
+
+void MemoryBuffer::readBilinearSpan(float *result,
+                                    const float *coords,
+                                    int num,
+                                    MemoryBufferExtend extend_x,
+                                    MemoryBufferExtend extend_y)
+{
+  const int width = this->m_width;
+  const int height = this->m_height;
+  const int num_channels = this->m_num_channels;
+  const bool wrap_x = (extend_x == COM_MB_REPEAT);
+  const bool wrap_y = (extend_y == COM_MB_REPEAT);
+  const float *buffer = this->m_buffer;
+  const float empty[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+  for (int i = 0; i < num; i++, coords += 2, result += num_channels) {
+    float u = coords[0];
+    float v = coords[1];
+    this->wrap_pixel(u, v, extend_x, extend_y);
+    if ((!wrap_x && (u < 0.0f || u >= width)) || (!wrap_y && (v < 0.0f || v >= height))) {
+      copy_vn_fl(result, num_channels, 0.0f);
+      continue;
+    }
+
+    /* same texel selection and weights as BLI_bilinear_interpolation_wrap_fl */
+    const float u_floor = floorf(u);
+    const float v_floor = floorf(v);
+    int x1 = (int)u_floor;
+    int x2 = (int)ceilf(u);
+    int y1 = (int)v_floor;
+    int y2 = (int)ceilf(v);
+    if (wrap_x) {
+      if (x1 < 0) {
+        x1 = width - 1;
+      }
+      if (x2 >= width) {
+        x2 = 0;
+      }
+    }
+    if (wrap_y) {
+      if (y1 < 0) {
+        y1 = height - 1;
+      }
+      if (y2 >= height) {
+        y2 = 0;
+      }
+    }
+
+    const float *row1 = (x1 < 0 || y1 < 0) ? empty : &buffer[(width * y1 + x1) * num_channels];
+    const float *row2 = (x1 < 0 || y2 > height - 1) ? empty :
+                                                      &buffer[(width * y2 + x1) * num_channels];
+    const float *row3 = (x2 > width - 1 || y1 < 0) ? empty :
+                                                     &buffer[(width * y1 + x2) * num_channels];
+    const float *row4 = (x2 > width - 1 || y2 > height - 1) ?
+                            empty :
+                            &buffer[(width * y2 + x2) * num_channels];
+
+    const float a = u - u_floor;
+    const float b = v - v_floor;
+    const float a_b = a * b;
+    const float ma_b = (1.0f - a) * b;
+    const float a_mb = a * (1.0f - b);
+    const float ma_mb = (1.0f - a) * (1.0f - b);
+
+#ifdef __SSE2__
+    if (num_channels == COM_NUM_CHANNELS_COLOR) {
+      __m128 sample = _mm_mul_ps(_mm_loadu_ps(row1), _mm_set1_ps(ma_mb));
+      sample = _mm_add_ps(sample, _mm_mul_ps(_mm_loadu_ps(row3), _mm_set1_ps(a_mb)));
+      sample = _mm_add_ps(sample, _mm_mul_ps(_mm_loadu_ps(row2), _mm_set1_ps(ma_b)));
+      sample = _mm_add_ps(sample, _mm_mul_ps(_mm_loadu_ps(row4), _mm_set1_ps(a_b)));
+      _mm_storeu_ps(result, sample);
+      continue;
+    }
+#endif
+    for (int c = 0; c < num_channels; c++) {
+      result[c] = ma_mb * row1[c] + a_mb * row3[c] + ma_b * row2[c] + a_b * row4[c];
+    }
+  }
+}
+
+void MemoryBuffer::readEWASpan(float *result,
+                               const float *coords,
+                               const float (*derivatives)[2][2],
+                               int num)
+{
+  /* the filter footprint differs per position, so there is little to share between them */
+  for (int i = 0; i < num; i++) {
+    this->readEWA(&result[i * COM_NUM_CHANNELS_COLOR], &coords[i * 2], derivatives[i]);
+  }
+}
@@ -140,6 +140,16 @@ class MemoryBuffer {
     return this->m_buffer;
   }
 
+  /**
+   * \brief get the data of the pixel at x, y
+   * \note the pixel should be inside the rect of this MemoryBuffer
+   */
+  float *getPixel(int x, int y)
+  {
+    return &this->m_buffer[((y - this->m_rect.ymin) * this->m_width + (x - this->m_rect.xmin)) *
+                           this->m_num_channels];
+  }
+
   /**
    * \brief after execution the state will be set to available by calling this method
    */
@@ -307,6 +317,27 @@ class MemoryBuffer {
 
   void readEWA(float *result, const float uv[2], const float derivatives[2][2]);
 
+  /**
+   * \brief bilinear sample a span of positions, same as calling readBilinear for each of them
+   * \param result: samples packed with the number of channels of this buffer
+   * \param coords: interleaved x and y of every position
+   * \param num: number of positions
+   */
+  void readBilinearSpan(float *result,
+                        const float *coords,
+                        int num,
+                        MemoryBufferExtend extend_x = COM_MB_CLIP,
+                        MemoryBufferExtend extend_y = COM_MB_CLIP);
+
+  /**
+   * \brief EWA filter a span of positions, same as calling readEWA for each of them
+   * \param derivatives: derivatives of every position
+   */
+  void readEWASpan(float *result,
+                   const float *coords,
+                   const float (*derivatives)[2][2],
+                   int num);
+
   /**
    * \brief is this MemoryBuffer a temporarily buffer (based on an area, not on a chunk)
    */
@@ -21,9 +21,23 @@
 
 #include "COM_defines.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_ReadBufferOperation.h"
 
 #include "COM_NodeOperation.h" /* own include */
 
+static unsigned int datatype_num_channels(DataType datatype)
+{
+  switch (datatype) {
+    case COM_DT_VALUE:
+      return COM_NUM_CHANNELS_VALUE;
+    case COM_DT_VECTOR:
+      return COM_NUM_CHANNELS_VECTOR;
+    case COM_DT_COLOR:
+    default:
+      return COM_NUM_CHANNELS_COLOR;
+  }
+}
+
 /*******************
  **** NodeOperation ****
  *******************/
@@ -150,6 +164,91 @@ NodeOperation *NodeOperation::getInputOperation(unsigned int inputSocketIndex)
   }
 }
 
+void NodeOperation::readInputRow(
+    unsigned int inputSocketIndex, int y, int xmin, int xmax, float *row)
+{
+  NodeOperation *inputOperation = this->getInputOperation(inputSocketIndex);
+  const unsigned int num_channels = datatype_num_channels(
+      this->getInputSocket(inputSocketIndex)->getDataType());
+
+  if (inputOperation == NULL) {
+    memset(row, 0, sizeof(float) * num_channels * (xmax - xmin));
+    return;
+  }
+
+  if (inputOperation->isReadBufferOperation()) {
+    ((ReadBufferOperation *)inputOperation)->readRow(row, y, xmin, xmax);
+    return;
+  }
+
+  float color[4];
+  if (inputOperation->isSetOperation()) {
+    /* constant input, read once */
+    inputOperation->readSampled(color, xmin, y, COM_PS_NEAREST);
+    for (int x = xmin; x < xmax; x++, row += num_channels) {
+      memcpy(row, color, sizeof(float) * num_channels);
+    }
+    return;
+  }
+
+  for (int x = xmin; x < xmax; x++, row += num_channels) {
+    inputOperation->readSampled(color, x, y, COM_PS_NEAREST);
+    memcpy(row, color, sizeof(float) * num_channels);
+  }
+}
+
+void NodeOperation::readInputSpanBilinear(unsigned int inputSocketIndex,
+                                          const float *coords,
+                                          int num,
+                                          float *result)
+{
+  NodeOperation *inputOperation = this->getInputOperation(inputSocketIndex);
+  const unsigned int num_channels = datatype_num_channels(
+      this->getInputSocket(inputSocketIndex)->getDataType());
+
+  if (inputOperation == NULL) {
+    memset(result, 0, sizeof(float) * num_channels * num);
+    return;
+  }
+
+  if (inputOperation->isReadBufferOperation()) {
+    ((ReadBufferOperation *)inputOperation)->readBilinearSpan(result, coords, num);
+    return;
+  }
+
+  float color[4];
+  for (int i = 0; i < num; i++, coords += 2, result += num_channels) {
+    inputOperation->readSampled(color, coords[0], coords[1], COM_PS_BILINEAR);
+    memcpy(result, color, sizeof(float) * num_channels);
+  }
+}
+
+void NodeOperation::readInputSpanFiltered(unsigned int inputSocketIndex,
+                                          const float *coords,
+                                          const float (*derivatives)[2][2],
+                                          int num,
+                                          float *result)
+{
+  NodeOperation *inputOperation = this->getInputOperation(inputSocketIndex);
+  BLI_assert(this->getInputSocket(inputSocketIndex)->getDataType() == COM_DT_COLOR);
+
+  if (inputOperation == NULL) {
+    memset(result, 0, sizeof(float) * COM_NUM_CHANNELS_COLOR * num);
+    return;
+  }
+
+  if (inputOperation->isReadBufferOperation()) {
+    ((ReadBufferOperation *)inputOperation)->readFilteredSpan(result, coords, derivatives, num);
+    return;
+  }
+
+  for (int i = 0; i < num; i++, result += COM_NUM_CHANNELS_COLOR) {
+    float dx[2] = {derivatives[i][0][0], derivatives[i][0][1]};
+    float dy[2] = {derivatives[i][1][0], derivatives[i][1][1]};
+    inputOperation->readFiltered(result, coords[i * 2], coords[i * 2 + 1], dx, dy);
+  }
+}
+
 void NodeOperation::getConnectedInputSockets(Inputs *sockets)
 {
   for (Inputs::const_iterator it = m_inputs.begin(); it != m_inputs.end(); ++it) {
@@ -203,6 +203,22 @@ class NodeOperation : public SocketReader {
   {
   }
 
+  /**
+   * \brief calculate an area of the output in bulk instead of per pixel
+   * \ingroup execution
+   *
+   * Called by WriteBufferOperation before falling back to executePixelSampled. Operations
+   * that can evaluate whole rows at once override this and read their inputs with
+   * readInputRow.
+   * \param output: the buffer to write to, covering at least the area
+   * \param area: the area to calculate
+   * \return false when the operation can only be evaluated per pixel
+   */
+  virtual bool executeArea(MemoryBuffer * /*output*/, const rcti * /*area*/)
+  {
+    return false;
+  }
+
   /**
    * \brief when a chunk is executed by an OpenCLDevice, this method is called
    * \ingroup execution
@@ -399,6 +415,35 @@ class NodeOperation : public SocketReader {
   SocketReader *getInputSocketReader(unsigned int inputSocketindex);
   NodeOperation *getInputOperation(unsigned int inputSocketindex);
 
+  /**
+   * \brief read the pixels xmin to xmax of row y of an input socket
+   *
+   * Pixels are packed tightly with the number of channels of the socket data type.
+   * Buffered inputs are copied directly, other inputs are read per pixel.
+   */
+  void readInputRow(unsigned int inputSocketindex, int y, int xmin, int xmax, float *row);
+
+  /**
+   * \brief bilinear sample an input socket at a span of positions
+   *
+   * Positions are interleaved x and y, results are packed like readInputRow.
+   * Buffered inputs are sampled in bulk, other inputs are read per pixel.
+   */
+  void readInputSpanBilinear(unsigned int inputSocketindex,
+                             const float *coords,
+                             int num,
+                             float *result);
+
+  /**
+   * \brief EWA filter a color input socket at a span of positions
+   * \see readInputSpanBilinear
+   */
+  void readInputSpanFiltered(unsigned int inputSocketindex,
+                             const float *coords,
+                             const float (*derivatives)[2][2],
+                             int num,
+                             float *result);
+
   void deinitMutex();
   void initMutex();
   void lockMutex();
@@ -16,6 +16,8 @@
  * Copyright 2013, Blender Foundation.
  */
 
+#include <typeinfo>
+
 extern "C" {
 #include "BLI_utildefines.h"
 }
@@ -40,7 +42,11 @@ extern "C" {
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree)
-    : m_context(context), m_current_node(NULL), m_active_viewer(NULL)
+    : m_context(context),
+      m_current_node(NULL),
+      m_current_node_key(0),
+      m_current_node_num_operations(0),
+      m_active_viewer(NULL)
 {
   m_graph.from_bNodeTree(*context, b_nodetree);
 }
@@ -54,10 +60,18 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /* interface handle for nodes */
   NodeConverter converter(this);
 
+  const bool use_result_cache = m_context->getResultCacheLimit() != 0;
+
   for (int index = 0; index < m_graph.nodes().size(); index++) {
     Node *node = (Node *)m_graph.nodes()[index];
 
     m_current_node = node;
+    if (use_result_cache) {
+      /* key every node, so tags of nodes for execution are handled even when the node
+       * is not used by a cached result */
+      m_current_node_key = ResultCache::node_key(node);
+      m_current_node_num_operations = 0;
+    }
 
     DebugInfo::node_to_operations(node);
     node->convertToOperations(converter, *m_context);
@@ -109,12 +123,21 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /* surround complex ops with read/write buffer */
   add_complex_operation_buffers();
 
+  if (m_context->getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME) {
+    /* buffer every result, so each operation is calculated once over the whole frame */
+    add_full_frame_operation_buffers();
+  }
+
   /* links not available from here on */
   /* XXX make m_links a local variable to avoid confusion! */
   m_links.clear();
 
   prune_operations();
 
+  if (use_result_cache) {
+    add_result_cache_keys();
+  }
+
   /* ensure topological (link-based) order of nodes */
   /*sort_operations();*/ /* not needed yet */
 
@@ -128,6 +151,11 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
   m_operations.push_back(operation);
+
+  if (m_current_node && m_context->getResultCacheLimit() != 0) {
+    m_node_keys[operation] = ResultCache::add_to_key(m_current_node_key,
+                                                     m_current_node_num_operations++);
+  }
 }
 
 void NodeOperationBuilder::mapInputSocket(NodeInput *node_socket,
@@ -599,6 +627,33 @@ void NodeOperationBuilder::add_complex_operation_buffers()
   }
 }
 
+void NodeOperationBuilder::add_full_frame_operation_buffers()
+{
+  /* note: operations are cached here first, since adding operations
+   * will invalidate iterators over the main m_operations
+   */
+  Operations buffered_ops;
+  for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+    NodeOperation *op = *it;
+    if (op->isReadBufferOperation() || op->isWriteBufferOperation() ||
+        op->isOutputOperation(m_context->isRendering())) {
+      continue;
+    }
+    /* constants are cheap to read per pixel, buffering them would cost a full frame */
+    if (op->isSetOperation()) {
+      continue;
+    }
+    buffered_ops.push_back(op);
+  }
+
+  for (Operations::const_iterator it = buffered_ops.begin(); it != buffered_ops.end(); ++it) {
+    NodeOperation *op = *it;
+    for (int index = 0; index < op->getNumberOfOutputSockets(); index++) {
+      add_output_buffers(op, op->getOutputSocket(index));
+    }
+  }
+}
+
 typedef std::set<NodeOperation *> Tags;
 
 static void find_reachable_operations_recursive(Tags &reachable, NodeOperation *op)
@@ -651,6 +706,77 @@ void NodeOperationBuilder::prune_operations()
   m_operations = reachable_ops;
 }
 
+ResultCache::Key NodeOperationBuilder::result_cache_key(OperationKeys &keys,
+                                                        ResultCache::Key context_key,
+                                                        NodeOperation *op) const
+{
+  OperationKeys::const_iterator found = keys.find(op);
+  if (found != keys.end()) {
+    return found->second;
+  }
+
+  ResultCache::Key key = ResultCache::add_string_to_key(context_key, typeid(*op).name());
+  key = ResultCache::add_to_key(key, op->getWidth());
+  key = ResultCache::add_to_key(key, op->getHeight());
+
+  if (op->isReadBufferOperation()) {
+    MemoryProxy *memproxy = ((ReadBufferOperation *)op)->getMemoryProxy();
+    key = ResultCache::add_to_key(
+        key, result_cache_key(keys, context_key, memproxy->getWriteBufferOperation()));
+  }
+
+  OperationKeys::const_iterator node_key = m_node_keys.find(op);
+  if (node_key != m_node_keys.end()) {
+    key = ResultCache::add_to_key(key, node_key->second);
+  }
+  else if (op->isSetOperation()) {
+    /* constants of unconnected inputs */
+    float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    op->readSampled(value, 0.0f, 0.0f, COM_PS_NEAREST);
+    key = ResultCache::add_to_key(key, value);
+  }
+
+  for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+    NodeOperationInput *input = op->getInputSocket(i);
+    if (!input->isConnected()) {
+      key = ResultCache::add_to_key(key, -1);
+      continue;
+    }
+
+    NodeOperationOutput *output = input->getLink();
+    NodeOperation &input_op = output->getOperation();
+    for (int index = 0; index < input_op.getNumberOfOutputSockets(); index++) {
+      if (input_op.getOutputSocket(index) == output) {
+        key = ResultCache::add_to_key(key, index);
+      }
+    }
+    key = ResultCache::add_to_key(key, result_cache_key(keys, context_key, &input_op));
+  }
+
+  keys[op] = key;
+  return key;
+}
+
+void NodeOperationBuilder::add_result_cache_keys()
+{
+  const ResultCache::Key context_key = ResultCache::context_key(*m_context);
+
+  OperationKeys keys;
+  for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+    NodeOperation *op = *it;
+    if (!op->isWriteBufferOperation()) {
+      continue;
+    }
+
+    /* only results of complex operations are worth keeping, others are fast to calculate */
+    WriteBufferOperation *write_op = (WriteBufferOperation *)op;
+    NodeOperationInput *input = write_op->getInputSocket(0);
+    if (input->isConnected() && input->getLink()->getOperation().isComplex()) {
+      write_op->setResultCacheKey(result_cache_key(keys, context_key, write_op));
+    }
+  }
+}
+
 /* topological (depth-first) sorting of operations */
 static void sort_operations_recursive(NodeOperationBuilder::Operations &sorted,
                                       Tags &visited,
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "COM_NodeGraph.h"
+#include "COM_ResultCache.h"
 
 using std::vector;
 
@@ -75,6 +76,8 @@ class NodeOperationBuilder {
   typedef std::vector<NodeOperationInput *> OpInputs;
   typedef std::map<NodeInput *, OpInputs> OpInputInverseMap;
 
+  typedef std::map<NodeOperation *, ResultCache::Key> OperationKeys;
+
  private:
   const CompositorContext *m_context;
   NodeGraph m_graph;
@@ -90,6 +93,12 @@ class NodeOperationBuilder {
 
   Node *m_current_node;
 
+  /** Keys of the settings of the nodes the operations are converted from,
+   * only used when results are cached */
+  OperationKeys m_node_keys;
+  ResultCache::Key m_current_node_key;
+  int m_current_node_num_operations;
+
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
    *  to avoid race conditions
@@ -156,12 +165,20 @@ class NodeOperationBuilder {
   WriteBufferOperation *find_attached_write_buffer_operation(NodeOperationOutput *output) const;
   /** Add read/write buffer operations around complex operations */
   void add_complex_operation_buffers();
+  /** Add write buffer operations after every operation, for full frame execution */
+  void add_full_frame_operation_buffers();
   void add_input_buffers(NodeOperation *operation, NodeOperationInput *input);
   void add_output_buffers(NodeOperation *operation, NodeOperationOutput *output);
 
   /** Remove unreachable operations */
   void prune_operations();
 
+  /** Identify results of complex operations, to keep them in the ResultCache */
+  void add_result_cache_keys();
+  ResultCache::Key result_cache_key(OperationKeys &keys,
+                                    ResultCache::Key context_key,
+                                    NodeOperation *op) const;
+
   /** Sort operations by link dependencies */
   void sort_operations();
 
@@ -0,0 +1,334 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#include <list>
+#include <map>
+#include <string.h>
+
+#include "COM_CompositorContext.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_Node.h"
+#include "COM_ResultCache.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_listbase.h"
+#include "BLI_utildefines.h"
+
+#include "BKE_node.h"
+
+#include "DNA_color_types.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+}
+
+#include "RNA_access.h"
+
+typedef struct CachedResult {
+  float *buffer;
+  int width;
+  int height;
+  int num_channels;
+  size_t size;
+  /** Position in the list of least recently used results. */
+  std::list<ResultCache::Key>::iterator used;
+} CachedResult;
+
+static std::map<ResultCache::Key, CachedResult> g_results;
+/** Keys of the results, the most recently used first. */
+static std::list<ResultCache::Key> g_used;
+static size_t g_size = 0;
+/** Number of times a node has been tagged for execution, by node instance key. */
+static std::map<unsigned int, unsigned int> g_node_generations;
+
+/* 64 bit FNV-1a. */
+ResultCache::Key ResultCache::begin_key()
+{
+  return 0xcbf29ce484222325ULL;
+}
+
+ResultCache::Key ResultCache::add_to_key(Key key, const void *data, size_t size)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+    key ^= bytes[i];
+    key *= 0x100000001b3ULL;
+  }
+  return key;
+}
+
+ResultCache::Key ResultCache::add_string_to_key(Key key, const char *str)
+{
+  if (str == NULL) {
+    return add_to_key(key, 0);
+  }
+  return add_to_key(key, str, strlen(str) + 1);
+}
+
+static ResultCache::Key add_curve_mapping_to_key(ResultCache::Key key,
+                                                 const CurveMapping *cumap)
+{
+  key = ResultCache::add_to_key(key, cumap->flag);
+  key = ResultCache::add_to_key(key, cumap->clipr);
+  key = ResultCache::add_to_key(key, cumap->black);
+  key = ResultCache::add_to_key(key, cumap->white);
+  key = ResultCache::add_to_key(key, cumap->tone);
+  for (int i = 0; i < CM_TOT; i++) {
+    const CurveMap *cuma = &cumap->cm[i];
+    key = ResultCache::add_to_key(key, cuma->totpoint);
+    for (int a = 0; a < cuma->totpoint; a++) {
+      /* selecting points does not change the curve */
+      const CurveMapPoint *point = &cuma->curve[a];
+      key = ResultCache::add_to_key(key, point->x);
+      key = ResultCache::add_to_key(key, point->y);
+      key = ResultCache::add_to_key(key, (short)(point->flag & ~CUMA_SELECT));
+    }
+  }
+  return key;
+}
+
+/* Settings of the node type, by their RNA properties. The storage of nodes also holds
+ * pointers and padding, which differ for every localized copy of the tree. */
+static ResultCache::Key add_node_properties_to_key(ResultCache::Key key, const Node *node)
+{
+  PointerRNA ptr;
+  RNA_pointer_create((ID *)node->getbNodeTree(), &RNA_Node, node->getbNode(), &ptr);
+
+  RNA_STRUCT_BEGIN (&ptr, prop) {
+    /* name, location, selection and other properties shared by all nodes */
+    if (RNA_struct_type_find_property(&RNA_Node, RNA_property_identifier(prop))) {
+      continue;
+    }
+
+    const PropertyType type = RNA_property_type(prop);
+    const int length = RNA_property_array_length(&ptr, prop);
+    switch (type) {
+      case PROP_BOOLEAN:
+        if (length == 0) {
+          key = ResultCache::add_to_key(key, RNA_property_boolean_get(&ptr, prop));
+        }
+        for (int i = 0; i < length; i++) {
+          key = ResultCache::add_to_key(key, RNA_property_boolean_get_index(&ptr, prop, i));
+        }
+        break;
+      case PROP_INT:
+        if (length == 0) {
+          key = ResultCache::add_to_key(key, RNA_property_int_get(&ptr, prop));
+        }
+        for (int i = 0; i < length; i++) {
+          key = ResultCache::add_to_key(key, RNA_property_int_get_index(&ptr, prop, i));
+        }
+        break;
+      case PROP_FLOAT:
+        if (length == 0) {
+          key = ResultCache::add_to_key(key, RNA_property_float_get(&ptr, prop));
+        }
+        for (int i = 0; i < length; i++) {
+          key = ResultCache::add_to_key(key, RNA_property_float_get_index(&ptr, prop, i));
+        }
+        break;
+      case PROP_ENUM:
+        key = ResultCache::add_to_key(key, RNA_property_enum_get(&ptr, prop));
+        break;
+      case PROP_STRING: {
+        char fixedbuf[256];
+        char *str = RNA_property_string_get_alloc(&ptr, prop, fixedbuf, sizeof(fixedbuf), NULL);
+        key = ResultCache::add_string_to_key(key, str);
+        if (str != fixedbuf) {
+          MEM_freeN(str);
+        }
+        break;
+      }
+      default:
+        /* IDs are keyed by node_key(), curve mappings by the type of their node */
+        break;
+    }
+  }
+  RNA_STRUCT_END;
+
+  return key;
+}
+
+ResultCache::Key ResultCache::context_key(const CompositorContext &context)
+{
+  Key key = begin_key();
+  key = add_to_key(key, context.getQuality());
+  key = add_to_key(key, context.isFastCalculation());
+  key = add_string_to_key(key, context.getViewName());
+
+  const RenderData *rd = context.getRenderData();
+  key = add_to_key(key, rd->cfra);
+  key = add_to_key(key, rd->xsch);
+  key = add_to_key(key, rd->ysch);
+  key = add_to_key(key, rd->size);
+  if (context.getScene()) {
+    key = add_to_key(key, context.getScene()->id.session_uuid);
+  }
+
+  const ColorManagedViewSettings *view_settings = context.getViewSettings();
+  if (view_settings) {
+    key = add_to_key(key, view_settings->flag);
+    key = add_string_to_key(key, view_settings->look);
+    key = add_string_to_key(key, view_settings->view_transform);
+    key = add_to_key(key, view_settings->exposure);
+    key = add_to_key(key, view_settings->gamma);
+    if ((view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) && view_settings->curve_mapping) {
+      key = add_curve_mapping_to_key(key, view_settings->curve_mapping);
+    }
+  }
+  const ColorManagedDisplaySettings *display_settings = context.getDisplaySettings();
+  if (display_settings) {
+    key = add_string_to_key(key, display_settings->display_device);
+  }
+  return key;
+}
+
+ResultCache::Key ResultCache::node_key(const Node *node)
+{
+  bNode *b_node = node->getbNode();
+  Key key = begin_key();
+  key = add_to_key(key, b_node->type);
+  key = add_to_key(key, b_node->custom1);
+  key = add_to_key(key, b_node->custom2);
+  key = add_to_key(key, b_node->custom3);
+  key = add_to_key(key, b_node->custom4);
+
+  /* pointers inside the storage differ for every localized copy of the tree */
+  if (b_node->storage) {
+    switch (b_node->type) {
+      case CMP_NODE_TIME:
+      case CMP_NODE_CURVE_VEC:
+      case CMP_NODE_CURVE_RGB:
+      case CMP_NODE_HUECORRECT:
+        key = add_curve_mapping_to_key(key, (const CurveMapping *)b_node->storage);
+        break;
+      case CMP_NODE_CRYPTOMATTE: {
+        const NodeCryptomatte *data = (const NodeCryptomatte *)b_node->storage;
+        key = add_to_key(key, data->add);
+        key = add_to_key(key, data->remove);
+        key = add_to_key(key, data->num_inputs);
+        key = add_string_to_key(key, data->matte_id);
+        break;
+      }
+      default:
+        key = add_node_properties_to_key(key, node);
+        break;
+    }
+  }
+
+  /* Some nodes convert editor values of their inputs into settings, value and color nodes
+   * store their values in their outputs. */
+  LISTBASE_FOREACH (bNodeSocket *, sock, &b_node->inputs) {
+    if (sock->default_value) {
+      key = add_to_key(key, sock->default_value, MEM_allocN_len(sock->default_value));
+    }
+  }
+  LISTBASE_FOREACH (bNodeSocket *, sock, &b_node->outputs) {
+    if (sock->default_value) {
+      key = add_to_key(key, sock->default_value, MEM_allocN_len(sock->default_value));
+    }
+  }
+
+  if (b_node->id) {
+    key = add_to_key(key, b_node->id->session_uuid);
+    key = add_string_to_key(key, b_node->id->name);
+
+    /* Edits of masks and textures do not tag the nodes using them, never reuse their
+     * results. */
+    const bool tagged = b_node->need_exec || ELEM(b_node->type, CMP_NODE_MASK, CMP_NODE_TEXTURE);
+    unsigned int &generation = g_node_generations[node->getInstanceKey().value];
+    if (tagged) {
+      generation++;
+      /* the tag is handled, the second pass of a two pass execution shares it */
+      b_node->need_exec = 0;
+    }
+    key = add_to_key(key, generation);
+  }
+  return key;
+}
+
+bool ResultCache::read(Key key, MemoryBuffer *buffer)
+{
+  std::map<Key, CachedResult>::iterator it = g_results.find(key);
+  if (it == g_results.end()) {
+    return false;
+  }
+
+  CachedResult &result = it->second;
+  if (result.width != buffer->getWidth() || result.height != buffer->getHeight() ||
+      result.num_channels != (int)buffer->get_num_channels()) {
+    return false;
+  }
+
+  memcpy(buffer->getBuffer(), result.buffer, result.size);
+  buffer->setCreatedState();
+
+  g_used.splice(g_used.begin(), g_used, result.used);
+  return true;
+}
+
+static void result_cache_free(std::map<ResultCache::Key, CachedResult>::iterator it)
+{
+  CachedResult &result = it->second;
+  g_size -= result.size;
+  g_used.erase(result.used);
+  MEM_freeN(result.buffer);
+  g_results.erase(it);
+}
+
+void ResultCache::write(Key key, MemoryBuffer *buffer, size_t limit)
+{
+  const size_t size = sizeof(float) * buffer->get_num_channels() * buffer->getWidth() *
+                      buffer->getHeight();
+  if (size == 0 || size > limit) {
+    return;
+  }
+
+  std::map<Key, CachedResult>::iterator it = g_results.find(key);
+  if (it != g_results.end()) {
+    /* same key, same result */
+    g_used.splice(g_used.begin(), g_used, it->second.used);
+    return;
+  }
+
+  while (g_size + size > limit) {
+    result_cache_free(g_results.find(g_used.back()));
+  }
+
+  CachedResult result;
+  result.buffer = (float *)MEM_mallocN(size, __func__);
+  memcpy(result.buffer, buffer->getBuffer(), size);
+  result.width = buffer->getWidth();
+  result.height = buffer->getHeight();
+  result.num_channels = buffer->get_num_channels();
+  result.size = size;
+  g_used.push_front(key);
+  result.used = g_used.begin();
+
+  g_results[key] = result;
+  g_size += size;
+}
+
+void ResultCache::clear()
+{
+  while (!g_results.empty()) {
+    result_cache_free(g_results.begin());
+  }
+  g_node_generations.clear();
+}
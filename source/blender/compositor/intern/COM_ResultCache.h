@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2020, Blender Foundation.
+ */
+
+#ifndef __COM_RESULTCACHE_H__
+#define __COM_RESULTCACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+class CompositorContext;
+class MemoryBuffer;
+class Node;
+
+/**
+ * \brief results of expensive operations kept between executions of the compositor
+ * \ingroup Execution
+ *
+ * A result is identified by a key, hashing the settings of the operation that calculated it
+ * and of all operations it depends on. When the key of an operation is found in the cache its
+ * result is copied from the cache, and the operations it depends on are not executed.
+ *
+ * The least recently used results are freed when the cache grows over its memory limit.
+ * \note all methods must be called with the compositor mutex locked.
+ */
+class ResultCache {
+ public:
+  typedef uint64_t Key;
+
+  /**
+   * \brief start a new key
+   */
+  static Key begin_key();
+
+  /**
+   * \brief add data to a key
+   */
+  static Key add_to_key(Key key, const void *data, size_t size);
+
+  template<typename T> static Key add_to_key(Key key, const T &value)
+  {
+    return add_to_key(key, &value, sizeof(value));
+  }
+
+  static Key add_string_to_key(Key key, const char *str);
+
+  /**
+   * \brief key of the settings shared by all operations of an execution
+   */
+  static Key context_key(const CompositorContext &context);
+
+  /**
+   * \brief key of the settings and the data of a node
+   *
+   * Nodes are tagged for execution when the data they use changes without their settings
+   * changing, for example when an image is painted or a render layer is re-rendered. Every
+   * tag changes the key of the node.
+   */
+  static Key node_key(const Node *node);
+
+  /**
+   * \brief copy a cached result into the buffer
+   * \return false when the key is not cached, or was cached for a buffer of another size.
+   */
+  static bool read(Key key, MemoryBuffer *buffer);
+
+  /**
+   * \brief store a copy of the buffer in the cache
+   * \param limit: size in bytes the cache is kept under, by freeing the least recently used
+   * results.
+   */
+  static void write(Key key, MemoryBuffer *buffer, size_t limit);
+
+  /**
+   * \brief free all results
+   */
+  static void clear();
+};
+
+#endif /* __COM_RESULTCACHE_H__ */
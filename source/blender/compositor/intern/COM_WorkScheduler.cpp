@@ -371,3 +371,10 @@ int WorkScheduler::current_thread_id()
   CPUDevice *device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
   return device->thread_id();
 }
+
+CPUDevice *WorkScheduler::set_thread_device(CPUDevice *device)
+{
+  CPUDevice *previous_device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
+  BLI_thread_local_set(g_thread_device, device);
+  return previous_device;
+}
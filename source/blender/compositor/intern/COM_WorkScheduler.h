@@ -30,6 +30,8 @@ extern "C" {
 /** \brief the workscheduler
  * \ingroup execution
  */
+class CPUDevice;
+
 class WorkScheduler {
 
 #if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
@@ -112,6 +114,13 @@ class WorkScheduler {
 
   static int current_thread_id();
 
+  /**
+   * \brief set the CPUDevice of the calling thread
+   * Used when work is executed outside of the WorkScheduler threads, so current_thread_id
+   * stays valid there. Returns the previous device of the thread.
+   */
+  static CPUDevice *set_thread_device(CPUDevice *device);
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:WorkScheduler")
 #endif
@@ -27,6 +27,7 @@ extern "C" {
 
 #include "COM_compositor.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "clew.h"
 #include "COM_MovieDistortionOperation.h"
@@ -115,8 +116,18 @@ void COM_deinitialize()
   if (is_compositorMutex_init) {
     BLI_mutex_lock(&s_compositorMutex);
     WorkScheduler::deinitialize();
+    ResultCache::clear();
     is_compositorMutex_init = false;
     BLI_mutex_unlock(&s_compositorMutex);
     BLI_mutex_end(&s_compositorMutex);
   }
 }
+
+void COM_clearCaches()
+{
+  if (is_compositorMutex_init) {
+    BLI_mutex_lock(&s_compositorMutex);
+    ResultCache::clear();
+    BLI_mutex_unlock(&s_compositorMutex);
+  }
+}
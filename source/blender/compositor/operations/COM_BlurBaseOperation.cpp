@@ -36,6 +36,7 @@ BlurBaseOperation::BlurBaseOperation(DataType data_type) : NodeOperation()
   this->m_size = 1.0f;
   this->m_sizeavailable = false;
   this->m_extend_bounds = false;
+  this->m_recursive_gauss = true;
 }
 void BlurBaseOperation::initExecution()
 {
@@ -90,6 +91,13 @@ float *BlurBaseOperation::make_gausstab(float rad, int size)
   return gausstab;
 }
 
+bool BlurBaseOperation::useRecursiveGauss(float rad) const
+{
+  /* the recursive filter approximates a gaussian, other filter types need their kernel */
+  return this->m_recursive_gauss && this->m_data.filtertype == R_FILTER_GAUSS &&
+         rad >= MIN_RECURSIVE_GAUSS_RADIUS;
+}
+
 #ifdef __SSE2__
 __m128 *BlurBaseOperation::convert_gausstab_sse(const float *gausstab, int size)
 {
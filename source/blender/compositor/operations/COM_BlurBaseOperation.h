@@ -22,6 +22,9 @@
 #include "COM_QualityStepHelper.h"
 
 #define MAX_GAUSSTAB_RADIUS 30000
+/* From this radius gaussian blurs are calculated recursively, which costs the same for every
+ * radius, instead of with a kernel that grows with the radius. */
+#define MIN_RECURSIVE_GAUSS_RADIUS 32
 
 #ifdef __SSE2__
 #  include <emmintrin.h>
@@ -36,6 +39,7 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
   __m128 *convert_gausstab_sse(const float *gaustab, int size);
 #endif
   float *make_dist_fac_inverse(float rad, int size, int falloff);
+  bool useRecursiveGauss(float rad) const;
 
   void updateSize();
 
@@ -51,6 +55,8 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
 
   bool m_extend_bounds;
 
+  bool m_recursive_gauss;
+
  public:
   /**
    * Initialize the execution
@@ -75,6 +81,12 @@ class BlurBaseOperation : public NodeOperation, public QualityStepHelper {
     this->m_extend_bounds = extend_bounds;
   }
 
+  /* Allow large gaussian radii to be calculated recursively, on by default. */
+  void setRecursiveGauss(bool recursive_gauss)
+  {
+    this->m_recursive_gauss = recursive_gauss;
+  }
+
   void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
 };
 #endif
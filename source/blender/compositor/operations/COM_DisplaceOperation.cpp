@@ -20,6 +20,8 @@
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 DisplaceOperation::DisplaceOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -64,6 +66,68 @@ void DisplaceOperation::executePixelSampled(float output[4],
   }
 }
 
+bool DisplaceOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  const int width = BLI_rcti_size_x(area);
+  if (width <= 0) {
+    return true;
+  }
+
+  /* undistorted pixels are sampled bilinear, the others are EWA filtered */
+  float *bilinear_coords = (float *)MEM_mallocN(sizeof(float) * 2 * width, __func__);
+  int *bilinear_indices = (int *)MEM_mallocN(sizeof(int) * width, __func__);
+  float *filtered_coords = (float *)MEM_mallocN(sizeof(float) * 2 * width, __func__);
+  float(*filtered_derivs)[2][2] = (float(*)[2][2])MEM_mallocN(sizeof(*filtered_derivs) * width,
+                                                               __func__);
+  int *filtered_indices = (int *)MEM_mallocN(sizeof(int) * width, __func__);
+  float *colors = (float *)MEM_mallocN(sizeof(float) * 4 * width, __func__);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    int num_bilinear = 0;
+    int num_filtered = 0;
+
+    for (int i = 0; i < width; i++) {
+      const float xy[2] = {(float)(area->xmin + i), (float)y};
+      float uv[2], deriv[2][2];
+      pixelTransform(xy, uv, deriv);
+      if (is_zero_v2(deriv[0]) && is_zero_v2(deriv[1])) {
+        copy_v2_v2(&bilinear_coords[num_bilinear * 2], uv);
+        bilinear_indices[num_bilinear++] = i;
+      }
+      else {
+        copy_v2_v2(&filtered_coords[num_filtered * 2], uv);
+        copy_v2_v2(filtered_derivs[num_filtered][0], deriv[0]);
+        copy_v2_v2(filtered_derivs[num_filtered][1], deriv[1]);
+        filtered_indices[num_filtered++] = i;
+      }
+    }
+
+    float *row = output->getPixel(area->xmin, y);
+
+    this->readInputSpanBilinear(0, bilinear_coords, num_bilinear, colors);
+    for (int j = 0; j < num_bilinear; j++) {
+      copy_v4_v4(&row[bilinear_indices[j] * 4], &colors[j * 4]);
+    }
+
+    this->readInputSpanFiltered(0, filtered_coords, filtered_derivs, num_filtered, colors);
+    for (int j = 0; j < num_filtered; j++) {
+      copy_v4_v4(&row[filtered_indices[j] * 4], &colors[j * 4]);
+    }
+
+    if (isBraked()) {
+      break;
+    }
+  }
+
+  MEM_freeN(bilinear_coords);
+  MEM_freeN(bilinear_indices);
+  MEM_freeN(filtered_coords);
+  MEM_freeN(filtered_derivs);
+  MEM_freeN(filtered_indices);
+  MEM_freeN(colors);
+  return true;
+}
+
 bool DisplaceOperation::read_displacement(
     float x, float y, float xscale, float yscale, const float origin[2], float &r_u, float &r_v)
 {
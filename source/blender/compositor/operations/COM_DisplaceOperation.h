@@ -48,6 +48,11 @@ class DisplaceOperation : public NodeOperation {
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
 
+  /**
+   * sample the image for whole rows at once
+   */
+  bool executeArea(MemoryBuffer *output, const rcti *area);
+
   void pixelTransform(const float xy[2], float r_uv[2], float r_deriv[2][2]);
 
   /**
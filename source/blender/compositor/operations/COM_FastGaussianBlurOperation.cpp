@@ -16,12 +16,14 @@
  * Copyright 2011, Blender Foundation.
  */
 
-#include <limits.h>
-
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 
+extern "C" {
+#include "BLI_task.h"
+}
+
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
   this->m_iirgaus = NULL;
@@ -111,42 +113,19 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
   return this->m_iirgaus;
 }
 
-void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
-                                          float sigma,
-                                          unsigned int chan,
-                                          unsigned int xy)
-{
-  double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-  double *X, *Y, *W;
-  const unsigned int src_width = src->getWidth();
-  const unsigned int src_height = src->getHeight();
-  unsigned int x, y, sz;
-  unsigned int i;
-  float *buffer = src->getBuffer();
-  const unsigned int num_channels = src->get_num_channels();
-
-  // <0.5 not valid, though can have a possibly useful sort of sharpening effect
-  if (sigma < 0.5f) {
-    return;
-  }
-
-  if ((xy < 1) || (xy > 3)) {
-    xy = 3;
-  }
+/* Coefficients of the recursive gaussian, see "Recursive Gabor Filtering" by Young/VanVliet. */
+typedef struct IIRGaussCoefficients {
+  double cf[4];
+  /* Triggs/Sdika border corrections. */
+  double tsM[9];
+} IIRGaussCoefficients;
 
-  // XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
-  //     so just skipping blur along faulty direction if src's def is below that limit!
-  if (src_width < 3) {
-    xy &= ~1;
-  }
-  if (src_height < 3) {
-    xy &= ~2;
-  }
-  if (xy < 1) {
-    return;
-  }
+static void iir_gauss_coefficients(IIRGaussCoefficients *coefficients, float sigma)
+{
+  double q, q2, sc;
+  double *cf = coefficients->cf;
+  double *tsM = coefficients->tsM;
 
-  // see "Recursive Gabor Filtering" by Young/VanVliet
   // all factors here in double.prec.
   // Required, because for single.prec it seems to blow up if sigma > ~200
   if (sigma >= 3.556f) {
@@ -184,76 +163,315 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
   tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
                  cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
   tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+}
 
-#define YVV(L) \
-  { \
-    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0]; \
-    for (i = 3; i < L; i++) { \
-      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3]; \
-    } \
-    tsu[0] = W[L - 1] - X[L - 1]; \
-    tsu[1] = W[L - 2] - X[L - 1]; \
-    tsu[2] = W[L - 3] - X[L - 1]; \
-    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1]; \
-    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1]; \
-    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1]; \
-    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2]; \
-    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1]; \
-    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-    /* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */ \
-    for (i = L - 4; i != UINT_MAX; i--) { \
-      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3]; \
-    } \
-  } \
-  (void)0
-
-  // intermediate buffers
-  sz = max(src_width, src_height);
-  X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-  Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-  W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
-  if (xy & 1) {  // H
-    int offset;
-    for (y = 0; y < src_height; y++) {
-      const int yx = y * src_width;
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        X[x] = buffer[offset];
-        offset += num_channels;
+/* Filter a line of at least 3 values forward into W and backward into Y. Beyond its ends the
+ * line is extended with the values left and right. */
+static void iir_gauss_line(const IIRGaussCoefficients &coefficients,
+                           const double *X,
+                           double *W,
+                           double *Y,
+                           const int L,
+                           const double left,
+                           const double right)
+{
+  const double *cf = coefficients.cf;
+  const double *tsM = coefficients.tsM;
+  double tsu[3], tsv[3];
+
+  W[0] = cf[0] * X[0] + cf[1] * left + cf[2] * left + cf[3] * left;
+  W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * left + cf[3] * left;
+  W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * left;
+  for (int i = 3; i < L; i++) {
+    W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];
+  }
+  tsu[0] = W[L - 1] - right;
+  tsu[1] = W[L - 2] - right;
+  tsu[2] = W[L - 3] - right;
+  tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + right;
+  tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + right;
+  tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + right;
+  Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];
+  Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];
+  Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0];
+  for (int i = L - 4; i >= 0; i--) {
+    Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];
+  }
+}
+
+/* Number of rows or columns filtered by a task. */
+#define IIR_GAUSS_BAND_LINES 16
+
+typedef struct IIRGaussPass {
+  IIRGaussCoefficients coefficients;
+  /** Lines are read from input and written to buffer, which may be the same. */
+  const float *input;
+  float *buffer;
+  unsigned int channel_begin;
+  unsigned int channel_end;
+  /** Length of the lines, number of lines. */
+  int length;
+  int num_lines;
+  /** Offset between lines, and between values of a line. */
+  int line_stride;
+  int value_stride;
+  /** When set values beyond the ends of a line are zero, and the result is divided by the
+   * filtered weights of the values inside the line. Otherwise the end values are extended. */
+  const double *clip_weights;
+} IIRGaussPass;
+
+static void iir_gauss_lines(const IIRGaussPass &pass, const int line_begin, const int line_end)
+{
+  const int L = pass.length;
+  double *X = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss X buf");
+  double *Y = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss Y buf");
+  double *W = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss W buf");
+
+  for (int line = line_begin; line < line_end; line++) {
+    for (unsigned int chan = pass.channel_begin; chan < pass.channel_end; chan++) {
+      const float *input = pass.input + line * pass.line_stride + chan;
+      float *values = pass.buffer + line * pass.line_stride + chan;
+      for (int i = 0; i < L; i++) {
+        X[i] = input[i * pass.value_stride];
       }
-      YVV(src_width);
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        buffer[offset] = Y[x];
-        offset += num_channels;
+      if (pass.clip_weights) {
+        iir_gauss_line(pass.coefficients, X, W, Y, L, 0.0, 0.0);
+        for (int i = 0; i < L; i++) {
+          values[i * pass.value_stride] = Y[i] / pass.clip_weights[i];
+        }
+      }
+      else {
+        iir_gauss_line(pass.coefficients, X, W, Y, L, X[0], X[L - 1]);
+        for (int i = 0; i < L; i++) {
+          values[i * pass.value_stride] = Y[i];
+        }
       }
     }
   }
+
+  MEM_freeN(X);
+  MEM_freeN(W);
+  MEM_freeN(Y);
+}
+
+static void iir_gauss_band(void *__restrict userdata,
+                           const int band,
+                           const TaskParallelTLS *__restrict /*tls*/)
+{
+  const IIRGaussPass &pass = *(const IIRGaussPass *)userdata;
+  iir_gauss_lines(pass,
+                  band * IIR_GAUSS_BAND_LINES,
+                  min_ii((band + 1) * IIR_GAUSS_BAND_LINES, pass.num_lines));
+}
+
+/* The filtered weights are the same for every line, calculate them once. */
+static double *iir_gauss_clip_weights_new(const IIRGaussPass &pass)
+{
+  const int L = pass.length;
+  double *X = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss X buf");
+  double *W = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss W buf");
+  double *clip_weights = (double *)MEM_mallocN(sizeof(double) * L, "IIR_gauss clip weights");
+  for (int i = 0; i < L; i++) {
+    X[i] = 1.0;
+  }
+  iir_gauss_line(pass.coefficients, X, W, clip_weights, L, 0.0, 0.0);
+  MEM_freeN(X);
+  MEM_freeN(W);
+  return clip_weights;
+}
+
+static void iir_gauss_pass(IIRGaussPass &pass, bool clip)
+{
+  double *clip_weights = clip ? iir_gauss_clip_weights_new(pass) : NULL;
+  pass.clip_weights = clip_weights;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  const int num_bands = (pass.num_lines + IIR_GAUSS_BAND_LINES - 1) / IIR_GAUSS_BAND_LINES;
+  BLI_task_parallel_range(0, num_bands, &pass, iir_gauss_band, &settings);
+
+  if (clip_weights) {
+    MEM_freeN(clip_weights);
+  }
+}
+
+static void iir_gauss(MemoryBuffer *src,
+                      float sigma,
+                      unsigned int channel_begin,
+                      unsigned int channel_end,
+                      unsigned int xy,
+                      bool clip)
+{
+  const int src_width = src->getWidth();
+  const int src_height = src->getHeight();
+  const int num_channels = src->get_num_channels();
+
+  // <0.5 not valid, though can have a possibly useful sort of sharpening effect
+  if (sigma < 0.5f) {
+    return;
+  }
+
+  if ((xy < 1) || (xy > 3)) {
+    xy = 3;
+  }
+
+  // XXX The line filter explicitly expects sources of at least 3x3 pixels,
+  //     so just skipping blur along faulty direction if src's def is below that limit!
+  if (src_width < 3) {
+    xy &= ~1;
+  }
+  if (src_height < 3) {
+    xy &= ~2;
+  }
+  if (xy < 1) {
+    return;
+  }
+
+  IIRGaussPass pass;
+  iir_gauss_coefficients(&pass.coefficients, sigma);
+  pass.input = src->getBuffer();
+  pass.buffer = src->getBuffer();
+  pass.channel_begin = channel_begin;
+  pass.channel_end = channel_end;
+
+  /* rows and columns are filtered independently of each other, in parallel */
+  if (xy & 1) {  // H
+    pass.length = src_width;
+    pass.num_lines = src_height;
+    pass.line_stride = src_width * num_channels;
+    pass.value_stride = num_channels;
+    iir_gauss_pass(pass, clip);
+  }
   if (xy & 2) {  // V
-    int offset;
-    const int add = src_width * num_channels;
-
-    for (x = 0; x < src_width; x++) {
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        X[y] = buffer[offset];
-        offset += add;
+    pass.length = src_height;
+    pass.num_lines = src_width;
+    pass.line_stride = num_channels;
+    pass.value_stride = src_width * num_channels;
+    iir_gauss_pass(pass, clip);
+  }
+}
+
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
+                                          float sigma,
+                                          unsigned int chan,
+                                          unsigned int xy)
+{
+  iir_gauss(src, sigma, chan, chan + 1, xy, false);
+}
+
+void FastGaussianBlurOperation::IIR_gauss_clip(MemoryBuffer *src, float sigma, unsigned int xy)
+{
+  iir_gauss(src, sigma, 0, src->get_num_channels(), xy, true);
+}
+
+/* Number of lines in the bands of IIRGaussLines. */
+#define IIR_GAUSS_LINES_BAND_SIZE 32
+
+IIRGaussLines::IIRGaussLines(MemoryBuffer *input, float sigma, unsigned int xy)
+{
+  BLI_assert(ELEM(xy, 1, 2));
+  this->m_input = input;
+  this->m_sigma = sigma;
+  this->m_xy = xy;
+  this->m_result = new MemoryBuffer(COM_DT_COLOR, input->getRect());
+
+  const int num_lines = (xy == 1) ? input->getHeight() : input->getWidth();
+  this->m_num_bands = (num_lines + IIR_GAUSS_LINES_BAND_SIZE - 1) / IIR_GAUSS_LINES_BAND_SIZE;
+  this->m_band_mutexes = (ThreadMutex *)MEM_mallocN(sizeof(ThreadMutex) * this->m_num_bands,
+                                                    __func__);
+  this->m_band_done = (bool *)MEM_callocN(sizeof(bool) * this->m_num_bands, __func__);
+  for (int band = 0; band < this->m_num_bands; band++) {
+    BLI_mutex_init(&this->m_band_mutexes[band]);
+  }
+
+  /* Same limits as iir_gauss(), lines which are too short are copied as they are. */
+  const int length = (xy == 1) ? input->getWidth() : input->getHeight();
+  this->m_clip_weights = NULL;
+  if (sigma >= 0.5f && length >= 3) {
+    IIRGaussPass pass;
+    iir_gauss_coefficients(&pass.coefficients, sigma);
+    pass.length = length;
+    this->m_clip_weights = iir_gauss_clip_weights_new(pass);
+  }
+}
+
+IIRGaussLines::~IIRGaussLines()
+{
+  for (int band = 0; band < this->m_num_bands; band++) {
+    BLI_mutex_end(&this->m_band_mutexes[band]);
+  }
+  MEM_freeN(this->m_band_mutexes);
+  MEM_freeN(this->m_band_done);
+  if (this->m_clip_weights) {
+    MEM_freeN(this->m_clip_weights);
+  }
+  delete this->m_result;
+}
+
+MemoryBuffer *IIRGaussLines::ensure(const rcti *rect)
+{
+  const rcti *buffer_rect = this->m_input->getRect();
+  const int width = this->m_input->getWidth();
+  const int height = this->m_input->getHeight();
+  const int num_channels = this->m_input->get_num_channels();
+
+  IIRGaussPass pass;
+  iir_gauss_coefficients(&pass.coefficients, this->m_sigma);
+  pass.input = this->m_input->getBuffer();
+  pass.buffer = this->m_result->getBuffer();
+  pass.channel_begin = 0;
+  pass.channel_end = num_channels;
+
+  int line_begin, line_end;
+  if (this->m_xy == 1) {
+    pass.length = width;
+    pass.num_lines = height;
+    pass.line_stride = width * num_channels;
+    pass.value_stride = num_channels;
+    line_begin = rect ? rect->ymin - buffer_rect->ymin : 0;
+    line_end = rect ? rect->ymax - buffer_rect->ymin : height;
+  }
+  else {
+    pass.length = height;
+    pass.num_lines = width;
+    pass.line_stride = num_channels;
+    pass.value_stride = width * num_channels;
+    line_begin = rect ? rect->xmin - buffer_rect->xmin : 0;
+    line_end = rect ? rect->xmax - buffer_rect->xmin : width;
+  }
+
+  const bool do_filter = this->m_clip_weights != NULL;
+  pass.clip_weights = this->m_clip_weights;
+
+  const int band_begin = max_ii(line_begin, 0) / IIR_GAUSS_LINES_BAND_SIZE;
+  const int band_end = min_ii((line_end + IIR_GAUSS_LINES_BAND_SIZE - 1) /
+                                  IIR_GAUSS_LINES_BAND_SIZE,
+                              this->m_num_bands);
+  for (int band = band_begin; band < band_end; band++) {
+    /* only tiles needing the same band wait for each other */
+    BLI_mutex_lock(&this->m_band_mutexes[band]);
+    if (!this->m_band_done[band]) {
+      const int band_line_begin = band * IIR_GAUSS_LINES_BAND_SIZE;
+      const int band_line_end = min_ii(band_line_begin + IIR_GAUSS_LINES_BAND_SIZE,
+                                       pass.num_lines);
+      if (do_filter) {
+        iir_gauss_lines(pass, band_line_begin, band_line_end);
       }
-      YVV(src_height);
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        buffer[offset] = Y[y];
-        offset += add;
+      else {
+        for (int line = band_line_begin; line < band_line_end; line++) {
+          for (int i = 0; i < pass.length; i++) {
+            const size_t offset = (size_t)line * pass.line_stride + (size_t)i * pass.value_stride;
+            memcpy(pass.buffer + offset, pass.input + offset, sizeof(float) * num_channels);
+          }
+        }
       }
+      this->m_band_done[band] = true;
     }
+    BLI_mutex_unlock(&this->m_band_mutexes[band]);
   }
 
-  MEM_freeN(X);
-  MEM_freeN(W);
-  MEM_freeN(Y);
-#undef YVV
+  return this->m_result;
 }
 
 ///
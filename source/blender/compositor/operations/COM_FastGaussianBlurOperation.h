@@ -36,11 +36,46 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
   void executePixel(float output[4], int x, int y, void *data);
 
   static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int channel, unsigned int xy);
+  /**
+   * \brief blur all channels, pixels outside of the buffer don't contribute to the result
+   * \note same as normalizing a gaussian kernel over the pixels inside the buffer, like
+   * GaussianXBlurOperation and GaussianYBlurOperation do.
+   */
+  static void IIR_gauss_clip(MemoryBuffer *src, float sigma, unsigned int xy);
   void *initializeTileData(rcti *rect);
   void deinitExecution();
   void initExecution();
 };
 
+/**
+ * Clipped recursive gaussian of the rows (xy = 1) or columns (xy = 2) of a buffer, like
+ * FastGaussianBlurOperation::IIR_gauss_clip(). The lines are filtered in bands as tiles request
+ * them, so tiles only wait for each other when they need the same band.
+ */
+class IIRGaussLines {
+ private:
+  MemoryBuffer *m_input;
+  MemoryBuffer *m_result;
+  float m_sigma;
+  unsigned int m_xy;
+  int m_num_bands;
+  ThreadMutex *m_band_mutexes;
+  bool *m_band_done;
+  /** Filtered weights of the values inside a line, the same for all lines. NULL when the lines
+   * are too short to filter. */
+  double *m_clip_weights;
+
+ public:
+  IIRGaussLines(MemoryBuffer *input, float sigma, unsigned int xy);
+  ~IIRGaussLines();
+
+  /**
+   * Filter the lines crossing rect, or all lines when rect is NULL.
+   * \return the result for the whole input, only valid inside of the filtered lines.
+   */
+  MemoryBuffer *ensure(const rcti *rect);
+};
+
 enum {
   FAST_GAUSS_OVERLAY_MIN = -1,
   FAST_GAUSS_OVERLAY_NONE = 0,
@@ -17,6 +17,7 @@
  */
 
 #include "COM_GaussianXBlurOperation.h"
+#include "COM_FastGaussianBlurOperation.h"
 #include "COM_OpenCLDevice.h"
 #include "BLI_math.h"
 #include "MEM_guardedalloc.h"
@@ -32,16 +33,28 @@ GaussianXBlurOperation::GaussianXBlurOperation() : BlurBaseOperation(COM_DT_COLO
   this->m_gausstab_sse = NULL;
 #endif
   this->m_filtersize = 0;
+  this->m_iirgaus = NULL;
 }
 
-void *GaussianXBlurOperation::initializeTileData(rcti * /*rect*/)
+void *GaussianXBlurOperation::initializeTileData(rcti *rect)
 {
   lockMutex();
   if (!this->m_sizeavailable) {
     updateGauss();
   }
   void *buffer = getInputOperation(0)->initializeTileData(NULL);
+
+  /* large radii are calculated recursively over whole rows */
+  const float rad = max_ff(m_size * m_data.sizex, 0.0f);
+  if (this->m_iirgaus == NULL && useRecursiveGauss(rad)) {
+    this->m_iirgaus = new IIRGaussLines((MemoryBuffer *)buffer, rad / 3.0f, 1);
+  }
   unlockMutex();
+
+  if (this->m_iirgaus) {
+    /* outside of the lock, only tiles sharing rows wait for each other */
+    return this->m_iirgaus->ensure(rect);
+  }
   return buffer;
 }
 
@@ -79,6 +92,11 @@ void GaussianXBlurOperation::updateGauss()
 
 void GaussianXBlurOperation::executePixel(float output[4], int x, int y, void *data)
 {
+  if (this->m_iirgaus) {
+    ((MemoryBuffer *)data)->read(output, x, y);
+    return;
+  }
+
   float ATTR_ALIGN(16) color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
   float multiplier_accum = 0.0f;
   MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
@@ -159,6 +177,10 @@ void GaussianXBlurOperation::deinitExecution()
 {
   BlurBaseOperation::deinitExecution();
 
+  if (this->m_iirgaus) {
+    delete this->m_iirgaus;
+    this->m_iirgaus = NULL;
+  }
   if (this->m_gausstab) {
     MEM_freeN(this->m_gausstab);
     this->m_gausstab = NULL;
@@ -191,7 +213,8 @@ bool GaussianXBlurOperation::determineDependingAreaOfInterest(rcti *input,
     }
   }
   {
-    if (this->m_sizeavailable && this->m_gausstab != NULL) {
+    if (this->m_sizeavailable && this->m_gausstab != NULL &&
+        !useRecursiveGauss(this->m_size * this->m_data.sizex)) {
       newInput.xmax = input->xmax + this->m_filtersize + 1;
       newInput.xmin = input->xmin - this->m_filtersize - 1;
       newInput.ymax = input->ymax;
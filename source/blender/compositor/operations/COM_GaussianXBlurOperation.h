@@ -21,6 +21,8 @@
 #include "COM_NodeOperation.h"
 #include "COM_BlurBaseOperation.h"
 
+class IIRGaussLines;
+
 class GaussianXBlurOperation : public BlurBaseOperation {
  private:
   float *m_gausstab;
@@ -28,6 +30,8 @@ class GaussianXBlurOperation : public BlurBaseOperation {
   __m128 *m_gausstab_sse;
 #endif
   int m_filtersize;
+  /** Result of the blur, when calculated recursively. */
+  IIRGaussLines *m_iirgaus;
   void updateGauss();
 
  public:
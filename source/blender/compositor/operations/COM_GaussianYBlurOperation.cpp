@@ -17,6 +17,7 @@
  */
 
 #include "COM_GaussianYBlurOperation.h"
+#include "COM_FastGaussianBlurOperation.h"
 #include "COM_OpenCLDevice.h"
 #include "BLI_math.h"
 #include "MEM_guardedalloc.h"
@@ -32,16 +33,28 @@ GaussianYBlurOperation::GaussianYBlurOperation() : BlurBaseOperation(COM_DT_COLO
   this->m_gausstab_sse = NULL;
 #endif
   this->m_filtersize = 0;
+  this->m_iirgaus = NULL;
 }
 
-void *GaussianYBlurOperation::initializeTileData(rcti * /*rect*/)
+void *GaussianYBlurOperation::initializeTileData(rcti *rect)
 {
   lockMutex();
   if (!this->m_sizeavailable) {
     updateGauss();
   }
   void *buffer = getInputOperation(0)->initializeTileData(NULL);
+
+  /* large radii are calculated recursively over whole columns */
+  const float rad = max_ff(m_size * m_data.sizey, 0.0f);
+  if (this->m_iirgaus == NULL && useRecursiveGauss(rad)) {
+    this->m_iirgaus = new IIRGaussLines((MemoryBuffer *)buffer, rad / 3.0f, 2);
+  }
   unlockMutex();
+
+  if (this->m_iirgaus) {
+    /* outside of the lock, only tiles sharing columns wait for each other */
+    return this->m_iirgaus->ensure(rect);
+  }
   return buffer;
 }
 
@@ -78,6 +91,11 @@ void GaussianYBlurOperation::updateGauss()
 
 void GaussianYBlurOperation::executePixel(float output[4], int x, int y, void *data)
 {
+  if (this->m_iirgaus) {
+    ((MemoryBuffer *)data)->read(output, x, y);
+    return;
+  }
+
   float ATTR_ALIGN(16) color_accum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
   float multiplier_accum = 0.0f;
   MemoryBuffer *inputBuffer = (MemoryBuffer *)data;
@@ -159,6 +177,10 @@ void GaussianYBlurOperation::deinitExecution()
 {
   BlurBaseOperation::deinitExecution();
 
+  if (this->m_iirgaus) {
+    delete this->m_iirgaus;
+    this->m_iirgaus = NULL;
+  }
   if (this->m_gausstab) {
     MEM_freeN(this->m_gausstab);
     this->m_gausstab = NULL;
@@ -191,7 +213,8 @@ bool GaussianYBlurOperation::determineDependingAreaOfInterest(rcti *input,
     }
   }
   {
-    if (this->m_sizeavailable && this->m_gausstab != NULL) {
+    if (this->m_sizeavailable && this->m_gausstab != NULL &&
+        !useRecursiveGauss(this->m_size * this->m_data.sizey)) {
       newInput.xmax = input->xmax;
       newInput.xmin = input->xmin;
       newInput.ymax = input->ymax + this->m_filtersize + 1;
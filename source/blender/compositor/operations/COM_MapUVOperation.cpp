@@ -19,6 +19,8 @@
 #include "COM_MapUVOperation.h"
 #include "BLI_math.h"
 
+#include "MEM_guardedalloc.h"
+
 MapUVOperation::MapUVOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR, COM_SC_NO_RESIZE);
@@ -55,6 +57,63 @@ void MapUVOperation::executePixelSampled(float output[4],
   /* EWA filtering */
   this->m_inputColorProgram->readFiltered(output, uv[0], uv[1], deriv[0], deriv[1]);
 
+  applyAlpha(output, deriv, alpha);
+}
+
+bool MapUVOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  const int width = BLI_rcti_size_x(area);
+  if (width <= 0) {
+    return true;
+  }
+
+  /* pixels with a valid uv, to be filtered together */
+  float *coords = (float *)MEM_mallocN(sizeof(float) * 2 * width, __func__);
+  float(*derivs)[2][2] = (float(*)[2][2])MEM_mallocN(sizeof(*derivs) * width, __func__);
+  float *alphas = (float *)MEM_mallocN(sizeof(float) * width, __func__);
+  int *indices = (int *)MEM_mallocN(sizeof(int) * width, __func__);
+  float *colors = (float *)MEM_mallocN(sizeof(float) * 4 * width, __func__);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *row = output->getPixel(area->xmin, y);
+    int num = 0;
+
+    for (int i = 0; i < width; i++) {
+      const float xy[2] = {(float)(area->xmin + i), (float)y};
+      float alpha;
+      pixelTransform(xy, &coords[num * 2], derivs[num], alpha);
+      if (alpha == 0.0f) {
+        zero_v4(&row[i * 4]);
+        continue;
+      }
+      alphas[num] = alpha;
+      indices[num] = i;
+      num++;
+    }
+
+    this->readInputSpanFiltered(0, coords, derivs, num, colors);
+
+    for (int j = 0; j < num; j++) {
+      float *color = &row[indices[j] * 4];
+      copy_v4_v4(color, &colors[j * 4]);
+      applyAlpha(color, derivs[j], alphas[j]);
+    }
+
+    if (isBraked()) {
+      break;
+    }
+  }
+
+  MEM_freeN(coords);
+  MEM_freeN(derivs);
+  MEM_freeN(alphas);
+  MEM_freeN(indices);
+  MEM_freeN(colors);
+  return true;
+}
+
+void MapUVOperation::applyAlpha(float color[4], const float deriv[2][2], float alpha)
+{
   /* UV to alpha threshold */
   const float threshold = this->m_alpha * 0.05f;
   /* XXX alpha threshold is used to fade out pixels on boundaries with invalid derivatives.
@@ -73,7 +132,7 @@ void MapUVOperation::executePixelSampled(float output[4],
 
   /* "premul" */
   if (alpha < 1.0f) {
-    mul_v4_fl(output, alpha);
+    mul_v4_fl(color, alpha);
   }
 }
 
@@ -45,6 +45,11 @@ class MapUVOperation : public NodeOperation {
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
 
+  /**
+   * filter the image for whole rows at once
+   */
+  bool executeArea(MemoryBuffer *output, const rcti *area);
+
   void pixelTransform(const float xy[2], float r_uv[2], float r_deriv[2][2], float &r_alpha);
 
   /**
@@ -64,6 +69,7 @@ class MapUVOperation : public NodeOperation {
 
  private:
   bool read_uv(float x, float y, float &r_u, float &r_v, float &r_alpha);
+  void applyAlpha(float color[4], const float deriv[2][2], float alpha);
 };
 
 #endif
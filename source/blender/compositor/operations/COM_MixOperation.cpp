@@ -18,6 +18,8 @@
 
 #include "COM_MixOperation.h"
 
+#include "MEM_guardedalloc.h"
+
 extern "C" {
 #include "BLI_math.h"
 }
@@ -97,6 +99,50 @@ void MixBaseOperation::deinitExecution()
   this->m_inputColor2Operation = NULL;
 }
 
+bool MixBaseOperation::executeAreaRows(MemoryBuffer *output,
+                                       const rcti *area,
+                                       MixRowFunc mix_row)
+{
+  const int width = BLI_rcti_size_x(area);
+  if (width <= 0) {
+    return true;
+  }
+
+  float *value = (float *)MEM_mallocN(sizeof(float) * width, __func__);
+  float *color1 = (float *)MEM_mallocN(sizeof(float) * 4 * width, __func__);
+  float *color2 = (float *)MEM_mallocN(sizeof(float) * 4 * width, __func__);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    this->readInputRow(0, y, area->xmin, area->xmax, value);
+    this->readInputRow(1, y, area->xmin, area->xmax, color1);
+    this->readInputRow(2, y, area->xmin, area->xmax, color2);
+
+    if (this->useValueAlphaMultiply()) {
+      for (int i = 0; i < width; i++) {
+        value[i] *= color2[i * 4 + 3];
+      }
+    }
+
+    float *row = output->getPixel(area->xmin, y);
+    mix_row(row, value, color1, color2, width);
+
+    if (this->m_useClamp) {
+      for (int i = 0; i < width; i++) {
+        clamp_v4(&row[i * 4], 0.0f, 1.0f);
+      }
+    }
+
+    if (isBraked()) {
+      break;
+    }
+  }
+
+  MEM_freeN(value);
+  MEM_freeN(color1);
+  MEM_freeN(color2);
+  return true;
+}
+
 /* ******** Mix Add Operation ******** */
 
 MixAddOperation::MixAddOperation() : MixBaseOperation()
@@ -126,6 +172,22 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
   clampIfNeeded(output);
 }
 
+static void mix_add_row(
+    float *output, const float *value, const float *color1, const float *color2, int length)
+{
+  for (int i = 0; i < length; i++, output += 4, color1 += 4, color2 += 4) {
+    output[0] = color1[0] + value[i] * color2[0];
+    output[1] = color1[1] + value[i] * color2[1];
+    output[2] = color1[2] + value[i] * color2[2];
+    output[3] = color1[3];
+  }
+}
+
+bool MixAddOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  return executeAreaRows(output, area, mix_add_row);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -160,6 +222,23 @@ void MixBlendOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+static void mix_blend_row(
+    float *output, const float *value, const float *color1, const float *color2, int length)
+{
+  for (int i = 0; i < length; i++, output += 4, color1 += 4, color2 += 4) {
+    const float valuem = 1.0f - value[i];
+    output[0] = valuem * color1[0] + value[i] * color2[0];
+    output[1] = valuem * color1[1] + value[i] * color2[1];
+    output[2] = valuem * color1[2] + value[i] * color2[2];
+    output[3] = color1[3];
+  }
+}
+
+bool MixBlendOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  return executeAreaRows(output, area, mix_blend_row);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixColorBurnOperation::MixColorBurnOperation() : MixBaseOperation()
@@ -707,6 +786,23 @@ void MixMultiplyOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+static void mix_multiply_row(
+    float *output, const float *value, const float *color1, const float *color2, int length)
+{
+  for (int i = 0; i < length; i++, output += 4, color1 += 4, color2 += 4) {
+    const float valuem = 1.0f - value[i];
+    output[0] = color1[0] * (valuem + value[i] * color2[0]);
+    output[1] = color1[1] * (valuem + value[i] * color2[1]);
+    output[2] = color1[2] * (valuem + value[i] * color2[2]);
+    output[3] = color1[3];
+  }
+}
+
+bool MixMultiplyOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  return executeAreaRows(output, area, mix_multiply_row);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -833,6 +929,23 @@ void MixScreenOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+static void mix_screen_row(
+    float *output, const float *value, const float *color1, const float *color2, int length)
+{
+  for (int i = 0; i < length; i++, output += 4, color1 += 4, color2 += 4) {
+    const float valuem = 1.0f - value[i];
+    output[0] = 1.0f - (valuem + value[i] * (1.0f - color2[0])) * (1.0f - color1[0]);
+    output[1] = 1.0f - (valuem + value[i] * (1.0f - color2[1])) * (1.0f - color1[1]);
+    output[2] = 1.0f - (valuem + value[i] * (1.0f - color2[2])) * (1.0f - color1[2]);
+    output[3] = color1[3];
+  }
+}
+
+bool MixScreenOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  return executeAreaRows(output, area, mix_screen_row);
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
@@ -911,6 +1024,22 @@ void MixSubtractOperation::executePixelSampled(float output[4],
   clampIfNeeded(output);
 }
 
+static void mix_subtract_row(
+    float *output, const float *value, const float *color1, const float *color2, int length)
+{
+  for (int i = 0; i < length; i++, output += 4, color1 += 4, color2 += 4) {
+    output[0] = color1[0] - value[i] * color2[0];
+    output[1] = color1[1] - value[i] * color2[1];
+    output[2] = color1[2] - value[i] * color2[2];
+    output[3] = color1[3];
+  }
+}
+
+bool MixSubtractOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  return executeAreaRows(output, area, mix_subtract_row);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
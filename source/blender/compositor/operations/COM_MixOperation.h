@@ -43,6 +43,17 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * Blend length pixels, value is a single channel and the colors have four channels.
+   */
+  typedef void (*MixRowFunc)(
+      float *output, const float *value, const float *color1, const float *color2, int length);
+
+  /**
+   * Calculate an area row by row, reading full input rows and blending them with mix_row.
+   */
+  bool executeAreaRows(MemoryBuffer *output, const rcti *area, MixRowFunc mix_row);
+
  public:
   /**
    * Default constructor
@@ -84,12 +95,14 @@ class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  bool executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  bool executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
@@ -156,6 +169,7 @@ class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  bool executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -174,6 +188,7 @@ class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  bool executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -186,6 +201,7 @@ class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  bool executeArea(MemoryBuffer *output, const rcti *area);
 };
 
 class MixValueOperation : public MixBaseOperation {
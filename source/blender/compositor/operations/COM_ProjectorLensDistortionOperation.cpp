@@ -20,6 +20,8 @@
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 ProjectorLensDistortionOperation::ProjectorLensDistortionOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -60,6 +62,56 @@ void ProjectorLensDistortionOperation::executePixel(float output[4], int x, int
   output[3] = 1.0f;
 }
 
+bool ProjectorLensDistortionOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  const int width = BLI_rcti_size_x(area);
+  if (width <= 0) {
+    return true;
+  }
+
+  MemoryBuffer *inputBuffer = (MemoryBuffer *)initializeTileData(NULL);
+  const float height = this->getHeight();
+  const float total_width = this->getWidth();
+
+  float *red_coords = (float *)MEM_mallocN(sizeof(float) * 2 * width, __func__);
+  float *blue_coords = (float *)MEM_mallocN(sizeof(float) * 2 * width, __func__);
+  float *red = (float *)MEM_mallocN(sizeof(float) * 4 * width, __func__);
+  float *blue = (float *)MEM_mallocN(sizeof(float) * 4 * width, __func__);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    const float v = (y + 0.5f) / height;
+    for (int i = 0; i < width; i++) {
+      const float u = (area->xmin + i + 0.5f) / total_width;
+      red_coords[i * 2] = (u * total_width + this->m_kr2) - 0.5f;
+      red_coords[i * 2 + 1] = v * height - 0.5f;
+      blue_coords[i * 2] = (u * total_width - this->m_kr2) - 0.5f;
+      blue_coords[i * 2 + 1] = v * height - 0.5f;
+    }
+    inputBuffer->readBilinearSpan(red, red_coords, width);
+    inputBuffer->readBilinearSpan(blue, blue_coords, width);
+
+    float *row = output->getPixel(area->xmin, y);
+    for (int i = 0; i < width; i++, row += 4) {
+      float inputValue[4];
+      inputBuffer->read(inputValue, area->xmin + i, y);
+      row[0] = red[i * 4];
+      row[1] = inputValue[1];
+      row[2] = blue[i * 4 + 2];
+      row[3] = 1.0f;
+    }
+
+    if (isBraked()) {
+      break;
+    }
+  }
+
+  MEM_freeN(red_coords);
+  MEM_freeN(blue_coords);
+  MEM_freeN(red);
+  MEM_freeN(blue);
+  return true;
+}
+
 void ProjectorLensDistortionOperation::deinitExecution()
 {
   this->deinitMutex();
@@ -41,6 +41,11 @@ class ProjectorLensDistortionOperation : public NodeOperation {
    */
   void executePixel(float output[4], int x, int y, void *data);
 
+  /**
+   * sample the red and blue channels for whole rows at once
+   */
+  bool executeArea(MemoryBuffer *output, const rcti *area);
+
   /**
    * Initialize the execution
    */
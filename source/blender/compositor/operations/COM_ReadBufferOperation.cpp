@@ -131,3 +131,65 @@ void ReadBufferOperation::updateMemoryBuffer()
 {
   this->m_buffer = this->getMemoryProxy()->getBuffer();
 }
+
+/* write buffer has a single value stored at (0,0), replicate it num times */
+static void read_single_value(MemoryBuffer *buffer, float *result, int num)
+{
+  const int num_channels = buffer->get_num_channels();
+  float value[4];
+  buffer->read(value, 0, 0);
+  for (int i = 0; i < num; i++, result += num_channels) {
+    memcpy(result, value, sizeof(float) * num_channels);
+  }
+}
+
+void ReadBufferOperation::readRow(float *row, int y, int xmin, int xmax)
+{
+  const int num_channels = m_buffer->get_num_channels();
+
+  if (m_single_value) {
+    read_single_value(m_buffer, row, xmax - xmin);
+    return;
+  }
+
+  const rcti *rect = m_buffer->getRect();
+  memset(row, 0, sizeof(float) * num_channels * (xmax - xmin));
+  if (y < rect->ymin || y >= rect->ymax) {
+    return;
+  }
+
+  const int x1 = max(xmin, rect->xmin);
+  const int x2 = min(xmax, rect->xmax);
+  if (x1 >= x2) {
+    return;
+  }
+
+  const int offset = (m_buffer->getWidth() * (y - rect->ymin) + (x1 - rect->xmin)) *
+                     num_channels;
+  memcpy(&row[(x1 - xmin) * num_channels],
+         &m_buffer->getBuffer()[offset],
+         sizeof(float) * num_channels * (x2 - x1));
+}
+
+void ReadBufferOperation::readBilinearSpan(float *result, const float *coords, int num)
+{
+  if (m_single_value) {
+    read_single_value(m_buffer, result, num);
+  }
+  else {
+    m_buffer->readBilinearSpan(result, coords, num);
+  }
+}
+
+void ReadBufferOperation::readFilteredSpan(float *result,
+                                           const float *coords,
+                                           const float (*derivatives)[2][2],
+                                           int num)
+{
+  if (m_single_value) {
+    read_single_value(m_buffer, result, num);
+  }
+  else {
+    m_buffer->readEWASpan(result, coords, derivatives, num);
+  }
+}
@@ -72,6 +72,24 @@ class ReadBufferOperation : public NodeOperation {
   }
   void readResolutionFromWriteBuffer();
   void updateMemoryBuffer();
+
+  /**
+   * \brief copy the pixels xmin to xmax of row y, pixels outside the buffer are zero
+   */
+  void readRow(float *row, int y, int xmin, int xmax);
+
+  /**
+   * \brief bilinear sample a span of positions, see MemoryBuffer::readBilinearSpan
+   */
+  void readBilinearSpan(float *result, const float *coords, int num);
+
+  /**
+   * \brief EWA filter a span of positions, see MemoryBuffer::readEWASpan
+   */
+  void readFilteredSpan(float *result,
+                        const float *coords,
+                        const float (*derivatives)[2][2],
+                        int num);
 };
 
 #endif
@@ -18,6 +18,8 @@
 
 #include "COM_TranslateOperation.h"
 
+#include "MEM_guardedalloc.h"
+
 TranslateOperation::TranslateOperation() : NodeOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -59,6 +61,35 @@ void TranslateOperation::executePixelSampled(float output[4],
   this->m_inputOperation->readSampled(output, originalXPos, originalYPos, COM_PS_BILINEAR);
 }
 
+bool TranslateOperation::executeArea(MemoryBuffer *output, const rcti *area)
+{
+  const int width = BLI_rcti_size_x(area);
+  if (width <= 0) {
+    return true;
+  }
+
+  ensureDelta();
+
+  const float deltaX = this->getDeltaX();
+  const float deltaY = this->getDeltaY();
+  float *coords = (float *)MEM_mallocN(sizeof(float) * 2 * width, __func__);
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    for (int i = 0; i < width; i++) {
+      coords[i * 2] = (area->xmin + i) - deltaX;
+      coords[i * 2 + 1] = y - deltaY;
+    }
+    this->readInputSpanBilinear(0, coords, width, output->getPixel(area->xmin, y));
+
+    if (isBraked()) {
+      break;
+    }
+  }
+
+  MEM_freeN(coords);
+  return true;
+}
+
 bool TranslateOperation::determineDependingAreaOfInterest(rcti *input,
                                                           ReadBufferOperation *readOperation,
                                                           rcti *output)
@@ -38,6 +38,7 @@ class TranslateOperation : public NodeOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  bool executeArea(MemoryBuffer *output, const rcti *area);
 
   void initExecution();
   void deinitExecution();
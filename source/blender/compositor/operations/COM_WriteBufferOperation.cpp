@@ -27,6 +27,8 @@ WriteBufferOperation::WriteBufferOperation(DataType datatype) : NodeOperation()
   this->m_memoryProxy = new MemoryProxy(datatype);
   this->m_memoryProxy->setWriteBufferOperation(this);
   this->m_memoryProxy->setExecutor(NULL);
+  this->m_cache_key = 0;
+  this->m_use_cache = false;
 }
 WriteBufferOperation::~WriteBufferOperation()
 {
@@ -61,7 +63,10 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
   MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
   float *buffer = memoryBuffer->getBuffer();
   const int num_channels = memoryBuffer->get_num_channels();
-  if (this->m_input->isComplex()) {
+  if (this->m_input->executeArea(memoryBuffer, rect)) {
+    /* calculated in bulk */
+  }
+  else if (this->m_input->isComplex()) {
     void *data = this->m_input->initializeTileData(rect);
     int x1 = rect->xmin;
     int y1 = rect->ymin;
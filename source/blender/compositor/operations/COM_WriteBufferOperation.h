@@ -21,6 +21,7 @@
 
 #include "COM_NodeOperation.h"
 #include "COM_MemoryProxy.h"
+#include "COM_ResultCache.h"
 #include "COM_SocketReader.h"
 /**
  * \brief NodeOperation to write to a tile
@@ -30,6 +31,9 @@ class WriteBufferOperation : public NodeOperation {
   MemoryProxy *m_memoryProxy;
   bool m_single_value; /* single value stored in buffer */
   NodeOperation *m_input;
+  /** Key of the result in the ResultCache, when it is kept between executions. */
+  ResultCache::Key m_cache_key;
+  bool m_use_cache;
 
  public:
   WriteBufferOperation(DataType datatype);
@@ -62,5 +66,19 @@ class WriteBufferOperation : public NodeOperation {
   {
     return m_input;
   }
+
+  void setResultCacheKey(ResultCache::Key key)
+  {
+    m_cache_key = key;
+    m_use_cache = true;
+  }
+  bool useResultCache() const
+  {
+    return m_use_cache;
+  }
+  ResultCache::Key getResultCacheKey() const
+  {
+    return m_cache_key;
+  }
 };
 #endif
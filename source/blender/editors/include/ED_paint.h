@@ -62,6 +62,7 @@ void ED_image_undo_push_begin_with_image(const char *name,
 
 void ED_image_undo_push_end(void);
 void ED_image_undo_restore(struct UndoStep *us);
+size_t ED_image_undo_memory_in_use(void);
 
 void ED_image_undosys_type(struct UndoType *ut);
 
@@ -34,6 +34,7 @@
 #include "BLI_listbase.h"
 #include "BLI_fileops.h"
 #include "BLI_path_util.h"
+#include "BLI_rect.h"
 
 #include "BKE_context.h"
 #include "BKE_global.h"
@@ -94,6 +95,9 @@ typedef struct BakeAPIRender {
   bool is_automatic_name;
   bool is_selected_to_active;
   bool is_cage;
+  bool is_tiled;
+
+  int tile_size;
 
   float cage_extrusion;
   int normal_space;
@@ -171,20 +175,40 @@ static void bake_update_image(ScrArea *sa, Image *image)
   }
 }
 
+static void bake_ibuf_tag_dirty(Image *image, ImBuf *ibuf)
+{
+  ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
+  BKE_image_mark_dirty(image, ibuf);
+
+  if (ibuf->rect_float) {
+    ibuf->userflags |= IB_RECT_INVALID;
+  }
+
+  /* force mipmap recalc */
+  if (ibuf->mipmap[0]) {
+    ibuf->userflags |= IB_MIPMAP_INVALID;
+    imb_freemipmapImBuf(ibuf);
+  }
+}
+
+/* Write the baked pixels of a region of the image, the pixels baked are marked in mask_buffer
+ * (sized for the whole image) for the margin, it's needed when is_clear is false. */
 static bool write_internal_bake_pixels(Image *image,
                                        BakePixel pixel_array[],
                                        float *buffer,
-                                       const int width,
-                                       const int height,
-                                       const int margin,
+                                       const rcti *rect,
+                                       char *mask_buffer,
                                        const bool is_clear,
                                        const bool is_noncolor)
 {
   ImBuf *ibuf;
   void *lock;
   bool is_float;
-  char *mask_buffer = NULL;
+  char *rect_mask = NULL;
+  const int width = BLI_rcti_size_x(rect);
+  const int height = BLI_rcti_size_y(rect);
   const size_t num_pixels = (size_t)width * (size_t)height;
+  size_t offset;
 
   ibuf = BKE_image_acquire_ibuf(image, NULL, &lock);
 
@@ -192,9 +216,22 @@ static bool write_internal_bake_pixels(Image *image,
     return false;
   }
 
-  if (margin > 0 || !is_clear) {
-    mask_buffer = MEM_callocN(sizeof(char) * num_pixels, "Bake Mask");
-    RE_bake_mask_fill(pixel_array, num_pixels, mask_buffer);
+  offset = (size_t)rect->ymin * (size_t)ibuf->x + (size_t)rect->xmin;
+
+  if (mask_buffer) {
+    if (width == ibuf->x) {
+      /* whole rows, the region is contiguous in the mask */
+      rect_mask = mask_buffer + offset;
+      RE_bake_mask_fill(pixel_array, num_pixels, rect_mask);
+    }
+    else {
+      rect_mask = MEM_callocN(sizeof(char) * num_pixels, "Bake Tile Mask");
+      RE_bake_mask_fill(pixel_array, num_pixels, rect_mask);
+
+      for (int y = 0; y < height; y++) {
+        memcpy(mask_buffer + offset + (size_t)y * ibuf->x, rect_mask + (size_t)y * width, width);
+      }
+    }
   }
 
   is_float = (ibuf->rect_float != NULL);
@@ -215,87 +252,91 @@ static bool write_internal_bake_pixels(Image *image,
 
     if (from_colorspace != to_colorspace) {
       IMB_colormanagement_transform(
-          buffer, ibuf->x, ibuf->y, ibuf->channels, from_colorspace, to_colorspace, false);
+          buffer, width, height, ibuf->channels, from_colorspace, to_colorspace, false);
     }
   }
 
   /* populates the ImBuf */
   if (is_clear) {
     if (is_float) {
-      IMB_buffer_float_from_float(ibuf->rect_float,
+      IMB_buffer_float_from_float(ibuf->rect_float + offset * ibuf->channels,
                                   buffer,
                                   ibuf->channels,
                                   IB_PROFILE_LINEAR_RGB,
                                   IB_PROFILE_LINEAR_RGB,
                                   false,
+                                  width,
+                                  height,
                                   ibuf->x,
-                                  ibuf->y,
-                                  ibuf->x,
-                                  ibuf->x);
+                                  width);
     }
     else {
-      IMB_buffer_byte_from_float((unsigned char *)ibuf->rect,
+      IMB_buffer_byte_from_float((unsigned char *)ibuf->rect + offset * 4,
                                  buffer,
                                  ibuf->channels,
                                  ibuf->dither,
                                  IB_PROFILE_SRGB,
                                  IB_PROFILE_SRGB,
                                  false,
+                                 width,
+                                 height,
                                  ibuf->x,
-                                 ibuf->y,
-                                 ibuf->x,
-                                 ibuf->x);
+                                 width);
     }
   }
   else {
     if (is_float) {
-      IMB_buffer_float_from_float_mask(ibuf->rect_float,
+      IMB_buffer_float_from_float_mask(ibuf->rect_float + offset * ibuf->channels,
                                        buffer,
                                        ibuf->channels,
+                                       width,
+                                       height,
                                        ibuf->x,
-                                       ibuf->y,
-                                       ibuf->x,
-                                       ibuf->x,
-                                       mask_buffer);
+                                       width,
+                                       rect_mask);
     }
     else {
-      IMB_buffer_byte_from_float_mask((unsigned char *)ibuf->rect,
+      IMB_buffer_byte_from_float_mask((unsigned char *)ibuf->rect + offset * 4,
                                       buffer,
                                       ibuf->channels,
                                       ibuf->dither,
                                       false,
+                                      width,
+                                      height,
                                       ibuf->x,
-                                      ibuf->y,
-                                      ibuf->x,
-                                      ibuf->x,
-                                      mask_buffer);
+                                      width,
+                                      rect_mask);
     }
   }
 
-  /* margins */
-  if (margin > 0) {
-    RE_bake_margin(ibuf, mask_buffer, margin);
-  }
+  bake_ibuf_tag_dirty(image, ibuf);
 
-  ibuf->userflags |= IB_DISPLAY_BUFFER_INVALID;
-  BKE_image_mark_dirty(image, ibuf);
+  BKE_image_release_ibuf(image, ibuf, NULL);
 
-  if (ibuf->rect_float) {
-    ibuf->userflags |= IB_RECT_INVALID;
+  if (rect_mask && rect_mask != mask_buffer + offset) {
+    MEM_freeN(rect_mask);
   }
 
-  /* force mipmap recalc */
-  if (ibuf->mipmap[0]) {
-    ibuf->userflags |= IB_MIPMAP_INVALID;
-    imb_freemipmapImBuf(ibuf);
-  }
+  return true;
+}
 
-  BKE_image_release_ibuf(image, ibuf, NULL);
+/* margins, once all the pixels of the image are written */
+static bool write_internal_bake_margin(Image *image, char *mask_buffer, const int margin)
+{
+  ImBuf *ibuf;
+  void *lock;
 
-  if (mask_buffer) {
-    MEM_freeN(mask_buffer);
+  ibuf = BKE_image_acquire_ibuf(image, NULL, &lock);
+
+  if (!ibuf) {
+    return false;
   }
 
+  RE_bake_margin(ibuf, mask_buffer, margin);
+  bake_ibuf_tag_dirty(image, ibuf);
+
+  BKE_image_release_ibuf(image, ibuf, NULL);
+
   return true;
 }
 
@@ -316,7 +357,7 @@ static void refresh_images(BakeImages *bake_images)
 }
 
 static bool write_external_bake_pixels(const char *filepath,
-                                       BakePixel pixel_array[],
+                                       char *mask_buffer,
                                        float *buffer,
                                        const int width,
                                        const int height,
@@ -374,16 +415,7 @@ static bool write_external_bake_pixels(const char *filepath,
 
   /* margins */
   if (margin > 0) {
-    char *mask_buffer = NULL;
-    const size_t num_pixels = (size_t)width * (size_t)height;
-
-    mask_buffer = MEM_callocN(sizeof(char) * num_pixels, "Bake Mask");
-    RE_bake_mask_fill(pixel_array, num_pixels, mask_buffer);
     RE_bake_margin(ibuf, mask_buffer, margin);
-
-    if (mask_buffer) {
-      MEM_freeN(mask_buffer);
-    }
   }
 
   if ((ok = BKE_imbuf_write(ibuf, filepath, im_format))) {
@@ -719,6 +751,239 @@ static Mesh *bake_mesh_new_from_object(Object *object)
   return me;
 }
 
+/* Mesh of the low poly object without multires, for the tangents of the tangent space normals.
+ * This frees the evaluated data of the object. */
+static Mesh *bake_mesh_new_without_multires(Object *ob_low_eval)
+{
+  Mesh *me_nores;
+  ModifierData *md;
+  int mode = 0;
+
+  BKE_object_eval_reset(ob_low_eval);
+  md = modifiers_findByType(ob_low_eval, eModifierType_Multires);
+
+  if (md) {
+    mode = md->mode;
+    md->mode &= ~eModifierMode_Render;
+  }
+
+  /* Evaluate modifiers again. */
+  me_nores = BKE_mesh_new_from_object(NULL, ob_low_eval, false);
+
+  if (md) {
+    md->mode = mode;
+  }
+
+  return me_nores;
+}
+
+/* A region of one of the images, baked at once with #R_BAKE_TILED. */
+typedef struct BakeTile {
+  int image_id;
+  rcti rect;
+} BakeTile;
+
+static void bake_pixels_populate(Mesh *me,
+                                 BakePixel *pixel_array,
+                                 const size_t num_pixels,
+                                 const BakeImages *bake_images,
+                                 const BakeTile *tile,
+                                 const char *uv_layer)
+{
+  if (tile) {
+    RE_bake_pixels_populate_tile(
+        me, pixel_array, bake_images, tile->image_id, &tile->rect, uv_layer);
+  }
+  else {
+    RE_bake_pixels_populate(me, pixel_array, num_pixels, bake_images, uv_layer);
+  }
+}
+
+/* Bake a tile of one of the images, or all the images at once when tile is NULL: populate the
+ * pixels, run the render engine and convert the normals, leaving the baked pixels in result.
+ * The triangles of the meshes are computed once by bake() and shared by all the tiles. */
+static bool bake_pixels(Render *re,
+                        Depsgraph *depsgraph,
+                        ReportList *reports,
+                        Object *ob_low_eval,
+                        Object *ob_cage,
+                        Mesh *me_low,
+                        Mesh *me_cage,
+                        Mesh *me_nores,
+                        const BakeMeshTriangles *tris_low,
+                        const BakeMeshTriangles *tris_cage,
+                        BakeHighPolyData *highpoly,
+                        const int tot_highpoly,
+                        const BakeImages *bake_images,
+                        const BakeTile *tile,
+                        const char *uv_layer,
+                        BakePixel *pixel_array_low,
+                        BakePixel *pixel_array_high,
+                        const size_t num_pixels,
+                        float *result,
+                        const int depth,
+                        const eScenePassType pass_type,
+                        const int pass_filter,
+                        const bool is_selected_to_active,
+                        const bool is_cage,
+                        const float cage_extrusion,
+                        const int normal_space,
+                        const eBakeNormalSwizzle normal_swizzle[])
+{
+  /* populate the pixel array with the face data,
+   * or with the 'cage' mesh (the smooth version of the mesh) */
+  if (is_selected_to_active && (ob_cage == NULL) && is_cage) {
+    bake_pixels_populate(me_cage, pixel_array_low, num_pixels, bake_images, tile, uv_layer);
+  }
+  else {
+    bake_pixels_populate(me_low, pixel_array_low, num_pixels, bake_images, tile, uv_layer);
+  }
+
+  if (is_selected_to_active) {
+    /* populate the pixel arrays with the corresponding face data for each high poly object */
+    if (!RE_bake_pixels_populate_from_objects(tris_low,
+                                              pixel_array_low,
+                                              pixel_array_high,
+                                              highpoly,
+                                              tot_highpoly,
+                                              num_pixels,
+                                              ob_cage != NULL,
+                                              cage_extrusion,
+                                              ob_low_eval->obmat,
+                                              (ob_cage ? ob_cage->obmat : ob_low_eval->obmat),
+                                              tris_cage)) {
+      BKE_report(reports, RPT_ERROR, "Error handling selected objects");
+      return false;
+    }
+
+    /* the baking itself */
+    for (int i = 0; i < tot_highpoly; i++) {
+      if (!RE_bake_engine(re,
+                          depsgraph,
+                          highpoly[i].ob,
+                          i,
+                          pixel_array_high,
+                          num_pixels,
+                          depth,
+                          pass_type,
+                          pass_filter,
+                          result)) {
+        BKE_reportf(
+            reports, RPT_ERROR, "Error baking from object \"%s\"", highpoly[i].ob->id.name + 2);
+        return false;
+      }
+    }
+  }
+  else {
+    /* If low poly is not renderable it should have failed long ago. */
+    BLI_assert((ob_low_eval->restrictflag & OB_RESTRICT_RENDER) == 0);
+
+    if (!RE_bake_engine(re,
+                        depsgraph,
+                        ob_low_eval,
+                        0,
+                        pixel_array_low,
+                        num_pixels,
+                        depth,
+                        pass_type,
+                        pass_filter,
+                        result)) {
+      BKE_reportf(reports, RPT_ERROR, "Problem baking object \"%s\"", ob_low_eval->id.name + 2);
+      return false;
+    }
+  }
+
+  /* normal space conversion
+   * the normals are expected to be in world space, +X +Y +Z */
+  if (pass_type == SCE_PASS_NORMAL) {
+    switch (normal_space) {
+      case R_BAKE_SPACE_WORLD: {
+        /* Cycles internal format */
+        if ((normal_swizzle[0] == R_BAKE_POSX) && (normal_swizzle[1] == R_BAKE_POSY) &&
+            (normal_swizzle[2] == R_BAKE_POSZ)) {
+          break;
+        }
+        else {
+          RE_bake_normal_world_to_world(
+              pixel_array_low, num_pixels, depth, result, normal_swizzle);
+        }
+        break;
+      }
+      case R_BAKE_SPACE_OBJECT: {
+        RE_bake_normal_world_to_object(
+            pixel_array_low, num_pixels, depth, result, ob_low_eval, normal_swizzle);
+        break;
+      }
+      case R_BAKE_SPACE_TANGENT: {
+        if (!is_selected_to_active) {
+          /* from multiresolution, tris_low are the triangles of me_nores */
+          bake_pixels_populate(me_nores, pixel_array_low, num_pixels, bake_images, tile, uv_layer);
+        }
+
+        RE_bake_normal_world_to_tangent(pixel_array_low,
+                                        num_pixels,
+                                        depth,
+                                        result,
+                                        tris_low,
+                                        normal_swizzle,
+                                        ob_low_eval->obmat);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
+
+static void bake_external_filepath(char name[FILE_MAX],
+                                   Main *bmain,
+                                   const BakeData *bake,
+                                   const char *filepath,
+                                   const char *identifier,
+                                   Object *ob_low_eval,
+                                   Mesh *me_low,
+                                   const BakeImage *bk_image,
+                                   const int image_id,
+                                   const bool is_automatic_name,
+                                   const bool is_split_materials)
+{
+  BKE_image_path_from_imtype(name,
+                             filepath,
+                             BKE_main_blendfile_path(bmain),
+                             0,
+                             bake->im_format.imtype,
+                             true,
+                             false,
+                             NULL);
+
+  if (is_automatic_name) {
+    BLI_path_suffix(name, FILE_MAX, ob_low_eval->id.name + 2, "_");
+    BLI_path_suffix(name, FILE_MAX, identifier, "_");
+  }
+
+  if (is_split_materials) {
+    if (bk_image->image) {
+      BLI_path_suffix(name, FILE_MAX, bk_image->image->id.name + 2, "_");
+    }
+    else {
+      if (ob_low_eval->mat[image_id]) {
+        BLI_path_suffix(name, FILE_MAX, ob_low_eval->mat[image_id]->id.name + 2, "_");
+      }
+      else if (me_low->mat[image_id]) {
+        BLI_path_suffix(name, FILE_MAX, me_low->mat[image_id]->id.name + 2, "_");
+      }
+      else {
+        /* if everything else fails, use the material index */
+        char tmp[5];
+        sprintf(tmp, "%d", image_id % 1000);
+        BLI_path_suffix(name, FILE_MAX, tmp, "_");
+      }
+    }
+  }
+}
+
 static int bake(Render *re,
                 Main *bmain,
                 Scene *scene,
@@ -735,6 +1000,8 @@ static int bake(Render *re,
                 const bool is_automatic_name,
                 const bool is_selected_to_active,
                 const bool is_cage,
+                const bool is_tiled,
+                const int tile_size,
                 const float cage_extrusion,
                 const int normal_space,
                 const eBakeNormalSwizzle normal_swizzle[],
@@ -754,6 +1021,9 @@ static int bake(Render *re,
   int op_result = OPERATOR_CANCELLED;
   bool ok = false;
 
+  const bool is_tangent = ((pass_type == SCE_PASS_NORMAL) &&
+                           (normal_space == R_BAKE_SPACE_TANGENT));
+
   Object *ob_cage = NULL;
   Object *ob_cage_eval = NULL;
   Object *ob_low_eval = NULL;
@@ -763,6 +1033,10 @@ static int bake(Render *re,
 
   Mesh *me_low = NULL;
   Mesh *me_cage = NULL;
+  Mesh *me_nores = NULL;
+
+  BakeMeshTriangles *tris_low = NULL;
+  BakeMeshTriangles *tris_cage = NULL;
 
   MultiresModifierData *mmd_low = NULL;
   int mmd_flags_low = 0;
@@ -772,6 +1046,10 @@ static int bake(Render *re,
   BakePixel *pixel_array_low = NULL;
   BakePixel *pixel_array_high = NULL;
 
+  /* with tiles, for the whole image */
+  char *mask_buffer = NULL;
+  float *image_result = NULL;
+
   const bool is_save_internal = (save_mode == R_BAKE_SAVE_INTERNAL);
   const bool is_noncolor = is_noncolor_pass(pass_type);
   const int depth = RE_pass_depth(pass_type);
@@ -780,6 +1058,7 @@ static int bake(Render *re,
 
   size_t num_pixels;
   int tot_materials;
+  int tot_images;
 
   RE_bake_engine_set_engine_parameters(re, bmain, scene);
 
@@ -887,6 +1166,20 @@ static int bake(Render *re,
     }
   }
 
+  /* when saving externally without splitting materials, a single image is saved */
+  tot_images = (is_save_internal || is_split_materials) ? bake_images.size :
+                                                          min_ii(bake_images.size, 1);
+
+  if (is_tiled) {
+    /* the pixels are only allocated for a tile */
+    num_pixels = 0;
+    for (int i = 0; i < tot_images; i++) {
+      const size_t num_pixels_tile = (size_t)min_ii(tile_size, bake_images.data[i].width) *
+                                     (size_t)min_ii(tile_size, bake_images.data[i].height);
+      num_pixels = max_zz(num_pixels, num_pixels_tile);
+    }
+  }
+
   pixel_array_low = MEM_mallocN(sizeof(BakePixel) * num_pixels, "bake pixels low poly");
   pixel_array_high = MEM_mallocN(sizeof(BakePixel) * num_pixels, "bake pixels high poly");
   result = MEM_callocN(sizeof(float) * depth * num_pixels, "bake return pixels");
@@ -908,12 +1201,6 @@ static int bake(Render *re,
   /* get the mesh as it arrives in the renderer */
   me_low = bake_mesh_new_from_object(ob_low_eval);
 
-  /* populate the pixel array with the face data */
-  if ((is_selected_to_active && (ob_cage == NULL) && is_cage) == false) {
-    RE_bake_pixels_populate(me_low, pixel_array_low, num_pixels, &bake_images, uv_layer);
-  }
-  /* else populate the pixel array with the 'cage' mesh (the smooth version of the mesh)  */
-
   if (is_selected_to_active) {
     CollectionPointerLink *link;
     int i = 0;
@@ -962,7 +1249,6 @@ static int bake(Render *re,
       }
 
       me_cage = BKE_mesh_new_from_object(NULL, ob_low_eval, false);
-      RE_bake_pixels_populate(me_cage, pixel_array_low, num_pixels, &bake_images, uv_layer);
     }
 
     highpoly = MEM_callocN(sizeof(BakeHighPolyData) * tot_highpoly, "bake high poly objects");
@@ -999,232 +1285,245 @@ static int bake(Render *re,
     }
     ob_low_eval->restrictflag |= OB_RESTRICT_RENDER;
     ob_low_eval->base_flag &= ~(BASE_VISIBLE_DEPSGRAPH | BASE_ENABLED_RENDER);
+  }
+  else if (is_tangent) {
+    /* Get the mesh without multires once for all tiles and evaluate the object again for the
+     * render engine, as is done for the cage above. */
+    me_nores = bake_mesh_new_without_multires(ob_low_eval);
+    BKE_object_handle_data_update(depsgraph, scene, ob_low_eval);
+  }
 
-    /* populate the pixel arrays with the corresponding face data for each high poly object */
-    if (!RE_bake_pixels_populate_from_objects(me_low,
-                                              pixel_array_low,
-                                              pixel_array_high,
-                                              highpoly,
-                                              tot_highpoly,
-                                              num_pixels,
-                                              ob_cage != NULL,
-                                              cage_extrusion,
-                                              ob_low_eval->obmat,
-                                              (ob_cage ? ob_cage->obmat : ob_low_eval->obmat),
-                                              me_cage)) {
-      BKE_report(reports, RPT_ERROR, "Error handling selected objects");
-      goto cleanup;
+  /* The triangles do not change between tiles. The low poly mesh needs tangents to convert
+   * the normals, or loop normals to cast rays from when there is no cage. */
+  if (is_selected_to_active) {
+    if (me_cage == NULL || ob_cage != NULL || is_tangent) {
+      tris_low = RE_bake_mesh_triangles_new(me_low, me_cage == NULL || is_tangent);
     }
-
-    /* the baking itself */
-    for (i = 0; i < tot_highpoly; i++) {
-      ok = RE_bake_engine(re,
-                          depsgraph,
-                          highpoly[i].ob,
-                          i,
-                          pixel_array_high,
-                          num_pixels,
-                          depth,
-                          pass_type,
-                          pass_filter,
-                          result);
-      if (!ok) {
-        BKE_reportf(
-            reports, RPT_ERROR, "Error baking from object \"%s\"", highpoly[i].ob->id.name + 2);
-        goto cleanup;
-      }
+    if (me_cage != NULL) {
+      tris_cage = RE_bake_mesh_triangles_new(me_cage, false);
     }
-  }
-  else {
-    /* If low poly is not renderable it should have failed long ago. */
-    BLI_assert((ob_low_eval->restrictflag & OB_RESTRICT_RENDER) == 0);
-
-    if (RE_bake_has_engine(re)) {
-      ok = RE_bake_engine(re,
-                          depsgraph,
-                          ob_low_eval,
-                          0,
-                          pixel_array_low,
-                          num_pixels,
-                          depth,
-                          pass_type,
-                          pass_filter,
-                          result);
+    for (int i = 0; i < tot_highpoly; i++) {
+      highpoly[i].triangles = RE_bake_mesh_triangles_new(highpoly[i].me, false);
     }
-    else {
-      BKE_report(reports, RPT_ERROR, "Current render engine does not support baking");
+  }
+  else if (is_tangent) {
+    tris_low = RE_bake_mesh_triangles_new(me_nores, true);
+  }
+
+  if (!is_tiled) {
+    ok = bake_pixels(re,
+                     depsgraph,
+                     reports,
+                     ob_low_eval,
+                     ob_cage,
+                     me_low,
+                     me_cage,
+                     me_nores,
+                     tris_low,
+                     tris_cage,
+                     highpoly,
+                     tot_highpoly,
+                     &bake_images,
+                     NULL,
+                     uv_layer,
+                     pixel_array_low,
+                     pixel_array_high,
+                     num_pixels,
+                     result,
+                     depth,
+                     pass_type,
+                     pass_filter,
+                     is_selected_to_active,
+                     is_cage,
+                     cage_extrusion,
+                     normal_space,
+                     normal_swizzle);
+
+    if (!ok) {
       goto cleanup;
     }
   }
 
-  /* normal space conversion
-   * the normals are expected to be in world space, +X +Y +Z */
-  if (ok && pass_type == SCE_PASS_NORMAL) {
-    switch (normal_space) {
-      case R_BAKE_SPACE_WORLD: {
-        /* Cycles internal format */
-        if ((normal_swizzle[0] == R_BAKE_POSX) && (normal_swizzle[1] == R_BAKE_POSY) &&
-            (normal_swizzle[2] == R_BAKE_POSZ)) {
-          break;
-        }
-        else {
-          RE_bake_normal_world_to_world(
-              pixel_array_low, num_pixels, depth, result, normal_swizzle);
-        }
-        break;
-      }
-      case R_BAKE_SPACE_OBJECT: {
-        RE_bake_normal_world_to_object(
-            pixel_array_low, num_pixels, depth, result, ob_low_eval, normal_swizzle);
-        break;
-      }
-      case R_BAKE_SPACE_TANGENT: {
-        if (is_selected_to_active) {
-          RE_bake_normal_world_to_tangent(pixel_array_low,
-                                          num_pixels,
-                                          depth,
-                                          result,
-                                          me_low,
-                                          normal_swizzle,
-                                          ob_low_eval->obmat);
-        }
-        else {
-          /* from multiresolution */
-          Mesh *me_nores = NULL;
-          ModifierData *md = NULL;
-          int mode;
-
-          BKE_object_eval_reset(ob_low_eval);
-          md = modifiers_findByType(ob_low_eval, eModifierType_Multires);
-
-          if (md) {
-            mode = md->mode;
-            md->mode &= ~eModifierMode_Render;
-          }
+  /* save the results */
+  for (int i = 0; i < tot_images; i++) {
+    BakeImage *bk_image = &bake_images.data[i];
+    const size_t num_pixels_image = (size_t)bk_image->width * (size_t)bk_image->height;
+    BakeData *bake = &scene->r.bake;
+    char name[FILE_MAX];
+
+    if (!is_save_internal) {
+      bake_external_filepath(name,
+                             bmain,
+                             bake,
+                             filepath,
+                             identifier,
+                             ob_low_eval,
+                             me_low,
+                             bk_image,
+                             i,
+                             is_automatic_name,
+                             is_split_materials);
+    }
 
-          /* Evaluate modifiers again. */
-          me_nores = BKE_mesh_new_from_object(NULL, ob_low_eval, false);
-          RE_bake_pixels_populate(me_nores, pixel_array_low, num_pixels, &bake_images, uv_layer);
-
-          RE_bake_normal_world_to_tangent(pixel_array_low,
-                                          num_pixels,
-                                          depth,
-                                          result,
-                                          me_nores,
-                                          normal_swizzle,
-                                          ob_low_eval->obmat);
-          BKE_id_free(NULL, &me_nores->id);
-
-          if (md) {
-            md->mode = mode;
-          }
-        }
-        break;
-      }
-      default:
-        break;
+    if ((!is_save_internal && margin > 0) || (is_save_internal && (margin > 0 || !is_clear))) {
+      mask_buffer = MEM_callocN(sizeof(char) * num_pixels_image, "Bake Mask");
     }
-  }
 
-  if (!ok) {
-    BKE_reportf(reports, RPT_ERROR, "Problem baking object \"%s\"", ob_low->id.name + 2);
-    op_result = OPERATOR_CANCELLED;
-  }
-  else {
-    /* save the results */
-    for (int i = 0; i < bake_images.size; i++) {
-      BakeImage *bk_image = &bake_images.data[i];
+    if (is_tiled) {
+      BakeTile tile = {i};
 
-      if (is_save_internal) {
-        ok = write_internal_bake_pixels(bk_image->image,
-                                        pixel_array_low + bk_image->offset,
-                                        result + bk_image->offset * depth,
-                                        bk_image->width,
-                                        bk_image->height,
-                                        margin,
-                                        is_clear,
-                                        is_noncolor);
+      if (!is_save_internal) {
+        image_result = MEM_callocN(sizeof(float) * depth * num_pixels_image, "bake image pixels");
+      }
 
-        /* might be read by UI to set active image for display */
-        bake_update_image(sa, bk_image->image);
+      /* bake the image one tile at a time, each tile is written to the image as it finishes */
+      for (int ymin = 0; ymin < bk_image->height; ymin += tile_size) {
+        for (int xmin = 0; xmin < bk_image->width; xmin += tile_size) {
+          BLI_rcti_init(&tile.rect,
+                        xmin,
+                        min_ii(xmin + tile_size, bk_image->width),
+                        ymin,
+                        min_ii(ymin + tile_size, bk_image->height));
+
+          const int tile_width = BLI_rcti_size_x(&tile.rect);
+          const int tile_height = BLI_rcti_size_y(&tile.rect);
+          const size_t num_pixels_tile = (size_t)tile_width * (size_t)tile_height;
+
+          if (G.is_break) {
+            goto cleanup;
+          }
 
-        if (!ok) {
-          BKE_reportf(reports,
-                      RPT_ERROR,
-                      "Problem saving the bake map internally for object \"%s\"",
-                      ob_low->id.name + 2);
-          op_result = OPERATOR_CANCELLED;
-        }
-        else {
-          BKE_report(reports,
-                     RPT_INFO,
-                     "Baking map saved to internal image, save it externally or pack it");
-          op_result = OPERATOR_FINISHED;
-        }
-      }
-      /* save externally */
-      else {
-        BakeData *bake = &scene->r.bake;
-        char name[FILE_MAX];
-
-        BKE_image_path_from_imtype(name,
-                                   filepath,
-                                   BKE_main_blendfile_path(bmain),
-                                   0,
-                                   bake->im_format.imtype,
-                                   true,
-                                   false,
-                                   NULL);
-
-        if (is_automatic_name) {
-          BLI_path_suffix(name, FILE_MAX, ob_low->id.name + 2, "_");
-          BLI_path_suffix(name, FILE_MAX, identifier, "_");
-        }
+          memset(result, 0, sizeof(float) * depth * num_pixels_tile);
+
+          ok = bake_pixels(re,
+                           depsgraph,
+                           reports,
+                           ob_low_eval,
+                           ob_cage,
+                           me_low,
+                           me_cage,
+                           me_nores,
+                           tris_low,
+                           tris_cage,
+                           highpoly,
+                           tot_highpoly,
+                           &bake_images,
+                           &tile,
+                           uv_layer,
+                           pixel_array_low,
+                           pixel_array_high,
+                           num_pixels_tile,
+                           result,
+                           depth,
+                           pass_type,
+                           pass_filter,
+                           is_selected_to_active,
+                           is_cage,
+                           cage_extrusion,
+                           normal_space,
+                           normal_swizzle);
+
+          if (!ok) {
+            goto cleanup;
+          }
 
-        if (is_split_materials) {
-          if (bk_image->image) {
-            BLI_path_suffix(name, FILE_MAX, bk_image->image->id.name + 2, "_");
+          if (is_save_internal) {
+            ok = write_internal_bake_pixels(bk_image->image,
+                                            pixel_array_low,
+                                            result,
+                                            &tile.rect,
+                                            mask_buffer,
+                                            is_clear,
+                                            is_noncolor);
+            if (!ok) {
+              break;
+            }
           }
           else {
-            if (ob_low_eval->mat[i]) {
-              BLI_path_suffix(name, FILE_MAX, ob_low_eval->mat[i]->id.name + 2, "_");
-            }
-            else if (me_low->mat[i]) {
-              BLI_path_suffix(name, FILE_MAX, me_low->mat[i]->id.name + 2, "_");
-            }
-            else {
-              /* if everything else fails, use the material index */
-              char tmp[5];
-              sprintf(tmp, "%d", i % 1000);
-              BLI_path_suffix(name, FILE_MAX, tmp, "_");
+            const size_t offset = (size_t)ymin * bk_image->width + xmin;
+
+            for (int y = 0; y < tile_height; y++) {
+              memcpy(image_result + (offset + (size_t)y * bk_image->width) * depth,
+                     result + (size_t)y * tile_width * depth,
+                     sizeof(float) * depth * tile_width);
+              RE_bake_mask_fill(pixel_array_low + (size_t)y * tile_width,
+                                tile_width,
+                                mask_buffer ? mask_buffer + offset + (size_t)y * bk_image->width :
+                                              NULL);
             }
           }
         }
 
-        /* save it externally */
-        ok = write_external_bake_pixels(name,
-                                        pixel_array_low + bk_image->offset,
-                                        result + bk_image->offset * depth,
-                                        bk_image->width,
-                                        bk_image->height,
-                                        margin,
-                                        &bake->im_format,
-                                        is_noncolor);
-
         if (!ok) {
-          BKE_reportf(reports, RPT_ERROR, "Problem saving baked map in \"%s\"", name);
-          op_result = OPERATOR_CANCELLED;
-        }
-        else {
-          BKE_reportf(reports, RPT_INFO, "Baking map written to \"%s\"", name);
-          op_result = OPERATOR_FINISHED;
-        }
-
-        if (!is_split_materials) {
           break;
         }
       }
+
+      if (ok && is_save_internal && margin > 0) {
+        ok = write_internal_bake_margin(bk_image->image, mask_buffer, margin);
+      }
+    }
+    else if (is_save_internal) {
+      rcti rect;
+      BLI_rcti_init(&rect, 0, bk_image->width, 0, bk_image->height);
+
+      ok = write_internal_bake_pixels(bk_image->image,
+                                      pixel_array_low + bk_image->offset,
+                                      result + bk_image->offset * depth,
+                                      &rect,
+                                      mask_buffer,
+                                      is_clear,
+                                      is_noncolor);
+
+      if (ok && margin > 0) {
+        ok = write_internal_bake_margin(bk_image->image, mask_buffer, margin);
+      }
     }
+    else {
+      RE_bake_mask_fill(pixel_array_low + bk_image->offset, num_pixels_image, mask_buffer);
+    }
+
+    if (is_save_internal) {
+      /* might be read by UI to set active image for display */
+      bake_update_image(sa, bk_image->image);
+
+      if (!ok) {
+        BKE_reportf(reports,
+                    RPT_ERROR,
+                    "Problem saving the bake map internally for object \"%s\"",
+                    ob_low->id.name + 2);
+        op_result = OPERATOR_CANCELLED;
+      }
+      else {
+        BKE_report(reports,
+                   RPT_INFO,
+                   "Baking map saved to internal image, save it externally or pack it");
+        op_result = OPERATOR_FINISHED;
+      }
+    }
+    /* save externally */
+    else {
+      ok = write_external_bake_pixels(name,
+                                      mask_buffer,
+                                      is_tiled ? image_result : result + bk_image->offset * depth,
+                                      bk_image->width,
+                                      bk_image->height,
+                                      margin,
+                                      &bake->im_format,
+                                      is_noncolor);
+
+      if (!ok) {
+        BKE_reportf(reports, RPT_ERROR, "Problem saving baked map in \"%s\"", name);
+        op_result = OPERATOR_CANCELLED;
+      }
+      else {
+        BKE_reportf(reports, RPT_INFO, "Baking map written to \"%s\"", name);
+        op_result = OPERATOR_FINISHED;
+      }
+    }
+
+    MEM_SAFE_FREE(mask_buffer);
+    MEM_SAFE_FREE(image_result);
   }
 
   if (is_save_internal) {
@@ -1239,6 +1538,9 @@ cleanup:
       if (highpoly[i].me != NULL) {
         BKE_id_free(NULL, &highpoly[i].me->id);
       }
+      if (highpoly[i].triangles != NULL) {
+        RE_bake_mesh_triangles_free(highpoly[i].triangles);
+      }
     }
     MEM_freeN(highpoly);
   }
@@ -1275,6 +1577,21 @@ cleanup:
     BKE_id_free(NULL, &me_cage->id);
   }
 
+  if (me_nores != NULL) {
+    BKE_id_free(NULL, &me_nores->id);
+  }
+
+  if (tris_low != NULL) {
+    RE_bake_mesh_triangles_free(tris_low);
+  }
+
+  if (tris_cage != NULL) {
+    RE_bake_mesh_triangles_free(tris_cage);
+  }
+
+  MEM_SAFE_FREE(mask_buffer);
+  MEM_SAFE_FREE(image_result);
+
   DEG_graph_free(depsgraph);
 
   return op_result;
@@ -1304,6 +1621,8 @@ static void bake_init_api_data(wmOperator *op, bContext *C, BakeAPIRender *bkr)
   bkr->is_selected_to_active = RNA_boolean_get(op->ptr, "use_selected_to_active");
   bkr->is_cage = RNA_boolean_get(op->ptr, "use_cage");
   bkr->cage_extrusion = RNA_float_get(op->ptr, "cage_extrusion");
+  bkr->is_tiled = RNA_boolean_get(op->ptr, "use_tiles");
+  bkr->tile_size = RNA_int_get(op->ptr, "tile_size");
 
   bkr->normal_space = RNA_enum_get(op->ptr, "normal_space");
   bkr->normal_swizzle[0] = RNA_enum_get(op->ptr, "normal_r");
@@ -1392,6 +1711,8 @@ static int bake_exec(bContext *C, wmOperator *op)
                   bkr.is_automatic_name,
                   true,
                   bkr.is_cage,
+                  bkr.is_tiled,
+                  bkr.tile_size,
                   bkr.cage_extrusion,
                   bkr.normal_space,
                   bkr.normal_swizzle,
@@ -1424,6 +1745,8 @@ static int bake_exec(bContext *C, wmOperator *op)
                     bkr.is_automatic_name,
                     false,
                     bkr.is_cage,
+                    bkr.is_tiled,
+                    bkr.tile_size,
                     bkr.cage_extrusion,
                     bkr.normal_space,
                     bkr.normal_swizzle,
@@ -1493,6 +1816,8 @@ static void bake_startjob(void *bkv, short *UNUSED(stop), short *do_update, floa
                        bkr->is_automatic_name,
                        true,
                        bkr->is_cage,
+                       bkr->is_tiled,
+                       bkr->tile_size,
                        bkr->cage_extrusion,
                        bkr->normal_space,
                        bkr->normal_swizzle,
@@ -1525,6 +1850,8 @@ static void bake_startjob(void *bkv, short *UNUSED(stop), short *do_update, floa
                          bkr->is_automatic_name,
                          false,
                          bkr->is_cage,
+                         bkr->is_tiled,
+                         bkr->tile_size,
                          bkr->cage_extrusion,
                          bkr->normal_space,
                          bkr->normal_swizzle,
@@ -1646,6 +1973,16 @@ static void bake_set_props(wmOperator *op, Scene *scene)
   if (!RNA_property_is_set(op->ptr, prop)) {
     RNA_property_enum_set(op->ptr, prop, bake->pass_filter);
   }
+
+  prop = RNA_struct_find_property(op->ptr, "use_tiles");
+  if (!RNA_property_is_set(op->ptr, prop)) {
+    RNA_property_boolean_set(op->ptr, prop, (bake->flag & R_BAKE_TILED) != 0);
+  }
+
+  prop = RNA_struct_find_property(op->ptr, "tile_size");
+  if (!RNA_property_is_set(op->ptr, prop)) {
+    RNA_property_int_set(op->ptr, prop, bake->tile_size);
+  }
 }
 
 static int bake_invoke(bContext *C, wmOperator *op, const wmEvent *UNUSED(event))
@@ -1827,6 +2164,20 @@ void OBJECT_OT_bake(wmOperatorType *ot)
                   false,
                   "Automatic Name",
                   "Automatically name the output file with the pass type");
+  RNA_def_boolean(ot->srna,
+                  "use_tiles",
+                  false,
+                  "Tiles",
+                  "Bake the images in tiles, using less memory for large images");
+  RNA_def_int(ot->srna,
+              "tile_size",
+              1024,
+              64,
+              8192,
+              "Tile Size",
+              "Size of the tiles baked at once, when baking in tiles",
+              256,
+              4096);
   RNA_def_string(ot->srna,
                  "uv_layer",
                  NULL,
@@ -28,6 +28,10 @@
 #include <stdio.h>
 #include <math.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #ifdef WIN32
@@ -157,6 +161,9 @@ BLI_INLINE unsigned char f_to_char(const float val)
 
 #  define PROJ_FACE_DEGENERATE (1 << 12)
 
+/* If the outset UV's of the seams are initialized. */
+#  define PROJ_FACE_SEAM_OUTSET (1 << 13)
+
 /* face winding */
 #  define PROJ_FACE_WINDING_INIT 1
 #  define PROJ_FACE_WINDING_CW 2
@@ -239,6 +246,26 @@ typedef struct LoopSeamData {
   float corner_dist_sq[2];
 } LoopSeamData;
 
+/**
+ * Pixels of a bucket, stored contiguously so painting walks memory linearly.
+ * The screen-space coordinates are duplicated as separate arrays padded to a multiple of 4
+ * with #FLT_MAX, to test the brush distance of 4 pixels at once.
+ */
+typedef struct ProjBucketPixels {
+  /** #ProjPaintState.pixel_sizeof bytes per pixel. */
+  char *pixels;
+  float *co_ss_x;
+  float *co_ss_y;
+  int len;
+} ProjBucketPixels;
+
+/** Growable buffer the pixels of a bucket are initialized into, one per thread. */
+typedef struct ProjPixelBuffer {
+  char *pixels;
+  int len;
+  int len_alloc;
+} ProjPixelBuffer;
+
 /* Main projection painting struct passed to all projection painting functions */
 typedef struct ProjPaintState {
   View3D *v3d;
@@ -272,9 +299,9 @@ typedef struct ProjPaintState {
   /* projection painting only */
   /** for multithreading, the first item is sometimes used for non threaded cases too. */
   MemArena *arena_mt[BLENDER_MAX_THREADS];
-  /** screen sized 2D array, each pixel has a linked list of ProjPixel's */
-  LinkNode **bucketRect;
-  /** bucketRect aligned array linkList of faces overlapping each bucket. */
+  /** screen sized 2D array, the pixels of each bucket. */
+  ProjBucketPixels *bucketPixels;
+  /** bucketPixels aligned array linkList of faces overlapping each bucket. */
   LinkNode **bucketFaces;
   /** store if the bucks have been initialized. */
   unsigned char *bucketFlags;
@@ -485,6 +512,13 @@ typedef struct ProjPixelClone {
   PixelStore clonepx;
 } ProjPixelClone;
 
+BLI_INLINE ProjPixel *project_bucket_pixel(const ProjPaintState *ps,
+                                           const ProjBucketPixels *bucket,
+                                           const int i)
+{
+  return (ProjPixel *)(bucket->pixels + (size_t)i * ps->pixel_sizeof);
+}
+
 /* undo tile pushing */
 typedef struct {
   SpinLock *lock;
@@ -582,7 +616,7 @@ static Image *project_paint_face_clone_image(const ProjPaintState *ps, int tri_i
 static int project_bucket_offset(const ProjPaintState *ps, const float projCoSS[2])
 {
   /* If we were not dealing with screenspace 2D coords we could simple do...
-   * ps->bucketRect[x + (y*ps->buckets_y)] */
+   * ps->bucketPixels[x + (y*ps->buckets_y)] */
 
   /* please explain?
    * projCoSS[0] - ps->screenMin[0]   : zero origin
@@ -1436,7 +1470,8 @@ static void insert_seam_vert_array(const ProjPaintState *ps,
  * Be tricky with flags, first 4 bits are #PROJ_FACE_SEAM0 to 4,
  * last 4 bits are #PROJ_FACE_NOSEAM0 to 4. `1 << i` - where i is `(0..3)`.
  *
- * If we're multithreadng, make sure threads are locked when this is called.
+ * This modifies other faces too, only call it before the painting threads start,
+ * see #project_paint_bucket_seams_init.
  */
 static void project_face_seams_init(const ProjPaintState *ps,
                                     MemArena *arena,
@@ -1874,18 +1909,35 @@ static int project_paint_undo_subtiles(const TileInfo *tinf, int tx, int ty)
   return tile_index;
 }
 
+/* Add an uninitialized pixel to the buffer of the bucket being initialized. */
+static ProjPixel *project_pixel_buffer_add(const ProjPaintState *ps,
+                                           ProjPixelBuffer *pixel_buffer)
+{
+  if (pixel_buffer->len == pixel_buffer->len_alloc) {
+    pixel_buffer->len_alloc = max_ii(pixel_buffer->len_alloc * 2, 256);
+    const size_t size = (size_t)pixel_buffer->len_alloc * ps->pixel_sizeof;
+    if (pixel_buffer->pixels) {
+      pixel_buffer->pixels = MEM_reallocN(pixel_buffer->pixels, size);
+    }
+    else {
+      pixel_buffer->pixels = MEM_mallocN(size, "ProjPixelBuffer");
+    }
+  }
+  return (ProjPixel *)(pixel_buffer->pixels + (size_t)pixel_buffer->len++ * ps->pixel_sizeof);
+}
+
 /* run this function when we know a bucket's, face's pixel can be initialized,
- * return the ProjPixel which is added to 'ps->bucketRect[bucket_index]' */
-static ProjPixel *project_paint_uvpixel_init(const ProjPaintState *ps,
-                                             MemArena *arena,
-                                             const TileInfo *tinf,
-                                             int x_px,
-                                             int y_px,
-                                             const float mask,
-                                             const int tri_index,
-                                             const float pixelScreenCo[4],
-                                             const float world_spaceCo[3],
-                                             const float w[3])
+ * the ProjPixel is added to 'pixel_buffer', and later to 'ps->bucketPixels[bucket_index]' */
+static void project_paint_uvpixel_init(const ProjPaintState *ps,
+                                       ProjPixelBuffer *pixel_buffer,
+                                       const TileInfo *tinf,
+                                       int x_px,
+                                       int y_px,
+                                       const float mask,
+                                       const int tri_index,
+                                       const float pixelScreenCo[4],
+                                       const float world_spaceCo[3],
+                                       const float w[3])
 {
   ProjPixel *projPixel;
   int x_tile, y_tile;
@@ -1902,7 +1954,7 @@ static ProjPixel *project_paint_uvpixel_init(const ProjPaintState *ps,
   y_px = mod_i(y_px, ibuf->y);
 
   BLI_assert(ps->pixel_sizeof == project_paint_pixel_sizeof(ps->tool));
-  projPixel = BLI_memarena_alloc(arena, ps->pixel_sizeof);
+  projPixel = project_pixel_buffer_add(ps, pixel_buffer);
 
   /* calculate the undo tile offset of the pixel, used to store the original
    * pixel color and accumulated mask if any */
@@ -2053,8 +2105,6 @@ static ProjPixel *project_paint_uvpixel_init(const ProjPaintState *ps,
 #endif
   /* pointer arithmetic */
   projPixel->image_index = projima - ps->projImages;
-
-  return projPixel;
 }
 
 static bool line_clip_rect2f(const rctf *cliprect,
@@ -2976,13 +3026,39 @@ static bool IsectPoly2Df_twoside(const float pt[2], float uv[][2], const int tot
   return true;
 }
 
+/* Use the UV offset by half a pixel instead of the face UV's,
+ * so we can avoid offsetting all the pixels by 0.5 which causes
+ * problems when wrapping negative coords */
+static void project_face_uv_pxoffset(const float *lt_tri_uv[3],
+                                     const int ibuf_x,
+                                     const int ibuf_y,
+                                     float r_uv_pxoffset[3][2])
+{
+  const float xhalfpx = (0.5f + (PROJ_PIXEL_TOLERANCE * (1.0f / 3.0f))) / (float)ibuf_x;
+  const float yhalfpx = (0.5f + (PROJ_PIXEL_TOLERANCE * (1.0f / 4.0f))) / (float)ibuf_y;
+
+  /* Note about (PROJ_GEOM_TOLERANCE/x) above...
+   * Needed to add this offset since UV coords are often quads aligned to pixels.
+   * In this case pixels can be exactly between 2 triangles causing nasty
+   * artifacts.
+   *
+   * This workaround can be removed and painting will still work on most cases
+   * but since the first thing most people try is painting onto a quad- better make it work.
+   */
+
+  for (int i = 0; i < 3; i++) {
+    r_uv_pxoffset[i][0] = lt_tri_uv[i][0] - xhalfpx;
+    r_uv_pxoffset[i][1] = lt_tri_uv[i][1] - yhalfpx;
+  }
+}
+
 /* One of the most important function for projection painting,
  * since it selects the pixels to be added into each bucket.
  *
  * initialize pixels from this face where it intersects with the bucket_index,
  * optionally initialize pixels for removing seams */
 static void project_paint_face_init(const ProjPaintState *ps,
-                                    const int thread_index,
+                                    ProjPixelBuffer *pixel_buffer,
                                     const int bucket_index,
                                     const int tri_index,
                                     const int image_index,
@@ -2992,10 +3068,7 @@ static void project_paint_face_init(const ProjPaintState *ps,
                                     ImBuf **tmpibuf)
 {
   /* Projection vars, to get the 3D locations into screen space  */
-  MemArena *arena = ps->arena_mt[thread_index];
-  LinkNode **bucketPixelNodes = ps->bucketRect + bucket_index;
   LinkNode *bucketFaceNodes = ps->bucketFaces[bucket_index];
-  bool threaded = (ps->thread_tot > 1);
 
   TileInfo tinf = {
       ps->tile_lock,
@@ -3035,7 +3108,6 @@ static void project_paint_face_init(const ProjPaintState *ps,
 
   /* bucket bounds in UV space so we can init pixels only for this face,  */
   float lt_uv_pxoffset[3][2];
-  float xhalfpx, yhalfpx;
   const float ibuf_xf = (float)ibuf->x, ibuf_yf = (float)ibuf->y;
 
   /* for early loop exit */
@@ -3052,29 +3124,7 @@ static void project_paint_face_init(const ProjPaintState *ps,
   vCo[1] = ps->mvert_eval[lt_vtri[1]].co;
   vCo[2] = ps->mvert_eval[lt_vtri[2]].co;
 
-  /* Use lt_uv_pxoffset instead of lt_tri_uv so we can offset the UV half a pixel
-   * this is done so we can avoid offsetting all the pixels by 0.5 which causes
-   * problems when wrapping negative coords */
-  xhalfpx = (0.5f + (PROJ_PIXEL_TOLERANCE * (1.0f / 3.0f))) / ibuf_xf;
-  yhalfpx = (0.5f + (PROJ_PIXEL_TOLERANCE * (1.0f / 4.0f))) / ibuf_yf;
-
-  /* Note about (PROJ_GEOM_TOLERANCE/x) above...
-   * Needed to add this offset since UV coords are often quads aligned to pixels.
-   * In this case pixels can be exactly between 2 triangles causing nasty
-   * artifacts.
-   *
-   * This workaround can be removed and painting will still work on most cases
-   * but since the first thing most people try is painting onto a quad- better make it work.
-   */
-
-  lt_uv_pxoffset[0][0] = lt_tri_uv[0][0] - xhalfpx;
-  lt_uv_pxoffset[0][1] = lt_tri_uv[0][1] - yhalfpx;
-
-  lt_uv_pxoffset[1][0] = lt_tri_uv[1][0] - xhalfpx;
-  lt_uv_pxoffset[1][1] = lt_tri_uv[1][1] - yhalfpx;
-
-  lt_uv_pxoffset[2][0] = lt_tri_uv[2][0] - xhalfpx;
-  lt_uv_pxoffset[2][1] = lt_tri_uv[2][1] - yhalfpx;
+  project_face_uv_pxoffset(lt_tri_uv, ibuf->x, ibuf->y, lt_uv_pxoffset);
 
   {
     uv1co = lt_uv_pxoffset[0];  // was lt_tri_uv[i1];
@@ -3164,11 +3214,8 @@ static void project_paint_face_init(const ProjPaintState *ps,
               mask = project_paint_uvpixel_mask(ps, tri_index, w);
 
               if (mask > 0.0f) {
-                BLI_linklist_prepend_arena(
-                    bucketPixelNodes,
-                    project_paint_uvpixel_init(
-                        ps, arena, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w),
-                    arena);
+                project_paint_uvpixel_init(
+                    ps, pixel_buffer, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w);
               }
             }
           }
@@ -3193,37 +3240,13 @@ static void project_paint_face_init(const ProjPaintState *ps,
 
 #ifndef PROJ_DEBUG_NOSEAMBLEED
   if (ps->seam_bleed_px > 0.0f && !(ps->faceSeamFlags[tri_index] & PROJ_FACE_DEGENERATE)) {
-    int face_seam_flag;
-
-    if (threaded) {
-      /* Other threads could be modifying these vars. */
-      BLI_thread_lock(LOCK_CUSTOM1);
-    }
-
-    face_seam_flag = ps->faceSeamFlags[tri_index];
-
-    /* are any of our edges un-initialized? */
-    if ((face_seam_flag & PROJ_FACE_SEAM_INIT0) == 0 ||
-        (face_seam_flag & PROJ_FACE_SEAM_INIT1) == 0 ||
-        (face_seam_flag & PROJ_FACE_SEAM_INIT2) == 0) {
-      project_face_seams_init(ps, arena, tri_index, 0, true, ibuf->x, ibuf->y);
-      face_seam_flag = ps->faceSeamFlags[tri_index];
-#  if 0
-      printf("seams - %d %d %d %d\n",
-             flag & PROJ_FACE_SEAM0,
-             flag & PROJ_FACE_SEAM1,
-             flag & PROJ_FACE_SEAM2);
-#  endif
-    }
+    /* Seams and their outset UV's are initialized by project_paint_bucket_seams_init()
+     * before the threads start, they are only read here. */
+    const int face_seam_flag = ps->faceSeamFlags[tri_index];
 
-    if ((face_seam_flag & (PROJ_FACE_SEAM0 | PROJ_FACE_SEAM1 | PROJ_FACE_SEAM2)) == 0) {
+    BLI_assert(face_seam_flag & PROJ_FACE_SEAM_OUTSET);
 
-      if (threaded) {
-        /* Other threads could be modifying these vars. */
-        BLI_thread_unlock(LOCK_CUSTOM1);
-      }
-    }
-    else {
+    if (face_seam_flag & (PROJ_FACE_SEAM0 | PROJ_FACE_SEAM1 | PROJ_FACE_SEAM2)) {
       /* we have a seam - deal with it! */
 
       /* inset face coords.  NOTE!!! ScreenSace for ortho, Worldspace in perspective view */
@@ -3255,18 +3278,6 @@ static void project_paint_face_init(const ProjPaintState *ps,
       lt_puv[2][0] = lt_uv_pxoffset[2][0] * ibuf->x;
       lt_puv[2][1] = lt_uv_pxoffset[2][1] * ibuf->y;
 
-      if ((ps->faceSeamFlags[tri_index] & PROJ_FACE_SEAM0) ||
-          (ps->faceSeamFlags[tri_index] & PROJ_FACE_SEAM1) ||
-          (ps->faceSeamFlags[tri_index] & PROJ_FACE_SEAM2)) {
-        uv_image_outset(ps, lt_uv_pxoffset, lt_puv, tri_index, ibuf->x, ibuf->y);
-      }
-
-      /* ps->loopSeamUVs cant be modified when threading, now this is done we can unlock. */
-      if (threaded) {
-        /* Other threads could be modifying these vars */
-        BLI_thread_unlock(LOCK_CUSTOM1);
-      }
-
       vCoSS[0] = ps->screenCoords[lt_vtri[0]];
       vCoSS[1] = ps->screenCoords[lt_vtri[1]];
       vCoSS[2] = ps->screenCoords[lt_vtri[2]];
@@ -3406,11 +3417,8 @@ static void project_paint_face_init(const ProjPaintState *ps,
                       mask = project_paint_uvpixel_mask(ps, tri_index, w);
 
                       if (mask > 0.0f) {
-                        BLI_linklist_prepend_arena(
-                            bucketPixelNodes,
-                            project_paint_uvpixel_init(
-                                ps, arena, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w),
-                            arena);
+                        project_paint_uvpixel_init(
+                            ps, pixel_buffer, &tinf, x, y, mask, tri_index, pixelScreenCo, wco, w);
                       }
                     }
                   }
@@ -3436,13 +3444,13 @@ static void project_paint_face_init(const ProjPaintState *ps,
     }
   }
 #else
-  UNUSED_VARS(vCo, threaded);
+  UNUSED_VARS(vCo);
 #endif  // PROJ_DEBUG_NOSEAMBLEED
 }
 
 /**
  * Takes floating point screenspace min/max and
- * returns int min/max to be used as indices for ps->bucketRect, ps->bucketFlags
+ * returns int min/max to be used as indices for ps->bucketPixels, ps->bucketFlags
  */
 static void project_paint_bucket_bounds(const ProjPaintState *ps,
                                         const float min[2],
@@ -3499,6 +3507,7 @@ static void project_bucket_bounds(const ProjPaintState *ps,
  * have bucket_bounds as an argument so we don't need to give bucket_x/y the rect function needs */
 static void project_bucket_init(const ProjPaintState *ps,
                                 const int thread_index,
+                                ProjPixelBuffer *pixel_buffer,
                                 const int bucket_index,
                                 const rctf *clip_rect,
                                 const rctf *bucket_bounds)
@@ -3510,13 +3519,15 @@ static void project_bucket_init(const ProjPaintState *ps,
   ImBuf *tmpibuf = NULL;
   int tile_last = 0;
 
+  pixel_buffer->len = 0;
+
   if (ps->image_tot == 1) {
     /* Simple loop, no context switching */
     ibuf = ps->projImages[0].ibuf;
 
     for (node = ps->bucketFaces[bucket_index]; node; node = node->next) {
       project_paint_face_init(ps,
-                              thread_index,
+                              pixel_buffer,
                               bucket_index,
                               POINTER_AS_INT(node->link),
                               0,
@@ -3555,7 +3566,7 @@ static void project_bucket_init(const ProjPaintState *ps,
       /* context switching done */
 
       project_paint_face_init(ps,
-                              thread_index,
+                              pixel_buffer,
                               bucket_index,
                               tri_index,
                               image_index,
@@ -3570,9 +3581,114 @@ static void project_bucket_init(const ProjPaintState *ps,
     IMB_freeImBuf(tmpibuf);
   }
 
+  /* Move the pixels into the arena of this thread, with the screen-space coordinates padded to
+   * whole groups of 4 pixels which are never inside of the brush. */
+  if (pixel_buffer->len) {
+    ProjBucketPixels *bucket = &ps->bucketPixels[bucket_index];
+    MemArena *arena = ps->arena_mt[thread_index];
+    const int len_padded = (pixel_buffer->len + 3) & ~3;
+    const size_t size = (size_t)pixel_buffer->len * ps->pixel_sizeof;
+
+    bucket->pixels = BLI_memarena_alloc(arena, size);
+    memcpy(bucket->pixels, pixel_buffer->pixels, size);
+    bucket->co_ss_x = BLI_memarena_alloc(arena, sizeof(float) * len_padded);
+    bucket->co_ss_y = BLI_memarena_alloc(arena, sizeof(float) * len_padded);
+    bucket->len = pixel_buffer->len;
+
+    for (int i = 0; i < len_padded; i++) {
+      if (i < bucket->len) {
+        const ProjPixel *projPixel = project_bucket_pixel(ps, bucket, i);
+        bucket->co_ss_x[i] = projPixel->projCoSS[0];
+        bucket->co_ss_y[i] = projPixel->projCoSS[1];
+      }
+      else {
+        bucket->co_ss_x[i] = FLT_MAX;
+        bucket->co_ss_y[i] = FLT_MAX;
+      }
+    }
+  }
+
   ps->bucketFlags[bucket_index] |= PROJ_BUCKET_INIT;
 }
 
+#ifndef PROJ_DEBUG_NOSEAMBLEED
+static ImBuf *project_paint_face_ibuf(const ProjPaintState *ps, const int tri_index)
+{
+  if (ps->image_tot == 1) {
+    return ps->projImages[0].ibuf;
+  }
+
+  const MLoopTri *lt = &ps->mlooptri_eval[tri_index];
+  const float *lt_tri_uv[3] = {PS_LOOPTRI_AS_UV_3(ps->poly_to_loop_uv, lt)};
+  Image *tpage = project_paint_face_paint_image(ps, tri_index);
+  const int tile = project_paint_face_paint_tile(tpage, lt_tri_uv[0]);
+
+  for (int image_index = 0; image_index < ps->image_tot; image_index++) {
+    const ProjPaintImage *projIma = &ps->projImages[image_index];
+    if ((projIma->ima == tpage) && (projIma->iuser.tile == tile)) {
+      return projIma->ibuf;
+    }
+  }
+  BLI_assert(0);
+  return NULL;
+}
+
+/* Initialize the seams of the faces in the buckets which are not initialized yet.
+ *
+ * Finding the seams of a face modifies the adjacent faces too, so this is done before the
+ * threads start, which can then initialize the pixels of their buckets without locking. */
+static void project_paint_bucket_seams_init(ProjPaintState *ps)
+{
+  if (ps->seam_bleed_px <= 0.0f) {
+    return;
+  }
+
+  for (int bucket_y = ps->bucketMin[1]; bucket_y < ps->bucketMax[1]; bucket_y++) {
+    for (int bucket_x = ps->bucketMin[0]; bucket_x < ps->bucketMax[0]; bucket_x++) {
+      const int bucket_index = bucket_x + bucket_y * ps->buckets_x;
+      if (ps->bucketFlags[bucket_index] & PROJ_BUCKET_INIT) {
+        continue;
+      }
+
+      for (LinkNode *node = ps->bucketFaces[bucket_index]; node; node = node->next) {
+        const int tri_index = POINTER_AS_INT(node->link);
+
+        if (ps->faceSeamFlags[tri_index] & (PROJ_FACE_DEGENERATE | PROJ_FACE_SEAM_OUTSET)) {
+          continue;
+        }
+
+        ImBuf *ibuf = project_paint_face_ibuf(ps, tri_index);
+        const int face_seam_init = PROJ_FACE_SEAM_INIT0 | PROJ_FACE_SEAM_INIT1 |
+                                   PROJ_FACE_SEAM_INIT2;
+
+        /* are any of our edges un-initialized? */
+        if ((ps->faceSeamFlags[tri_index] & face_seam_init) != face_seam_init) {
+          project_face_seams_init(ps, ps->arena_mt[0], tri_index, 0, true, ibuf->x, ibuf->y);
+        }
+
+        if (ps->faceSeamFlags[tri_index] & (PROJ_FACE_SEAM0 | PROJ_FACE_SEAM1 | PROJ_FACE_SEAM2)) {
+          const MLoopTri *lt = &ps->mlooptri_eval[tri_index];
+          const float *lt_tri_uv[3] = {PS_LOOPTRI_AS_UV_3(ps->poly_to_loop_uv, lt)};
+          float lt_uv_pxoffset[3][2];
+          /* Pixelspace UVs. */
+          float lt_puv[3][2];
+
+          project_face_uv_pxoffset(lt_tri_uv, ibuf->x, ibuf->y, lt_uv_pxoffset);
+          for (int i = 0; i < 3; i++) {
+            lt_puv[i][0] = lt_uv_pxoffset[i][0] * ibuf->x;
+            lt_puv[i][1] = lt_uv_pxoffset[i][1] * ibuf->y;
+          }
+
+          uv_image_outset(ps, lt_uv_pxoffset, lt_puv, tri_index, ibuf->x, ibuf->y);
+        }
+
+        ps->faceSeamFlags[tri_index] |= PROJ_FACE_SEAM_OUTSET;
+      }
+    }
+  }
+}
+#endif  // PROJ_DEBUG_NOSEAMBLEED
+
 /* We want to know if a bucket and a face overlap in screen-space
  *
  * Note, if this ever returns false positives its not that bad, since a face in the bounding area
@@ -3639,7 +3755,7 @@ static void project_paint_delayed_face_init(ProjPaintState *ps,
 {
   const int lt_vtri[3] = {PS_LOOPTRI_AS_VERT_INDEX_3(ps, lt)};
   float min[2], max[2], *vCoSS;
-  /* for ps->bucketRect indexing */
+  /* for ps->bucketPixels indexing */
   int bucketMin[2], bucketMax[2];
   int fidx, bucket_x, bucket_y;
   /* for early loop exit */
@@ -4559,8 +4675,8 @@ static void project_paint_begin(const bContext *C,
   CLAMP(ps->buckets_x, PROJ_BUCKET_RECT_MIN, PROJ_BUCKET_RECT_MAX);
   CLAMP(ps->buckets_y, PROJ_BUCKET_RECT_MIN, PROJ_BUCKET_RECT_MAX);
 
-  ps->bucketRect = MEM_callocN(sizeof(LinkNode *) * ps->buckets_x * ps->buckets_y,
-                               "paint-bucketRect");
+  ps->bucketPixels = MEM_callocN(sizeof(ProjBucketPixels) * ps->buckets_x * ps->buckets_y,
+                                 "paint-bucketPixels");
   ps->bucketFaces = MEM_callocN(sizeof(LinkNode *) * ps->buckets_x * ps->buckets_y,
                                 "paint-bucketFaces");
 
@@ -4619,7 +4735,7 @@ static void project_paint_end(ProjPaintState *ps)
   BKE_image_release_ibuf(ps->reproject_image, ps->reproject_ibuf, NULL);
 
   MEM_freeN(ps->screenCoords);
-  MEM_freeN(ps->bucketRect);
+  MEM_freeN(ps->bucketPixels);
   MEM_freeN(ps->bucketFaces);
   MEM_freeN(ps->bucketFlags);
 
@@ -5089,6 +5205,35 @@ static void do_projectpaint_draw(ProjPaintState *ps,
   }
 }
 
+#ifdef __SSE2__
+/* Same as blend_color_mix_float(). */
+BLI_INLINE void blend_color_mix_float_sse2(float dst[4], const float src1[4], const float src2[4])
+{
+  if (src2[3] != 0.0f) {
+    const __m128 mt = _mm_set1_ps(1.0f - src2[3]);
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_mul_ps(mt, _mm_loadu_ps(src1)), _mm_loadu_ps(src2)));
+  }
+  else {
+    copy_v4_v4(dst, src1);
+  }
+}
+#endif
+
+/* Same as IMB_blend_color_float(), with the common mix blending inlined. */
+BLI_INLINE void project_paint_blend_color_float(const ProjPaintState *ps,
+                                                float dst[4],
+                                                const float src1[4],
+                                                const float src2[4])
+{
+#ifdef __SSE2__
+  if (ps->blend == IMB_BLEND_MIX) {
+    blend_color_mix_float_sse2(dst, src1, src2);
+    return;
+  }
+#endif
+  IMB_blend_color_float(dst, src1, src2, ps->blend);
+}
+
 static void do_projectpaint_draw_f(ProjPaintState *ps,
                                    ProjPixel *projPixel,
                                    const float texrgb[3],
@@ -5106,10 +5251,10 @@ static void do_projectpaint_draw_f(ProjPaintState *ps,
   rgba[3] = mask;
 
   if (ps->do_masking) {
-    IMB_blend_color_float(projPixel->pixel.f_pt, projPixel->origColor.f_pt, rgba, ps->blend);
+    project_paint_blend_color_float(ps, projPixel->pixel.f_pt, projPixel->origColor.f_pt, rgba);
   }
   else {
-    IMB_blend_color_float(projPixel->pixel.f_pt, projPixel->pixel.f_pt, rgba, ps->blend);
+    project_paint_blend_color_float(ps, projPixel->pixel.f_pt, projPixel->pixel.f_pt, rgba);
   }
 }
 
@@ -5134,10 +5279,10 @@ static void do_projectpaint_mask_f(ProjPaintState *ps, ProjPixel *projPixel, flo
   rgba[3] = mask;
 
   if (ps->do_masking) {
-    IMB_blend_color_float(projPixel->pixel.f_pt, projPixel->origColor.f_pt, rgba, ps->blend);
+    project_paint_blend_color_float(ps, projPixel->pixel.f_pt, projPixel->origColor.f_pt, rgba);
   }
   else {
-    IMB_blend_color_float(projPixel->pixel.f_pt, projPixel->pixel.f_pt, rgba, ps->blend);
+    project_paint_blend_color_float(ps, projPixel->pixel.f_pt, projPixel->pixel.f_pt, rgba);
   }
 }
 
@@ -5167,6 +5312,29 @@ static void copy_original_alpha_channel(ProjPixel *pixel, bool is_floatbuf)
   }
 }
 
+/* Test if any of the 4 pixels of a bucket starting at 'i' is inside of the brush. */
+BLI_INLINE bool project_bucket_pixels_isect_brush(const ProjBucketPixels *bucket,
+                                                  const int i,
+                                                  const float pos[2],
+                                                  const float radius_sq)
+{
+#ifdef __SSE2__
+  const __m128 dx = _mm_sub_ps(_mm_loadu_ps(bucket->co_ss_x + i), _mm_set1_ps(pos[0]));
+  const __m128 dy = _mm_sub_ps(_mm_loadu_ps(bucket->co_ss_y + i), _mm_set1_ps(pos[1]));
+  const __m128 dist_sq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+  return _mm_movemask_ps(_mm_cmple_ps(dist_sq, _mm_set1_ps(radius_sq))) != 0;
+#else
+  for (int j = i; j < i + 4; j++) {
+    const float dx = bucket->co_ss_x[j] - pos[0];
+    const float dy = bucket->co_ss_y[j] - pos[1];
+    if (dx * dx + dy * dy <= radius_sq) {
+      return true;
+    }
+  }
+  return false;
+#endif
+}
+
 /* Run this for single and multi-threaded painting. */
 static void do_projectpaint_thread(TaskPool *__restrict UNUSED(pool),
                                    void *ph_v,
@@ -5184,6 +5352,7 @@ static void do_projectpaint_thread(TaskPool *__restrict UNUSED(pool),
   LinkNode *node;
   ProjPixel *projPixel;
   Brush *brush = ps->brush;
+  ProjPixelBuffer pixel_buffer = {NULL};
 
   int last_index = -1;
   ProjPaintImage *last_projIma = NULL;
@@ -5243,15 +5412,18 @@ static void do_projectpaint_thread(TaskPool *__restrict UNUSED(pool),
       clip_rect.ymin -= PROJ_PIXEL_TOLERANCE;
       clip_rect.ymax += PROJ_PIXEL_TOLERANCE;
       /* No pixels initialized */
-      project_bucket_init(ps, thread_index, bucket_index, &clip_rect, &bucket_bounds);
+      project_bucket_init(
+          ps, thread_index, &pixel_buffer, bucket_index, &clip_rect, &bucket_bounds);
     }
 
+    const ProjBucketPixels *bucket = &ps->bucketPixels[bucket_index];
+
     if (ps->source != PROJ_SRC_VIEW) {
 
       /* Re-Projection, simple, no brushes! */
 
-      for (node = ps->bucketRect[bucket_index]; node; node = node->next) {
-        projPixel = (ProjPixel *)node->link;
+      for (int i = 0; i < bucket->len; i++) {
+        projPixel = project_bucket_pixel(ps, bucket, i);
 
         /* copy of code below */
         if (last_index != projPixel->image_index) {
@@ -5392,9 +5564,14 @@ static void do_projectpaint_thread(TaskPool *__restrict UNUSED(pool),
     else {
       /* Normal brush painting */
 
-      for (node = ps->bucketRect[bucket_index]; node; node = node->next) {
+      for (int i = 0; i < bucket->len; i++) {
+        /* Skip whole groups of pixels outside of the brush. */
+        if ((i & 3) == 0 && !project_bucket_pixels_isect_brush(bucket, i, pos, brush_radius_sq)) {
+          i += 3;
+          continue;
+        }
 
-        projPixel = (ProjPixel *)node->link;
+        projPixel = project_bucket_pixel(ps, bucket, i);
 
         dist_sq = len_squared_v2v2(projPixel->projCoSS, pos);
 
@@ -5596,6 +5773,8 @@ static void do_projectpaint_thread(TaskPool *__restrict UNUSED(pool),
 
     BLI_memarena_free(softenArena);
   }
+
+  MEM_SAFE_FREE(pixel_buffer.pixels);
 }
 
 static bool project_paint_op(void *state, const float lastpos[2], const float pos[2])
@@ -5615,6 +5794,10 @@ static bool project_paint_op(void *state, const float lastpos[2], const float po
     return touch_any;
   }
 
+#ifndef PROJ_DEBUG_NOSEAMBLEED
+  project_paint_bucket_seams_init(ps);
+#endif
+
   if (ps->thread_tot > 1) {
     scheduler = BLI_task_scheduler_get();
     task_pool = BLI_task_pool_create_suspended(scheduler, NULL);
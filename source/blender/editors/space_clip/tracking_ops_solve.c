@@ -142,10 +142,14 @@ static void solve_camera_freejob(void *scv)
     }
   }
   else {
+    char statistics_message[256];
+    BKE_tracking_reconstruction_statistics_report(
+        scj->context, statistics_message, sizeof(statistics_message));
     BKE_reportf(scj->reports,
                 RPT_INFO,
-                "Average re-projection error: %.3f",
-                tracking->reconstruction.error);
+                "Average re-projection error: %.3f, %s",
+                tracking->reconstruction.error,
+                statistics_message);
   }
 
   /* Set currently solved clip as active for scene. */
@@ -253,6 +253,11 @@ typedef struct FileListEntryCache {
   /* Previews handling. */
   TaskPool *previews_pool;
   ThreadQueue *previews_done;
+  /* Previews waiting for a thread, the one closest to previews_center_index is taken first so
+   * visible entries get their preview before the rest of the block. */
+  ListBase previews_todo;
+  int previews_center_index;
+  ThreadMutex previews_mutex;
 } FileListEntryCache;
 
 /* FileListCache.flags */
@@ -262,6 +267,7 @@ enum {
 };
 
 typedef struct FileListEntryPreview {
+  struct FileListEntryPreview *next, *prev;
   char path[FILE_MAX];
   unsigned int flags;
   int index;
@@ -1240,18 +1246,42 @@ static void filelist_intern_free(FileListIntern *filelist_intern)
   MEM_SAFE_FREE(filelist_intern->filtered);
 }
 
+static FileListEntryPreview *filelist_cache_preview_pop(FileListEntryCache *cache)
+{
+  FileListEntryPreview *preview_best = NULL;
+  int distance_best = INT_MAX;
+
+  BLI_mutex_lock(&cache->previews_mutex);
+  LISTBASE_FOREACH (FileListEntryPreview *, preview, &cache->previews_todo) {
+    const int distance = abs(preview->index - cache->previews_center_index);
+    if (distance < distance_best) {
+      preview_best = preview;
+      distance_best = distance;
+    }
+  }
+  if (preview_best) {
+    BLI_remlink(&cache->previews_todo, preview_best);
+  }
+  BLI_mutex_unlock(&cache->previews_mutex);
+
+  return preview_best;
+}
+
 static void filelist_cache_preview_runf(TaskPool *__restrict pool,
-                                        void *taskdata,
+                                        void *UNUSED(taskdata),
                                         int UNUSED(threadid))
 {
   FileListEntryCache *cache = BLI_task_pool_userdata(pool);
-  FileListEntryPreview *preview = taskdata;
 
-  ThumbSource source = 0;
+  /* There is one task per pushed preview, each taking the waiting preview closest to the
+   * visible entries. Tasks of canceled previews find nothing left to do. */
+  FileListEntryPreview *preview = filelist_cache_preview_pop(cache);
+  if (preview == NULL) {
+    return;
+  }
 
-  //  printf("%s: Start (%d)...\n", __func__, threadid);
+  ThumbSource source = 0;
 
-  //  printf("%s: %d - %s - %p\n", __func__, preview->index, preview->path, preview->img);
   BLI_assert(preview->flags &
              (FILE_TYPE_IMAGE | FILE_TYPE_MOVIE | FILE_TYPE_FTFONT | FILE_TYPE_BLENDER |
               FILE_TYPE_BLENDER_BACKUP | FILE_TYPE_BLENDERLIB));
@@ -1274,29 +1304,7 @@ static void filelist_cache_preview_runf(TaskPool *__restrict pool,
   preview->img = IMB_thumb_manage(preview->path, THB_LARGE, source);
   IMB_thumb_path_unlock(preview->path);
 
-  /* Used to tell free func to not free anything.
-   * Note that we do not care about cas result here,
-   * we only want value attribution itself to be atomic (and memory barier).*/
-  atomic_cas_uint32(&preview->flags, preview->flags, 0);
   BLI_thread_queue_push(cache->previews_done, preview);
-
-  //  printf("%s: End (%d)...\n", __func__, threadid);
-}
-
-static void filelist_cache_preview_freef(TaskPool *__restrict UNUSED(pool),
-                                         void *taskdata,
-                                         int UNUSED(threadid))
-{
-  FileListEntryPreview *preview = taskdata;
-
-  /* If preview->flag is empty, it means that preview has already been generated and
-   * added to done queue, we do not own it anymore. */
-  if (preview->flags) {
-    if (preview->img) {
-      IMB_freeImBuf(preview->img);
-    }
-    MEM_freeN(preview);
-  }
 }
 
 static void filelist_cache_preview_ensure_running(FileListEntryCache *cache)
@@ -1311,20 +1319,54 @@ static void filelist_cache_preview_ensure_running(FileListEntryCache *cache)
   }
 }
 
+static void filelist_cache_preview_free(FileListEntryPreview *preview)
+{
+  if (preview->img) {
+    IMB_freeImBuf(preview->img);
+  }
+  MEM_freeN(preview);
+}
+
+/* Cancel waiting previews of entries outside of the [start_index, end_index[ range, without
+ * waiting for the ones being generated. Those still get pushed to the done queue. */
+static void filelist_cache_previews_cancel_outside(FileListEntryCache *cache,
+                                                   const int start_index,
+                                                   const int end_index)
+{
+  if (!cache->previews_pool) {
+    return;
+  }
+
+  BLI_mutex_lock(&cache->previews_mutex);
+  FileListEntryPreview *preview = cache->previews_todo.first;
+  while (preview) {
+    FileListEntryPreview *preview_next = preview->next;
+    if (preview->index < start_index || preview->index >= end_index) {
+      BLI_remlink(&cache->previews_todo, preview);
+      filelist_cache_preview_free(preview);
+    }
+    preview = preview_next;
+  }
+  BLI_mutex_unlock(&cache->previews_mutex);
+}
+
 static void filelist_cache_previews_clear(FileListEntryCache *cache)
 {
   FileListEntryPreview *preview;
 
   if (cache->previews_pool) {
+    filelist_cache_previews_cancel_outside(cache, 0, 0);
     BLI_task_pool_cancel(cache->previews_pool);
 
     while ((preview = BLI_thread_queue_pop_timeout(cache->previews_done, 0))) {
       // printf("%s: DONE %d - %s - %p\n", __func__, preview->index, preview->path,
       // preview->img);
-      if (preview->img) {
-        IMB_freeImBuf(preview->img);
-      }
-      MEM_freeN(preview);
+      filelist_cache_preview_free(preview);
+    }
+
+    /* Nothing is being loaded anymore, entries can be pushed again. */
+    LISTBASE_FOREACH (FileDirEntry *, entry, &cache->cached_entries) {
+      entry->flags &= ~FILE_ENTRY_PREVIEW_LOADING;
     }
   }
 }
@@ -1353,7 +1395,8 @@ static void filelist_cache_previews_push(FileList *filelist, FileDirEntry *entry
 
   BLI_assert(cache->flags & FLC_PREVIEWS_ACTIVE);
 
-  if (!entry->image && !(entry->flags & FILE_ENTRY_INVALID_PREVIEW) &&
+  if (!entry->image &&
+      !(entry->flags & (FILE_ENTRY_INVALID_PREVIEW | FILE_ENTRY_PREVIEW_LOADING)) &&
       (entry->typeflag & (FILE_TYPE_IMAGE | FILE_TYPE_MOVIE | FILE_TYPE_FTFONT |
                           FILE_TYPE_BLENDER | FILE_TYPE_BLENDER_BACKUP | FILE_TYPE_BLENDERLIB))) {
     FileListEntryPreview *preview = MEM_mallocN(sizeof(*preview), __func__);
@@ -1364,13 +1407,14 @@ static void filelist_cache_previews_push(FileList *filelist, FileDirEntry *entry
     preview->img = NULL;
     //      printf("%s: %d - %s - %p\n", __func__, preview->index, preview->path, preview->img);
 
+    entry->flags |= FILE_ENTRY_PREVIEW_LOADING;
+
     filelist_cache_preview_ensure_running(cache);
-    BLI_task_pool_push_ex(cache->previews_pool,
-                          filelist_cache_preview_runf,
-                          preview,
-                          true,
-                          filelist_cache_preview_freef,
-                          TASK_PRIORITY_LOW);
+    BLI_mutex_lock(&cache->previews_mutex);
+    BLI_addtail(&cache->previews_todo, preview);
+    BLI_mutex_unlock(&cache->previews_mutex);
+    BLI_task_pool_push(
+        cache->previews_pool, filelist_cache_preview_runf, NULL, false, TASK_PRIORITY_LOW);
   }
 }
 
@@ -1392,6 +1436,9 @@ static void filelist_cache_init(FileListEntryCache *cache, size_t cache_size)
   cache->uuids = BLI_ghash_new_ex(
       BLI_ghashutil_uinthash_v4_p, BLI_ghashutil_uinthash_v4_cmp, __func__, cache_size * 2);
 
+  BLI_listbase_clear(&cache->previews_todo);
+  BLI_mutex_init(&cache->previews_mutex);
+
   cache->size = cache_size;
   cache->flags = FLC_IS_INIT;
 
@@ -1408,6 +1455,7 @@ static void filelist_cache_free(FileListEntryCache *cache)
   }
 
   filelist_cache_previews_free(cache);
+  BLI_mutex_end(&cache->previews_mutex);
 
   MEM_freeN(cache->block_entries);
 
@@ -1894,7 +1942,14 @@ bool filelist_file_cache_block(struct FileList *filelist, const int index)
       //          printf("Full Recaching!\n");
 
       if (cache->flags & FLC_PREVIEWS_ACTIVE) {
-        filelist_cache_previews_clear(cache);
+        if (full_refresh) {
+          /* Indices may refer to other files now, wait for the previews being generated. */
+          filelist_cache_previews_clear(cache);
+        }
+        else {
+          filelist_cache_previews_update(filelist);
+          filelist_cache_previews_cancel_outside(cache, start_index, end_index);
+        }
       }
 
       if (idx1 + size1 > cache_size) {
@@ -1918,11 +1973,11 @@ bool filelist_file_cache_block(struct FileList *filelist, const int index)
       //          printf("Partial Recaching!\n");
 
       /* At this point, we know we keep part of currently cached entries, so update previews
-       * if needed, and remove everything from working queue - we'll add all newly needed
-       * entries at the end. */
+       * if needed, and cancel the waiting ones of entries leaving the cache - we'll add all
+       * newly needed entries at the end. */
       if (cache->flags & FLC_PREVIEWS_ACTIVE) {
         filelist_cache_previews_update(filelist);
-        filelist_cache_previews_clear(cache);
+        filelist_cache_previews_cancel_outside(cache, start_index, end_index);
       }
 
       //          printf("\tpreview cleaned up...\n");
@@ -2035,15 +2090,17 @@ bool filelist_file_cache_block(struct FileList *filelist, const int index)
     }
   }
   else if ((cache->block_center_index != index) && (cache->flags & FLC_PREVIEWS_ACTIVE)) {
-    /* We try to always preview visible entries first, so 'restart' preview background task. */
     filelist_cache_previews_update(filelist);
-    filelist_cache_previews_clear(cache);
   }
 
   //  printf("Re-queueing previews...\n");
 
   /* Note we try to preview first images around given index - i.e. assumed visible ones. */
   if (cache->flags & FLC_PREVIEWS_ACTIVE) {
+    BLI_mutex_lock(&cache->previews_mutex);
+    cache->previews_center_index = index;
+    BLI_mutex_unlock(&cache->previews_mutex);
+
     for (i = 0; ((index + i) < end_index) || ((index - i) >= start_index); i++) {
       if ((index - i) >= start_index) {
         const int idx = (cache->block_cursor + (index - start_index) - i) % cache_size;
@@ -2119,6 +2176,7 @@ bool filelist_cache_previews_update(FileList *filelist)
        * i.e. entry->image may already be set at this point. */
       if (entry && !entry->image) {
         entry->image = preview->img;
+        entry->flags &= ~FILE_ENTRY_PREVIEW_LOADING;
         changed = true;
       }
       else {
@@ -2130,6 +2188,7 @@ bool filelist_cache_previews_update(FileList *filelist)
        * Note that, since entries only live in cache,
        * preview will be retried quite often anyway. */
       entry->flags |= FILE_ENTRY_INVALID_PREVIEW;
+      entry->flags &= ~FILE_ENTRY_PREVIEW_LOADING;
     }
 
     MEM_freeN(preview);
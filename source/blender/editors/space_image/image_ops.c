@@ -3936,7 +3936,7 @@ static int image_read_viewlayers_exec(bContext *C, wmOperator *UNUSED(op))
     ED_space_image_set(bmain, sima, NULL, ima, false);
   }
 
-  RE_ReadRenderResult(scene, scene);
+  RE_ReadRenderResult(scene, scene, NULL);
 
   WM_event_add_notifier(C, NC_IMAGE | NA_EDITED, ima);
   return OPERATOR_FINISHED;
@@ -28,6 +28,9 @@
  *
  * When the undo system manages an image, there will always be a full copy (as a #UndoImageBuf)
  * each new undo step only stores modified tiles.
+ *
+ * Once a step is encoded its new tiles are compressed (when built with LZO),
+ * tiles which a stroke pushed but didn't change are shared with the previous state.
  */
 
 #include "CLG_log.h"
@@ -37,6 +40,7 @@
 #include "BLI_math.h"
 #include "BLI_blenlib.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "DNA_image_types.h"
@@ -64,6 +68,16 @@
 
 #include "WM_api.h"
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#endif
+
+#define LZO_OUT_LEN(size) ((size) + (size) / 16 + 64 + 3)
+
 static CLG_LogRef LOG = {"ed.image.undo"};
 
 /* -------------------------------------------------------------------- */
@@ -326,9 +340,19 @@ typedef struct UndoImageTile {
     uint *uint;
     void *pt;
   } rect;
+  /** Size of the rect when it's compressed, zero when it's stored as is. */
+  uint compressed_size;
+  bool use_float;
+  /** Set once the step which added the tile is encoded, the tile is then read-only. */
+  bool is_encoded;
   int users;
 } UndoImageTile;
 
+static size_t utile_rect_size(bool use_float)
+{
+  return (use_float ? sizeof(float[4]) : sizeof(uint)) * SQUARE(ED_IMAGE_UNDO_TILE_SIZE);
+}
+
 static UndoImageTile *utile_alloc(bool has_float)
 {
   UndoImageTile *utile = MEM_callocN(sizeof(*utile), "ImageUndoTile");
@@ -338,9 +362,97 @@ static UndoImageTile *utile_alloc(bool has_float)
   else {
     utile->rect.uint = MEM_mallocN(sizeof(uint) * SQUARE(ED_IMAGE_UNDO_TILE_SIZE), __func__);
   }
+  utile->use_float = has_float;
   return utile;
 }
 
+static size_t utile_memory_size(const UndoImageTile *utile)
+{
+  return sizeof(*utile) +
+         (utile->compressed_size ? utile->compressed_size : utile_rect_size(utile->use_float));
+}
+
+#ifdef WITH_LZO
+typedef struct TileCompressTLS {
+  lzo_align_t *wrkmem;
+  uchar *out;
+} TileCompressTLS;
+
+static void utile_compress_cb(void *__restrict userdata,
+                              const int iter,
+                              const TaskParallelTLS *__restrict tls)
+{
+  UndoImageTile *utile = ((UndoImageTile **)userdata)[iter];
+  TileCompressTLS *tile_tls = tls->userdata_chunk;
+  const size_t in_len = utile_rect_size(utile->use_float);
+
+  if (tile_tls->wrkmem == NULL) {
+    tile_tls->wrkmem = MEM_mallocN(LZO1X_1_MEM_COMPRESS, __func__);
+    tile_tls->out = MEM_mallocN(LZO_OUT_LEN(utile_rect_size(true)), __func__);
+  }
+
+  lzo_uint out_len;
+  const int r = lzo1x_1_compress(
+      utile->rect.pt, (lzo_uint)in_len, tile_tls->out, &out_len, tile_tls->wrkmem);
+
+  /* Keep tiles which don't compress, such as float noise, as they are. */
+  if (r == LZO_E_OK && out_len < in_len) {
+    MEM_freeN(utile->rect.pt);
+    utile->rect.pt = MEM_mallocN(out_len, "ImageUndoTile.compressed");
+    memcpy(utile->rect.pt, tile_tls->out, out_len);
+    utile->compressed_size = (uint)out_len;
+  }
+}
+
+static void utile_compress_finalize(void *__restrict UNUSED(userdata),
+                                    void *__restrict userdata_chunk)
+{
+  TileCompressTLS *tile_tls = userdata_chunk;
+  MEM_SAFE_FREE(tile_tls->wrkmem);
+  MEM_SAFE_FREE(tile_tls->out);
+}
+#endif
+
+/**
+ * Compress the tiles, the same tile may only be passed once.
+ */
+static void utile_compress_array(UndoImageTile **utiles, int utiles_len)
+{
+#ifdef WITH_LZO
+  TileCompressTLS tile_tls = {NULL};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.userdata_chunk = &tile_tls;
+  settings.userdata_chunk_size = sizeof(tile_tls);
+  settings.func_finalize = utile_compress_finalize;
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, utiles_len, utiles, utile_compress_cb, &settings);
+#else
+  UNUSED_VARS(utiles, utiles_len);
+#endif
+}
+
+/**
+ * Uncompressed rect of the tile, decompressed into \a buffer when needed.
+ */
+static void *utile_rect_get(const UndoImageTile *utile, void *buffer)
+{
+  if (utile->compressed_size == 0) {
+    return utile->rect.pt;
+  }
+#ifdef WITH_LZO
+  lzo_uint out_len = utile_rect_size(utile->use_float);
+  const int r = lzo1x_decompress_safe(
+      utile->rect.pt, (lzo_uint)utile->compressed_size, buffer, &out_len, NULL);
+  BLI_assert(r == LZO_E_OK && out_len == utile_rect_size(utile->use_float));
+  UNUSED_VARS_NDEBUG(r);
+#else
+  BLI_assert(0);
+#endif
+  return buffer;
+}
+
 static void utile_init_from_imbuf(
     UndoImageTile *utile, const uint x, const uint y, const ImBuf *ibuf, ImBuf *tmpibuf)
 {
@@ -363,6 +475,35 @@ static void utile_init_from_imbuf(
   }
 }
 
+/**
+ * Check the tile still matches the image, for tiles a stroke pushed without changing them.
+ * Only the part of the tile inside of the image is compared, as only that part is restored.
+ */
+static bool utile_matches_imbuf(
+    const UndoImageTile *utile, const uint x, const uint y, const ImBuf *ibuf, ImBuf *tmpibuf)
+{
+  const bool has_float = ibuf->rect_float;
+  if (has_float != utile->use_float || (has_float && ibuf->channels != 4)) {
+    return false;
+  }
+
+  const size_t pixel_size = has_float ? sizeof(float[4]) : sizeof(uint);
+  const char *rect = utile_rect_get(
+      utile, has_float ? (void *)tmpibuf->rect_float : (void *)tmpibuf->rect);
+  const char *ibuf_rect = has_float ? (char *)ibuf->rect_float : (char *)ibuf->rect;
+  const uint width = min_ii(ED_IMAGE_UNDO_TILE_SIZE, ibuf->x - (int)x);
+  const uint height = min_ii(ED_IMAGE_UNDO_TILE_SIZE, ibuf->y - (int)y);
+
+  for (uint row = 0; row < height; row++) {
+    if (memcmp(rect + (size_t)row * ED_IMAGE_UNDO_TILE_SIZE * pixel_size,
+               ibuf_rect + ((size_t)(y + row) * ibuf->x + x) * pixel_size,
+               width * pixel_size) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void utile_restore(
     const UndoImageTile *utile, const uint x, const uint y, ImBuf *ibuf, ImBuf *tmpibuf)
 {
@@ -370,11 +511,12 @@ static void utile_restore(
   float *prev_rect_float = tmpibuf->rect_float;
   uint *prev_rect = tmpibuf->rect;
 
+  /* Compressed tiles are decompressed into the buffers of the temporary tile. */
   if (has_float) {
-    tmpibuf->rect_float = utile->rect.fp;
+    tmpibuf->rect_float = utile_rect_get(utile, prev_rect_float);
   }
   else {
-    tmpibuf->rect = utile->rect.uint;
+    tmpibuf->rect = utile_rect_get(utile, prev_rect);
   }
 
   IMB_rectcpy(ibuf, tmpibuf, x, y, 0, 0, ED_IMAGE_UNDO_TILE_SIZE, ED_IMAGE_UNDO_TILE_SIZE);
@@ -586,6 +728,48 @@ static void uhandle_restore_list(ListBase *undo_handles, bool use_init)
   IMB_freeImBuf(tmpibuf);
 }
 
+/**
+ * Compress the tiles added by the step owning \a undo_handles,
+ * tiles shared with previous steps are already encoded.
+ *
+ * \return The memory used by the added tiles.
+ */
+static size_t uhandle_list_encode_tiles(ListBase *undo_handles)
+{
+  uint utiles_len_max = 0;
+  LISTBASE_FOREACH (UndoImageHandle *, uh, undo_handles) {
+    LISTBASE_FOREACH (UndoImageBuf *, ubuf, &uh->buffers) {
+      utiles_len_max += ubuf->tiles_len + (ubuf->post ? ubuf->post->tiles_len : 0);
+    }
+  }
+
+  UndoImageTile **utiles = MEM_mallocN(sizeof(*utiles) * utiles_len_max, __func__);
+  int utiles_len = 0;
+  LISTBASE_FOREACH (UndoImageHandle *, uh, undo_handles) {
+    LISTBASE_FOREACH (UndoImageBuf *, ubuf_pre, &uh->buffers) {
+      for (UndoImageBuf *ubuf = ubuf_pre; ubuf; ubuf = (ubuf == ubuf_pre) ? ubuf->post : NULL) {
+        for (uint i = 0; i < ubuf->tiles_len; i++) {
+          UndoImageTile *utile = ubuf->tiles[i];
+          if (!utile->is_encoded) {
+            utile->is_encoded = true;
+            utiles[utiles_len++] = utile;
+          }
+        }
+      }
+    }
+  }
+
+  utile_compress_array(utiles, utiles_len);
+
+  size_t data_size = 0;
+  for (int i = 0; i < utiles_len; i++) {
+    data_size += utile_memory_size(utiles[i]);
+  }
+  MEM_freeN(utiles);
+
+  return data_size;
+}
+
 static void uhandle_free_list(ListBase *undo_handles)
 {
   LISTBASE_FOREACH_MUTABLE (UndoImageHandle *, uh, undo_handles) {
@@ -784,6 +968,7 @@ static bool image_undosys_step_encode(struct bContext *C,
 
         UndoImageTile *utile = MEM_callocN(sizeof(*utile), "UndoImageTile");
         utile->users = 1;
+        utile->use_float = ptile->use_float;
         utile->rect.pt = ptile->rect.pt;
         ptile->rect.pt = NULL;
         const uint tile_index = index_from_xy(ptile->x_tile, ptile->y_tile, ubuf_pre->tiles_dims);
@@ -828,7 +1013,15 @@ static bool image_undosys_step_encode(struct bContext *C,
                                                /* In this case the paint stroke as has added a tile
                                                 * which we have a duplicate reference available. */
                                                (ubuf_pre->tiles[i]->users == 1))) {
-                if (ubuf_pre->tiles[i] != NULL) {
+                if (ubuf_pre->tiles[i] != NULL &&
+                    utile_matches_imbuf(ubuf_pre->tiles[i], x, y, ibuf, tmpibuf)) {
+                  /* The stroke didn't change this tile, share the reference instead. */
+                  utile_decref(ubuf_pre->tiles[i]);
+                  ubuf_pre->tiles[i] = NULL;
+                  ubuf_post->tiles[i] = ubuf_reference->tiles[i];
+                  ubuf_post->tiles[i]->users += 1;
+                }
+                else if (ubuf_pre->tiles[i] != NULL) {
                   /* If we have a reference, re-use this single use tile for the post state. */
                   BLI_assert(ubuf_pre->tiles[i]->users == 1);
                   ubuf_post->tiles[i] = ubuf_pre->tiles[i];
@@ -847,6 +1040,12 @@ static bool image_undosys_step_encode(struct bContext *C,
                 BLI_assert(ubuf_pre->tiles[i] != NULL);
                 BLI_assert(ubuf_post->tiles[i] != NULL);
               }
+              else if (ubuf_pre->tiles[i] != NULL &&
+                       utile_matches_imbuf(ubuf_pre->tiles[i], x, y, ibuf, tmpibuf)) {
+                /* The stroke didn't change this tile, share it between both states. */
+                ubuf_post->tiles[i] = ubuf_pre->tiles[i];
+                ubuf_post->tiles[i]->users += 1;
+              }
               else {
                 UndoImageTile *utile = utile_alloc(has_float);
                 utile_init_from_imbuf(utile, x, y, ibuf, tmpibuf);
@@ -875,6 +1074,8 @@ static bool image_undosys_step_encode(struct bContext *C,
 
     IMB_freeImBuf(tmpibuf);
 
+    us->step.data_size = uhandle_list_encode_tiles(&us->handles);
+
     /* Useful to debug tiles are stored correctly. */
     if (false) {
       uhandle_restore_list(&us->handles, false);
@@ -1083,4 +1284,19 @@ void ED_image_undo_push_end(void)
   WM_file_tag_modified();
 }
 
+/* Memory used by the image undo steps, for statistics. */
+size_t ED_image_undo_memory_in_use(void)
+{
+  UndoStack *ustack = ED_undo_stack_get();
+  size_t data_size = 0;
+  if (ustack != NULL) {
+    LISTBASE_FOREACH (UndoStep *, us, &ustack->steps) {
+      if (us->type == BKE_UNDOSYS_TYPE_IMAGE) {
+        data_size += us->data_size;
+      }
+    }
+  }
+  return data_size;
+}
+
 /** \} */
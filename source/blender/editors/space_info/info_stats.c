@@ -59,6 +59,7 @@
 
 #include "ED_info.h"
 #include "ED_armature.h"
+#include "ED_paint.h"
 
 #include "GPU_extensions.h"
 
@@ -396,7 +397,7 @@ static void stats_update(Depsgraph *depsgraph, ViewLayer *view_layer)
 
 static void stats_string(ViewLayer *view_layer)
 {
-#define MAX_INFO_MEM_LEN 64
+#define MAX_INFO_MEM_LEN 96
   SceneStats *stats = view_layer->stats;
   SceneStatsFmt stats_fmt;
   LayerCollection *layer_collection = view_layer->active_collection;
@@ -449,7 +450,12 @@ static void stats_string(ViewLayer *view_layer)
 
   if (mmap_in_use) {
     BLI_str_format_byte_unit(formatted_mem, mmap_in_use, false);
-    BLI_snprintf(memstr + ofs, MAX_INFO_MEM_LEN - ofs, TIP_(" (%s)"), formatted_mem);
+    ofs += BLI_snprintf(memstr + ofs, MAX_INFO_MEM_LEN - ofs, TIP_(" (%s)"), formatted_mem);
+  }
+
+  if (object_mode & OB_MODE_TEXTURE_PAINT) {
+    BLI_str_format_byte_unit(formatted_mem, ED_image_undo_memory_in_use(), false);
+    BLI_snprintf(memstr + ofs, MAX_INFO_MEM_LEN - ofs, TIP_(" | Paint Undo: %s"), formatted_mem);
   }
 
   if (GPU_mem_stats_supported()) {
@@ -31,6 +31,7 @@
 
 #include "BLI_math.h"
 #include "BLI_blenlib.h"
+#include "BLI_ghash.h"
 
 #include "BKE_context.h"
 #include "BKE_global.h"
@@ -515,6 +516,7 @@ void ED_node_composit_default(const bContext *C, struct Scene *sce)
   sce->nodetree = ntreeAddTree(NULL, "Compositing Nodetree", ntreeType_Composite->idname);
 
   sce->nodetree->chunksize = 256;
+  sce->nodetree->cache_size = 512;
   sce->nodetree->edit_quality = NTREE_QUALITY_HIGH;
   sce->nodetree->render_quality = NTREE_QUALITY_HIGH;
 
@@ -1355,6 +1357,34 @@ void ED_node_select_all(ListBase *lb, int action)
 /* ******************************** */
 // XXX some code needing updating to operators...
 
+/* Passes of the scene linked from the Render Layers nodes of the tree, as "view layer.pass" keys
+ * for RE_ReadRenderResult(). */
+static GSet *node_read_viewlayers_passes(bNodeTree *ntree, Scene *scene)
+{
+  GSet *passes = BLI_gset_str_new(__func__);
+
+  LISTBASE_FOREACH (bNode *, node, &ntree->nodes) {
+    if (node->type != CMP_NODE_R_LAYERS || node->id != &scene->id) {
+      continue;
+    }
+    ViewLayer *view_layer = BLI_findlink(&scene->view_layers, node->custom1);
+    if (view_layer == NULL) {
+      continue;
+    }
+    LISTBASE_FOREACH (bNodeSocket *, sock, &node->outputs) {
+      NodeImageLayer *sockdata = sock->storage;
+      if ((sock->flag & SOCK_IN_USE) && sockdata) {
+        char *key = BLI_sprintfN("%s.%s", view_layer->name, sockdata->pass_name);
+        if (!BLI_gset_add(passes, key)) {
+          MEM_freeN(key);
+        }
+      }
+    }
+  }
+
+  return passes;
+}
+
 /* goes over all scenes, reads render layers */
 static int node_read_viewlayers_exec(bContext *C, wmOperator *UNUSED(op))
 {
@@ -1374,7 +1404,10 @@ static int node_read_viewlayers_exec(bContext *C, wmOperator *UNUSED(op))
     if (node->type == CMP_NODE_R_LAYERS) {
       ID *id = node->id;
       if (id->tag & LIB_TAG_DOIT) {
-        RE_ReadRenderResult(curscene, (Scene *)id);
+        /* only the passes the compositor uses are decoded */
+        GSet *passes = node_read_viewlayers_passes(snode->edittree, (Scene *)id);
+        RE_ReadRenderResult(curscene, (Scene *)id, passes);
+        BLI_gset_free(passes, MEM_freeN);
         ntreeCompositTagRender((Scene *)id);
         id->tag &= ~LIB_TAG_DOIT;
       }
@@ -1800,6 +1800,8 @@ typedef struct CacheDrawData {
   struct View2D *v2d;
   float stripe_offs;
   float stripe_ht;
+  /** Scale stripes of strips by the time it took to render their images. */
+  bool show_cost;
   GPUVertBuf *raw_vbo;
   GPUVertBuf *preprocessed_vbo;
   GPUVertBuf *composite_vbo;
@@ -1812,13 +1814,15 @@ typedef struct CacheDrawData {
 
 /* Called as a callback */
 static bool draw_cache_view_cb(
-    void *userdata, struct Sequence *seq, int nfra, int cache_type, float UNUSED(cost))
+    void *userdata, struct Sequence *seq, int nfra, int cache_type, float cost)
 {
   CacheDrawData *drawdata = userdata;
   struct View2D *v2d = drawdata->v2d;
   float stripe_bot, stripe_top, stripe_offs, stripe_ht;
   GPUVertBuf *vbo;
   size_t *vert_count;
+  /* Cost is the render time relative to the duration of a frame, keep cheap images visible. */
+  const float cost_fac = drawdata->show_cost ? clamp_f(cost, 0.1f, 1.0f) : 1.0f;
   switch (cache_type) {
     case SEQ_CACHE_STORE_FINAL_OUT:
       stripe_ht = UI_view2d_region_to_view_y(v2d, 4.0f * UI_DPI_FAC * U.pixelsize) - v2d->cur.ymin;
@@ -1832,7 +1836,7 @@ static bool draw_cache_view_cb(
       stripe_offs = drawdata->stripe_offs;
       stripe_ht = drawdata->stripe_ht;
       stripe_bot = seq->machine + SEQ_STRIP_OFSBOTTOM + stripe_offs;
-      stripe_top = stripe_bot + stripe_ht;
+      stripe_top = stripe_bot + stripe_ht * cost_fac;
       vbo = drawdata->raw_vbo;
       vert_count = &drawdata->raw_vert_count;
       break;
@@ -1841,7 +1845,7 @@ static bool draw_cache_view_cb(
       stripe_offs = drawdata->stripe_offs;
       stripe_ht = drawdata->stripe_ht;
       stripe_bot = seq->machine + SEQ_STRIP_OFSBOTTOM + (stripe_offs + stripe_ht) + stripe_offs;
-      stripe_top = stripe_bot + stripe_ht;
+      stripe_top = stripe_bot + stripe_ht * cost_fac;
       vbo = drawdata->preprocessed_vbo;
       vert_count = &drawdata->preprocessed_vert_count;
       break;
@@ -1850,7 +1854,7 @@ static bool draw_cache_view_cb(
       stripe_offs = drawdata->stripe_offs;
       stripe_ht = drawdata->stripe_ht;
       stripe_top = seq->machine + SEQ_STRIP_OFSTOP - stripe_offs;
-      stripe_bot = stripe_top - stripe_ht;
+      stripe_bot = stripe_top - stripe_ht * cost_fac;
       vbo = drawdata->composite_vbo;
       vert_count = &drawdata->composite_vert_count;
       break;
@@ -1969,6 +1973,7 @@ static void draw_cache_view(const bContext *C)
     userdata.v2d = v2d;
     userdata.stripe_offs = stripe_offs;
     userdata.stripe_ht = stripe_ht;
+    userdata.show_cost = (scene->ed->cache_flag & SEQ_CACHE_VIEW_COST) != 0;
     userdata.raw_vert_count = 0;
     userdata.preprocessed_vert_count = 0;
     userdata.composite_vert_count = 0;
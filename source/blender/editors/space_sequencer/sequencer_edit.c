@@ -30,6 +30,8 @@
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_timecode.h"
 #include "BLI_utildefines.h"
 
@@ -61,6 +63,8 @@
 #include "ED_sequencer.h"
 #include "ED_space_api.h"
 
+#include "IMB_imbuf.h"
+
 #include "UI_view2d.h"
 #include "UI_interface.h"
 
@@ -133,34 +137,128 @@ typedef struct ProxyBuildJob {
   Scene *scene;
   ListBase queue;
   int stop;
+
+  /* Progress of the strips being built at the same time, averaged into the progress of the
+   * job by proxy_updatejob(). */
+  float *job_progress;
+  float *build_progress;
+  int num_build;
+  SpinLock build_progress_lock;
 } ProxyJob;
 
+typedef struct ProxyBuildTask {
+  struct SeqIndexBuildContext *context;
+  short *stop;
+  short *do_update;
+  float *progress;
+} ProxyBuildTask;
+
 static void proxy_freejob(void *pjv)
 {
   ProxyJob *pj = pjv;
 
   BLI_freelistN(&pj->queue);
+  MEM_SAFE_FREE(pj->build_progress);
+  BLI_spin_end(&pj->build_progress_lock);
 
   MEM_freeN(pj);
 }
 
+static void proxy_build_task_func(TaskPool *__restrict UNUSED(pool),
+                                  void *taskdata,
+                                  int UNUSED(threadid))
+{
+  ProxyBuildTask *task = taskdata;
+  BKE_sequencer_proxy_rebuild(task->context, task->stop, task->do_update, task->progress);
+}
+
+/* Build the strips from first to last, movies at the same time on their own scheduler. */
+static void proxy_build_strips(
+    ProxyJob *pj, LinkData *first, LinkData *last, short *stop, short *do_update)
+{
+  int num_build = 1;
+  int num_movies = BKE_sequencer_proxy_rebuild_supports_threads(first->data) ? 1 : 0;
+  for (LinkData *link = first; link != last; link = link->next) {
+    num_build++;
+    num_movies += BKE_sequencer_proxy_rebuild_supports_threads(link->next->data) ? 1 : 0;
+  }
+
+  /* Each movie encodes every proxy size on a thread of its own next to the threads of its
+   * decoder. Only build as many movies at once as the system has threads for, and split the
+   * remaining threads between their decoders. */
+  const int num_threads = BLI_system_thread_count();
+  const int num_parallel = max_ii(1, min_ii(num_movies, num_threads / (IMB_PROXY_MAX_SLOT + 1)));
+  const int num_decode_threads = max_ii(1, num_threads / num_parallel - IMB_PROXY_MAX_SLOT);
+
+  BLI_spin_lock(&pj->build_progress_lock);
+  MEM_SAFE_FREE(pj->build_progress);
+  pj->build_progress = MEM_callocN(sizeof(float) * num_build, __func__);
+  pj->num_build = num_build;
+  BLI_spin_unlock(&pj->build_progress_lock);
+
+  ProxyBuildTask *tasks = MEM_mallocN(sizeof(ProxyBuildTask) * num_build, __func__);
+  TaskScheduler *task_scheduler = BLI_task_scheduler_create(num_parallel);
+  TaskPool *task_pool = BLI_task_pool_create(task_scheduler, NULL);
+  LinkData *link = first;
+
+  for (int i = 0; i < num_build; i++, link = link->next) {
+    tasks[i].context = link->data;
+    tasks[i].stop = stop;
+    tasks[i].do_update = do_update;
+    tasks[i].progress = &pj->build_progress[i];
+
+    if (BKE_sequencer_proxy_rebuild_supports_threads(tasks[i].context)) {
+      BKE_sequencer_proxy_rebuild_set_num_threads(tasks[i].context, num_decode_threads);
+      BLI_task_pool_push(task_pool, proxy_build_task_func, &tasks[i], false, TASK_PRIORITY_LOW);
+    }
+  }
+
+  for (int i = 0; i < num_build && !*stop; i++) {
+    if (!BKE_sequencer_proxy_rebuild_supports_threads(tasks[i].context)) {
+      proxy_build_task_func(NULL, &tasks[i], 0);
+    }
+  }
+
+  BLI_task_pool_work_and_wait(task_pool);
+  BLI_task_pool_free(task_pool);
+  BLI_task_scheduler_free(task_scheduler);
+  MEM_freeN(tasks);
+}
+
 /* only this runs inside thread */
 static void proxy_startjob(void *pjv, short *stop, short *do_update, float *progress)
 {
   ProxyJob *pj = pjv;
-  LinkData *link;
+  LinkData *link = pj->queue.first;
 
-  for (link = pj->queue.first; link; link = link->next) {
-    struct SeqIndexBuildContext *context = link->data;
+  pj->job_progress = progress;
 
-    BKE_sequencer_proxy_rebuild(context, stop, do_update, progress);
+  /* Strips can be added to the queue while the job runs, they are built afterwards. */
+  while (link && !*stop) {
+    LinkData *last = pj->queue.last;
+    proxy_build_strips(pj, link, last, stop, do_update);
+    link = last->next;
+  }
 
-    if (*stop) {
-      pj->stop = 1;
-      fprintf(stderr, "Canceling proxy rebuild on users request...\n");
-      break;
+  if (*stop) {
+    pj->stop = 1;
+    fprintf(stderr, "Canceling proxy rebuild on users request...\n");
+  }
+}
+
+static void proxy_updatejob(void *pjv)
+{
+  ProxyJob *pj = pjv;
+
+  BLI_spin_lock(&pj->build_progress_lock);
+  if (pj->job_progress && pj->num_build) {
+    float progress = 0.0f;
+    for (int i = 0; i < pj->num_build; i++) {
+      progress += pj->build_progress[i];
     }
+    *pj->job_progress = progress / pj->num_build;
   }
+  BLI_spin_unlock(&pj->build_progress_lock);
 }
 
 static void proxy_endjob(void *pjv)
@@ -208,10 +306,11 @@ static void seq_proxy_build_job(const bContext *C, ReportList *reports)
     pj->depsgraph = depsgraph;
     pj->scene = scene;
     pj->main = CTX_data_main(C);
+    BLI_spin_init(&pj->build_progress_lock);
 
     WM_jobs_customdata_set(wm_job, pj, proxy_freejob);
     WM_jobs_timer(wm_job, 0.1, NC_SCENE | ND_SEQUENCER, NC_SCENE | ND_SEQUENCER);
-    WM_jobs_callbacks(wm_job, proxy_startjob, NULL, NULL, proxy_endjob);
+    WM_jobs_callbacks(wm_job, proxy_startjob, NULL, proxy_updatejob, proxy_endjob);
   }
 
   file_list = BLI_gset_new(BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, "file list");
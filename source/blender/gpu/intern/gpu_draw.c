@@ -264,17 +264,15 @@ static uint gpu_texture_create_tile_array(Image *ima, ImBuf *main_ibuf)
 
   ListBase boxes = {NULL};
 
+  /* Only the size of the tiles is needed for packing, which doesn't require to decode them. Tiles
+   * are acquired one at a time for the upload, so the image budget can free the uploaded ones. */
   LISTBASE_FOREACH (ImageTile *, tile, &ima->tiles) {
-    ImageUser iuser;
-    BKE_imageuser_default(&iuser);
-    iuser.tile = tile->tile_number;
-    ImBuf *ibuf = BKE_image_acquire_ibuf(ima, &iuser, NULL);
-
-    if (ibuf) {
+    int width, height;
+    if (BKE_image_get_tile_size(ima, tile, &width, &height)) {
       PackTile *packtile = MEM_callocN(sizeof(PackTile), __func__);
       packtile->tile = tile;
-      packtile->boxpack.w = ibuf->x;
-      packtile->boxpack.h = ibuf->y;
+      packtile->boxpack.w = width;
+      packtile->boxpack.h = height;
 
       if (is_over_resolution_limit(
               GL_TEXTURE_2D_ARRAY, packtile->boxpack.w, packtile->boxpack.h)) {
@@ -289,7 +287,6 @@ static uint gpu_texture_create_tile_array(Image *ima, ImBuf *main_ibuf)
       float w = packtile->boxpack.w, h = packtile->boxpack.h;
       packtile->pack_score = max_ff(w, h) / min_ff(w, h) * w * h;
 
-      BKE_image_release_ibuf(ima, ibuf, NULL);
       BLI_addtail(&boxes, packtile);
     }
   }
@@ -117,6 +117,50 @@ struct ImBuf *IMB_testiffname(const char *filepath, int flags);
  */
 struct ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_SPACE]);
 
+/**
+ * Load an image for its thumbnail, at a reduced resolution of at least max_thumb_size pixels on
+ * its longest side for formats which can decode it faster that way. The size of the full image
+ * is returned in r_width and r_height.
+ *
+ * \attention Defined in readimage.c
+ */
+struct ImBuf *IMB_thumb_load_image(const char *filepath,
+                                   size_t max_thumb_size,
+                                   char colorspace[IM_MAX_SPACE],
+                                   size_t *r_width,
+                                   size_t *r_height);
+
+/**
+ * Start loading an image in the background, for IMB_load_async_acquire() to pick up.
+ * Returns false when too many images are being loaded already.
+ *
+ * \attention Defined in readimage_async.c
+ */
+bool IMB_load_async_request(const char *filepath, int flags, const char *colorspace);
+
+/**
+ * Same as IMB_loadiffname(), taking the result of a matching request when there is one.
+ *
+ * \attention Defined in readimage_async.c
+ */
+struct ImBuf *IMB_load_async_acquire(const char *filepath,
+                                     int flags,
+                                     char colorspace[IM_MAX_SPACE]);
+
+/**
+ * Drop all requests, images being decoded are freed when they finish.
+ *
+ * \attention Defined in readimage_async.c
+ */
+void IMB_load_async_cancel_all(void);
+
+/**
+ * Create the threads loading images, for requests made from tasks, which can not create them.
+ *
+ * \attention Defined in readimage_async.c
+ */
+void IMB_load_async_ensure_threads(void);
+
 /**
  *
  * \attention Defined in allocimbuf.c
@@ -342,6 +386,9 @@ void IMB_anim_index_rebuild(struct IndexBuildContext *context,
                             short *do_update,
                             float *progress);
 
+/* threads used to decode the movie, zero for all threads of the system */
+void IMB_anim_index_rebuild_set_num_threads(struct IndexBuildContext *context, int num_threads);
+
 /* finish rebuilding proxises/timecodes and free temporary contexts used */
 void IMB_anim_index_rebuild_finish(struct IndexBuildContext *context, short stop);
 
@@ -400,6 +447,14 @@ struct ImBuf *IMB_anim_previewframe(struct anim *anim);
  */
 void IMB_free_anim(struct anim *anim);
 
+/**
+ * Decode movies opened afterwards with FFmpeg threads, and decode frames ahead in the
+ * background while they are requested in order.
+ *
+ * \attention Defined in anim_movie.c
+ */
+void IMB_anim_set_threaded_decoding(bool use_threads);
+
 /**
  *
  * \attention Defined in filter.c
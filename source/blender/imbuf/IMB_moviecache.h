@@ -58,6 +58,12 @@ void IMB_moviecache_set_priority_callback(struct MovieCache *cache,
                                           MovieCacheGetItemPriorityFP getitempriorityfp,
                                           MovieCachePriorityDeleterFP prioritydeleterfp);
 
+/* Image tiles are limited by their own memory budget, separate from the cache limit of movies
+ * and sequences. Unreferenced tiles are freed least recently used first. */
+void IMB_moviecache_use_image_budget(struct MovieCache *cache);
+void IMB_moviecache_set_image_budget(size_t maximum);
+size_t IMB_moviecache_get_image_budget_in_use(void);
+
 void IMB_moviecache_put(struct MovieCache *cache, void *userkey, struct ImBuf *ibuf);
 bool IMB_moviecache_put_if_possible(struct MovieCache *cache, void *userkey, struct ImBuf *ibuf);
 struct ImBuf *IMB_moviecache_get(struct MovieCache *cache, void *userkey);
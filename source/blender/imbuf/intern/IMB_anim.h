@@ -63,6 +63,10 @@
 #  include <libavformat/avformat.h>
 #  include <libavcodec/avcodec.h>
 #  include <libswscale/swscale.h>
+
+#  include "DNA_listBase.h"
+
+#  include "BLI_threads.h"
 #endif
 
 /* more endianness... should move to a separate file... */
@@ -81,6 +85,9 @@
 
 #define MAXNUMSTREAMS 50
 
+/* Most frames decoded ahead of playback, fewer are kept for large movies. */
+#define FFMPEG_READ_AHEAD_MAX_FRAMES 16
+
 struct IDProperty;
 struct _AviMovie;
 struct anim_index;
@@ -134,9 +141,27 @@ struct anim {
   int videoStream;
 
   struct ImBuf *last_frame;
+  /* Position of last_frame, the read-ahead thread decodes past curposition. */
+  int last_position;
   int64_t last_pts;
   int64_t next_pts;
   AVPacket next_packet;
+
+  /* Frames read_ahead_start to read_ahead_end (exclusive) decoded by the read-ahead thread,
+   * stored at their position modulo read_ahead_size. */
+  struct ImBuf *read_ahead_frames[FFMPEG_READ_AHEAD_MAX_FRAMES];
+  int read_ahead_size;
+  int read_ahead_start, read_ahead_end;
+  int read_ahead_tc;
+  int read_ahead_last_request;
+  /* Number of requests waiting for the read-ahead thread to finish its frame. */
+  int read_ahead_requests;
+  bool read_ahead_busy;
+  bool read_ahead_active;
+  bool read_ahead_stop;
+  ListBase read_ahead_thread;
+  ThreadMutex read_ahead_lock;
+  ThreadCondition read_ahead_cond;
 #endif
 
   char index_dir[768];
@@ -123,4 +123,19 @@ void colorspace_set_default_role(char *colorspace, int size, int role);
 void colormanage_imbuf_set_default_spaces(struct ImBuf *ibuf);
 void colormanage_imbuf_make_linear(struct ImBuf *ibuf, const char *from_colorspace);
 
+/* divers.c */
+void imb_buffer_byte_from_float_ex(unsigned char *rect_to,
+                                   const float *rect_from,
+                                   int channels_from,
+                                   float dither,
+                                   int profile_to,
+                                   int profile_from,
+                                   bool predivide,
+                                   int width,
+                                   int height,
+                                   int stride_to,
+                                   int stride_from,
+                                   int start_y,
+                                   int total_height);
+
 #endif /* __IMB_COLORMANAGEMENT_INTERN_H__ */
@@ -39,6 +39,14 @@ typedef struct ImFileType {
                         int flags,
                         char colorspace[IM_MAX_SPACE]);
   struct ImBuf *(*load_filepath)(const char *name, int flags, char colorspace[IM_MAX_SPACE]);
+  /** Load the image at a reduced resolution of at least max_thumb_size pixels on its longest
+   * side when the format can skip data for it, the full image size is returned. */
+  struct ImBuf *(*load_filepath_thumbnail)(const char *name,
+                                           int flags,
+                                           size_t max_thumb_size,
+                                           char colorspace[IM_MAX_SPACE],
+                                           size_t *r_width,
+                                           size_t *r_height);
   int (*save)(struct ImBuf *ibuf, const char *name, int flags);
   void (*load_tile)(struct ImBuf *ibuf,
                     const unsigned char *mem,
@@ -61,6 +69,9 @@ void imb_filetypes_exit(void);
 void imb_tile_cache_init(void);
 void imb_tile_cache_exit(void);
 
+void imb_load_async_init(void);
+void imb_load_async_exit(void);
+
 void imb_loadtile(struct ImBuf *ibuf, int tx, int ty, unsigned int *rect);
 void imb_tile_cache_tile_free(struct ImBuf *ibuf, int tx, int ty);
 
@@ -106,6 +117,12 @@ struct ImBuf *imb_load_jpeg(const unsigned char *buffer,
                             size_t size,
                             int flags,
                             char colorspace[IM_MAX_SPACE]);
+struct ImBuf *imb_thumbnail_jpeg(const char *name,
+                                 int flags,
+                                 size_t max_thumb_size,
+                                 char colorspace[IM_MAX_SPACE],
+                                 size_t *r_width,
+                                 size_t *r_height);
 
 /* bmp */
 int imb_is_a_bmp(const unsigned char *buf);
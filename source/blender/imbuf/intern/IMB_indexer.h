@@ -110,6 +110,13 @@ void IMB_free_indices(struct anim *anim);
 
 struct anim *IMB_anim_open_proxy(struct anim *anim, IMB_Proxy_Size preview_size);
 struct anim_index *IMB_anim_open_index(struct anim *anim, IMB_Timecode_Type tc);
+/* Same as IMB_anim_open_index(), with the read-ahead lock already held by the caller. */
+struct anim_index *IMB_anim_open_index_locked(struct anim *anim, IMB_Timecode_Type tc);
+
+/* Wait for the read-ahead thread to finish its frame and keep it from decoding until
+ * IMB_anim_read_ahead_resume(), while the indices it reads are opened or freed. */
+void IMB_anim_read_ahead_pause(struct anim *anim, bool discard_frames);
+void IMB_anim_read_ahead_resume(struct anim *anim);
 
 int IMB_proxy_size_to_array_index(IMB_Proxy_Size pr_size);
 int IMB_timecode_to_array_index(IMB_Timecode_Type tc);
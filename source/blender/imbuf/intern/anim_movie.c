@@ -59,6 +59,8 @@
 #endif
 
 #include "BLI_utildefines.h"
+#include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_string.h"
 #include "BLI_path_util.h"
 
@@ -87,6 +89,13 @@
 #  include <libswscale/swscale.h>
 
 #  include "ffmpeg_compat.h"
+
+/* Memory for frames decoded ahead, shared by all movies. 16 frames of HD and 8 frames of 4K. */
+#  define FFMPEG_READ_AHEAD_MEMORY (256 * 1024 * 1024)
+
+static bool anim_use_threads = false;
+static size_t ffmpeg_read_ahead_memory_in_use = 0;
+static ThreadMutex ffmpeg_read_ahead_memory_lock = BLI_MUTEX_INITIALIZER;
 #endif  // WITH_FFMPEG
 
 int ismovie(const char *UNUSED(filepath))
@@ -247,6 +256,21 @@ void IMB_close_anim_proxies(struct anim *anim)
   IMB_free_indices(anim);
 }
 
+static int anim_get_duration_locked(struct anim *anim, IMB_Timecode_Type tc)
+{
+  struct anim_index *idx;
+  if (tc == IMB_TC_NONE) {
+    return anim->duration_in_frames;
+  }
+
+  idx = IMB_anim_open_index_locked(anim, tc);
+  if (!idx) {
+    return anim->duration_in_frames;
+  }
+
+  return IMB_indexer_get_duration(idx);
+}
+
 struct IDProperty *IMB_anim_load_metadata(struct anim *anim)
 {
   switch (anim->curtype) {
@@ -559,6 +583,11 @@ static int startffmpeg(struct anim *anim)
 
   pCodecCtx->workaround_bugs = 1;
 
+  if (anim_use_threads) {
+    pCodecCtx->thread_count = BLI_system_thread_count();
+    pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+  }
+
   if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
     avformat_close_input(&pFormatCtx);
     return -1;
@@ -623,6 +652,7 @@ static int startffmpeg(struct anim *anim)
 
   anim->curposition = -1;
   anim->last_frame = 0;
+  anim->last_position = -1;
   anim->last_pts = -1;
   anim->next_pts = -1;
   anim->next_packet.stream_index = -1;
@@ -729,6 +759,25 @@ static int startffmpeg(struct anim *anim)
   }
 #  endif
 
+  if (anim_use_threads) {
+    anim->read_ahead_size = (int)clamp_z(
+        FFMPEG_READ_AHEAD_MEMORY / anim->framesize, 2, FFMPEG_READ_AHEAD_MAX_FRAMES);
+    anim->read_ahead_start = 0;
+    anim->read_ahead_end = 0;
+    anim->read_ahead_tc = IMB_TC_NONE;
+    anim->read_ahead_last_request = -1;
+    anim->read_ahead_active = false;
+    anim->read_ahead_stop = false;
+    anim->read_ahead_busy = false;
+    anim->read_ahead_requests = 0;
+    BLI_listbase_clear(&anim->read_ahead_thread);
+    BLI_mutex_init(&anim->read_ahead_lock);
+    BLI_condition_init(&anim->read_ahead_cond);
+  }
+  else {
+    anim->read_ahead_size = 0;
+  }
+
   return (0);
 }
 
@@ -1051,8 +1100,10 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: pos=%d\n", position);
 
+  /* Either the read-ahead lock is held, or the read-ahead thread decodes the frame with the
+   * index it opened under the lock. */
   if (tc != IMB_TC_NONE) {
-    tc_index = IMB_anim_open_index(anim, tc);
+    tc_index = IMB_anim_open_index_locked(anim, tc);
   }
 
   v_st = anim->pFormatCtx->streams[anim->videoStream];
@@ -1064,7 +1115,7 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
   if (tc_index) {
     new_frame_index = IMB_indexer_get_frame_index(tc_index, position);
-    old_frame_index = IMB_indexer_get_frame_index(tc_index, anim->curposition);
+    old_frame_index = IMB_indexer_get_frame_index(tc_index, anim->last_position);
     pts_to_search = IMB_indexer_get_pts(tc_index, new_frame_index);
   }
   else {
@@ -1091,12 +1142,12 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
            (long long int)anim->last_pts,
            (long long int)anim->next_pts);
     IMB_refImBuf(anim->last_frame);
-    anim->curposition = position;
+    anim->last_position = position;
     return anim->last_frame;
   }
 
-  if (position > anim->curposition + 1 && anim->preseek && !tc_index &&
-      position - (anim->curposition + 1) < anim->preseek) {
+  if (position > anim->last_position + 1 && anim->preseek && !tc_index &&
+      position - (anim->last_position + 1) < anim->preseek) {
     av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: within preseek interval (no index)\n");
 
     ffmpeg_decode_video_frame_scan(anim, pts_to_search);
@@ -1109,7 +1160,7 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
     ffmpeg_decode_video_frame_scan(anim, pts_to_search);
   }
-  else if (position != anim->curposition + 1) {
+  else if (position != anim->last_position + 1) {
     long long pos;
     int ret;
 
@@ -1182,7 +1233,7 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
       ffmpeg_decode_video_frame_scan(anim, pts_to_search);
     }
   }
-  else if (position == 0 && anim->curposition == -1) {
+  else if (position == 0 && anim->last_position == -1) {
     /* first frame without seeking special case... */
     ffmpeg_decode_video_frame(anim);
   }
@@ -1200,13 +1251,168 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
   ffmpeg_decode_video_frame(anim);
 
-  anim->curposition = position;
+  anim->last_position = position;
 
   IMB_refImBuf(anim->last_frame);
 
   return anim->last_frame;
 }
 
+/* Account for a frame kept by a movie, returns false when it does not fit in the memory for
+ * frames decoded ahead. Frames which are shown are always kept. */
+static bool ffmpeg_read_ahead_memory_add(size_t size, bool force)
+{
+  bool ok = false;
+  BLI_mutex_lock(&ffmpeg_read_ahead_memory_lock);
+  if (force || ffmpeg_read_ahead_memory_in_use + size <= FFMPEG_READ_AHEAD_MEMORY) {
+    ffmpeg_read_ahead_memory_in_use += size;
+    ok = true;
+  }
+  BLI_mutex_unlock(&ffmpeg_read_ahead_memory_lock);
+  return ok;
+}
+
+static void ffmpeg_read_ahead_memory_remove(size_t size)
+{
+  BLI_mutex_lock(&ffmpeg_read_ahead_memory_lock);
+  BLI_assert(ffmpeg_read_ahead_memory_in_use >= size);
+  ffmpeg_read_ahead_memory_in_use -= size;
+  BLI_mutex_unlock(&ffmpeg_read_ahead_memory_lock);
+}
+
+/* Free the decoded frames before the given position. */
+static void ffmpeg_read_ahead_free_frames(struct anim *anim, int position)
+{
+  while (anim->read_ahead_start < min_ii(position, anim->read_ahead_end)) {
+    ImBuf **frame = &anim->read_ahead_frames[anim->read_ahead_start % anim->read_ahead_size];
+    IMB_freeImBuf(*frame);
+    *frame = NULL;
+    ffmpeg_read_ahead_memory_remove(anim->framesize);
+    anim->read_ahead_start++;
+  }
+}
+
+static void *ffmpeg_read_ahead_thread(void *anim_v)
+{
+  struct anim *anim = anim_v;
+
+  BLI_mutex_lock(&anim->read_ahead_lock);
+  while (!anim->read_ahead_stop) {
+    const int position = anim->read_ahead_end;
+    const IMB_Timecode_Type tc = anim->read_ahead_tc;
+
+    /* Requests go first, they wait for the frame being decoded. Without memory left, wait for
+     * the next request to free the frames before it. */
+    if (anim->read_ahead_requests > 0 || !anim->read_ahead_active ||
+        position - anim->read_ahead_start >= anim->read_ahead_size ||
+        position >= anim_get_duration_locked(anim, tc) ||
+        !ffmpeg_read_ahead_memory_add(anim->framesize, false)) {
+      BLI_condition_wait(&anim->read_ahead_cond, &anim->read_ahead_lock);
+      continue;
+    }
+
+    /* The decoder is left to this thread until the frame is done, the frames and the
+     * positions can't change meanwhile. */
+    anim->read_ahead_busy = true;
+    BLI_mutex_unlock(&anim->read_ahead_lock);
+
+    ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, tc);
+
+    BLI_mutex_lock(&anim->read_ahead_lock);
+    anim->read_ahead_busy = false;
+    if (ibuf) {
+      anim->read_ahead_frames[position % anim->read_ahead_size] = ibuf;
+      anim->read_ahead_end++;
+    }
+    else {
+      ffmpeg_read_ahead_memory_remove(anim->framesize);
+      anim->read_ahead_active = false;
+    }
+    BLI_condition_notify_all(&anim->read_ahead_cond);
+  }
+  BLI_mutex_unlock(&anim->read_ahead_lock);
+
+  return NULL;
+}
+
+/* Fetch a frame decoded ahead, or decode it and continue decoding from there. */
+static ImBuf *ffmpeg_fetchibuf_read_ahead(struct anim *anim, int position, IMB_Timecode_Type tc)
+{
+  ImBuf *ibuf;
+  bool is_decoded = false;
+
+  BLI_mutex_lock(&anim->read_ahead_lock);
+  anim->read_ahead_requests++;
+  while (anim->read_ahead_busy) {
+    BLI_condition_wait(&anim->read_ahead_cond, &anim->read_ahead_lock);
+  }
+  anim->read_ahead_requests--;
+
+  /* Frames before the requested one are not going to be shown, seeking back or changing the
+   * timecode invalidates all of them. */
+  if (tc != anim->read_ahead_tc || position < anim->read_ahead_start) {
+    ffmpeg_read_ahead_free_frames(anim, anim->read_ahead_end);
+  }
+  else {
+    ffmpeg_read_ahead_free_frames(anim, position);
+  }
+
+  if (anim->read_ahead_start == position && position < anim->read_ahead_end) {
+    ibuf = anim->read_ahead_frames[position % anim->read_ahead_size];
+    is_decoded = true;
+  }
+  else {
+    ibuf = ffmpeg_fetchibuf(anim, position, tc);
+    anim->read_ahead_frames[position % anim->read_ahead_size] = ibuf;
+    anim->read_ahead_start = position;
+    anim->read_ahead_end = (ibuf) ? position + 1 : position;
+    anim->read_ahead_tc = tc;
+    if (ibuf) {
+      ffmpeg_read_ahead_memory_add(anim->framesize, true);
+    }
+  }
+  /* The requested frame stays decoded, for redraws. */
+  if (ibuf) {
+    IMB_refImBuf(ibuf);
+  }
+
+  /* Decode ahead while frames are requested in order, and stop when scrubbing. */
+  if (position == anim->read_ahead_last_request + 1) {
+    anim->read_ahead_active = true;
+  }
+  else if (!is_decoded && position != anim->read_ahead_last_request) {
+    anim->read_ahead_active = false;
+  }
+  anim->read_ahead_last_request = position;
+
+  if (anim->read_ahead_active && BLI_listbase_is_empty(&anim->read_ahead_thread)) {
+    BLI_threadpool_init(&anim->read_ahead_thread, ffmpeg_read_ahead_thread, 1);
+    BLI_threadpool_insert(&anim->read_ahead_thread, anim);
+  }
+
+  BLI_condition_notify_all(&anim->read_ahead_cond);
+  BLI_mutex_unlock(&anim->read_ahead_lock);
+
+  return ibuf;
+}
+
+static void free_anim_ffmpeg_read_ahead(struct anim *anim)
+{
+  BLI_mutex_lock(&anim->read_ahead_lock);
+  anim->read_ahead_stop = true;
+  BLI_condition_notify_all(&anim->read_ahead_cond);
+  BLI_mutex_unlock(&anim->read_ahead_lock);
+
+  if (!BLI_listbase_is_empty(&anim->read_ahead_thread)) {
+    BLI_threadpool_end(&anim->read_ahead_thread);
+  }
+
+  ffmpeg_read_ahead_free_frames(anim, anim->read_ahead_end);
+  BLI_condition_end(&anim->read_ahead_cond);
+  BLI_mutex_end(&anim->read_ahead_lock);
+  anim->read_ahead_size = 0;
+}
+
 static void free_anim_ffmpeg(struct anim *anim)
 {
   if (anim == NULL) {
@@ -1214,6 +1420,10 @@ static void free_anim_ffmpeg(struct anim *anim)
   }
 
   if (anim->pCodecCtx) {
+    if (anim->read_ahead_size) {
+      free_anim_ffmpeg_read_ahead(anim);
+    }
+
     avcodec_close(anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
 
@@ -1393,7 +1603,12 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 #endif
 #ifdef WITH_FFMPEG
     case ANIM_FFMPEG:
-      ibuf = ffmpeg_fetchibuf(anim, position, tc);
+      if (anim->read_ahead_size) {
+        ibuf = ffmpeg_fetchibuf_read_ahead(anim, position, tc);
+      }
+      else {
+        ibuf = ffmpeg_fetchibuf(anim, position, tc);
+      }
       if (ibuf) {
         anim->curposition = position;
       }
@@ -1415,17 +1630,49 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 
 int IMB_anim_get_duration(struct anim *anim, IMB_Timecode_Type tc)
 {
-  struct anim_index *idx;
-  if (tc == IMB_TC_NONE) {
-    return anim->duration_in_frames;
+  int duration;
+
+  IMB_anim_read_ahead_pause(anim, false);
+  duration = anim_get_duration_locked(anim, tc);
+  IMB_anim_read_ahead_resume(anim);
+
+  return duration;
+}
+
+void IMB_anim_read_ahead_pause(struct anim *anim, bool discard_frames)
+{
+#ifdef WITH_FFMPEG
+  if (anim->read_ahead_size == 0) {
+    return;
   }
 
-  idx = IMB_anim_open_index(anim, tc);
-  if (!idx) {
-    return anim->duration_in_frames;
+  BLI_mutex_lock(&anim->read_ahead_lock);
+  while (anim->read_ahead_busy) {
+    BLI_condition_wait(&anim->read_ahead_cond, &anim->read_ahead_lock);
   }
 
-  return IMB_indexer_get_duration(idx);
+  if (discard_frames) {
+    ffmpeg_read_ahead_free_frames(anim, anim->read_ahead_end);
+    anim->read_ahead_active = false;
+    anim->read_ahead_last_request = -1;
+  }
+#else
+  UNUSED_VARS(anim, discard_frames);
+#endif
+}
+
+void IMB_anim_read_ahead_resume(struct anim *anim)
+{
+#ifdef WITH_FFMPEG
+  if (anim->read_ahead_size == 0) {
+    return;
+  }
+
+  BLI_condition_notify_all(&anim->read_ahead_cond);
+  BLI_mutex_unlock(&anim->read_ahead_lock);
+#else
+  UNUSED_VARS(anim);
+#endif
 }
 
 bool IMB_anim_get_fps(struct anim *anim, short *frs_sec, float *frs_sec_base, bool no_av_base)
@@ -1470,3 +1717,12 @@ int IMB_anim_get_preseek(struct anim *anim)
 {
   return anim->preseek;
 }
+
+void IMB_anim_set_threaded_decoding(bool use_threads)
+{
+#ifdef WITH_FFMPEG
+  anim_use_threads = use_threads;
+#else
+  UNUSED_VARS(use_threads);
+#endif
+}
@@ -1607,6 +1607,64 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
   }
 }
 
+/* Number of pixels of float buffers processed at once, small enough for the intermediate buffer
+ * to stay in cache from the view transform to the conversion to bytes. */
+#define DISPLAY_BUFFER_PIXELS_PER_STEP 16384
+
+/* Display transform of a float buffer in linear space, the common case of renders and float
+ * images. Done a few lines at a time so every line is read from memory only once. */
+static void display_buffer_apply_float_lines(DisplayBufferThread *handle)
+{
+  ColormanageProcessor *cm_processor = handle->cm_processor;
+  float *display_buffer = handle->display_buffer;
+  unsigned char *display_buffer_byte = handle->display_buffer_byte;
+  const int channels = handle->channels;
+  const int width = handle->width;
+  const int height = handle->tot_line;
+  const bool predivide = handle->predivide;
+  const int step_lines = max_ii(DISPLAY_BUFFER_PIXELS_PER_STEP / width, 1);
+
+  float *linear_buffer = MEM_mallocN(
+      ((size_t)channels) * width * min_ii(step_lines, height) * sizeof(float),
+      "color conversion linear buffer");
+
+  for (int y = 0; y < height; y += step_lines) {
+    const int num_lines = min_ii(step_lines, height - y);
+    const size_t offset = ((size_t)channels) * width * y;
+    const size_t num_floats = ((size_t)channels) * width * num_lines;
+
+    memcpy(linear_buffer, handle->buffer + offset, num_floats * sizeof(float));
+
+    if (!handle->is_data) {
+      IMB_colormanagement_processor_apply(
+          cm_processor, linear_buffer, width, num_lines, channels, predivide);
+    }
+
+    if (display_buffer_byte) {
+      imb_buffer_byte_from_float_ex(display_buffer_byte + ((size_t)DISPLAY_BUFFER_CHANNELS) *
+                                                              width * y,
+                                    linear_buffer,
+                                    channels,
+                                    handle->dither,
+                                    IB_PROFILE_SRGB,
+                                    IB_PROFILE_SRGB,
+                                    predivide,
+                                    width,
+                                    num_lines,
+                                    width,
+                                    width,
+                                    y,
+                                    height);
+    }
+
+    if (display_buffer) {
+      memcpy(display_buffer + offset, linear_buffer, num_floats * sizeof(float));
+    }
+  }
+
+  MEM_freeN(linear_buffer);
+}
+
 static void *do_display_buffer_apply_thread(void *handle_v)
 {
   DisplayBufferThread *handle = (DisplayBufferThread *)handle_v;
@@ -1644,6 +1702,9 @@ static void *do_display_buffer_apply_thread(void *handle_v)
                                  width);
     }
   }
+  else if (handle->buffer && handle->float_colorspace == NULL) {
+    display_buffer_apply_float_lines(handle);
+  }
   else {
     bool is_straight_alpha;
     float *linear_buffer = MEM_mallocN(((size_t)channels) * width * height * sizeof(float),
@@ -35,6 +35,10 @@
 
 #include "MEM_guardedalloc.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 /************************* Floyd-Steinberg dithering *************************/
 
 typedef struct DitherContext {
@@ -96,30 +100,68 @@ MINLINE void float_to_byte_dither_v4(
   b[3] = unit_float_to_uchar_clamp(f[3]);
 }
 
+#ifdef __SSE2__
+/* Same as rgba_float_to_uchar(). */
+MINLINE void float_to_byte_v4_sse2(uchar b[4], __m128 f)
+{
+  __m128 v = _mm_min_ps(_mm_max_ps(f, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+  __m128i i = _mm_cvttps_epi32(v);
+  i = _mm_packs_epi32(i, i);
+  i = _mm_packus_epi16(i, i);
+  const int packed = _mm_cvtsi128_si32(i);
+  memcpy(b, &packed, sizeof(packed));
+}
+
+/* Same as premul_to_straight_v4_v4(). */
+MINLINE __m128 premul_to_straight_v4_sse2(__m128 premul)
+{
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 alpha = _mm_shuffle_ps(premul, premul, _MM_SHUFFLE(3, 3, 3, 3));
+  /* Colors with alpha of zero or one are left unchanged, as is alpha itself. */
+  __m128 keep = _mm_or_ps(_mm_cmpeq_ps(alpha, _mm_setzero_ps()), _mm_cmpeq_ps(alpha, one));
+  keep = _mm_or_ps(keep, _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)));
+  const __m128 straight = _mm_mul_ps(premul, _mm_div_ps(one, alpha));
+  return _mm_or_ps(_mm_and_ps(keep, premul), _mm_andnot_ps(keep, straight));
+}
+
+/* Same as float_to_byte_dither_v4(). */
+MINLINE void float_to_byte_dither_v4_sse2(
+    uchar b[4], __m128 f, DitherContext *di, float s, float t)
+{
+  const float dither_value = dither_random_value(s, t) * 0.0033f * di->dither;
+  const __m128 dither_v = _mm_set_ps(0.0f, dither_value, dither_value, dither_value);
+  float_to_byte_v4_sse2(b, _mm_add_ps(f, dither_v));
+}
+#endif
+
 /* Test if colorspace conversions of pixels in buffer need to take into account alpha. */
 bool IMB_alpha_affects_rgb(const ImBuf *ibuf)
 {
   return (ibuf->flags & IB_alphamode_channel_packed) == 0;
 }
 
-/* float to byte pixels, output 4-channel RGBA */
-void IMB_buffer_byte_from_float(uchar *rect_to,
-                                const float *rect_from,
-                                int channels_from,
-                                float dither,
-                                int profile_to,
-                                int profile_from,
-                                bool predivide,
-                                int width,
-                                int height,
-                                int stride_to,
-                                int stride_from)
+/* float to byte pixels, output 4-channel RGBA, for rows start_y to start_y + height of an image
+ * of total_height rows, which the dither noise depends on. */
+void imb_buffer_byte_from_float_ex(uchar *rect_to,
+                                   const float *rect_from,
+                                   int channels_from,
+                                   float dither,
+                                   int profile_to,
+                                   int profile_from,
+                                   bool predivide,
+                                   int width,
+                                   int height,
+                                   int stride_to,
+                                   int stride_from,
+                                   int start_y,
+                                   int total_height)
 {
   float tmp[4];
   int x, y;
   DitherContext *di = NULL;
   float inv_width = 1.0f / width;
-  float inv_height = 1.0f / height;
+  float inv_height = 1.0f / total_height;
 
   /* we need valid profiles */
   BLI_assert(profile_to != IB_PROFILE_NONE);
@@ -130,7 +172,7 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
   }
 
   for (y = 0; y < height; y++) {
-    float t = y * inv_height;
+    float t = (start_y + y) * inv_height;
 
     if (channels_from == 1) {
       /* single channel input */
@@ -176,9 +218,33 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
       uchar *to = rect_to + ((size_t)stride_to) * y * 4;
 
       if (profile_to == profile_from) {
+        /* no color space conversion */
+#ifdef __SSE2__
+        /* The common case of display buffers, four channels at once. */
+        if (dither && predivide) {
+          for (x = 0; x < width; x++, from += 4, to += 4) {
+            __m128 straight_v = premul_to_straight_v4_sse2(_mm_loadu_ps(from));
+            float_to_byte_dither_v4_sse2(to, straight_v, di, (float)x * inv_width, t);
+          }
+        }
+        else if (dither) {
+          for (x = 0; x < width; x++, from += 4, to += 4) {
+            float_to_byte_dither_v4_sse2(to, _mm_loadu_ps(from), di, (float)x * inv_width, t);
+          }
+        }
+        else if (predivide) {
+          for (x = 0; x < width; x++, from += 4, to += 4) {
+            float_to_byte_v4_sse2(to, premul_to_straight_v4_sse2(_mm_loadu_ps(from)));
+          }
+        }
+        else {
+          for (x = 0; x < width; x++, from += 4, to += 4) {
+            float_to_byte_v4_sse2(to, _mm_loadu_ps(from));
+          }
+        }
+#else
         float straight[4];
 
-        /* no color space conversion */
         if (dither && predivide) {
           for (x = 0; x < width; x++, from += 4, to += 4) {
             premul_to_straight_v4_v4(straight, from);
@@ -201,6 +267,7 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
             rgba_float_to_uchar(to, from);
           }
         }
+#endif
       }
       else if (profile_to == IB_PROFILE_SRGB) {
         /* convert from linear to sRGB */
@@ -269,6 +336,34 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
   }
 }
 
+/* float to byte pixels, output 4-channel RGBA */
+void IMB_buffer_byte_from_float(uchar *rect_to,
+                                const float *rect_from,
+                                int channels_from,
+                                float dither,
+                                int profile_to,
+                                int profile_from,
+                                bool predivide,
+                                int width,
+                                int height,
+                                int stride_to,
+                                int stride_from)
+{
+  imb_buffer_byte_from_float_ex(rect_to,
+                                rect_from,
+                                channels_from,
+                                dither,
+                                profile_to,
+                                profile_from,
+                                predivide,
+                                width,
+                                height,
+                                stride_to,
+                                stride_from,
+                                0,
+                                height);
+}
+
 /* float to byte pixels, output 4-channel RGBA */
 void IMB_buffer_byte_from_float_mask(uchar *rect_to,
                                      const float *rect_from,
@@ -30,6 +30,8 @@
 #include "BLI_string.h"
 #include "BLI_fileops.h"
 #include "BLI_ghash.h"
+#include "BLI_listbase.h"
+#include "BLI_threads.h"
 
 #include "IMB_indexer.h"
 #include "IMB_anim.h"
@@ -442,6 +444,10 @@ typedef struct IndexBuildContext {
 
 #ifdef WITH_FFMPEG
 
+/* Decoded frames waiting to be encoded by a proxy output, decoding waits for the encoder
+ * when it falls behind. */
+#  define PROXY_OUTPUT_MAX_QUEUED_FRAMES 8
+
 struct proxy_output_ctx {
   AVFormatContext *of;
   AVStream *st;
@@ -453,6 +459,10 @@ struct proxy_output_ctx {
   int proxy_size;
   int orig_height;
   struct anim *anim;
+
+  /* Frames to scale and encode on the thread of this output. */
+  ThreadQueue *frames;
+  bool stop;
 };
 
 // work around stupid swscaler 16 bytes alignment bug...
@@ -683,14 +693,53 @@ static void free_proxy_output_ffmpeg(struct proxy_output_ctx *ctx, int rollback)
   MEM_freeN(ctx);
 }
 
+static void *proxy_output_ffmpeg_thread(void *ctx_v)
+{
+  struct proxy_output_ctx *ctx = ctx_v;
+  AVFrame *frame;
+
+  while ((frame = BLI_thread_queue_pop(ctx->frames))) {
+    if (!ctx->stop) {
+      add_to_proxy_output_ffmpeg(ctx, frame);
+    }
+    av_frame_free(&frame);
+  }
+
+  return NULL;
+}
+
+static void proxy_output_ffmpeg_push(struct proxy_output_ctx *ctx, AVFrame *frame)
+{
+  if (!ctx) {
+    return;
+  }
+
+  /* The decoder reuses the frame, the queued copy owns its data. */
+  AVFrame *frame_copy = av_frame_clone(frame);
+  if (!frame_copy) {
+    return;
+  }
+
+  if (BLI_thread_queue_len(ctx->frames) >= PROXY_OUTPUT_MAX_QUEUED_FRAMES) {
+    BLI_thread_queue_wait_finish(ctx->frames);
+  }
+  BLI_thread_queue_push(ctx->frames, frame_copy);
+}
+
 typedef struct FFmpegIndexBuilderContext {
   int anim_type;
 
+  /* One thread per proxy output, encoding while the next frames are decoded. */
+  ListBase proxy_threads;
+
   AVFormatContext *iFormatCtx;
   AVCodecContext *iCodecCtx;
   AVCodec *iCodec;
   AVStream *iStream;
   int videoStream;
+  /* Threads of the decoder, which is only opened when the build starts so callers building
+   * several movies at once can lower it. Zero uses all threads of the system. */
+  int num_threads;
 
   int num_proxy_sizes;
   int num_indexers;
@@ -777,12 +826,6 @@ static IndexBuildContext *index_ffmpeg_create_context(struct anim *anim,
 
   context->iCodecCtx->workaround_bugs = 1;
 
-  if (avcodec_open2(context->iCodecCtx, context->iCodec, NULL) < 0) {
-    avformat_close_input(&context->iFormatCtx);
-    MEM_freeN(context);
-    return NULL;
-  }
-
   for (i = 0; i < num_proxy_sizes; i++) {
     if (proxy_sizes_in_use & proxy_sizes[i]) {
       context->proxy_ctx[i] = alloc_proxy_output_ffmpeg(
@@ -818,6 +861,11 @@ static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, int
 {
   int i;
 
+  /* Nothing was decoded when the decoder could not be opened. */
+  if (!avcodec_is_open(context->iCodecCtx)) {
+    stop = 1;
+  }
+
   for (i = 0; i < context->num_indexers; i++) {
     if (context->tcs_in_use & tc_types[i]) {
       IMB_index_builder_finish(context->indexer[i], stop);
@@ -846,7 +894,7 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
   unsigned long long pts = av_get_pts_from_frame(context->iFormatCtx, in_frame);
 
   for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
+    proxy_output_ffmpeg_push(context->proxy_ctx[i], in_frame);
   }
 
   if (!context->start_pts_set) {
@@ -890,6 +938,52 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
   context->frameno_gapless++;
 }
 
+static void index_rebuild_ffmpeg_threads_begin(FFmpegIndexBuilderContext *context)
+{
+  int num_outputs = 0;
+
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    if (context->proxy_ctx[i]) {
+      context->proxy_ctx[i]->frames = BLI_thread_queue_init();
+      context->proxy_ctx[i]->stop = false;
+      num_outputs++;
+    }
+  }
+
+  if (num_outputs == 0) {
+    return;
+  }
+
+  BLI_threadpool_init(&context->proxy_threads, proxy_output_ffmpeg_thread, num_outputs);
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    if (context->proxy_ctx[i]) {
+      BLI_threadpool_insert(&context->proxy_threads, context->proxy_ctx[i]);
+    }
+  }
+}
+
+/* Wait for the outputs to encode the queued frames, or drop them when stopped. */
+static void index_rebuild_ffmpeg_threads_end(FFmpegIndexBuilderContext *context, bool stop)
+{
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    if (context->proxy_ctx[i]) {
+      context->proxy_ctx[i]->stop = stop;
+      BLI_thread_queue_nowait(context->proxy_ctx[i]->frames);
+    }
+  }
+
+  if (!BLI_listbase_is_empty(&context->proxy_threads)) {
+    BLI_threadpool_end(&context->proxy_threads);
+  }
+
+  for (int i = 0; i < context->num_proxy_sizes; i++) {
+    if (context->proxy_ctx[i]) {
+      BLI_thread_queue_free(context->proxy_ctx[i]->frames);
+      context->proxy_ctx[i]->frames = NULL;
+    }
+  }
+}
+
 static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
                                 short *stop,
                                 short *do_update,
@@ -901,6 +995,16 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
 
   memset(&next_packet, 0, sizeof(AVPacket));
 
+  context->iCodecCtx->thread_count = context->num_threads > 0 ? context->num_threads :
+                                                                BLI_system_thread_count();
+  /* Frame threads return frames some packets late, the seek positions taken from the packets
+   * would not match the frames anymore. */
+  context->iCodecCtx->thread_type = FF_THREAD_SLICE;
+
+  if (avcodec_open2(context->iCodecCtx, context->iCodec, NULL) < 0) {
+    return 0;
+  }
+
   in_frame = av_frame_alloc();
 
   stream_size = avio_size(context->iFormatCtx->pb);
@@ -908,6 +1012,8 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
   context->frame_rate = av_q2d(av_guess_frame_rate(context->iFormatCtx, context->iStream, NULL));
   context->pts_time_base = av_q2d(context->iStream->time_base);
 
+  index_rebuild_ffmpeg_threads_begin(context);
+
   while (av_read_frame(context->iFormatCtx, &next_packet) >= 0) {
     int frame_finished = 0;
     float next_progress =
@@ -963,6 +1069,8 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
     } while (frame_finished);
   }
 
+  index_rebuild_ffmpeg_threads_end(context, *stop);
+
   av_free(in_frame);
 
   return 1;
@@ -1241,6 +1349,21 @@ void IMB_anim_index_rebuild(struct IndexBuildContext *context,
   UNUSED_VARS(stop, do_update, progress);
 }
 
+void IMB_anim_index_rebuild_set_num_threads(IndexBuildContext *context, int num_threads)
+{
+  switch (context->anim_type) {
+#ifdef WITH_FFMPEG
+    case ANIM_FFMPEG:
+      ((FFmpegIndexBuilderContext *)context)->num_threads = num_threads;
+      break;
+#endif
+    default:
+      break;
+  }
+
+  UNUSED_VARS(num_threads);
+}
+
 void IMB_anim_index_rebuild_finish(IndexBuildContext *context, short stop)
 {
   switch (context->anim_type) {
@@ -1260,7 +1383,7 @@ void IMB_anim_index_rebuild_finish(IndexBuildContext *context, short stop)
   UNUSED_VARS(stop, proxy_sizes);
 }
 
-void IMB_free_indices(struct anim *anim)
+static void anim_free_indices(struct anim *anim)
 {
   int i;
 
@@ -1282,14 +1405,24 @@ void IMB_free_indices(struct anim *anim)
   anim->indices_tried = 0;
 }
 
+void IMB_free_indices(struct anim *anim)
+{
+  /* Frames decoded ahead used the indices being freed. */
+  IMB_anim_read_ahead_pause(anim, true);
+  anim_free_indices(anim);
+  IMB_anim_read_ahead_resume(anim);
+}
+
 void IMB_anim_set_index_dir(struct anim *anim, const char *dir)
 {
   if (STREQ(anim->index_dir, dir)) {
     return;
   }
-  BLI_strncpy(anim->index_dir, dir, sizeof(anim->index_dir));
 
-  IMB_free_indices(anim);
+  IMB_anim_read_ahead_pause(anim, true);
+  BLI_strncpy(anim->index_dir, dir, sizeof(anim->index_dir));
+  anim_free_indices(anim);
+  IMB_anim_read_ahead_resume(anim);
 }
 
 struct anim *IMB_anim_open_proxy(struct anim *anim, IMB_Proxy_Size preview_size)
@@ -1315,7 +1448,7 @@ struct anim *IMB_anim_open_proxy(struct anim *anim, IMB_Proxy_Size preview_size)
   return anim->proxy_anim[i];
 }
 
-struct anim_index *IMB_anim_open_index(struct anim *anim, IMB_Timecode_Type tc)
+struct anim_index *IMB_anim_open_index_locked(struct anim *anim, IMB_Timecode_Type tc)
 {
   char fname[FILE_MAX];
   int i = IMB_timecode_to_array_index(tc);
@@ -1337,6 +1470,17 @@ struct anim_index *IMB_anim_open_index(struct anim *anim, IMB_Timecode_Type tc)
   return anim->curr_idx[i];
 }
 
+struct anim_index *IMB_anim_open_index(struct anim *anim, IMB_Timecode_Type tc)
+{
+  struct anim_index *idx;
+
+  IMB_anim_read_ahead_pause(anim, false);
+  idx = IMB_anim_open_index_locked(anim, tc);
+  IMB_anim_read_ahead_resume(anim);
+
+  return idx;
+}
+
 int IMB_anim_index_get_frame_index(struct anim *anim, IMB_Timecode_Type tc, int position)
 {
   struct anim_index *idx = IMB_anim_open_index(anim, tc);
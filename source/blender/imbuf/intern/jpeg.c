@@ -52,7 +52,11 @@ static void skip_input_data(j_decompress_ptr cinfo, long num_bytes);
 static void term_source(j_decompress_ptr cinfo);
 static void memory_source(j_decompress_ptr cinfo, const unsigned char *buffer, size_t size);
 static boolean handle_app1(j_decompress_ptr cinfo);
-static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int flags);
+static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo,
+                                   int flags,
+                                   int max_size,
+                                   size_t *r_width,
+                                   size_t *r_height);
 
 static const uchar jpeg_default_quality = 75;
 static uchar ibuf_quality;
@@ -258,7 +262,13 @@ static boolean handle_app1(j_decompress_ptr cinfo)
   return true;
 }
 
-static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int flags)
+/* With a max_size, the image is scaled down by libjpeg while decoding it, skipping most of the
+ * inverse DCT work, it ends up between max_size and twice as large on its longest side. */
+static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo,
+                                   int flags,
+                                   int max_size,
+                                   size_t *r_width,
+                                   size_t *r_height)
 {
   JSAMPARRAY row_pointer;
   JSAMPLE *buffer = NULL;
@@ -276,16 +286,33 @@ static ImBuf *ibJpegImageFromCinfo(struct jpeg_decompress_struct *cinfo, int fla
   jpeg_save_markers(cinfo, JPEG_COM, 0xffff);
 
   if (jpeg_read_header(cinfo, false) == JPEG_HEADER_OK) {
-    x = cinfo->image_width;
-    y = cinfo->image_height;
     depth = cinfo->num_components;
 
+    if (r_width) {
+      *r_width = cinfo->image_width;
+      *r_height = cinfo->image_height;
+    }
+
     if (cinfo->jpeg_color_space == JCS_YCCK) {
       cinfo->out_color_space = JCS_CMYK;
     }
 
+    if (max_size > 0) {
+      const int size = (int)MAX2(cinfo->image_width, cinfo->image_height);
+      cinfo->scale_num = 1;
+      cinfo->scale_denom = 1;
+      while (cinfo->scale_denom < 8 && size / (int)(cinfo->scale_denom * 2) >= max_size) {
+        cinfo->scale_denom *= 2;
+      }
+      cinfo->dct_method = JDCT_IFAST;
+      cinfo->do_fancy_upsampling = false;
+    }
+
     jpeg_start_decompress(cinfo);
 
+    x = cinfo->output_width;
+    y = cinfo->output_height;
+
     if (flags & IB_test) {
       jpeg_abort_decompress(cinfo);
       ibuf = IMB_allocImBuf(x, y, 8 * depth, 0);
@@ -450,11 +477,52 @@ ImBuf *imb_load_jpeg(const unsigned char *buffer,
   jpeg_create_decompress(cinfo);
   memory_source(cinfo, buffer, size);
 
-  ibuf = ibJpegImageFromCinfo(cinfo, flags);
+  ibuf = ibJpegImageFromCinfo(cinfo, flags, 0, NULL, NULL);
 
   return (ibuf);
 }
 
+ImBuf *imb_thumbnail_jpeg(const char *name,
+                          int flags,
+                          size_t max_thumb_size,
+                          char colorspace[IM_MAX_SPACE],
+                          size_t *r_width,
+                          size_t *r_height)
+{
+  struct jpeg_decompress_struct _cinfo, *cinfo = &_cinfo;
+  struct my_error_mgr jerr;
+  FILE *infile;
+  ImBuf *ibuf;
+
+  if ((infile = BLI_fopen(name, "rb")) == NULL) {
+    return NULL;
+  }
+
+  colorspace_set_default_role(colorspace, IM_MAX_SPACE, COLOR_ROLE_DEFAULT_BYTE);
+
+  cinfo->err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = jpeg_error;
+
+  /* Establish the setjmp return context for my_error_exit to use. */
+  if (setjmp(jerr.setjmp_buffer)) {
+    jpeg_destroy_decompress(cinfo);
+    fclose(infile);
+    return NULL;
+  }
+
+  jpeg_create_decompress(cinfo);
+  jpeg_stdio_src(cinfo, infile);
+
+  ibuf = ibJpegImageFromCinfo(cinfo, flags, (int)max_thumb_size, r_width, r_height);
+  if (ibuf == NULL) {
+    jpeg_destroy_decompress(cinfo);
+  }
+
+  fclose(infile);
+
+  return ibuf;
+}
+
 static void write_jpeg(struct jpeg_compress_struct *cinfo, struct ImBuf *ibuf)
 {
   JSAMPLE *buffer = NULL;
@@ -33,11 +33,13 @@ void IMB_init(void)
   imb_mmap_lock_init();
   imb_filetypes_init();
   imb_tile_cache_init();
+  imb_load_async_init();
   colormanagement_init();
 }
 
 void IMB_exit(void)
 {
+  imb_load_async_exit();
   imb_tile_cache_exit();
   imb_filetypes_exit();
   colormanagement_exit();
@@ -51,6 +51,9 @@
 #endif
 
 static MEM_CacheLimiterC *limitor = NULL;
+/* Separate limiter for the tiles of images, which have their own memory budget. */
+static MEM_CacheLimiterC *image_limitor = NULL;
+static size_t image_limitor_maximum = 0;
 static pthread_mutex_t limitor_lock = BLI_MUTEX_INITIALIZER;
 
 typedef struct MovieCache {
@@ -74,7 +77,7 @@ typedef struct MovieCache {
   void *last_userkey;
 
   int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
-  int pad;
+  bool use_image_budget;
 } MovieCache;
 
 typedef struct MovieCacheKey {
@@ -245,19 +248,70 @@ static bool get_item_destroyable(void *item_v)
   return true;
 }
 
+static bool get_image_item_destroyable(void *item_v)
+{
+  MovieCacheItem *item = (MovieCacheItem *)item_v;
+  /* Only free tiles nobody else is using, freeing a tile which is still referenced would only
+   * drop it from the cache without giving back any memory. */
+  return get_item_destroyable(item_v) && item->ibuf->refcounter == 0;
+}
+
 void IMB_moviecache_init(void)
 {
   limitor = new_MEM_CacheLimiter(IMB_moviecache_destructor, get_item_size);
 
   MEM_CacheLimiter_ItemPriority_Func_set(limitor, get_item_priority);
   MEM_CacheLimiter_ItemDestroyable_Func_set(limitor, get_item_destroyable);
+
+  image_limitor = new_MEM_CacheLimiter(IMB_moviecache_destructor, get_item_size);
+
+  MEM_CacheLimiter_ItemDestroyable_Func_set(image_limitor, get_image_item_destroyable);
+  MEM_CacheLimiter_set_cache_maximum(image_limitor, image_limitor_maximum);
 }
 
 void IMB_moviecache_destruct(void)
 {
   if (limitor) {
     delete_MEM_CacheLimiter(limitor);
+    delete_MEM_CacheLimiter(image_limitor);
+    limitor = NULL;
+    image_limitor = NULL;
+  }
+}
+
+void IMB_moviecache_use_image_budget(MovieCache *cache)
+{
+  BLI_assert(BLI_ghash_len(cache->hash) == 0);
+  cache->use_image_budget = true;
+}
+
+void IMB_moviecache_set_image_budget(size_t maximum)
+{
+  BLI_mutex_lock(&limitor_lock);
+  image_limitor_maximum = maximum;
+  if (image_limitor) {
+    MEM_CacheLimiter_set_cache_maximum(image_limitor, maximum);
+    MEM_CacheLimiter_enforce_limits(image_limitor);
   }
+  BLI_mutex_unlock(&limitor_lock);
+}
+
+size_t IMB_moviecache_get_image_budget_in_use(void)
+{
+  size_t mem_in_use = 0;
+
+  BLI_mutex_lock(&limitor_lock);
+  if (image_limitor) {
+    mem_in_use = MEM_CacheLimiter_get_memory_in_use(image_limitor);
+  }
+  BLI_mutex_unlock(&limitor_lock);
+
+  return mem_in_use;
+}
+
+static MEM_CacheLimiterC *moviecache_limitor(MovieCache *cache)
+{
+  return cache->use_image_budget ? image_limitor : limitor;
 }
 
 MovieCache *IMB_moviecache_create(const char *name,
@@ -343,10 +397,10 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
     BLI_mutex_lock(&limitor_lock);
   }
 
-  item->c_handle = MEM_CacheLimiter_insert(limitor, item);
+  item->c_handle = MEM_CacheLimiter_insert(moviecache_limitor(cache), item);
 
   MEM_CacheLimiter_ref(item->c_handle);
-  MEM_CacheLimiter_enforce_limits(limitor);
+  MEM_CacheLimiter_enforce_limits(moviecache_limitor(cache));
   MEM_CacheLimiter_unref(item->c_handle);
 
   if (need_lock) {
@@ -56,6 +56,9 @@
 #include <ImfTiledOutputPart.h>
 #include <ImfPartType.h>
 #include <ImfPartHelper.h>
+#include <ImfRgbaFile.h>
+#include <ImfThreading.h>
+#include <ImfTiledRgbaFile.h>
 
 #include "DNA_scene_types.h" /* For OpenEXR compression constants */
 
@@ -78,6 +81,7 @@ _CRTIMP void __cdecl _invalid_parameter_noinfo(void)
 
 #include "BLI_blenlib.h"
 #include "BLI_math_color.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_idprop.h"
@@ -99,6 +103,24 @@ extern "C" {
 using namespace Imf;
 using namespace Imath;
 
+static ThreadMutex exr_thread_count_lock = BLI_MUTEX_INITIALIZER;
+
+/* Number of threads OpenEXR decodes and encodes blocks of lines or tiles with. The global pool
+ * is created on startup, keep it in sync with the number of threads Blender uses, which can be
+ * overridden from the command line afterwards. */
+static int exr_thread_count(void)
+{
+  const int num_threads = BLI_system_thread_count();
+
+  BLI_mutex_lock(&exr_thread_count_lock);
+  if (globalThreadCount() != num_threads) {
+    setGlobalThreadCount(num_threads);
+  }
+  BLI_mutex_unlock(&exr_thread_count_lock);
+
+  return num_threads;
+}
+
 extern "C" {
 /* prototype */
 static struct ExrPass *imb_exr_get_pass(ListBase *lb, char *passname);
@@ -443,7 +465,7 @@ static bool imb_save_openexr_half(ImBuf *ibuf, const char *name, const int flags
     else {
       file_stream = new OFileStream(name);
     }
-    OutputFile file(*file_stream, header);
+    OutputFile file(*file_stream, header, exr_thread_count());
 
     /* we store first everything in half array */
     std::vector<RGBAZ> pixels(height * width);
@@ -549,7 +571,7 @@ static bool imb_save_openexr_float(ImBuf *ibuf, const char *name, const int flag
     else {
       file_stream = new OFileStream(name);
     }
-    OutputFile file(*file_stream, header);
+    OutputFile file(*file_stream, header, exr_thread_count());
 
     int xstride = sizeof(float) * channels;
     int ystride = -xstride * width;
@@ -881,7 +903,7 @@ int IMB_exr_begin_write(void *handle,
   /* manually create ofstream, so we can handle utf-8 filepaths on windows */
   try {
     data->ofile_stream = new OFileStream(filename);
-    data->ofile = new OutputFile(*(data->ofile_stream), header);
+    data->ofile = new OutputFile(*(data->ofile_stream), header, exr_thread_count());
   }
   catch (const std::exception &exc) {
     std::cerr << "IMB_exr_begin_write: ERROR: " << exc.what() << std::endl;
@@ -952,7 +974,8 @@ void IMB_exrtile_begin_write(
   /* manually create ofstream, so we can handle utf-8 filepaths on windows */
   try {
     data->ofile_stream = new OFileStream(filename);
-    data->mpofile = new MultiPartOutputFile(*(data->ofile_stream), &headers[0], headers.size());
+    data->mpofile = new MultiPartOutputFile(
+        *(data->ofile_stream), &headers[0], headers.size(), false, exr_thread_count());
   }
   catch (const std::exception &) {
     delete data->mpofile;
@@ -974,7 +997,7 @@ int IMB_exr_begin_read(void *handle, const char *filename, int *width, int *heig
     /* avoid crash/abort when we don't have permission to write here */
     try {
       data->ifile_stream = new IFileStream(filename);
-      data->ifile = new MultiPartInputFile(*(data->ifile_stream));
+      data->ifile = new MultiPartInputFile(*(data->ifile_stream), exr_thread_count());
     }
     catch (const std::exception &) {
       delete data->ifile;
@@ -1096,6 +1119,26 @@ void IMB_exr_clear_channels(void *handle)
   BLI_freelistN(&data->channels);
 }
 
+typedef struct ExrHalfConvertData {
+  const float *rect;
+  half *rect_half;
+  int xstride;
+  int width;
+} ExrHalfConvertData;
+
+static void exr_half_convert_line(void *__restrict userdata,
+                                  const int y,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ExrHalfConvertData *convert_data = (ExrHalfConvertData *)userdata;
+  const size_t offset = (size_t)y * convert_data->width;
+  const float *rect = convert_data->rect + offset * convert_data->xstride;
+  half *cur = convert_data->rect_half + offset;
+  for (int x = 0; x < convert_data->width; x++, cur++, rect += convert_data->xstride) {
+    *cur = *rect;
+  }
+}
+
 void IMB_exr_write_channels(void *handle)
 {
   ExrHandle *data = (ExrHandle *)handle;
@@ -1116,11 +1159,16 @@ void IMB_exr_write_channels(void *handle)
     for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
       /* Writing starts from last scanline, stride negative. */
       if (echan->use_half_float) {
-        float *rect = echan->rect;
-        half *cur = current_rect_half;
-        for (size_t i = 0; i < num_pixels; i++, cur++) {
-          *cur = rect[i * echan->xstride];
-        }
+        ExrHalfConvertData convert_data;
+        convert_data.rect = echan->rect;
+        convert_data.rect_half = current_rect_half;
+        convert_data.xstride = echan->xstride;
+        convert_data.width = data->width;
+
+        TaskParallelSettings settings;
+        BLI_parallel_range_settings_defaults(&settings);
+        settings.min_iter_per_thread = 64;
+        BLI_task_parallel_range(0, data->height, &convert_data, exr_half_convert_line, &settings);
         half *rect_to_write = current_rect_half + (data->height - 1L) * data->width;
         frameBuffer.insert(
             echan->name,
@@ -1207,6 +1255,53 @@ void IMB_exrtile_write_channels(
   }
 }
 
+static void exr_read_part(ExrHandle *data, const int part, const short flip)
+{
+  try {
+    /* Read part header. */
+    InputPart in(*data->ifile, part);
+    Header header = in.header();
+    Box2i dw = header.dataWindow();
+
+    /* Insert all matching channel into framebuffer. */
+    FrameBuffer frameBuffer;
+    ExrChannel *echan;
+
+    for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
+      if (echan->m->part_number != part || echan->rect == NULL) {
+        continue;
+      }
+
+      float *rect = echan->rect;
+      size_t xstride = echan->xstride * sizeof(float);
+      size_t ystride = echan->ystride * sizeof(float);
+
+      if (!flip) {
+        /* Inverse correct first pixel for data-window coordinates. */
+        rect -= echan->xstride * (dw.min.x - dw.min.y * data->width);
+        /* move to last scanline to flip to Blender convention */
+        rect += echan->xstride * (data->height - 1) * data->width;
+        ystride = -ystride;
+      }
+      else {
+        /* Inverse correct first pixel for data-window coordinates. */
+        rect -= echan->xstride * (dw.min.x + dw.min.y * data->width);
+      }
+
+      frameBuffer.insert(echan->m->internal_name,
+                         Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+    }
+
+    /* Read pixels. */
+    in.setFrameBuffer(frameBuffer);
+    exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", part, dw.min.y, dw.max.y);
+    in.readPixels(dw.min.y, dw.max.y);
+  }
+  catch (const std::exception &exc) {
+    std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
+  }
+}
+
 void IMB_exr_read_channels(void *handle)
 {
   ExrHandle *data = (ExrHandle *)handle;
@@ -1227,61 +1322,23 @@ void IMB_exr_read_channels(void *handle)
       "name",
       "internal_name");
 
-  for (int i = 0; i < numparts; i++) {
-    /* Read part header. */
-    InputPart in(*data->ifile, i);
-    Header header = in.header();
-    Box2i dw = header.dataWindow();
-
-    /* Insert all matching channel into framebuffer. */
-    FrameBuffer frameBuffer;
-    ExrChannel *echan;
-
-    for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
-      if (echan->m->part_number != i) {
-        continue;
-      }
-
-      exr_printf("%d %-6s %-22s \"%s\"\n",
-                 echan->m->part_number,
-                 echan->m->view.c_str(),
-                 echan->m->name.c_str(),
-                 echan->m->internal_name.c_str());
-
-      if (echan->rect) {
-        float *rect = echan->rect;
-        size_t xstride = echan->xstride * sizeof(float);
-        size_t ystride = echan->ystride * sizeof(float);
-
-        if (!flip) {
-          /* Inverse correct first pixel for data-window coordinates. */
-          rect -= echan->xstride * (dw.min.x - dw.min.y * data->width);
-          /* move to last scanline to flip to Blender convention */
-          rect += echan->xstride * (data->height - 1) * data->width;
-          ystride = -ystride;
-        }
-        else {
-          /* Inverse correct first pixel for data-window coordinates. */
-          rect -= echan->xstride * (dw.min.x + dw.min.y * data->width);
-        }
-
-        frameBuffer.insert(echan->m->internal_name,
-                           Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
-      }
-      else {
-        printf("warning, channel with no rect set %s\n", echan->m->internal_name.c_str());
-      }
-    }
+  /* Only channels with a rect are decoded, parts without any of them are not read at all. */
+  std::vector<bool> part_used(numparts, false);
+  for (ExrChannel *echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
+    exr_printf("%d %-6s %-22s \"%s\"\n",
+               echan->m->part_number,
+               echan->m->view.c_str(),
+               echan->m->name.c_str(),
+               echan->m->internal_name.c_str());
 
-    /* Read pixels. */
-    try {
-      in.setFrameBuffer(frameBuffer);
-      exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, dw.min.y, dw.max.y);
-      in.readPixels(dw.min.y, dw.max.y);
+    if (echan->rect && echan->m->part_number >= 0 && echan->m->part_number < numparts) {
+      part_used[echan->m->part_number] = true;
     }
-    catch (const std::exception &exc) {
-      std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
-      break;
+  }
+  /* Lines or tiles of every part are decoded by the OpenEXR thread pool. */
+  for (int i = 0; i < numparts; i++) {
+    if (part_used[i]) {
+      exr_read_part(data, i, flip);
     }
   }
 }
@@ -1898,7 +1955,7 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem,
     bool is_multi;
 
     membuf = new IMemStream((unsigned char *)mem, size);
-    file = new MultiPartInputFile(*membuf);
+    file = new MultiPartInputFile(*membuf, exr_thread_count());
 
     Box2i dw = file->header(0).dataWindow();
     const int width = dw.max.x - dw.min.x + 1;
@@ -2073,6 +2130,156 @@ struct ImBuf *imb_load_openexr(const unsigned char *mem,
   }
 }
 
+/* Read the smallest level of a mipmapped file which is still at least max_thumb_size pixels on
+ * its longest side, ripmaps use their levels with the same reduction on both axes. */
+static ImBuf *exr_thumbnail_from_levels(TiledRgbaInputFile &file, const size_t max_thumb_size)
+{
+  const int num_levels = (file.levelMode() == MIPMAP_LEVELS) ?
+                             file.numLevels() :
+                             std::min(file.numXLevels(), file.numYLevels());
+  int level = 0;
+  while (level + 1 < num_levels &&
+         (size_t)std::max(file.levelWidth(level + 1), file.levelHeight(level + 1)) >=
+             max_thumb_size) {
+    level++;
+  }
+
+  const Box2i dw = file.dataWindowForLevel(level, level);
+  const int width = dw.max.x - dw.min.x + 1;
+  const int height = dw.max.y - dw.min.y + 1;
+
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
+  if (ibuf == NULL) {
+    return NULL;
+  }
+
+  Array2D<Rgba> pixels(height, width);
+  file.setFrameBuffer(&pixels[0][0] - dw.min.x - dw.min.y * width, 1, width);
+  file.readTiles(0, file.numXTiles(level) - 1, 0, file.numYTiles(level) - 1, level, level);
+
+  for (int y = 0; y < height; y++) {
+    const Rgba *pixel = pixels[height - 1 - y];
+    float *rect = ibuf->rect_float + (size_t)4 * y * width;
+    for (int x = 0; x < width; x++, pixel++, rect += 4) {
+      rect[0] = pixel->r;
+      rect[1] = pixel->g;
+      rect[2] = pixel->b;
+      rect[3] = pixel->a;
+    }
+  }
+
+  return ibuf;
+}
+
+/* Read every n-th scanline and pixel only, scanlines in between are not decompressed unless
+ * they share a compressed block with a scanline that is read. */
+static ImBuf *exr_thumbnail_from_scanlines(RgbaInputFile &file, const size_t max_thumb_size)
+{
+  const Box2i dw = file.dataWindow();
+  const int width = dw.max.x - dw.min.x + 1;
+  const int height = dw.max.y - dw.min.y + 1;
+  const int step = std::max(1, std::max(width, height) / (int)max_thumb_size);
+  const int thumb_width = (width + step - 1) / step;
+  const int thumb_height = (height + step - 1) / step;
+
+  ImBuf *ibuf = IMB_allocImBuf(thumb_width, thumb_height, 32, IB_rectfloat);
+  if (ibuf == NULL) {
+    return NULL;
+  }
+
+  /* A zero y stride makes every scanline land in the same row. */
+  Array<Rgba> row(width);
+  file.setFrameBuffer(&row[0] - dw.min.x, 1, 0);
+
+  for (int y = 0; y < thumb_height; y++) {
+    file.readPixels(dw.min.y + y * step);
+
+    float *rect = ibuf->rect_float + (size_t)4 * (thumb_height - 1 - y) * thumb_width;
+    for (int x = 0; x < thumb_width; x++, rect += 4) {
+      const Rgba &pixel = row[x * step];
+      rect[0] = pixel.r;
+      rect[1] = pixel.g;
+      rect[2] = pixel.b;
+      rect[3] = pixel.a;
+    }
+  }
+
+  return ibuf;
+}
+
+struct ImBuf *imb_load_filepath_thumbnail_openexr(const char *filepath,
+                                                  const int flags,
+                                                  const size_t max_thumb_size,
+                                                  char colorspace[IM_MAX_SPACE],
+                                                  size_t *r_width,
+                                                  size_t *r_height)
+{
+  struct ImBuf *ibuf = NULL;
+  IStream *stream = NULL;
+  RgbaInputFile *file = NULL;
+  TiledRgbaInputFile *tiled_file = NULL;
+
+  colorspace_set_default_role(colorspace, IM_MAX_SPACE, COLOR_ROLE_DEFAULT_FLOAT);
+
+  try {
+    stream = new IFileStream(filepath);
+    file = new RgbaInputFile(*stream, exr_thread_count());
+
+    const RgbaChannels channels = file->channels();
+
+    /* Multilayer files without a combined layer, these fail to load as a single image too. */
+    if ((channels & (WRITE_R | WRITE_G | WRITE_B | WRITE_Y)) == 0) {
+      delete file;
+      delete stream;
+      return NULL;
+    }
+
+    const Box2i dw = file->dataWindow();
+    *r_width = dw.max.x - dw.min.x + 1;
+    *r_height = dw.max.y - dw.min.y + 1;
+
+    const Header &header = file->header();
+    if (header.hasTileDescription() && header.tileDescription().mode != ONE_LEVEL) {
+      delete file;
+      file = NULL;
+      delete stream;
+      stream = NULL;
+
+      stream = new IFileStream(filepath);
+      tiled_file = new TiledRgbaInputFile(*stream, exr_thread_count());
+      ibuf = exr_thumbnail_from_levels(*tiled_file, max_thumb_size);
+    }
+    else {
+      ibuf = exr_thumbnail_from_scanlines(*file, max_thumb_size);
+    }
+
+    if (ibuf) {
+      ibuf->planes = (channels & WRITE_A) ? 32 : 24;
+      ibuf->ftype = IMB_FTYPE_OPENEXR;
+      if (flags & IB_alphamode_detect) {
+        ibuf->flags |= IB_alphamode_premul;
+      }
+    }
+
+    delete tiled_file;
+    delete file;
+    delete stream;
+
+    return ibuf;
+  }
+  catch (const std::exception &exc) {
+    std::cerr << exc.what() << std::endl;
+    if (ibuf) {
+      IMB_freeImBuf(ibuf);
+    }
+    delete tiled_file;
+    delete file;
+    delete stream;
+
+    return NULL;
+  }
+}
+
 void imb_initopenexr(void)
 {
   int num_threads = BLI_system_thread_count();
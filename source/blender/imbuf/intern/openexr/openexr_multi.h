@@ -72,6 +72,8 @@ float *IMB_exr_channel_rect(void *handle,
                             const char *passname,
                             const char *view);
 
+/* Only channels given a rect are decoded, so passing the rects of the passes that are used
+ * after IMB_exr_begin_read() skips reading the rest of the file. */
 void IMB_exr_read_channels(void *handle);
 void IMB_exr_write_channels(void *handle);
 void IMB_exrtile_write_channels(
@@ -252,6 +252,43 @@ ImBuf *IMB_loadiffname(const char *filepath, int flags, char colorspace[IM_MAX_S
   return ibuf;
 }
 
+ImBuf *IMB_thumb_load_image(const char *filepath,
+                            size_t max_thumb_size,
+                            char colorspace[IM_MAX_SPACE],
+                            size_t *r_width,
+                            size_t *r_height)
+{
+  const int ftype = IMB_ispic_type(filepath);
+  const int flags = IB_rect | IB_metadata;
+  const ImFileType *type;
+  ImBuf *ibuf = NULL;
+
+  for (type = IMB_FILE_TYPES; type < IMB_FILE_TYPES_LAST; type++) {
+    if (type->filetype == ftype && type->load_filepath_thumbnail) {
+      char effective_colorspace[IM_MAX_SPACE] = "";
+      if (colorspace) {
+        BLI_strncpy(effective_colorspace, colorspace, sizeof(effective_colorspace));
+      }
+
+      ibuf = type->load_filepath_thumbnail(
+          filepath, flags, max_thumb_size, effective_colorspace, r_width, r_height);
+      if (ibuf) {
+        imb_handle_alpha(ibuf, flags, colorspace, effective_colorspace);
+        return ibuf;
+      }
+      break;
+    }
+  }
+
+  /* Formats without a reduced resolution path are loaded fully. */
+  ibuf = IMB_loadiffname(filepath, flags, colorspace);
+  if (ibuf) {
+    *r_width = ibuf->x;
+    *r_height = ibuf->y;
+  }
+  return ibuf;
+}
+
 ImBuf *IMB_testiffname(const char *filepath, int flags)
 {
   ImBuf *ibuf;
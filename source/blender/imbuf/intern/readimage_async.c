@@ -0,0 +1,310 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup imbuf
+ *
+ * Loading of images in the background, for players of image sequences to request the frames
+ * they are going to show next. Requests are decoded by the task scheduler and identified by
+ * their file path, flags and color space, acquiring a requested image takes its result or
+ * waits for it to finish decoding. Results nobody acquired yet are kept in a movie cache, so
+ * they count against the memory cache limit.
+ */
+
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+
+#include "BLI_ghash.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+#include "IMB_moviecache.h"
+
+#include "IMB_filetype.h"
+
+/* Decoded images of 4K float sequences take more than 100MB, keep the number of requests small. */
+#define IMB_LOAD_ASYNC_MAX_REQUESTS 8
+
+typedef struct ImBufLoadKey {
+  char filepath[FILE_MAX];
+  int flags;
+  /** Color space given with the request. */
+  char colorspace[IM_MAX_SPACE];
+} ImBufLoadKey;
+
+typedef struct ImBufLoadRequest {
+  struct ImBufLoadRequest *next, *prev;
+
+  ImBufLoadKey key;
+  /** Color space the image was loaded with. */
+  char colorspace[IM_MAX_SPACE];
+
+  bool is_running;
+  bool is_done;
+} ImBufLoadRequest;
+
+static struct {
+  TaskPool *pool;
+  /** Images of done requests, until they are acquired or freed by the cache limiter. */
+  struct MovieCache *results;
+  /** Requests which are waiting, being decoded or done, oldest first. */
+  ListBase requests;
+  int num_requests;
+  /** Requests which were canceled while being decoded, freed by their task. */
+  ListBase canceled;
+  ThreadMutex mutex;
+  ThreadCondition done_cond;
+} imb_load_async = {NULL};
+
+void imb_load_async_init(void)
+{
+  BLI_mutex_init(&imb_load_async.mutex);
+  BLI_condition_init(&imb_load_async.done_cond);
+}
+
+static void load_async_pool_ensure(void)
+{
+  if (imb_load_async.pool == NULL) {
+    imb_load_async.pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), NULL);
+  }
+}
+
+void IMB_load_async_ensure_threads(void)
+{
+  BLI_mutex_lock(&imb_load_async.mutex);
+  load_async_pool_ensure();
+  BLI_mutex_unlock(&imb_load_async.mutex);
+}
+
+static unsigned int load_async_key_hash(const void *key_v)
+{
+  const ImBufLoadKey *key = key_v;
+  return BLI_ghashutil_strhash_p(key->filepath) ^ BLI_ghashutil_strhash_p(key->colorspace) ^
+         BLI_ghashutil_inthash(key->flags);
+}
+
+static bool load_async_key_cmp(const void *a_v, const void *b_v)
+{
+  const ImBufLoadKey *a = a_v;
+  const ImBufLoadKey *b = b_v;
+  /* Same convention as GHash comparators, false means equal. */
+  return !(a->flags == b->flags && STREQ(a->filepath, b->filepath) &&
+           STREQ(a->colorspace, b->colorspace));
+}
+
+static void load_async_key_init(ImBufLoadKey *key,
+                                const char *filepath,
+                                int flags,
+                                const char *colorspace)
+{
+  memset(key, 0, sizeof(*key));
+  BLI_strncpy(key->filepath, filepath, sizeof(key->filepath));
+  key->flags = flags;
+  if (colorspace) {
+    BLI_strncpy(key->colorspace, colorspace, sizeof(key->colorspace));
+  }
+}
+
+static void load_async_request_free(ImBufLoadRequest *request)
+{
+  if (request->is_done && imb_load_async.results) {
+    IMB_moviecache_remove(imb_load_async.results, &request->key);
+  }
+  MEM_freeN(request);
+}
+
+static ImBufLoadRequest *load_async_request_find(const ImBufLoadKey *key)
+{
+  LISTBASE_FOREACH (ImBufLoadRequest *, request, &imb_load_async.requests) {
+    if (!load_async_key_cmp(&request->key, key)) {
+      return request;
+    }
+  }
+  return NULL;
+}
+
+static void load_async_request_remove(ImBufLoadRequest *request)
+{
+  BLI_remlink(&imb_load_async.requests, request);
+  imb_load_async.num_requests--;
+}
+
+/* Make room for a new request, results nobody acquired are the oldest prefetched frames and
+ * are dropped first. */
+static bool load_async_ensure_room(void)
+{
+  ImBufLoadRequest *request = imb_load_async.requests.first;
+  while (imb_load_async.num_requests >= IMB_LOAD_ASYNC_MAX_REQUESTS && request) {
+    ImBufLoadRequest *next = request->next;
+    if (request->is_done) {
+      load_async_request_remove(request);
+      load_async_request_free(request);
+    }
+    request = next;
+  }
+  return imb_load_async.num_requests < IMB_LOAD_ASYNC_MAX_REQUESTS;
+}
+
+static void load_async_task(TaskPool *__restrict UNUSED(pool),
+                            void *taskdata,
+                            int UNUSED(threadid))
+{
+  ImBufLoadRequest *request = (ImBufLoadRequest *)taskdata;
+
+  BLI_mutex_lock(&imb_load_async.mutex);
+  /* Acquired or canceled before it got to run, the request is freed. */
+  if (BLI_findindex(&imb_load_async.requests, request) == -1 || request->is_running) {
+    BLI_mutex_unlock(&imb_load_async.mutex);
+    return;
+  }
+  request->is_running = true;
+  BLI_mutex_unlock(&imb_load_async.mutex);
+
+  ImBuf *ibuf = IMB_loadiffname(request->key.filepath, request->key.flags, request->colorspace);
+
+  BLI_mutex_lock(&imb_load_async.mutex);
+  request->is_done = true;
+  if (BLI_findindex(&imb_load_async.canceled, request) != -1) {
+    BLI_remlink(&imb_load_async.canceled, request);
+    MEM_freeN(request);
+  }
+  else if (ibuf) {
+    /* Without room in the cache, acquiring the image will load it again. */
+    IMB_moviecache_put_if_possible(imb_load_async.results, &request->key, ibuf);
+  }
+  if (ibuf) {
+    IMB_freeImBuf(ibuf);
+  }
+  BLI_condition_notify_all(&imb_load_async.done_cond);
+  BLI_mutex_unlock(&imb_load_async.mutex);
+}
+
+bool IMB_load_async_request(const char *filepath, int flags, const char *colorspace)
+{
+  bool requested = false;
+  ImBufLoadKey key;
+  load_async_key_init(&key, filepath, flags, colorspace);
+
+  BLI_mutex_lock(&imb_load_async.mutex);
+
+  if (load_async_request_find(&key)) {
+    requested = true;
+  }
+  else if (load_async_ensure_room()) {
+    ImBufLoadRequest *request = MEM_callocN(sizeof(ImBufLoadRequest), __func__);
+    request->key = key;
+    BLI_strncpy(request->colorspace, key.colorspace, sizeof(request->colorspace));
+
+    BLI_addtail(&imb_load_async.requests, request);
+    imb_load_async.num_requests++;
+
+    if (imb_load_async.results == NULL) {
+      imb_load_async.results = IMB_moviecache_create(
+          "load async", sizeof(ImBufLoadKey), load_async_key_hash, load_async_key_cmp);
+    }
+    load_async_pool_ensure();
+    BLI_task_pool_push(imb_load_async.pool, load_async_task, request, false, TASK_PRIORITY_LOW);
+    requested = true;
+  }
+
+  BLI_mutex_unlock(&imb_load_async.mutex);
+  return requested;
+}
+
+ImBuf *IMB_load_async_acquire(const char *filepath, int flags, char colorspace[IM_MAX_SPACE])
+{
+  ImBufLoadKey key;
+  load_async_key_init(&key, filepath, flags, colorspace);
+
+  BLI_mutex_lock(&imb_load_async.mutex);
+
+  ImBufLoadRequest *request = load_async_request_find(&key);
+  while (request && request->is_running && !request->is_done) {
+    BLI_condition_wait(&imb_load_async.done_cond, &imb_load_async.mutex);
+    /* Another thread may have acquired it meanwhile. */
+    request = load_async_request_find(&key);
+  }
+
+  ImBuf *ibuf = NULL;
+  if (request) {
+    if (request->is_done) {
+      /* NULL when it failed to load or was freed by the cache limiter. */
+      ibuf = IMB_moviecache_get(imb_load_async.results, &key);
+      if (ibuf && colorspace) {
+        BLI_strncpy(colorspace, request->colorspace, IM_MAX_SPACE);
+      }
+    }
+    load_async_request_remove(request);
+    load_async_request_free(request);
+  }
+
+  BLI_mutex_unlock(&imb_load_async.mutex);
+
+  if (ibuf == NULL) {
+    /* Not requested, or still waiting for a thread, decoding it here is faster. */
+    ibuf = IMB_loadiffname(filepath, flags, colorspace);
+  }
+
+  return ibuf;
+}
+
+void IMB_load_async_cancel_all(void)
+{
+  BLI_mutex_lock(&imb_load_async.mutex);
+  ImBufLoadRequest *request = imb_load_async.requests.first;
+  while (request) {
+    ImBufLoadRequest *next = request->next;
+    load_async_request_remove(request);
+    if (request->is_running && !request->is_done) {
+      BLI_addtail(&imb_load_async.canceled, request);
+    }
+    else {
+      /* Tasks of requests which did not run yet find them removed and return. */
+      load_async_request_free(request);
+    }
+    request = next;
+  }
+  BLI_mutex_unlock(&imb_load_async.mutex);
+}
+
+void imb_load_async_exit(void)
+{
+  IMB_load_async_cancel_all();
+
+  if (imb_load_async.pool) {
+    /* Waits for the running tasks, which free the canceled requests. */
+    BLI_task_pool_cancel(imb_load_async.pool);
+    BLI_task_pool_free(imb_load_async.pool);
+    imb_load_async.pool = NULL;
+  }
+  BLI_assert(BLI_listbase_is_empty(&imb_load_async.canceled));
+
+  if (imb_load_async.results) {
+    IMB_moviecache_free(imb_load_async.results);
+    imb_load_async.results = NULL;
+  }
+
+  BLI_condition_end(&imb_load_async.done_cond);
+  BLI_mutex_end(&imb_load_async.mutex);
+}
@@ -425,6 +425,7 @@ static ImBuf *thumb_create_ex(const char *file_path,
   char cwidth[40] = "0"; /* in case images have no data */
   char cheight[40] = "0";
   short tsize = 128;
+  size_t image_width = 0, image_height = 0;
   short ex, ey;
   float scaledx, scaledy;
   BLI_stat_t info;
@@ -471,7 +472,7 @@ static ImBuf *thumb_create_ex(const char *file_path,
         if (img == NULL) {
           switch (source) {
             case THB_SOURCE_IMAGE:
-              img = IMB_loadiffname(file_path, IB_rect | IB_metadata, NULL);
+              img = IMB_thumb_load_image(file_path, tsize, NULL, &image_width, &image_height);
               break;
             case THB_SOURCE_BLEND:
               img = IMB_thumb_load_blend(file_path, blen_group, blen_id);
@@ -488,8 +489,13 @@ static ImBuf *thumb_create_ex(const char *file_path,
           if (BLI_stat(file_path, &info) != -1) {
             BLI_snprintf(mtime, sizeof(mtime), "%ld", (long int)info.st_mtime);
           }
-          BLI_snprintf(cwidth, sizeof(cwidth), "%d", img->x);
-          BLI_snprintf(cheight, sizeof(cheight), "%d", img->y);
+          if (image_width == 0) {
+            /* Given, or loaded at full size. */
+            image_width = img->x;
+            image_height = img->y;
+          }
+          BLI_snprintf(cwidth, sizeof(cwidth), "%d", (int)image_width);
+          BLI_snprintf(cheight, sizeof(cheight), "%d", (int)image_height);
         }
       }
       else if (THB_SOURCE_MOVIE == source) {
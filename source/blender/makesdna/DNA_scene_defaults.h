@@ -48,6 +48,7 @@
     .width = 512, \
     .height = 512, \
     .margin = 16, \
+    .tile_size = 1024, \
     .normal_space = R_BAKE_SPACE_TANGENT, \
     .normal_swizzle = {R_BAKE_POSX, R_BAKE_POSY, R_BAKE_POSZ}, \
   }
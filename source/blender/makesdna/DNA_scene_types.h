@@ -560,7 +560,9 @@ typedef struct BakeData {
   char normal_space;
 
   char save_mode;
-  char _pad[3];
+  char _pad[1];
+  /** Size of the tiles baked at once, with #R_BAKE_TILED. */
+  short tile_size;
 
   struct Object *cage_object;
 } BakeData;
@@ -1939,6 +1941,7 @@ enum {
 #define R_BAKE_CAGE (1 << 8)
 #define R_BAKE_SPLIT_MAT (1 << 9)
 #define R_BAKE_AUTO_NAME (1 << 10)
+#define R_BAKE_TILED (1 << 11)
 
 /* RenderData.bake_normal_space */
 #define R_BAKE_SPACE_CAMERA 0
@@ -682,6 +682,12 @@ enum {
   SEQ_CACHE_VIEW_FINAL_OUT = (1 << 9),
 
   SEQ_CACHE_PREFETCH_ENABLE = (1 << 10),
+  /* compress cached images of frames not being displayed */
+  SEQ_CACHE_COMPRESS = (1 << 11),
+  /* store final and preprocessed images on disk too, see #UserDef.sequencer_disk_cache_dir */
+  SEQ_CACHE_DISK_CACHE_ENABLE = (1 << 12),
+  /* scale cached images of strips by the time it took to render them */
+  SEQ_CACHE_VIEW_COST = (1 << 13),
 };
 
 #ifdef __cplusplus
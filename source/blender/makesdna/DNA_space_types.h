@@ -1010,6 +1010,7 @@ enum {
 /* FileDirEntry.flags */
 enum {
   FILE_ENTRY_INVALID_PREVIEW = 1 << 0, /* The preview for this entry could not be generated. */
+  FILE_ENTRY_PREVIEW_LOADING = 1 << 1, /* The preview for this entry is being generated. */
 };
 
 /** \} */
@@ -648,6 +648,8 @@ typedef struct UserDef {
   char image_editor[1024];
   /** 1024 = FILE_MAX. */
   char anim_player[1024];
+  /** 1024 = FILE_MAX. */
+  char sequencer_disk_cache_dir[1024];
   int anim_player_preset;
 
   /** Minimum spacing between gridlines in View2D grids. */
@@ -735,11 +737,15 @@ typedef struct UserDef {
   short vbotimeout, vbocollectrate;
   short textimeout, texcollectrate;
   int memcachelimit;
-  /** Unused. */
-  int prefetchframes;
+  /** Unused, older versions may have stored values here. */
+  int prefetchframes DNA_DEPRECATED;
   /** Control the rotation step of the view when PAD2, PAD4, PAD6&PAD8 is use. */
   float pad_rot_angle;
-  char _pad12[4];
+  /** Size limit of the sequencer disk cache in gigabytes. */
+  int sequencer_disk_cache_size_limit;
+  /** Memory budget of the UDIM tiles of images in megabytes. */
+  int image_cache_limit;
+  char _pad14[4];
   /** Rotating view icon size. */
   short rvisize;
   /** Rotating view icon brightness. */
@@ -925,7 +931,7 @@ typedef enum eUserPref_Flag {
   USER_FLAG_UNUSED_6 = (1 << 6), /* cleared */
   USER_FLAG_UNUSED_7 = (1 << 7), /* cleared */
   USER_MAT_ON_OB = (1 << 8),
-  USER_FLAG_UNUSED_9 = (1 << 9), /* cleared */
+  USER_MOVIE_DECODE_THREADS = (1 << 9),
   USER_DEVELOPER_UI = (1 << 10),
   USER_TOOLTIPS = (1 << 11),
   USER_TWOBUTTONMOUSE = (1 << 12),
@@ -91,6 +91,21 @@ static const EnumPropertyItem node_quality_items[] = {
     {0, NULL, 0, NULL, NULL},
 };
 
+static const EnumPropertyItem node_execution_mode_items[] = {
+    {NTREE_EXECUTION_MODE_TILED,
+     "TILED",
+     0,
+     "Tiled",
+     "Evaluate nodes per pixel, in tiles that are scheduled as soon as their input is available"},
+    {NTREE_EXECUTION_MODE_FULL_FRAME,
+     "FULL_FRAME",
+     0,
+     "Full Frame",
+     "Evaluate nodes one after another over the whole frame, keeping every intermediate "
+     "result in memory (faster for large images, uses more memory)"},
+    {0, NULL, 0, NULL, NULL},
+};
+
 static const EnumPropertyItem node_chunksize_items[] = {
     {NTREE_CHUNKSIZE_32, "32", 0, "32x32", "Chunksize of 32x32"},
     {NTREE_CHUNKSIZE_64, "64", 0, "64x64", "Chunksize of 64x64"},
@@ -9408,6 +9423,11 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
   RNA_def_property_enum_items(prop, node_quality_items);
   RNA_def_property_ui_text(prop, "Edit Quality", "Quality when editing");
 
+  prop = RNA_def_property(srna, "execution_mode", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, NULL, "execution_mode");
+  RNA_def_property_enum_items(prop, node_execution_mode_items);
+  RNA_def_property_ui_text(prop, "Execution Mode", "How the compositor evaluates the node tree");
+
   prop = RNA_def_property(srna, "chunk_size", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_sdna(prop, NULL, "chunksize");
   RNA_def_property_enum_items(prop, node_chunksize_items);
@@ -9416,6 +9436,16 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
                            "Max size of a tile (smaller values gives better distribution "
                            "of multiple threads, but more overhead)");
 
+  prop = RNA_def_property(srna, "cache_size", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "cache_size");
+  RNA_def_property_range(prop, 0, INT_MAX);
+  RNA_def_property_ui_range(prop, 0, 16384, 64, -1);
+  RNA_def_property_ui_text(prop,
+                           "Cache Size",
+                           "Memory in megabytes for results of expensive nodes kept between "
+                           "executions, to skip recalculating them when they did not change "
+                           "(0 disables the cache)");
+
   prop = RNA_def_property(srna, "use_opencl", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_OPENCL);
   RNA_def_property_ui_text(prop, "OpenCL", "Enable GPU calculations");
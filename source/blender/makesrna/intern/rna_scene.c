@@ -4830,6 +4830,20 @@ static void rna_def_bake_data(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Cage", "Cast rays to active object from a cage");
   RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
 
+  prop = RNA_def_property(srna, "use_tiles", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", R_BAKE_TILED);
+  RNA_def_property_ui_text(prop,
+                           "Tiles",
+                           "Bake the images in tiles, using less memory for large images and "
+                           "updating the images as each tile finishes");
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
+
+  prop = RNA_def_property(srna, "tile_size", PROP_INT, PROP_PIXEL);
+  RNA_def_property_range(prop, 64, 8192);
+  RNA_def_property_ui_range(prop, 256, 4096, 256, 0);
+  RNA_def_property_ui_text(prop, "Tile Size", "Dimension of the tiles baked at once");
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, NULL);
+
   /* custom passes flags */
   prop = RNA_def_property(srna, "use_pass_ambient_occlusion", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "pass_filter", R_BAKE_PASS_FILTER_AO);
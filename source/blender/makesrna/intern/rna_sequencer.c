@@ -1914,6 +1914,15 @@ static void rna_def_editor(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Composite Images", "Visualize cached composite images");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, NULL);
 
+  prop = RNA_def_property(srna, "show_cache_render_time", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_VIEW_COST);
+  RNA_def_property_ui_text(
+      prop,
+      "Render Time",
+      "Scale cached images of strips by the time it took to render them, full height is the "
+      "duration of a frame");
+  RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, NULL);
+
   prop = RNA_def_property(srna, "use_cache_raw", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_STORE_RAW);
   RNA_def_property_ui_text(prop,
@@ -1946,6 +1955,21 @@ static void rna_def_editor(BlenderRNA *brna)
                            "Render frames ahead of playhead in background for faster playback");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, NULL);
 
+  prop = RNA_def_property(srna, "use_cache_compression", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_COMPRESS);
+  RNA_def_property_ui_text(prop,
+                           "Compress Cache",
+                           "Compress cached images of frames not being displayed in background, "
+                           "to fit more frames into the cache limit");
+
+  prop = RNA_def_property(srna, "use_cache_disk", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "cache_flag", SEQ_CACHE_DISK_CACHE_ENABLE);
+  RNA_def_property_ui_text(prop,
+                           "Disk Cache",
+                           "Store final and preprocessed images on disk as well, to play them "
+                           "back without rendering after reopening the file (needs a disk cache "
+                           "directory in the preferences)");
+
   prop = RNA_def_property(srna, "recycle_max_cost", PROP_FLOAT, PROP_NONE);
   RNA_def_property_range(prop, 0.0f, SEQ_CACHE_COST_MAX);
   RNA_def_property_ui_range(prop, 0.0f, SEQ_CACHE_COST_MAX, 0.1f, 1);
@@ -195,6 +195,9 @@ static const EnumPropertyItem rna_enum_userdef_viewport_aa_items[] = {
 #  include "MEM_guardedalloc.h"
 #  include "MEM_CacheLimiterC-Api.h"
 
+#  include "IMB_imbuf.h"
+#  include "IMB_moviecache.h"
+
 #  include "UI_interface.h"
 
 #  ifdef WITH_OPENSUBDIV
@@ -536,6 +539,27 @@ static void rna_Userdef_memcache_update(Main *UNUSED(bmain),
   USERDEF_TAG_DIRTY;
 }
 
+static void rna_Userdef_image_cache_update(Main *UNUSED(bmain),
+                                           Scene *UNUSED(scene),
+                                           PointerRNA *UNUSED(ptr))
+{
+  IMB_moviecache_set_image_budget(((size_t)U.image_cache_limit) * 1024 * 1024);
+  USERDEF_TAG_DIRTY;
+}
+
+static int rna_Userdef_image_cache_memory_usage_get(PointerRNA *UNUSED(ptr))
+{
+  return (int)(IMB_moviecache_get_image_budget_in_use() / (1024 * 1024));
+}
+
+static void rna_Userdef_movie_decode_threads_update(Main *UNUSED(bmain),
+                                                    Scene *UNUSED(scene),
+                                                    PointerRNA *UNUSED(ptr))
+{
+  IMB_anim_set_threaded_decoding((U.flag & USER_MOVIE_DECODE_THREADS) != 0);
+  USERDEF_TAG_DIRTY;
+}
+
 static void rna_UserDef_weight_color_update(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
   Object *ob;
@@ -5152,6 +5176,37 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "image_cache_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "image_cache_limit");
+  RNA_def_property_range(prop, 1, max_memory_in_megabytes_int());
+  RNA_def_property_ui_text(prop,
+                           "Image Cache Limit",
+                           "Memory used by the UDIM tiles of images before the least recently "
+                           "used ones are freed (in megabytes)");
+  RNA_def_property_update(prop, 0, "rna_Userdef_image_cache_update");
+
+  prop = RNA_def_property(srna, "image_cache_memory_usage", PROP_INT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_Userdef_image_cache_memory_usage_get", NULL, NULL);
+  RNA_def_property_ui_text(prop,
+                           "Image Cache Memory Usage",
+                           "Memory used by the UDIM tiles of images in the cache (in megabytes)");
+
+  prop = RNA_def_property(srna, "sequencer_disk_cache_size_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "sequencer_disk_cache_size_limit");
+  RNA_def_property_range(prop, 1, INT_MAX);
+  RNA_def_property_ui_range(prop, 1, 10000, 10, -1);
+  RNA_def_property_ui_text(
+      prop, "Sequencer Disk Cache Limit", "Disk space used by the sequencer disk cache (in GB)");
+
+  prop = RNA_def_property(srna, "use_movie_decode_threads", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", USER_MOVIE_DECODE_THREADS);
+  RNA_def_property_ui_text(prop,
+                           "Threaded Movie Decoding",
+                           "Decode movies with multiple threads and decode frames ahead of "
+                           "playback in the background, for movies opened afterwards");
+  RNA_def_property_update(prop, 0, "rna_Userdef_movie_decode_threads_update");
+
   prop = RNA_def_property(srna, "scrollback", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_int_sdna(prop, NULL, "scrollback");
   RNA_def_property_range(prop, 32, 32768);
@@ -5874,6 +5929,13 @@ static void rna_def_userdef_filepaths(BlenderRNA *brna)
   RNA_def_property_string_sdna(prop, NULL, "render_cachedir");
   RNA_def_property_ui_text(prop, "Render Cache Path", "Where to cache raw render results");
 
+  prop = RNA_def_property(srna, "sequencer_disk_cache_directory", PROP_STRING, PROP_DIRPATH);
+  RNA_def_property_string_sdna(prop, NULL, "sequencer_disk_cache_dir");
+  RNA_def_property_ui_text(prop,
+                           "Sequencer Disk Cache Path",
+                           "Where to store images of the sequencer disk cache, the disk cache "
+                           "is not used when empty");
+
   prop = RNA_def_property(srna, "image_editor", PROP_STRING, PROP_FILEPATH);
   RNA_def_property_string_sdna(prop, NULL, "image_editor");
   RNA_def_property_ui_text(prop, "Image Editor", "Path to an image editor");
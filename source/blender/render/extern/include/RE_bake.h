@@ -28,6 +28,7 @@ struct Depsgraph;
 struct ImBuf;
 struct Mesh;
 struct Render;
+struct rcti;
 
 typedef struct BakeImage {
   struct Image *image;
@@ -49,10 +50,14 @@ typedef struct BakePixel {
   float dv_dx, dv_dy;
 } BakePixel;
 
+/* Triangles of a mesh, computed once and used by all the tiles of a bake. */
+typedef struct BakeMeshTriangles BakeMeshTriangles;
+
 typedef struct BakeHighPolyData {
   struct Object *ob;
   struct Object *ob_eval;
   struct Mesh *me;
+  BakeMeshTriangles *triangles;
   bool is_flip_object;
 
   float obmat[4][4];
@@ -76,7 +81,10 @@ bool RE_bake_engine(struct Render *re,
 /* bake.c */
 int RE_pass_depth(const eScenePassType pass_type);
 
-bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
+BakeMeshTriangles *RE_bake_mesh_triangles_new(struct Mesh *me, const bool tangent);
+void RE_bake_mesh_triangles_free(BakeMeshTriangles *triangles);
+
+bool RE_bake_pixels_populate_from_objects(const BakeMeshTriangles *triangles_low,
                                           BakePixel pixel_array_from[],
                                           BakePixel pixel_array_to[],
                                           BakeHighPolyData highpoly[],
@@ -86,7 +94,7 @@ bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
                                           const float cage_extrusion,
                                           float mat_low[4][4],
                                           float mat_cage[4][4],
-                                          struct Mesh *me_cage);
+                                          const BakeMeshTriangles *triangles_cage);
 
 void RE_bake_pixels_populate(struct Mesh *me,
                              struct BakePixel *pixel_array,
@@ -94,6 +102,15 @@ void RE_bake_pixels_populate(struct Mesh *me,
                              const struct BakeImages *bake_images,
                              const char *uv_layer);
 
+/* Same as RE_bake_pixels_populate(), for a region of one image,
+ * pixel_array is sized for the region only. */
+void RE_bake_pixels_populate_tile(struct Mesh *me,
+                                  struct BakePixel *pixel_array,
+                                  const struct BakeImages *bake_images,
+                                  const int image_id,
+                                  const struct rcti *tile,
+                                  const char *uv_layer);
+
 void RE_bake_mask_fill(const BakePixel pixel_array[], const size_t num_pixels, char *mask);
 
 void RE_bake_margin(struct ImBuf *ibuf, char *mask, const int margin);
@@ -108,7 +125,7 @@ void RE_bake_normal_world_to_tangent(const BakePixel pixel_array[],
                                      const size_t num_pixels,
                                      const int depth,
                                      float result[],
-                                     struct Mesh *me,
+                                     const BakeMeshTriangles *mesh_triangles,
                                      const eBakeNormalSwizzle normal_swizzle[3],
                                      float mat[4][4]);
 void RE_bake_normal_world_to_world(const BakePixel pixel_array[],
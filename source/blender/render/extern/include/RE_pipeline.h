@@ -28,6 +28,7 @@
 #include "DNA_vec_types.h"
 #include "DEG_depsgraph.h"
 
+struct GSet;
 struct Image;
 struct ImageFormatData;
 struct Main;
@@ -310,7 +311,7 @@ void RE_SetReports(struct Render *re, struct ReportList *reports);
 /* main preview render call */
 void RE_PreviewRender(struct Render *re, struct Main *bmain, struct Scene *scene);
 
-bool RE_ReadRenderResult(struct Scene *scene, struct Scene *scenode);
+bool RE_ReadRenderResult(struct Scene *scene, struct Scene *scenode, struct GSet *passes);
 bool RE_WriteRenderResult(struct ReportList *reports,
                           RenderResult *rr,
                           const char *filename,
@@ -34,6 +34,7 @@
 
 struct ColorManagedDisplaySettings;
 struct ColorManagedViewSettings;
+struct GSet;
 struct ImBuf;
 struct ListBase;
 struct Render;
@@ -100,12 +101,13 @@ void render_result_exr_file_path(struct Scene *scene,
                                  char *filepath);
 int render_result_exr_file_read_path(struct RenderResult *rr,
                                      struct RenderLayer *rl_single,
+                                     struct GSet *passes,
                                      const char *filepath);
 
 /* EXR cache */
 
 void render_result_exr_file_cache_write(struct Render *re);
-bool render_result_exr_file_cache_read(struct Render *re);
+bool render_result_exr_file_cache_read(struct Render *re, struct GSet *passes);
 
 /* Combined Pixel Rect */
 
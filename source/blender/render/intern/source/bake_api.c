@@ -66,6 +66,8 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math.h"
+#include "BLI_rect.h"
+#include "BLI_task.h"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -90,13 +92,31 @@
 
 typedef struct BakeDataZSpan {
   BakePixel *pixel_array;
+  /** Pixels are stored at offset + y * stride + x. */
+  size_t offset;
+  int stride;
   int primitive_id;
-  BakeImage *bk_image;
-  ZSpan *zspan;
   float du_dx, du_dy;
   float dv_dx, dv_dy;
 } BakeDataZSpan;
 
+/**
+ * Triangle of the low-poly mesh in the pixel space of the image it bakes to,
+ * computed once and then rasterized by all the threads populating the pixels.
+ */
+typedef struct BakeTriUV {
+  float vec[3][2];
+  float du_dx, du_dy;
+  float dv_dx, dv_dy;
+  /** Rows of pixels the triangle may cover, so bands can skip it without rasterizing it. */
+  int ymin, ymax;
+  int primitive_id;
+  int image_id;
+} BakeTriUV;
+
+/* Rows of pixels populated per task. */
+#define BAKE_POPULATE_BAND_SIZE 64
+
 /**
  * struct wrapping up tangent space data
  */
@@ -118,9 +138,7 @@ static void store_bake_pixel(void *handle, int x, int y, float u, float v)
   BakeDataZSpan *bd = (BakeDataZSpan *)handle;
   BakePixel *pixel;
 
-  const int width = bd->bk_image->width;
-  const size_t offset = bd->bk_image->offset;
-  const int i = offset + y * width + x;
+  const size_t i = bd->offset + (size_t)y * bd->stride + x;
 
   pixel = &bd->pixel_array[i];
   pixel->primitive_id = bd->primitive_id;
@@ -512,7 +530,143 @@ static TriTessFace *mesh_calc_tri_tessface(Mesh *me, bool tangent, Mesh *me_eval
   return triangles;
 }
 
-bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
+/* Triangles of a mesh, computed once for all the tiles of a bake. */
+struct BakeMeshTriangles {
+  TriTessFace *tris;
+  /* Evaluated copy of the mesh holding the tangents and loop normals, when requested. */
+  Mesh *me_eval;
+};
+
+BakeMeshTriangles *RE_bake_mesh_triangles_new(Mesh *me, const bool tangent)
+{
+  BakeMeshTriangles *triangles = MEM_callocN(sizeof(BakeMeshTriangles), __func__);
+
+  if (tangent) {
+    triangles->me_eval = BKE_mesh_copy_for_eval(me, false);
+  }
+  triangles->tris = mesh_calc_tri_tessface(me, tangent, triangles->me_eval);
+
+  return triangles;
+}
+
+void RE_bake_mesh_triangles_free(BakeMeshTriangles *triangles)
+{
+  MEM_freeN(triangles->tris);
+
+  if (triangles->me_eval) {
+    BKE_id_free(NULL, triangles->me_eval);
+  }
+
+  MEM_freeN(triangles);
+}
+
+/* Pixels cast from the low-poly mesh per task. */
+#define BAKE_RAYCAST_BLOCK_SIZE 4096
+
+typedef struct BakeRaycastData {
+  BakePixel *pixel_array_from;
+  BakePixel *pixel_array_to;
+  size_t num_pixels;
+  BakeHighPolyData *highpoly;
+  int tot_highpoly;
+  BVHTreeFromMesh *treeData;
+  TriTessFace *tris_low;
+  TriTessFace *tris_cage;
+  TriTessFace **tris_high;
+  bool is_custom_cage;
+  bool is_cage;
+  float cage_extrusion;
+  float (*mat_low)[4];
+  float (*imat_low)[4];
+  float (*mat_cage)[4];
+} BakeRaycastData;
+
+static void bake_raycast_block(void *__restrict userdata,
+                               const int block,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BakeRaycastData *data = userdata;
+  BakePixel *pixel_array_from = data->pixel_array_from;
+  BakePixel *pixel_array_to = data->pixel_array_to;
+  const size_t start = (size_t)block * BAKE_RAYCAST_BLOCK_SIZE;
+  const size_t end = min_zz(start + BAKE_RAYCAST_BLOCK_SIZE, data->num_pixels);
+
+  for (size_t i = start; i < end; i++) {
+    float co[3];
+    float dir[3];
+    TriTessFace *tri_low;
+    int primitive_id = pixel_array_from[i].primitive_id;
+    float u, v;
+
+    if (primitive_id == -1) {
+      pixel_array_to[i].primitive_id = -1;
+      continue;
+    }
+
+    u = pixel_array_from[i].uv[0];
+    v = pixel_array_from[i].uv[1];
+
+    /* calculate from low poly mesh cage */
+    if (data->is_custom_cage) {
+      calc_point_from_barycentric_cage(data->tris_low,
+                                       data->tris_cage,
+                                       data->mat_low,
+                                       data->mat_cage,
+                                       primitive_id,
+                                       u,
+                                       v,
+                                       co,
+                                       dir);
+      tri_low = &data->tris_cage[primitive_id];
+    }
+    else if (data->is_cage) {
+      calc_point_from_barycentric_extrusion(data->tris_cage,
+                                            data->mat_low,
+                                            data->imat_low,
+                                            primitive_id,
+                                            u,
+                                            v,
+                                            data->cage_extrusion,
+                                            co,
+                                            dir,
+                                            true);
+      tri_low = &data->tris_cage[primitive_id];
+    }
+    else {
+      calc_point_from_barycentric_extrusion(data->tris_low,
+                                            data->mat_low,
+                                            data->imat_low,
+                                            primitive_id,
+                                            u,
+                                            v,
+                                            data->cage_extrusion,
+                                            co,
+                                            dir,
+                                            false);
+      tri_low = &data->tris_low[primitive_id];
+    }
+
+    /* cast ray */
+    if (!cast_ray_highpoly(data->treeData,
+                           tri_low,
+                           data->tris_high,
+                           pixel_array_from,
+                           pixel_array_to,
+                           data->mat_low,
+                           data->highpoly,
+                           co,
+                           dir,
+                           i,
+                           data->tot_highpoly)) {
+      /* if it fails mask out the original pixel array */
+      pixel_array_from[i].primitive_id = -1;
+    }
+  }
+}
+
+/* The triangles of the low poly mesh (with tangents when there is no cage), of the cage and of
+ * the high poly meshes are computed once by the caller, see RE_bake_mesh_triangles_new(). */
+bool RE_bake_pixels_populate_from_objects(const BakeMeshTriangles *triangles_low,
                                           BakePixel pixel_array_from[],
                                           BakePixel pixel_array_to[],
                                           BakeHighPolyData highpoly[],
@@ -522,47 +676,34 @@ bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
                                           const float cage_extrusion,
                                           float mat_low[4][4],
                                           float mat_cage[4][4],
-                                          struct Mesh *me_cage)
+                                          const BakeMeshTriangles *triangles_cage)
 {
   size_t i;
-  int primitive_id;
-  float u, v;
   float imat_low[4][4];
-  bool is_cage = me_cage != NULL;
+  bool is_cage = triangles_cage != NULL;
   bool result = true;
 
-  Mesh *me_eval_low = NULL;
   Mesh **me_highpoly;
   BVHTreeFromMesh *treeData;
 
   /* Note: all coordinates are in local space */
-  TriTessFace *tris_low = NULL;
-  TriTessFace *tris_cage = NULL;
+  TriTessFace *tris_low = triangles_low ? triangles_low->tris : NULL;
+  TriTessFace *tris_cage = triangles_cage ? triangles_cage->tris : NULL;
   TriTessFace **tris_high;
 
-  /* assume all lowpoly tessfaces can be quads */
   tris_high = MEM_callocN(sizeof(TriTessFace *) * tot_highpoly, "MVerts Highpoly Mesh Array");
 
   /* assume all highpoly tessfaces are triangles */
   me_highpoly = MEM_mallocN(sizeof(Mesh *) * tot_highpoly, "Highpoly Derived Meshes");
   treeData = MEM_callocN(sizeof(BVHTreeFromMesh) * tot_highpoly, "Highpoly BVH Trees");
 
-  if (!is_cage) {
-    me_eval_low = BKE_mesh_copy_for_eval(me_low, false);
-    tris_low = mesh_calc_tri_tessface(me_low, true, me_eval_low);
-  }
-  else if (is_custom_cage) {
-    tris_low = mesh_calc_tri_tessface(me_low, false, NULL);
-    tris_cage = mesh_calc_tri_tessface(me_cage, false, NULL);
-  }
-  else {
-    tris_cage = mesh_calc_tri_tessface(me_cage, false, NULL);
-  }
+  BLI_assert(tris_low != NULL || !is_custom_cage);
+  BLI_assert(tris_low != NULL || is_cage);
 
   invert_m4_m4(imat_low, mat_low);
 
   for (i = 0; i < tot_highpoly; i++) {
-    tris_high[i] = mesh_calc_tri_tessface(highpoly[i].me, false, NULL);
+    tris_high[i] = highpoly[i].triangles->tris;
 
     me_highpoly[i] = highpoly[i].me;
     BKE_mesh_runtime_looptri_ensure(me_highpoly[i]);
@@ -580,83 +721,46 @@ bool RE_bake_pixels_populate_from_objects(struct Mesh *me_low,
     }
   }
 
-  for (i = 0; i < num_pixels; i++) {
-    float co[3];
-    float dir[3];
-    TriTessFace *tri_low;
-
-    primitive_id = pixel_array_from[i].primitive_id;
-
-    if (primitive_id == -1) {
-      pixel_array_to[i].primitive_id = -1;
-      continue;
-    }
+  BakeRaycastData data = {
+      .pixel_array_from = pixel_array_from,
+      .pixel_array_to = pixel_array_to,
+      .num_pixels = num_pixels,
+      .highpoly = highpoly,
+      .tot_highpoly = tot_highpoly,
+      .treeData = treeData,
+      .tris_low = tris_low,
+      .tris_cage = tris_cage,
+      .tris_high = tris_high,
+      .is_custom_cage = is_custom_cage,
+      .is_cage = is_cage,
+      .cage_extrusion = cage_extrusion,
+      .mat_low = mat_low,
+      .imat_low = imat_low,
+      .mat_cage = mat_cage,
+  };
 
-    u = pixel_array_from[i].uv[0];
-    v = pixel_array_from[i].uv[1];
-
-    /* calculate from low poly mesh cage */
-    if (is_custom_cage) {
-      calc_point_from_barycentric_cage(
-          tris_low, tris_cage, mat_low, mat_cage, primitive_id, u, v, co, dir);
-      tri_low = &tris_cage[primitive_id];
-    }
-    else if (is_cage) {
-      calc_point_from_barycentric_extrusion(
-          tris_cage, mat_low, imat_low, primitive_id, u, v, cage_extrusion, co, dir, true);
-      tri_low = &tris_cage[primitive_id];
-    }
-    else {
-      calc_point_from_barycentric_extrusion(
-          tris_low, mat_low, imat_low, primitive_id, u, v, cage_extrusion, co, dir, false);
-      tri_low = &tris_low[primitive_id];
-    }
-
-    /* cast ray */
-    if (!cast_ray_highpoly(treeData,
-                           tri_low,
-                           tris_high,
-                           pixel_array_from,
-                           pixel_array_to,
-                           mat_low,
-                           highpoly,
-                           co,
-                           dir,
-                           i,
-                           tot_highpoly)) {
-      /* if it fails mask out the original pixel array */
-      pixel_array_from[i].primitive_id = -1;
-    }
-  }
+  const int num_blocks = (int)((num_pixels + BAKE_RAYCAST_BLOCK_SIZE - 1) /
+                               BAKE_RAYCAST_BLOCK_SIZE);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = num_blocks > 1;
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num_blocks, &data, bake_raycast_block, &settings);
 
   /* garbage collection */
 cleanup:
   for (i = 0; i < tot_highpoly; i++) {
     free_bvhtree_from_mesh(&treeData[i]);
-
-    if (tris_high[i]) {
-      MEM_freeN(tris_high[i]);
-    }
   }
 
   MEM_freeN(tris_high);
   MEM_freeN(treeData);
   MEM_freeN(me_highpoly);
 
-  if (me_eval_low) {
-    BKE_id_free(NULL, me_eval_low);
-  }
-  if (tris_low) {
-    MEM_freeN(tris_low);
-  }
-  if (tris_cage) {
-    MEM_freeN(tris_cage);
-  }
-
   return result;
 }
 
-static void bake_differentials(BakeDataZSpan *bd,
+static void bake_differentials(BakeTriUV *tri,
                                const float *uv1,
                                const float *uv2,
                                const float *uv3)
@@ -669,31 +773,29 @@ static void bake_differentials(BakeDataZSpan *bd,
   if (fabsf(A) > FLT_EPSILON) {
     A = 0.5f / A;
 
-    bd->du_dx = (uv2[1] - uv3[1]) * A;
-    bd->dv_dx = (uv3[1] - uv1[1]) * A;
+    tri->du_dx = (uv2[1] - uv3[1]) * A;
+    tri->dv_dx = (uv3[1] - uv1[1]) * A;
 
-    bd->du_dy = (uv3[0] - uv2[0]) * A;
-    bd->dv_dy = (uv1[0] - uv3[0]) * A;
+    tri->du_dy = (uv3[0] - uv2[0]) * A;
+    tri->dv_dy = (uv1[0] - uv3[0]) * A;
   }
   else {
-    bd->du_dx = bd->du_dy = 0.0f;
-    bd->dv_dx = bd->dv_dy = 0.0f;
+    tri->du_dx = tri->du_dy = 0.0f;
+    tri->dv_dx = tri->dv_dy = 0.0f;
   }
 }
 
-void RE_bake_pixels_populate(Mesh *me,
-                             BakePixel pixel_array[],
-                             const size_t num_pixels,
-                             const BakeImages *bake_images,
-                             const char *uv_layer)
+/* Returns the triangles which bake to an image, NULL when the mesh has no UV's. */
+static BakeTriUV *bake_tris_uv_calc(Mesh *me,
+                                    const BakeImages *bake_images,
+                                    const char *uv_layer,
+                                    int *r_tottri)
 {
-  BakeDataZSpan bd;
-  size_t i;
-  int a, p_id;
-
   const MLoopUV *mloopuv;
   const int tottri = poly_to_tri_count(me->totpoly, me->totloop);
   MLoopTri *looptri;
+  BakeTriUV *tris;
+  int i, a, p_id;
 
   if ((uv_layer == NULL) || (uv_layer[0] == '\0')) {
     mloopuv = CustomData_get_layer(&me->ldata, CD_MLOOPUV);
@@ -704,31 +806,19 @@ void RE_bake_pixels_populate(Mesh *me,
   }
 
   if (mloopuv == NULL) {
-    return;
-  }
-
-  bd.pixel_array = pixel_array;
-  bd.zspan = MEM_callocN(sizeof(ZSpan) * bake_images->size, "bake zspan");
-
-  /* initialize all pixel arrays so we know which ones are 'blank' */
-  for (i = 0; i < num_pixels; i++) {
-    pixel_array[i].primitive_id = -1;
-    pixel_array[i].object_id = 0;
-  }
-
-  for (i = 0; i < bake_images->size; i++) {
-    zbuf_alloc_span(&bd.zspan[i], bake_images->data[i].width, bake_images->data[i].height);
+    return NULL;
   }
 
   looptri = MEM_mallocN(sizeof(*looptri) * tottri, __func__);
+  tris = MEM_mallocN(sizeof(*tris) * tottri, __func__);
 
   BKE_mesh_recalc_looptri(me->mloop, me->mpoly, me->mvert, me->totloop, me->totpoly, looptri);
 
   p_id = -1;
+  *r_tottri = 0;
   for (i = 0; i < tottri; i++) {
     const MLoopTri *lt = &looptri[i];
     const MPoly *mp = &me->mpoly[lt->poly];
-    float vec[3][2];
     int mat_nr = mp->mat_nr;
     int image_id = bake_images->lookup[mat_nr];
 
@@ -736,8 +826,10 @@ void RE_bake_pixels_populate(Mesh *me,
       continue;
     }
 
-    bd.bk_image = &bake_images->data[image_id];
-    bd.primitive_id = ++p_id;
+    const BakeImage *bk_image = &bake_images->data[image_id];
+    BakeTriUV *tri = &tris[(*r_tottri)++];
+    tri->primitive_id = ++p_id;
+    tri->image_id = image_id;
 
     for (a = 0; a < 3; a++) {
       const float *uv = mloopuv[lt->tri[a]].uv;
@@ -746,20 +838,155 @@ void RE_bake_pixels_populate(Mesh *me,
        * intersection tests where a pixel gets in between 2 faces or the middle of a quad,
        * camera aligned quads also have this problem but they are less common.
        * Add a small offset to the UVs, fixes bug #18685 - Campbell */
-      vec[a][0] = uv[0] * (float)bd.bk_image->width - (0.5f + 0.001f);
-      vec[a][1] = uv[1] * (float)bd.bk_image->height - (0.5f + 0.002f);
+      tri->vec[a][0] = uv[0] * (float)bk_image->width - (0.5f + 0.001f);
+      tri->vec[a][1] = uv[1] * (float)bk_image->height - (0.5f + 0.002f);
     }
 
-    bake_differentials(&bd, vec[0], vec[1], vec[2]);
-    zspan_scanconvert(&bd.zspan[image_id], (void *)&bd, vec[0], vec[1], vec[2], store_bake_pixel);
-  }
+    tri->ymin = (int)floorf(min_fff(tri->vec[0][1], tri->vec[1][1], tri->vec[2][1]));
+    tri->ymax = (int)ceilf(max_fff(tri->vec[0][1], tri->vec[1][1], tri->vec[2][1])) + 1;
 
-  for (i = 0; i < bake_images->size; i++) {
-    zbuf_free_span(&bd.zspan[i]);
+    bake_differentials(tri, tri->vec[0], tri->vec[1], tri->vec[2]);
   }
 
   MEM_freeN(looptri);
-  MEM_freeN(bd.zspan);
+
+  return tris;
+}
+
+typedef struct BakePopulateData {
+  const BakeTriUV *tris;
+  int tottri;
+  int image_id;
+  /** Region of the image, the first pixel of the region and the pixels per row. */
+  const rcti *region;
+  BakePixel *pixel_array;
+  int stride;
+} BakePopulateData;
+
+/* Rasterize the triangles of an image into a band of rows of the region. */
+static void bake_pixels_populate_band(void *__restrict userdata,
+                                      const int band,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BakePopulateData *data = userdata;
+  const int xmin = data->region->xmin;
+  const int ymin = data->region->ymin + band * BAKE_POPULATE_BAND_SIZE;
+  const int ymax = min_ii(ymin + BAKE_POPULATE_BAND_SIZE, data->region->ymax);
+  BakeDataZSpan bd;
+  ZSpan zspan;
+
+  bd.pixel_array = data->pixel_array;
+  bd.offset = (size_t)(ymin - data->region->ymin) * data->stride;
+  bd.stride = data->stride;
+
+  zbuf_alloc_span(&zspan, BLI_rcti_size_x(data->region), ymax - ymin);
+
+  for (int i = 0; i < data->tottri; i++) {
+    const BakeTriUV *tri = &data->tris[i];
+    float vec[3][2];
+
+    if (tri->image_id != data->image_id || tri->ymax <= ymin || tri->ymin >= ymax) {
+      continue;
+    }
+
+    /* Offset to the band, the span clips the pixels outside of it. */
+    for (int a = 0; a < 3; a++) {
+      vec[a][0] = tri->vec[a][0] - (float)xmin;
+      vec[a][1] = tri->vec[a][1] - (float)ymin;
+    }
+
+    bd.primitive_id = tri->primitive_id;
+    bd.du_dx = tri->du_dx;
+    bd.du_dy = tri->du_dy;
+    bd.dv_dx = tri->dv_dx;
+    bd.dv_dy = tri->dv_dy;
+
+    zspan_scanconvert(&zspan, (void *)&bd, vec[0], vec[1], vec[2], store_bake_pixel);
+  }
+
+  zbuf_free_span(&zspan);
+}
+
+/* Populate a region of an image, with its rows split into bands populated in parallel. */
+static void bake_pixels_populate_region(const BakeTriUV *tris,
+                                        const int tottri,
+                                        const int image_id,
+                                        const rcti *region,
+                                        BakePixel pixel_array[],
+                                        const int stride)
+{
+  const int num_bands = (BLI_rcti_size_y(region) + BAKE_POPULATE_BAND_SIZE - 1) /
+                        BAKE_POPULATE_BAND_SIZE;
+  BakePopulateData data = {
+      .tris = tris,
+      .tottri = tottri,
+      .image_id = image_id,
+      .region = region,
+      .pixel_array = pixel_array,
+      .stride = stride,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = num_bands > 1;
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num_bands, &data, bake_pixels_populate_band, &settings);
+}
+
+static void bake_pixels_clear(BakePixel pixel_array[], const size_t num_pixels)
+{
+  /* initialize all pixel arrays so we know which ones are 'blank' */
+  for (size_t i = 0; i < num_pixels; i++) {
+    pixel_array[i].primitive_id = -1;
+    pixel_array[i].object_id = 0;
+  }
+}
+
+void RE_bake_pixels_populate(Mesh *me,
+                             BakePixel pixel_array[],
+                             const size_t num_pixels,
+                             const BakeImages *bake_images,
+                             const char *uv_layer)
+{
+  int tottri;
+  BakeTriUV *tris = bake_tris_uv_calc(me, bake_images, uv_layer, &tottri);
+
+  if (tris == NULL) {
+    return;
+  }
+
+  bake_pixels_clear(pixel_array, num_pixels);
+
+  for (int i = 0; i < bake_images->size; i++) {
+    const BakeImage *bk_image = &bake_images->data[i];
+    rcti region;
+
+    BLI_rcti_init(&region, 0, bk_image->width, 0, bk_image->height);
+    bake_pixels_populate_region(
+        tris, tottri, i, &region, pixel_array + bk_image->offset, bk_image->width);
+  }
+
+  MEM_freeN(tris);
+}
+
+void RE_bake_pixels_populate_tile(Mesh *me,
+                                  BakePixel pixel_array[],
+                                  const BakeImages *bake_images,
+                                  const int image_id,
+                                  const rcti *tile,
+                                  const char *uv_layer)
+{
+  int tottri;
+  BakeTriUV *tris = bake_tris_uv_calc(me, bake_images, uv_layer, &tottri);
+
+  if (tris == NULL) {
+    return;
+  }
+
+  bake_pixels_clear(pixel_array, (size_t)BLI_rcti_size_x(tile) * BLI_rcti_size_y(tile));
+  bake_pixels_populate_region(tris, tottri, image_id, tile, pixel_array, BLI_rcti_size_x(tile));
+
+  MEM_freeN(tris);
 }
 
 /* ******************** NORMALS ************************ */
@@ -819,27 +1046,25 @@ static void normal_compress(float out[3],
 /**
  * This function converts an object space normal map
  * to a tangent space normal map for a given low poly mesh.
+ * The triangles of the mesh are created with their tangents.
  */
 void RE_bake_normal_world_to_tangent(const BakePixel pixel_array[],
                                      const size_t num_pixels,
                                      const int depth,
                                      float result[],
-                                     Mesh *me,
+                                     const BakeMeshTriangles *mesh_triangles,
                                      const eBakeNormalSwizzle normal_swizzle[3],
                                      float mat[4][4])
 {
   size_t i;
 
-  TriTessFace *triangles;
-
-  Mesh *me_eval = BKE_mesh_copy_for_eval(me, false);
-
-  triangles = mesh_calc_tri_tessface(me, true, me_eval);
+  const TriTessFace *triangles = mesh_triangles->tris;
 
+  BLI_assert(mesh_triangles->me_eval != NULL);
   BLI_assert(num_pixels >= 3);
 
   for (i = 0; i < num_pixels; i++) {
-    TriTessFace *triangle;
+    const TriTessFace *triangle;
     float tangents[3][3];
     float normals[3][3];
     float signs[3];
@@ -936,13 +1161,6 @@ void RE_bake_normal_world_to_tangent(const BakePixel pixel_array[],
     /* save back the values */
     normal_compress(&result[offset], nor, normal_swizzle);
   }
-
-  /* garbage collection */
-  MEM_freeN(triangles);
-
-  if (me_eval) {
-    BKE_id_free(NULL, me_eval);
-  }
 }
 
 void RE_bake_normal_world_to_object(const BakePixel pixel_array[],
@@ -2797,8 +2797,10 @@ void RE_CleanAfterRender(Render *re)
 
 /* note; repeated win/disprect calc... solve that nicer, also in compo */
 
-/* only the temp file! */
-bool RE_ReadRenderResult(Scene *scene, Scene *scenode)
+/* only the temp file!
+ * passes holds "view layer.pass" keys of the passes to read, for example the ones a node tree
+ * uses, NULL reads all passes. */
+bool RE_ReadRenderResult(Scene *scene, Scene *scenode, GSet *passes)
 {
   Render *re;
   int winx, winy;
@@ -2836,7 +2838,7 @@ bool RE_ReadRenderResult(Scene *scene, Scene *scenode)
   re->scene = scene;
 
   BLI_rw_mutex_lock(&re->resultmutex, THREAD_LOCK_WRITE);
-  success = render_result_exr_file_cache_read(re);
+  success = render_result_exr_file_cache_read(re, passes);
   BLI_rw_mutex_unlock(&re->resultmutex);
 
   render_result_uncrop(re);
@@ -2920,7 +2922,7 @@ void RE_layer_load_from_file(
 
 void RE_result_load_from_file(RenderResult *result, ReportList *reports, const char *filename)
 {
-  if (!render_result_exr_file_read_path(result, NULL, filename)) {
+  if (!render_result_exr_file_read_path(result, NULL, NULL, filename)) {
     BKE_reportf(reports, RPT_ERROR, "%s: failed to load '%s'", __func__, filename);
     return;
   }
@@ -1304,7 +1304,7 @@ void render_result_exr_file_end(Render *re, RenderEngine *engine)
     render_result_exr_file_path(re->scene, rl->name, 0, str);
     printf("read exr tmp file: %s\n", str);
 
-    if (!render_result_exr_file_read_path(re->result, rl, str)) {
+    if (!render_result_exr_file_read_path(re->result, rl, NULL, str)) {
       printf("cannot read: %s\n", str);
     }
     BLI_rw_mutex_unlock(&re->resultmutex);
@@ -1338,9 +1338,12 @@ void render_result_exr_file_path(Scene *scene, const char *layname, int sample,
   BLI_make_file_string("/", filepath, BKE_tempdir_session(), name);
 }
 
-/* called for reading temp files, and for external engines */
+/* called for reading temp files, and for external engines
+ * passes holds "layer.pass" keys of the passes to decode, NULL decodes all of them. Other passes
+ * keep their cleared pixels, the Combined pass is always read. */
 int render_result_exr_file_read_path(RenderResult *rr,
                                      RenderLayer *rl_single,
+                                     GSet *passes,
                                      const char *filepath)
 {
   RenderLayer *rl;
@@ -1376,13 +1379,21 @@ int render_result_exr_file_read_path(RenderResult *rr,
       int a;
       char fullname[EXR_PASS_MAXNAME];
 
+      set_pass_full_name(rpass->fullname, rpass->name, -1, rpass->view, rpass->chan_id);
+
+      if (passes && !STREQ(rpass->name, RE_PASSNAME_COMBINED)) {
+        char key[EXR_LAY_MAXNAME + EXR_PASS_MAXNAME + 1];
+        BLI_snprintf(key, sizeof(key), "%s.%s", rl->name, rpass->name);
+        if (!BLI_gset_haskey(passes, key)) {
+          continue;
+        }
+      }
+
       for (a = 0; a < xstride; a++) {
         set_pass_full_name(fullname, rpass->name, a, rpass->view, rpass->chan_id);
         IMB_exr_set_channel(
             exrhandle, rl->name, fullname, xstride, xstride * rectx, rpass->rect + a);
       }
-
-      set_pass_full_name(rpass->fullname, rpass->name, -1, rpass->view, rpass->chan_id);
     }
   }
 
@@ -1437,8 +1448,9 @@ void render_result_exr_file_cache_write(Render *re)
   RE_WriteRenderResult(NULL, rr, str, NULL, NULL, -1);
 }
 
-/* For cache, makes exact copy of render result */
-bool render_result_exr_file_cache_read(Render *re)
+/* For cache, makes exact copy of render result, of the passes given only when passes is not
+ * NULL */
+bool render_result_exr_file_cache_read(Render *re, GSet *passes)
 {
   char str[FILE_MAXFILE + MAX_ID_NAME + MAX_ID_NAME + 100] = "";
   char *root = U.render_cachedir;
@@ -1450,7 +1462,7 @@ bool render_result_exr_file_cache_read(Render *re)
   render_result_exr_file_cache_path(re->scene, root, str);
 
   printf("read exr cache file: %s\n", str);
-  if (!render_result_exr_file_read_path(re->result, NULL, str)) {
+  if (!render_result_exr_file_read_path(re->result, NULL, passes, str)) {
     printf("cannot read: %s\n", str);
     return false;
   }
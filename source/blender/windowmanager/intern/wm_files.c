@@ -97,6 +97,7 @@
 
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
+#include "IMB_moviecache.h"
 #include "IMB_thumbs.h"
 
 #include "ED_datafiles.h"
@@ -118,6 +119,8 @@
 /* only to report a missing engine */
 #include "RE_engine.h"
 
+#include "COM_compositor.h"
+
 #ifdef WITH_PYTHON
 #  include "BPY_extern.h"
 #endif
@@ -369,6 +372,8 @@ static void wm_init_userdef(Main *bmain)
   }
 
   MEM_CacheLimiter_set_maximum(((size_t)U.memcachelimit) * 1024 * 1024);
+  IMB_moviecache_set_image_budget(((size_t)U.image_cache_limit) * 1024 * 1024);
+  IMB_anim_set_threaded_decoding((U.flag & USER_MOVIE_DECODE_THREADS) != 0);
   BKE_sound_init(bmain);
 
   /* update tempdir from user preferences */
@@ -614,6 +619,10 @@ bool WM_file_read(bContext *C, const char *filepath, ReportList *reports)
 
   /* Reset session-wise ID UUID counter. */
   BKE_lib_libblock_session_uuid_reset();
+#ifdef WITH_COMPOSITOR
+  /* Cached compositor results are identified by the UUID of the IDs they use. */
+  COM_clearCaches();
+#endif
 
   /* first try to append data from exotic file formats... */
   /* it throws error box when file doesn't exist and returns -1 */
@@ -923,6 +932,10 @@ void wm_homefile_read(bContext *C,
 
   /* Reset session-wise ID UUID counter. */
   BKE_lib_libblock_session_uuid_reset();
+#ifdef WITH_COMPOSITOR
+  /* Cached compositor results are identified by the UUID of the IDs they use. */
+  COM_clearCaches();
+#endif
 
   if (!use_factory_settings || (filepath_startup[0] != '\0')) {
     if (BLI_access(filepath_startup, R_OK) == 0) {
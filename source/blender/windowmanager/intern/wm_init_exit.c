@@ -564,6 +564,7 @@ void WM_exit_ex(bContext *C, const bool do_python)
   }
 
   BKE_sequencer_free_clipboard(); /* sequencer.c */
+  BKE_sequencer_cache_disk_exit(); /* seqcache.c */
   BKE_tracking_clipboard_free();
   BKE_mask_clipboard_free();
   BKE_vfont_clipboard_free();
@@ -0,0 +1,179 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_BlurBaseOperation.h"
+#include "COM_GaussianXBlurOperation.h"
+#include "COM_GaussianYBlurOperation.h"
+#include "COM_MemoryBuffer.h"
+
+extern "C" {
+#include "BLI_math_base.h"
+#include "BLI_rect.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+}
+
+#define BUFFER_SIZE 1024
+#define TILE_SIZE 256
+
+/* Feeds a memory buffer into the blur operations, as a ReadBufferOperation would. */
+class BufferInputOperation : public NodeOperation {
+ private:
+  MemoryBuffer *m_buffer;
+
+ public:
+  BufferInputOperation(MemoryBuffer *buffer) : m_buffer(buffer)
+  {
+    this->addOutputSocket(COM_DT_COLOR);
+    this->setWidth(buffer->getWidth());
+    this->setHeight(buffer->getHeight());
+  }
+
+  void *initializeTileData(rcti * /*rect*/)
+  {
+    return m_buffer;
+  }
+
+  void executePixelSampled(float output[4], float x, float y, PixelSampler /*sampler*/)
+  {
+    m_buffer->read(output, (int)x, (int)y);
+  }
+};
+
+/* Hard edges of a checker board on top of gradients, where the approximation of the recursive
+ * filter would show first. */
+static MemoryBuffer *gaussian_blur_input_create(int width, int height)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  MemoryBuffer *buffer = new MemoryBuffer(COM_DT_COLOR, &rect);
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      float *pixel = buffer->getPixel(x, y);
+      pixel[0] = ((x / 64 + y / 64) & 1) ? 1.0f : 0.0f;
+      pixel[1] = (float)x / width;
+      pixel[2] = (float)y / height;
+      pixel[3] = 1.0f;
+    }
+  }
+  return buffer;
+}
+
+/* Blur the input with the operation tile by tile, like an execution group does. */
+static MemoryBuffer *gaussian_blur_execute(BlurBaseOperation *blur,
+                                           MemoryBuffer *input,
+                                           float rad,
+                                           bool recursive)
+{
+  BufferInputOperation input_operation(input);
+  blur->getInputSocket(0)->setLink(input_operation.getOutputSocket());
+
+  NodeBlurData data;
+  memset(&data, 0, sizeof(data));
+  data.filtertype = R_FILTER_GAUSS;
+  data.sizex = data.sizey = (short)rad;
+  blur->setData(&data);
+  blur->setSize(1.0f);
+  blur->setRecursiveGauss(recursive);
+
+  unsigned int resolution[2] = {(unsigned int)input->getWidth(),
+                                (unsigned int)input->getHeight()};
+  blur->setResolution(resolution);
+
+  MemoryBuffer *output = new MemoryBuffer(COM_DT_COLOR, input->getRect());
+
+  blur->initExecution();
+  for (int tile_y = 0; tile_y < input->getHeight(); tile_y += TILE_SIZE) {
+    for (int tile_x = 0; tile_x < input->getWidth(); tile_x += TILE_SIZE) {
+      rcti rect;
+      BLI_rcti_init(&rect,
+                    tile_x,
+                    min_ii(tile_x + TILE_SIZE, input->getWidth()),
+                    tile_y,
+                    min_ii(tile_y + TILE_SIZE, input->getHeight()));
+      void *tile_data = blur->initializeTileData(&rect);
+      for (int y = rect.ymin; y < rect.ymax; y++) {
+        for (int x = rect.xmin; x < rect.xmax; x++) {
+          blur->read(output->getPixel(x, y), x, y, tile_data);
+        }
+      }
+      blur->deinitializeTileData(&rect, tile_data);
+    }
+  }
+  blur->deinitExecution();
+
+  blur->getInputSocket(0)->setLink(NULL);
+  return output;
+}
+
+static void gaussian_blur_test_do(float rad)
+{
+  MemoryBuffer *input = gaussian_blur_input_create(BUFFER_SIZE, BUFFER_SIZE);
+  MemoryBuffer *results[2];
+  double timings[2];
+
+  for (int recursive = 0; recursive < 2; recursive++) {
+    GaussianXBlurOperation blur_x;
+    GaussianYBlurOperation blur_y;
+
+    const double init_time = PIL_check_seconds_timer();
+    MemoryBuffer *temp = gaussian_blur_execute(&blur_x, input, rad, recursive);
+    results[recursive] = gaussian_blur_execute(&blur_y, temp, rad, recursive);
+    timings[recursive] = PIL_check_seconds_timer() - init_time;
+
+    delete temp;
+  }
+
+  const float *convolution_data = results[0]->getBuffer();
+  const float *recursive_data = results[1]->getBuffer();
+  float max_error = 0.0f;
+  for (int i = 0; i < BUFFER_SIZE * BUFFER_SIZE * COM_NUM_CHANNELS_COLOR; i++) {
+    max_error = max_ff(max_error, fabsf(convolution_data[i] - recursive_data[i]));
+  }
+
+  /* below MIN_RECURSIVE_GAUSS_RADIUS both runs convolve, and have to match exactly */
+  if (rad >= MIN_RECURSIVE_GAUSS_RADIUS) {
+    EXPECT_LT(max_error, 1e-2f);
+  }
+  else {
+    EXPECT_EQ(max_error, 0.0f);
+  }
+
+  printf("\tRadius %.0f: convolution done in %fs, recursive done in %fs, max error %f\n",
+         rad,
+         timings[0],
+         timings[1],
+         max_error);
+
+  delete input;
+  delete results[0];
+  delete results[1];
+}
+
+TEST(compositor_gaussian_blur, Radius8)
+{
+  gaussian_blur_test_do(8.0f);
+}
+
+TEST(compositor_gaussian_blur, Radius32)
+{
+  gaussian_blur_test_do(32.0f);
+}
+
+TEST(compositor_gaussian_blur, Radius128)
+{
+  gaussian_blur_test_do(128.0f);
+}
+
+TEST(compositor_gaussian_blur, Radius512)
+{
+  gaussian_blur_test_do(512.0f);
+}
@@ -0,0 +1,161 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_MemoryBuffer.h"
+
+extern "C" {
+#include "BLI_rand.h"
+#include "BLI_rect.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 10
+
+#define BUFFER_SIZE 1024
+
+/* Noise, so that neighbouring samples differ and interpolation errors show. */
+static MemoryBuffer *memory_buffer_create(DataType datatype, int width, int height)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  MemoryBuffer *buffer = new MemoryBuffer(datatype, &rect);
+
+  RNG *rng = BLI_rng_new(0);
+  float *data = buffer->getBuffer();
+  const int size = width * height * buffer->get_num_channels();
+  for (int i = 0; i < size; i++) {
+    data[i] = BLI_rng_get_float(rng);
+  }
+  BLI_rng_free(rng);
+  return buffer;
+}
+
+/* Positions of a row rotated and scaled around the center, as read by a transform. */
+static void memory_buffer_row_coords(float *coords, int width, int height, int y)
+{
+  const float angle = 0.3f, scale = 0.8f;
+  const float cosine = cosf(angle) * scale, sine = sinf(angle) * scale;
+  const float center_x = width * 0.5f, center_y = height * 0.5f;
+  for (int x = 0; x < width; x++) {
+    const float dx = x - center_x, dy = y - center_y;
+    coords[x * 2] = center_x + cosine * dx + sine * dy;
+    coords[x * 2 + 1] = center_y - sine * dx + cosine * dy;
+  }
+}
+
+static void memory_buffer_bilinear_test_do(const char *id, DataType datatype)
+{
+  MemoryBuffer *buffer = memory_buffer_create(datatype, BUFFER_SIZE, BUFFER_SIZE);
+  const int num_channels = buffer->get_num_channels();
+
+  float *coords = (float *)MEM_mallocN(sizeof(float) * 2 * BUFFER_SIZE, __func__);
+  float *result_pixel = (float *)MEM_mallocN(
+      sizeof(float) * num_channels * BUFFER_SIZE * BUFFER_SIZE, __func__);
+  float *result_span = (float *)MEM_mallocN(
+      sizeof(float) * num_channels * BUFFER_SIZE * BUFFER_SIZE, __func__);
+
+  double pixel_timing = 0.0, span_timing = 0.0;
+  for (int run = 0; run < NUM_RUN_AVERAGED; run++) {
+    double init_time = PIL_check_seconds_timer();
+    for (int y = 0; y < BUFFER_SIZE; y++) {
+      memory_buffer_row_coords(coords, BUFFER_SIZE, BUFFER_SIZE, y);
+      float *result = &result_pixel[y * BUFFER_SIZE * num_channels];
+      for (int x = 0; x < BUFFER_SIZE; x++, result += num_channels) {
+        buffer->readBilinear(result, coords[x * 2], coords[x * 2 + 1]);
+      }
+    }
+    pixel_timing += PIL_check_seconds_timer() - init_time;
+
+    init_time = PIL_check_seconds_timer();
+    for (int y = 0; y < BUFFER_SIZE; y++) {
+      memory_buffer_row_coords(coords, BUFFER_SIZE, BUFFER_SIZE, y);
+      buffer->readBilinearSpan(&result_span[y * BUFFER_SIZE * num_channels], coords, BUFFER_SIZE);
+    }
+    span_timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  for (int i = 0; i < BUFFER_SIZE * BUFFER_SIZE * num_channels; i++) {
+    EXPECT_NEAR(result_pixel[i], result_span[i], 1e-6f);
+  }
+
+  printf("\t%s: per pixel done in %fs, span done in %fs on average over %d runs\n",
+         id,
+         pixel_timing / NUM_RUN_AVERAGED,
+         span_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  MEM_freeN(coords);
+  MEM_freeN(result_pixel);
+  MEM_freeN(result_span);
+  delete buffer;
+}
+
+TEST(compositor_memory_buffer, BilinearColor)
+{
+  memory_buffer_bilinear_test_do("Bilinear color", COM_DT_COLOR);
+}
+
+TEST(compositor_memory_buffer, BilinearVector)
+{
+  memory_buffer_bilinear_test_do("Bilinear vector", COM_DT_VECTOR);
+}
+
+TEST(compositor_memory_buffer, BilinearValue)
+{
+  memory_buffer_bilinear_test_do("Bilinear value", COM_DT_VALUE);
+}
+
+TEST(compositor_memory_buffer, EWAColor)
+{
+  MemoryBuffer *buffer = memory_buffer_create(COM_DT_COLOR, BUFFER_SIZE, BUFFER_SIZE);
+
+  float *coords = (float *)MEM_mallocN(sizeof(float) * 2 * BUFFER_SIZE, __func__);
+  float(*derivatives)[2][2] = (float(*)[2][2])MEM_mallocN(sizeof(*derivatives) * BUFFER_SIZE,
+                                                           __func__);
+  float *result_pixel = (float *)MEM_mallocN(sizeof(float) * 4 * BUFFER_SIZE, __func__);
+  float *result_span = (float *)MEM_mallocN(sizeof(float) * 4 * BUFFER_SIZE, __func__);
+
+  for (int x = 0; x < BUFFER_SIZE; x++) {
+    derivatives[x][0][0] = 1.5f;
+    derivatives[x][0][1] = 0.2f;
+    derivatives[x][1][0] = -0.2f;
+    derivatives[x][1][1] = 1.5f;
+  }
+
+  /* EWA is expensive, sample a band of rows only. */
+  const int num_rows = BUFFER_SIZE / 16;
+  double pixel_timing = 0.0, span_timing = 0.0;
+  for (int y = 0; y < num_rows; y++) {
+    memory_buffer_row_coords(coords, BUFFER_SIZE, BUFFER_SIZE, y * 16);
+
+    double init_time = PIL_check_seconds_timer();
+    for (int x = 0; x < BUFFER_SIZE; x++) {
+      buffer->readEWA(&result_pixel[x * 4], &coords[x * 2], derivatives[x]);
+    }
+    pixel_timing += PIL_check_seconds_timer() - init_time;
+
+    init_time = PIL_check_seconds_timer();
+    buffer->readEWASpan(result_span, coords, derivatives, BUFFER_SIZE);
+    span_timing += PIL_check_seconds_timer() - init_time;
+
+    for (int i = 0; i < BUFFER_SIZE * 4; i++) {
+      EXPECT_EQ(result_pixel[i], result_span[i]);
+    }
+  }
+
+  printf("\tEWA color: per pixel done in %fs, span done in %fs over %d rows\n",
+         pixel_timing,
+         span_timing,
+         num_rows);
+
+  MEM_freeN(coords);
+  MEM_freeN(derivatives);
+  MEM_freeN(result_pixel);
+  MEM_freeN(result_span);
+  delete buffer;
+}
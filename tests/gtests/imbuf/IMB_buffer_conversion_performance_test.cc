@@ -0,0 +1,137 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_math.h"
+#include "BLI_utildefines.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 10
+
+/* 4K frame. */
+#define BUFFER_WIDTH 3840
+#define BUFFER_HEIGHT 2160
+
+/* Premultiplied ramps over every byte level, slightly out of the [0, 1] range to exercise
+ * clamping, with zero alpha every fifth pixel to exercise the predivide fallback. */
+static float *float_buffer_create(void)
+{
+  const size_t size = (size_t)BUFFER_WIDTH * BUFFER_HEIGHT * 4;
+  float *buffer = (float *)MEM_mallocN(sizeof(float) * size, __func__);
+  float *pixel = buffer;
+  for (int y = 0; y < BUFFER_HEIGHT; y++) {
+    for (int x = 0; x < BUFFER_WIDTH; x++, pixel += 4) {
+      const float alpha = (float)(x % 5) / 4.0f;
+      for (int c = 0; c < 3; c++) {
+        const int level = (x + y + c * 85) % 256;
+        pixel[c] = alpha * ((float)level / 255.0f * 1.1f - 0.05f);
+      }
+      pixel[3] = alpha;
+    }
+  }
+  return buffer;
+}
+
+/* Per pixel conversion as done before the conversion was vectorized. */
+static void byte_from_float_reference(unsigned char *rect_to,
+                                      const float *rect_from,
+                                      float dither,
+                                      bool predivide)
+{
+  for (int y = 0; y < BUFFER_HEIGHT; y++) {
+    const float t = (float)y / BUFFER_HEIGHT;
+    const float *from = rect_from + (size_t)BUFFER_WIDTH * y * 4;
+    unsigned char *to = rect_to + (size_t)BUFFER_WIDTH * y * 4;
+
+    for (int x = 0; x < BUFFER_WIDTH; x++, from += 4, to += 4) {
+      float straight[4];
+      if (predivide) {
+        premul_to_straight_v4_v4(straight, from);
+      }
+      else {
+        copy_v4_v4(straight, from);
+      }
+
+      if (dither) {
+        const float s = (float)x / BUFFER_WIDTH;
+        const float dither_value = dither_random_value(s, t) * 0.0033f * dither;
+        to[0] = unit_float_to_uchar_clamp(dither_value + straight[0]);
+        to[1] = unit_float_to_uchar_clamp(dither_value + straight[1]);
+        to[2] = unit_float_to_uchar_clamp(dither_value + straight[2]);
+        to[3] = unit_float_to_uchar_clamp(straight[3]);
+      }
+      else {
+        rgba_float_to_uchar(to, straight);
+      }
+    }
+  }
+}
+
+static void buffer_byte_from_float_test_do(const char *id, float dither, bool predivide)
+{
+  const size_t size = (size_t)BUFFER_WIDTH * BUFFER_HEIGHT * 4;
+  float *buffer = float_buffer_create();
+  unsigned char *result_reference = (unsigned char *)MEM_mallocN(size, __func__);
+  unsigned char *result = (unsigned char *)MEM_mallocN(size, __func__);
+
+  double reference_timing = 0.0, timing = 0.0;
+  for (int run = 0; run < NUM_RUN_AVERAGED; run++) {
+    double init_time = PIL_check_seconds_timer();
+    byte_from_float_reference(result_reference, buffer, dither, predivide);
+    reference_timing += PIL_check_seconds_timer() - init_time;
+
+    init_time = PIL_check_seconds_timer();
+    IMB_buffer_byte_from_float(result,
+                               buffer,
+                               4,
+                               dither,
+                               IB_PROFILE_SRGB,
+                               IB_PROFILE_SRGB,
+                               predivide,
+                               BUFFER_WIDTH,
+                               BUFFER_HEIGHT,
+                               BUFFER_WIDTH,
+                               BUFFER_WIDTH);
+    timing += PIL_check_seconds_timer() - init_time;
+  }
+
+  EXPECT_EQ(memcmp(result_reference, result, size), 0);
+
+  printf("\t%s: per pixel done in %fs, buffer conversion done in %fs on average over %d runs\n",
+         id,
+         reference_timing / NUM_RUN_AVERAGED,
+         timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  MEM_freeN(buffer);
+  MEM_freeN(result_reference);
+  MEM_freeN(result);
+}
+
+TEST(imbuf_buffer_conversion, ByteFromFloat)
+{
+  buffer_byte_from_float_test_do("Byte from float", 0.0f, false);
+}
+
+TEST(imbuf_buffer_conversion, ByteFromFloatPredivide)
+{
+  buffer_byte_from_float_test_do("Byte from float predivide", 0.0f, true);
+}
+
+TEST(imbuf_buffer_conversion, ByteFromFloatDither)
+{
+  buffer_byte_from_float_test_do("Byte from float dither", 1.0f, false);
+}
+
+TEST(imbuf_buffer_conversion, ByteFromFloatDitherPredivide)
+{
+  buffer_byte_from_float_test_do("Byte from float dither predivide", 1.0f, true);
+}
@@ -0,0 +1,186 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+extern "C" {
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "PIL_time.h"
+
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/log.h>
+}
+
+/* One minute of 1080p at 25 frames per second. */
+#define CLIP_WIDTH 1920
+#define CLIP_HEIGHT 1080
+#define CLIP_FRAMES 1500
+
+static bool clip_write_packets(AVFormatContext *outfile, AVCodecContext *c, AVStream *st)
+{
+  AVPacket packet = {0};
+  av_init_packet(&packet);
+
+  while (avcodec_receive_packet(c, &packet) >= 0) {
+    av_packet_rescale_ts(&packet, c->time_base, st->time_base);
+    packet.stream_index = st->index;
+    if (av_interleaved_write_frame(outfile, &packet) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Encode a clip of moving gradients, long enough for the decoding and encoding of the proxies
+ * to dominate the timings. */
+static bool clip_create(const char *filepath)
+{
+  AVFormatContext *outfile = NULL;
+  if (avformat_alloc_output_context2(&outfile, NULL, "avi", filepath) < 0) {
+    return false;
+  }
+
+  AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+  AVStream *st = avformat_new_stream(outfile, codec);
+  AVCodecContext *c = avcodec_alloc_context3(codec);
+  c->width = CLIP_WIDTH;
+  c->height = CLIP_HEIGHT;
+  c->pix_fmt = AV_PIX_FMT_YUV420P;
+  c->time_base.num = 1;
+  c->time_base.den = 25;
+  c->gop_size = 25;
+  c->bit_rate = 20000000;
+  st->time_base = c->time_base;
+
+  bool ok = avcodec_open2(c, codec, NULL) >= 0 &&
+            avcodec_parameters_from_context(st->codecpar, c) >= 0 &&
+            avio_open(&outfile->pb, filepath, AVIO_FLAG_WRITE) >= 0 &&
+            avformat_write_header(outfile, NULL) >= 0;
+
+  AVFrame *frame = av_frame_alloc();
+  frame->format = c->pix_fmt;
+  frame->width = c->width;
+  frame->height = c->height;
+  ok = ok && av_frame_get_buffer(frame, 32) >= 0;
+
+  for (int i = 0; i < CLIP_FRAMES && ok; i++) {
+    av_frame_make_writable(frame);
+    for (int y = 0; y < c->height; y++) {
+      for (int x = 0; x < c->width; x++) {
+        frame->data[0][y * frame->linesize[0] + x] = (unsigned char)(x + y + i * 3);
+      }
+    }
+    for (int y = 0; y < c->height / 2; y++) {
+      for (int x = 0; x < c->width / 2; x++) {
+        frame->data[1][y * frame->linesize[1] + x] = (unsigned char)(128 + y + i * 2);
+        frame->data[2][y * frame->linesize[2] + x] = (unsigned char)(64 + x + i * 5);
+      }
+    }
+    frame->pts = i;
+    ok = avcodec_send_frame(c, frame) >= 0 && clip_write_packets(outfile, c, st);
+  }
+
+  if (ok) {
+    avcodec_send_frame(c, NULL);
+    ok = clip_write_packets(outfile, c, st) && av_write_trailer(outfile) >= 0;
+  }
+
+  av_frame_free(&frame);
+  avcodec_free_context(&c);
+  if (outfile->pb) {
+    avio_closep(&outfile->pb);
+  }
+  avformat_free_context(outfile);
+  return ok;
+}
+
+static double proxy_build(const char *filepath, IMB_Proxy_Size proxy_sizes)
+{
+  char colorspace[IM_MAX_SPACE] = "";
+  struct anim *anim = IMB_open_anim(filepath, IB_rect, 0, colorspace);
+  if (anim == NULL) {
+    return 0.0;
+  }
+
+  const double init_time = PIL_check_seconds_timer();
+  struct IndexBuildContext *context = IMB_anim_index_rebuild_context(
+      anim, IMB_TC_RECORD_RUN, proxy_sizes, 50, true, NULL);
+  short stop = false, do_update = false;
+  float progress = 0.0f;
+  if (context) {
+    IMB_anim_index_rebuild(context, &stop, &do_update, &progress);
+    IMB_anim_index_rebuild_finish(context, stop);
+  }
+  const double timing = PIL_check_seconds_timer() - init_time;
+
+  IMB_close_anim(anim);
+  return timing;
+}
+
+/* Contents of the record run index of the clip, empty when it does not exist. */
+static std::string index_read(const std::string &filepath)
+{
+  char index_filepath[FILE_MAX];
+  BLI_split_dir_part(filepath.c_str(), index_filepath, sizeof(index_filepath));
+  BLI_path_append(index_filepath, sizeof(index_filepath), "BL_proxy");
+  BLI_path_append(index_filepath, sizeof(index_filepath), BLI_path_basename(filepath.c_str()));
+  BLI_path_append(index_filepath, sizeof(index_filepath), "record_run.blen_tc");
+
+  std::ifstream file(index_filepath, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+TEST(imbuf_proxy_build, AllSizes)
+{
+  av_log_set_level(AV_LOG_QUIET);
+  IMB_init();
+
+  const std::string filepath = ::testing::TempDir() + "proxy_build_performance.avi";
+  ASSERT_TRUE(clip_create(filepath.c_str()));
+
+  const IMB_Proxy_Size sizes[] = {IMB_PROXY_25, IMB_PROXY_50, IMB_PROXY_75, IMB_PROXY_100};
+  double separate_timing = 0.0;
+  for (const IMB_Proxy_Size size : sizes) {
+    separate_timing += proxy_build(filepath.c_str(), size);
+  }
+
+  const IMB_Proxy_Size all_sizes = (IMB_Proxy_Size)(IMB_PROXY_25 | IMB_PROXY_50 | IMB_PROXY_75 |
+                                                    IMB_PROXY_100);
+  const double timing = proxy_build(filepath.c_str(), all_sizes);
+
+  printf("\t%d frames: one size per pass done in %fs, all sizes in one pass done in %fs\n",
+         CLIP_FRAMES,
+         separate_timing,
+         timing);
+
+  /* Decoding with threads has to find the same frames at the same seek positions. */
+  const std::string index = index_read(filepath);
+  BLI_system_num_threads_override_set(1);
+  proxy_build(filepath.c_str(), all_sizes);
+  BLI_system_num_threads_override_set(0);
+  const std::string index_reference = index_read(filepath);
+
+  EXPECT_FALSE(index_reference.empty());
+  EXPECT_TRUE(index == index_reference);
+
+  char proxy_dir[FILE_MAX];
+  BLI_split_dir_part(filepath.c_str(), proxy_dir, sizeof(proxy_dir));
+  BLI_path_append(proxy_dir, sizeof(proxy_dir), "BL_proxy");
+  BLI_delete(proxy_dir, true, true);
+  BLI_delete(filepath.c_str(), false, false);
+
+  IMB_exit();
+}